@@ -0,0 +1,186 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;                                                                            ;
+;                               conversions.s                                ;
+;                          Various type conversions                          ;
+;                                                                            ;
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;
+; This files contains functions that convert between various types:
+;   IntToString - convert a 32-bit integer to a padded string
+;   i16ToString - convert a 16-bit integer to a string
+;
+; The copies of this file in the projects must stay the same, IntToString and
+; the copies are checked on a host by testing/conversions (make).
+;
+; Revision History:
+;	4/28/24	Adam Krivka		added IntToString (division-free), i16ToString
+;							uses it
+;	5/18/24	Adam Krivka		IntToString doesn't use SP as an operand
+
+; local includes
+	.include "ascii.inc"
+
+; export functions to other files
+	.def IntToString
+	.def i16ToString
+
+
+
+ASR_LENGTH	.equ	31
+WORD_SIZE	.equ	4
+BASE		.equ	10
+
+; reciprocal of 10 for dividing with a multiply, x / 10 is the high word of
+; x * RECIP_10 shifted right by RECIP_10_SHIFT (exact for every 32-bit x)
+RECIP_10		.equ	0xCCCCCCCD	; round_up(2^35 / 10)
+RECIP_10_SHIFT	.equ	3			; 35 - 32
+
+; local buffer for the digits (10 digits and a sign, word aligned)
+DIGIT_BUFFER_SIZE	.equ	12
+
+
+
+; IntToString
+;
+; Description:          Converts a signed 32-bit integer to a NUL terminated
+;						decimal string, left justified and padded with spaces
+;						to the passed width.
+;
+; Operation:            The absolute value is divided by 10 repeatedly, the
+;						remainders are the digits from the least significant
+;						one.  They are stored in a buffer on the stack, then
+;						the sign is added and the buffer is copied out
+;						backwards, followed by the padding and the NUL.
+;
+; Arguments:            R0 = integer to convert, R1 = string buffer pointer
+;						(must hold max(length, width) + 1 bytes, 12 bytes are
+;						enough for any integer), R2 = width to pad to (0 for
+;						no padding).
+; Return Values:        None (string in buffer pointed by R1)
+;
+; Local Variables:      |integer| in R4, string pointer in R5, sign mask in R6,
+;						padding left in R7, digit buffer pointer in R3.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Algorithms:           Division by 10 is done by multiplying by the reciprocal
+;						(UMULL) instead of with the slow divide instruction.
+; Registers Changed:    flags, R0, R1, R2, R3
+; Stack Depth:          8
+;
+; Revision History:
+;	4/28/24	Adam Krivka		initial revision
+;	5/18/24	Adam Krivka		length not computed with SP as an operand
+
+IntToString:
+	PUSH	{LR, R4, R5, R6, R7}		; save return address and used registers
+
+; save variables
+	MOV		R5, R1						; string buffer pointer
+	MOV		R7, R2						; width to pad to
+
+; check if negative
+	ASR		R6, R0, #ASR_LENGTH			; R6 = R0[31] (-1 if negative, 0 if positive)
+
+; take absolute value (as unsigned, so the most negative integer works)
+	EOR		R4, R0, R6					; R4 = R0 ^ R6 (R4 = R0 if positive, R4 = -R0 - 1 if negative)
+	SUB		R4, R4, R6					; R4 = R4 - R6 (R4 = R0 if positive, R4 = -R0 if negative)
+
+; create local buffer for the digits on the stack
+	SUB		R13, #DIGIT_BUFFER_SIZE
+	MOV		R3, R13						; next free byte in the buffer
+
+	MOVW	R1, #(RECIP_10 & 0xFFFF)	; prepare reciprocal of 10 (low half)
+	MOVT	R1, #(RECIP_10 >> 16)		;   and high half
+IntToStringConversionLoop:
+; divide by 10 and get remainder
+	UMULL	R2, R0, R4, R1				; R0 = high word of R4 * RECIP_10
+	LSR		R0, #RECIP_10_SHIFT			; R0 = R4 / 10 (rounded down)
+	MOV		R2, #BASE
+	MLS		R2, R0, R2, R4				; R2 = R4 - R0*10 (R2 = R4 % 10)
+
+	ADD		R2, #ASCII_ZERO				; convert to ASCII
+	STRB	R2, [R3], #1				; store in stack buffer
+
+	MOVS	R4, R0						; update number to convert
+	BNE		IntToStringConversionLoop	; if it isn't zero, there are more digits
+	;B		IntToStringConversionLoopDone
+
+IntToStringConversionLoopDone:
+	CMP		R6, #0						; check if negative
+	BEQ		IntToStringPositive			; if not, skip adding minus sign
+	;B		IntToStringNegative
+
+IntToStringNegative:
+	MOV		R2, #ASCII_MINUS			; prepare minus sign ASCII code
+	STRB	R2, [R3], #1				; add minus sign to buffer
+	;B		IntToStringPositive
+
+IntToStringPositive:
+	MOV		R0, R13						; get length of the number (SP can't
+	SUB		R0, R3, R0					;   be subtracted directly)
+	SUB		R7, R0						; padding needed (not if negative)
+	;B		IntToStringCopyLoop
+
+IntToStringCopyLoop:
+	LDRB	R2, [R3, #-1]!				; load byte from stack buffer (backwards)
+	STRB	R2, [R5], #1				; store byte in string buffer
+	CMP		R3, R13						; check if at the start of the stack buffer
+	BNE		IntToStringCopyLoop			; if not, copy more
+	;B		IntToStringPadLoop
+
+IntToStringPadLoop:
+	CMP		R7, #0						; check if more padding is needed
+	BLE		IntToStringPadDone			; if not, done padding
+	MOV		R2, #ASCII_SPACE			; pad with a space
+	STRB	R2, [R5], #1
+	SUB		R7, #1						; one less space needed
+	B		IntToStringPadLoop
+
+IntToStringPadDone:
+	MOV		R2, #ASCII_NUL				; terminate the string
+	STRB	R2, [R5]
+
+	ADD		R13, #DIGIT_BUFFER_SIZE		; restore stack pointer
+	POP		{LR, R4, R5, R6, R7}		; restore return address and used registers
+	BX		LR							; return
+
+
+
+; i16ToString
+;
+; Description:          Converts a 16-bit integer to a string.
+;
+; Arguments:            R0 = integer to convert, R1 = string buffer pointer (must
+;						exactly 8 bytes).
+; Return Values:        None (string in buffer pointed by R1)
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2, R3
+; Stack Depth:          9
+;
+; Revision History:
+;	4/28/24	Adam Krivka		uses IntToString
+
+i16ToString:
+	PUSH	{LR}						; save return address
+
+; clean buffer (set to zeros)
+	MOV		R2, #0
+	STR		R2, [R1]					; set first word to zero
+	STR		R2, [R1, #WORD_SIZE]		; set second word to zero
+
+; sign extend to 32 bits and convert with no padding
+	SXTH	R0, R0						; R0 = R0[15:0] sign extended to 32 bits
+	MOV		R2, #0						; no padding
+	BL		IntToString
+
+	POP		{LR}						; restore return address
+	BX		LR							; return
@@ -11,10 +11,12 @@
 ;    GPIOClockInit - initializes the clock for the GPIO peripheral
 ;    GPTClockInit - initializes the clock for the GPT peripheral
 ;	 SSIClockInit - initializes the clock for the SSI module
+;	 DMAClockInit - initializes the clock for the uDMA controller
 ;
 ; Revision History:
 ;     11/7/23  Adam Krivka      initial revision
 ;	  1/12/24  Adam Krivka		added SSIClockInit
+;	  5/18/24  Adam Krivka		added DMAClockInit
 
 
 ; local include files
@@ -26,6 +28,7 @@
     .def GPIOClockInit
     .def GPTClockInit
     .def SSIClockInit
+    .def DMAClockInit
 
 ; ----------------------------------------------------------------------------
 
@@ -203,3 +206,47 @@ SSIClockLoop:
 
     BNE        SSIClockLoop                ; if not, loop/try again
     BX         LR                          ; if yes, return
+
+
+; DMAClockInit
+;
+; Description:        Initializes the clock for the uDMA controller.
+;
+; Operation:        Sets SECDMACLKGR to turn on the clock, then waits for
+;                    CLKLOADCTL to indicate that the clock is on.
+;
+; Arguments:        None
+; Returns:            None
+;
+; Local Variables:    None
+; Global Variables:    None
+;
+; Error Handling:    None
+;
+; Algorithms:        None
+; Data Structures:    None
+;
+; Registers Changed:    R0, R1
+; Stack Depth:        0
+;
+; Revision History:    5/18/24  Adam Krivka  initial revision
+
+DMAClockInit:
+    MOV32      R0, PRCM_BASE_ADDR           ; prepare PRCM register base address
+    MOV        R1, #SECDMACLKGR_DMA_CLK_EN  ; prepare DMA_CLK_EN (clock enable)
+                                            ; value for SECDMACLKGR
+    STR        R1, [R0, #SECDMACLKGR_OFFSET] ; write to SECDMACLKGR register to
+                                            ; turn on the clock
+
+    MOV        R1, #CLKLOADCTL_LOAD         ; prepare LOAD value for CLKLOADCTL
+    STR        R1, [R0, #CLKLOADCTL_OFFSET] ; write to CLKLOADCTL to load the clock
+    ;DMAClockLoop
+
+; Wait for CLKLOADCTL to signal clock done loading
+DMAClockLoop:
+    ; check if CLKLOADCTL has LOAD_DONE bit set active
+    LDR        R1, [R0, #CLKLOADCTL_OFFSET]
+    CMP        R1, #CLKLOADCTL_LOAD_DONE
+
+    BNE        DMAClockLoop                ; if not, loop/try again
+    BX         LR                          ; if yes, return
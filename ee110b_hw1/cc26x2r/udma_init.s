@@ -0,0 +1,92 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;                                                                            ;
+;                                 udma_init.s                                ;
+;                        uDMA Initialization Procedures                      ;
+;                                                                            ;
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+; This file contains the uDMA channel control table and the function:
+;    UDMAInit - enables the uDMA controller with the control table
+;
+; The table is shared by all the drivers using uDMA.  Each driver writes the
+; control structures of its own channels at
+;    UDMAControlTable + UDMA_ENTRY_SIZE * channel (primary) or
+;    UDMAControlTable + UDMA_ALT_OFFSET + UDMA_ENTRY_SIZE * channel (alternate).
+;
+; Revision History:
+;	5/18/24	Adam Krivka		initial revision
+
+
+
+; local include files
+	.include "udma_reg.inc"
+	.include "../std.inc"
+
+; exporting functions and variables defined in this file
+	.def UDMAInit
+	.def UDMAControlTable
+
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; DATA
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+	.data
+
+	; channel control table (primary then alternate structures)
+	.align UDMA_TABLE_ALIGN
+UDMAControlTable:	.space UDMA_TABLE_SIZE
+
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; CODE
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+	.text
+
+; UDMAInit
+;
+; Description:			Enables the uDMA controller with UDMAControlTable as
+;						its channel control table.  No channels are enabled.
+;						The uDMA clock must already be on (DMAClockInit).
+;
+; Operation:			Every channel is disabled, set to use its primary
+;						structure, and has its requests unmasked, then the
+;						table address is written to CTRL and the controller
+;						is enabled.
+;
+; Arguments:			None.
+; Return Values:		None.
+;
+; Local Variables:		None.
+; Shared Variables:		None.
+; Global Variables:		None.
+;
+; Input:				None.
+; Output:				uDMA registers.
+;
+; Error Handling:		None.
+;
+; Registers Changed:	R0, R1
+; Stack Depth:			0 words
+;
+; Algorithms:			None.
+; Data Structures:		None.
+;
+; Revision History:
+;	5/18/24	Adam Krivka		initial revision
+
+UDMAInit:
+	MOV32	R1, UDMA_BASE_ADDR			; prepare uDMA base address
+
+	; start with every channel off, on its primary structure, and unmasked
+	STREG	0xFFFFFFFF, R1, UDMA_CLEARCHANNELEN_OFFSET
+	STREG	0xFFFFFFFF, R1, UDMA_CLEARCHNLPRIALT_OFFSET
+	STREG	0xFFFFFFFF, R1, UDMA_CLEARREQMASK_OFFSET
+
+	MOVA	R0, UDMAControlTable		; set the control table
+	STR		R0, [R1, #UDMA_CTRL_OFFSET]
+
+	STREG	UDMA_CFG_MASTERENABLE, R1, UDMA_CFG_OFFSET	; enable the controller
+
+	BX		LR							; done, return
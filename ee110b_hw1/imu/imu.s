@@ -20,9 +20,15 @@
 ;		GetMagX
 ;		GetMagY
 ;		GetMagZ
+;		ReadIMUAll
+;		IMUUnpack
 
 ; Revision History:
 ;		12/5/23	Adam Krivka		initial revision
+;		5/16/24	Adam Krivka		added ReadIMUAll (burst read of the
+;								accelerometer and gyroscope)
+;		5/18/24	Adam Krivka		split IMUUnpack out of ReadIMUAll for the
+;								streamed samples
 
 
 
@@ -32,6 +38,7 @@
 
 ; import functions from other files
 	.ref SSITransact
+	.ref SSIBurst
 
 ; export functions to other files
 	.def InitIMU
@@ -44,6 +51,8 @@
 	.def GetMagX
 	.def GetMagY
 	.def GetMagZ
+	.def ReadIMUAll
+	.def IMUUnpack
 
 
 
@@ -235,6 +244,120 @@ WriteIMUReg:
 	POP		{LR}						; restore return address and used registers
 	BX		LR							; return
 
+; ReadIMUAll
+;
+; Description:			Reads the accelerometer, temperature, and gyroscope
+;						registers (ACCEL_XOUT_H through GYRO_ZOUT_L) in one
+;						burst into the passed structure of signed 16-bit
+;						values (see IMU_DATA_* in imu_symbols.inc).
+;
+; Operation:			The read address is sent in the high byte of the
+;						first 16-bit frame and the IMU auto-increments the
+;						register address for the rest of the frames, so each
+;						received frame holds the low byte of one value and
+;						the high byte of the next (the first and last bytes
+;						are unused).  The frames are received in a buffer on
+;						the stack and then put back together into the values.
+;
+; Arguments:			R0 = address of the IMU data structure (IMU_DATA_SIZE
+;						bytes, halfword aligned).
+; Returns:				R0 = FUNCTION_SUCCESS if the data was read,
+;						FUNCTION_FAIL otherwise.
+;
+; Local Variables:      R4 = structure pointer.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       If the burst fails FUNCTION_FAIL is returned and the
+;						structure isn't changed.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          7
+;
+; Revision History:
+;		5/16/24	Adam Krivka		initial revision
+;		5/18/24	Adam Krivka		unpacks with IMUUnpack
+
+ReadIMUAll:
+	PUSH	{LR, R4}						; save return address and used registers
+
+; create local buffer for the received frames
+	SUB		R13, #(IMU_BURST_FRAMES * 2)
+	MOV		R4, R0						; save the structure pointer
+
+	; read all the registers in one burst
+	MOV		R0, #((IMU_READ | IMU_BURST_START) << IMU_WORD)	; read from the first
+	MOV		R1, R13						; into the local buffer
+	MOV		R2, #IMU_BURST_FRAMES
+	BL		SSIBurst
+	CMP		R0, #FUNCTION_FAIL
+	BEQ		ReadIMUAllDone				; burst failed, return the failure
+
+	; put the values back together
+	MOV		R0, R13						; from the received frames
+	MOV		R1, R4						; into the structure
+	BL		IMUUnpack
+	;B		ReadIMUAllSuccess
+
+ReadIMUAllSuccess:
+	MOV		R0, #FUNCTION_SUCCESS
+	;B		ReadIMUAllDone
+
+ReadIMUAllDone:
+	ADD		R13, #(IMU_BURST_FRAMES * 2)	; return stack pointer
+	POP		{LR, R4}						; restore return address and used registers
+	BX		LR							; return
+
+
+
+; IMUUnpack
+;
+; Description:			Puts the IMU_BURST_FRAMES frames received in a burst
+;						read from IMU_BURST_START (by ReadIMUAll or the IMU
+;						stream) back together into the structure of signed
+;						16-bit values (see IMU_DATA_* in imu_symbols.inc).
+;
+; Operation:			Each received frame holds the low byte of one value
+;						and the high byte of the next (the first byte of the
+;						first frame was clocked in with the address and the
+;						last byte of the last frame is unused), so each
+;						value is the low byte of one frame followed by the
+;						high byte of the next.
+;
+; Arguments:			R0 = address of the received frames (halfword
+;						aligned).
+;						R1 = address of the IMU data structure (IMU_DATA_SIZE
+;						bytes, halfword aligned).
+; Returns:				None.
+;
+; Local Variables:      R2 = values left.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          0
+;
+; Revision History:
+;		5/18/24	Adam Krivka		initial revision (from ReadIMUAll)
+
+IMUUnpack:
+	MOV		R2, #IMU_BURST_VALUES		; get all the values
+	;B		IMUUnpackLoop
+
+IMUUnpackLoop:
+	LDRB	R3, [R0], #2				; high byte is the low byte of the frame
+	LDRB	R12, [R0, #1]				; low byte is the high byte of the next
+	ORR		R12, R12, R3, LSL #8		; combine high and low bytes
+	STRH	R12, [R1], #2				; store the value
+	SUBS	R2, #1						; check for more values
+	BNE		IMUUnpackLoop
+	;B		IMUUnpackDone
+
+IMUUnpackDone:
+	BX		LR							; return
+
 ; WriteMagnetReg
 ;
 ; Description:			Writes a register to the magnetometer.
@@ -0,0 +1,364 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;                                                                            ;
+;                                imu_stream.s                                ;
+;                             IMU Sample Streaming                           ;
+;                                                                            ;
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;
+; This file contains the code that streams the IMU accelerometer, temperature,
+; and gyroscope samples at a fixed output data rate without the CPU.  The
+; sample timer's uDMA channel writes the frames of a burst read (see
+; ReadIMUAll) to the SSI on every time-out, and the SSI receive uDMA channel
+; stores the received frames into one of two blocks of samples.  When a block
+; is full the channels switch to the other block (ping-pong) and the SSI
+; interrupt passes the full block to the callback, so the CPU is only
+; involved once per IMU_STREAM_BLOCK_SAMPLES samples.
+;
+; The SSI can't be used for anything else (SSITransact, SSIBurst, ReadIMUAll,
+; ...) while streaming.
+;
+; This file defines functions:
+;		IMUStreamStart
+;		IMUStreamStop
+;
+; Revision History:
+;		5/18/24	Adam Krivka		initial revision
+
+
+
+; local includes
+	.include "../std.inc"
+	.include "imu_symbols.inc"
+	.include "imu_stream_symbols.inc"
+	.include "../cc26x2r/cpu_scs_reg.inc"
+
+; import symbols from other files
+	.ref UDMAControlTable
+
+; export functions to other files
+	.def IMUStreamStart
+	.def IMUStreamStop
+
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; DATA
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+	.data
+
+	.align BYTES_PER_WORD
+; frames sent for a block of samples (the sample timer channel sends a block
+; from here for every block received)
+StreamTx:		.space	IMU_STREAM_BLOCK_SIZE
+
+; the two blocks of received samples
+StreamBlocks:	.space	(2 * IMU_STREAM_BLOCK_SIZE)
+
+; function called with each full block (0 for none)
+StreamCallback:	.word	0
+
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; CODE
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+	.text
+
+; IMUStreamStart
+;
+; Description:			Starts streaming the IMU samples at the passed output
+;						data rate.  Every IMU_STREAM_BLOCK_SAMPLES samples the
+;						callback is called (from the SSI interrupt) with
+;						R0 = address of the block of samples and R1 =
+;						IMU_STREAM_BLOCK_SAMPLES.  Each sample is
+;						IMU_STREAM_SAMPLE_SIZE bytes of received frames (use
+;						IMUUnpack to get the values).  The block stays
+;						unchanged until the other block is full, one block
+;						time later.  The uDMA controller (UDMAInit), the SSI
+;						(InitSSI), and the IMU (InitIMU) must already be
+;						initialized.
+;
+; Operation:			The frames sent for a block are written to StreamTx.
+;						Both channels are set up in ping-pong mode with a
+;						block per structure: the sample timer channel moves
+;						a whole sample from StreamTx to the SSI data register
+;						per request (time-out), and the SSI receive channel
+;						moves each received frame to the primary or alternate
+;						block.  The SSI interrupt is installed and enabled,
+;						the SSI receive FIFO is emptied and its uDMA requests
+;						are enabled, and the sample timer is started with a
+;						period of IMU_STREAM_CLOCK / rate clocks.
+;
+; Arguments:			R0 = output data rate in Hz (1 to IMU_STREAM_MAX_ODR).
+;						R1 = address of the callback (0 for none).
+; Returns:				R0 = FUNCTION_SUCCESS if streaming was started,
+;						FUNCTION_FAIL otherwise.
+;
+; Local Variables:      R4 = sample timer period, R1 = control table.
+; Shared Variables:     Sets StreamTx and StreamCallback.
+; Global Variables:     Writes the stream channels in UDMAControlTable.
+;
+; Error Handling:       A rate of 0 or above IMU_STREAM_MAX_ODR returns
+;						FUNCTION_FAIL without starting.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          2
+;
+; Revision History:
+;		5/18/24	Adam Krivka		initial revision
+
+IMUStreamStart:
+	PUSH	{LR, R4}					; save return address and used registers
+
+	; check the output data rate
+	CMP		R0, #0
+	BEQ		IMUStreamStartFail			; no rate, fail
+	CMP		R0, #IMU_STREAM_MAX_ODR
+	BHI		IMUStreamStartFail			; too fast, fail
+	;B		IMUStreamStartPeriod
+
+IMUStreamStartPeriod:
+	MOV32	R2, IMU_STREAM_CLOCK		; period = clock / rate
+	UDIV	R4, R2, R0
+	SUB		R4, #1						; timer counts down to 0
+
+	MOVA	R2, StreamCallback			; remember the callback
+	STR		R1, [R2]
+
+	; fill in the frames sent for a block
+	MOVA	R1, StreamTx				; start at the first sample
+	MOV		R2, #IMU_STREAM_BLOCK_SAMPLES	; and fill them all
+	MOV		R3, #IMU_STREAM_FIRST_FRAME	; each one starts with the address
+	MOV		R0, #0						; followed by zeros
+	;B		IMUStreamStartTxSample
+
+IMUStreamStartTxSample:
+	STRH	R3, [R1], #2				; store the address frame
+	MOV		R12, #(IMU_BURST_FRAMES - 1)	; and the zero frames
+	;B		IMUStreamStartTxZero
+
+IMUStreamStartTxZero:
+	STRH	R0, [R1], #2				; store a zero frame
+	SUBS	R12, #1						; check for more zero frames
+	BNE		IMUStreamStartTxZero
+	SUBS	R2, #1						; check for more samples
+	BNE		IMUStreamStartTxSample
+	;B		IMUStreamStartChannels
+
+IMUStreamStartChannels:
+	MOVA	R1, UDMAControlTable		; prepare control table address
+
+	; sample timer channel, both structures send all of StreamTx
+	MOVA	R2, StreamTx				; end pointer is the last frame
+	ADD		R2, #(IMU_STREAM_BLOCK_SIZE - 2)
+	STR		R2, [R1, #(STREAM_TX_PRI + UDMA_ENTRY_SRCENDP)]
+	STR		R2, [R1, #(STREAM_TX_ALT + UDMA_ENTRY_SRCENDP)]
+	MOV32	R2, (SSI_BASE_ADDR + DR_OFFSET)	; all go to the SSI data register
+	STR		R2, [R1, #(STREAM_TX_PRI + UDMA_ENTRY_DSTENDP)]
+	STR		R2, [R1, #(STREAM_TX_ALT + UDMA_ENTRY_DSTENDP)]
+	MOV32	R0, STREAM_TX_CHCTL
+	STR		R0, [R1, #(STREAM_TX_PRI + UDMA_ENTRY_CHCTL)]
+	STR		R0, [R1, #(STREAM_TX_ALT + UDMA_ENTRY_CHCTL)]
+
+	; SSI receive channel, primary fills the first block, alternate the second
+	STR		R2, [R1, #(STREAM_RX_PRI + UDMA_ENTRY_SRCENDP)]	; all from the
+	STR		R2, [R1, #(STREAM_RX_ALT + UDMA_ENTRY_SRCENDP)]	; SSI data register
+	MOVA	R2, StreamBlocks			; end pointer is the last frame
+	ADD		R2, #(IMU_STREAM_BLOCK_SIZE - 2)
+	STR		R2, [R1, #(STREAM_RX_PRI + UDMA_ENTRY_DSTENDP)]
+	ADD		R2, #IMU_STREAM_BLOCK_SIZE	; of each block
+	STR		R2, [R1, #(STREAM_RX_ALT + UDMA_ENTRY_DSTENDP)]
+	MOV32	R0, STREAM_RX_CHCTL
+	STR		R0, [R1, #(STREAM_RX_PRI + UDMA_ENTRY_CHCTL)]
+	STR		R0, [R1, #(STREAM_RX_ALT + UDMA_ENTRY_CHCTL)]
+
+	; start both channels on their primary structures
+	MOV32	R1, UDMA_BASE_ADDR			; prepare uDMA base address
+	STREG	STREAM_CHANNELS, R1, UDMA_CLEARCHNLPRIALT_OFFSET
+	STREG	STREAM_CHANNELS, R1, UDMA_REQDONE_OFFSET	; clear old done
+	STREG	STREAM_CHANNELS, R1, UDMA_SETCHANNELEN_OFFSET
+
+	; set up the SSI interrupt in the CPU
+	MOV32	R1, SCS_BASE_ADDR
+	LDR		R2, [R1, #SCS_VTOR_OFFSET]	; load VTOR address
+	MOVA	R0, IMUStreamEventHandler	; load event handler address
+	STR		R0, [R2, #(BYTES_PER_WORD * STREAM_EXCEPTION_NUMBER)] ; store event handler
+	STREG	(0x1 << STREAM_IRQ_NUMBER), R1, SCS_NVIC_ISER0_OFFSET ; enable interrupt
+
+	; let the SSI receive FIFO request uDMA
+	MOV32	R1, SSI_BASE_ADDR			; prepare SSI base address
+	;B		IMUStreamStartFlush
+
+IMUStreamStartFlush:
+	LDR		R2, [R1, #SR_OFFSET]		; load status register
+	TST		R2, #SR_BSY_BUSY			; wait for the bus to be idle
+	BNE		IMUStreamStartFlush
+	TST		R2, #SR_RNE_NOTEMPTY		; check for old received data
+	BEQ		IMUStreamStartSSI			; none, start the SSI requests
+	LDR		R2, [R1, #DR_OFFSET]		; throw away old received data
+	B		IMUStreamStartFlush
+
+IMUStreamStartSSI:
+	STREG	DMACR_RXDMAE, R1, DMACR_OFFSET
+
+	; start the sample timer
+	MOV32	R1, STREAMTIMER_BASE_ADDR	; prepare sample timer base address
+	STREG	STREAMTIMER_DISABLE, R1, GPT_CTL_OFFSET
+	STREG	STREAMTIMER_CFG, R1, GPT_CFG_OFFSET
+	STREG	STREAMTIMER_TAMR, R1, GPT_TAMR_OFFSET
+	STR		R4, [R1, #GPT_TAILR_OFFSET]	; period for the output data rate
+	STREG	0, R1, GPT_TAPR_OFFSET		; no prescale
+	STREG	STREAMTIMER_IMR, R1, GPT_IMR_OFFSET
+	STREG	STREAMTIMER_DMAEV, R1, GPT_DMAEV_OFFSET
+	STREG	STREAMTIMER_ENABLE, R1, GPT_CTL_OFFSET	; enable timer
+	;B		IMUStreamStartSuccess
+
+IMUStreamStartSuccess:
+	MOV		R0, #FUNCTION_SUCCESS
+	B		IMUStreamStartDone
+
+IMUStreamStartFail:
+	MOV		R0, #FUNCTION_FAIL
+	;B		IMUStreamStartDone
+
+IMUStreamStartDone:
+	POP		{LR, R4}					; restore return address and used registers
+	BX		LR							; return
+
+
+
+; IMUStreamStop
+;
+; Description:			Stops streaming the IMU samples.  The SSI can be used
+;						normally again afterwards.
+;
+; Operation:			Stops the sample timer and its uDMA requests,
+;						disables the SSI interrupt and the stream channels,
+;						and turns off the SSI uDMA requests.  A sample in
+;						progress is finished by the SSI but not stored, so
+;						once the bus is idle the frames left in the receive
+;						FIFO are thrown away.
+;
+; Arguments:			None.
+; Returns:				None.
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2
+; Stack Depth:          0
+;
+; Revision History:
+;		5/18/24	Adam Krivka		initial revision
+;		5/18/24	Adam Krivka		empties the receive FIFO
+
+IMUStreamStop:
+	MOV32	R1, STREAMTIMER_BASE_ADDR	; stop the sample timer
+	STREG	STREAMTIMER_DISABLE, R1, GPT_CTL_OFFSET
+	STREG	0, R1, GPT_DMAEV_OFFSET
+
+	MOV32	R1, SCS_BASE_ADDR			; disable the SSI interrupt
+	STREG	(0x1 << STREAM_IRQ_NUMBER), R1, SCS_NVIC_ICER0_OFFSET
+
+	MOV32	R1, UDMA_BASE_ADDR			; disable the channels
+	STREG	STREAM_CHANNELS, R1, UDMA_CLEARCHANNELEN_OFFSET
+
+	MOV32	R1, SSI_BASE_ADDR			; no more SSI requests
+	STREG	0, R1, DMACR_OFFSET
+	;B		IMUStreamStopFlush
+
+IMUStreamStopFlush:
+	LDR		R2, [R1, #SR_OFFSET]		; load status register
+	TST		R2, #SR_BSY_BUSY			; wait for the bus to be idle
+	BNE		IMUStreamStopFlush
+	TST		R2, #SR_RNE_NOTEMPTY		; check for frames left over
+	BEQ		IMUStreamStopDone			; none, done
+	LDR		R2, [R1, #DR_OFFSET]		; throw away a left over frame
+	B		IMUStreamStopFlush
+
+IMUStreamStopDone:
+	BX		LR							; return
+
+
+
+; IMUStreamEventHandler
+;
+; Description:			Handles the SSI interrupt, signaled when a stream
+;						channel finishes a block.  Each full block is passed
+;						to the callback and its structures are set up again
+;						for the block after next.
+;
+; Operation:			The done flags of the channels are cleared.  Then
+;						the primary and then the alternate structures are
+;						checked: if the receive structure has stopped, its
+;						block is full, so the receive and the sample timer
+;						structures are given their control words again (the
+;						sample timer structure finished its block before the
+;						last frames were received) and the callback is
+;						called with the block.
+;
+; Arguments:			None.
+; Returns:				None.
+;
+; Local Variables:      R4 = offset of the structures checked, R5 = their
+;						block.
+; Shared Variables:     Reads StreamCallback.
+; Global Variables:     Writes the stream channels in UDMAControlTable.
+;
+; Error Handling:       If the handler runs late both blocks may be full, then
+;						both are passed to the callback, primary first.  If
+;						it runs more than a block late the channels have
+;						stopped and streaming must be started again.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          3 + callback
+;
+; Revision History:
+;		5/18/24	Adam Krivka		initial revision
+
+IMUStreamEventHandler:
+	PUSH	{LR, R4, R5}				; save return address and used registers
+
+	MOV32	R1, UDMA_BASE_ADDR			; clear the done flags
+	STREG	STREAM_CHANNELS, R1, UDMA_REQDONE_OFFSET
+
+	MOV		R4, #0						; check the primary structures
+	MOVA	R5, StreamBlocks			; and the first block first
+	;B		IMUStreamEventCheck
+
+IMUStreamEventCheck:
+	MOVA	R1, UDMAControlTable		; get the structures
+	ADD		R1, R4
+	LDR		R0, [R1, #(STREAM_RX_PRI + UDMA_ENTRY_CHCTL)]
+	TST		R0, #UDMA_CHCTL_XFERMODE_MASK	; check if still filling the block
+	BNE		IMUStreamEventNext			; if so, check the next structures
+	;B		IMUStreamEventRearm			; otherwise the block is full
+
+IMUStreamEventRearm:
+	MOV32	R0, STREAM_RX_CHCTL			; receive the block after next
+	STR		R0, [R1, #(STREAM_RX_PRI + UDMA_ENTRY_CHCTL)]
+	MOV32	R0, STREAM_TX_CHCTL			; and send for it
+	STR		R0, [R1, #(STREAM_TX_PRI + UDMA_ENTRY_CHCTL)]
+
+	MOVA	R1, StreamCallback			; get the callback
+	LDR		R2, [R1]
+	CMP		R2, #0
+	BEQ		IMUStreamEventNext			; none, nothing to call
+	MOV		R0, R5						; pass it the block
+	MOV		R1, #IMU_STREAM_BLOCK_SAMPLES	; and its samples
+	BLX		R2
+	;B		IMUStreamEventNext
+
+IMUStreamEventNext:
+	CMP		R4, #0						; check if the alternate was checked
+	BNE		IMUStreamEventDone			; if so, done
+	MOV		R4, #UDMA_ALT_OFFSET		; otherwise check the alternate
+	ADD		R5, #IMU_STREAM_BLOCK_SIZE	; structures and the second block
+	B		IMUStreamEventCheck
+
+IMUStreamEventDone:
+	POP		{LR, R4, R5}				; restore return address and used registers
+	BX		LR							; return
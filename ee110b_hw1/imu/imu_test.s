@@ -8,15 +8,21 @@
 ; This file contains the function:
 ;   TestIMUAccelGyro
 ;	TestIMUMagnet
+;	TestIMUStream
 ; which tests IMU functionality, defined in imu.s.
 ; 
 ; Revision History: 
+;	5/16/24	Adam Krivka		accelerometer and gyroscope test reads them in one
+;							burst
+;	5/18/24	Adam Krivka		added TestIMUStream (samples streamed with uDMA)
 
 
 
 ; local includes
 	.include "../std.inc"
 	.include "imu_test_symbols.inc"
+	.include "imu_symbols.inc"
+	.include "imu_stream_symbols.inc"
 	.include "../cc26x2r/gpio_reg.inc"
 	.include "../cc26x2r/gpt_reg.inc"
 	.include "../cc26x2r/event_reg.inc"
@@ -25,12 +31,9 @@
 
 ; import functions from other files
 	.ref InitIMU
-	.ref GetAccelX
-	.ref GetAccelY
-	.ref GetAccelZ
-	.ref GetGyroX
-	.ref GetGyroY
-	.ref GetGyroZ
+	.ref ReadIMUAll
+	.ref IMUUnpack
+	.ref IMUStreamStart
 	.ref GetMagX
 	.ref GetMagY
 	.ref GetMagZ
@@ -41,16 +44,13 @@
 ; export functions to other files
 	.def TestIMUAccelGyro
 	.def TestIMUMagnet
+	.def TestIMUStream
 
 
 ; TestIMUAccelGyroShowOnLCD
 ;
 ; Description:			Reads the accelerometer and gyroscope X, Y, Z values and
-;						displays them on the LCD like this:
-;						| Accel X | Gyro X |
-;						| Accel Y | Gyro Y |
-;						| Accel Z | Gyro Z |
-;						| 				   |
+;						displays them on the LCD (see ShowAccelGyro).
 ;
 ; Arguments:			None
 ; Returns:				None
@@ -65,15 +65,107 @@
 ; Error Handling:		None.
 ;
 ; Revision History:
+;	5/18/24	Adam Krivka		displays with ShowAccelGyro
 
 TestIMUAccelGyroShowOnLCD:
 	PUSH	{LR, R4}						; save return address and used registers
 
+; create local IMU data buffer (rounded up to a word multiple)
+	SUBS	R13, #IMU_DATA_BUFFER_SIZE
+	MOV		R4, R13						; store pointer to it in R4
+
+	MOV		R0, R4						; read all the values in one burst
+	BL		ReadIMUAll
+	CMP		R0, #FUNCTION_FAIL
+	BEQ		TestIMUAccelGyroShowOnLCDDone	; failed, show nothing new
+
+	MOV		R0, R4						; show them
+	BL		ShowAccelGyro
+
+TestIMUAccelGyroShowOnLCDDone:
+	; Clear interrupt
+	MOV32	R1, TESTTIMER_BASE_ADDR	; prepare timer base address
+	STREG	GPT_ICLR_TATOCINT_CLEAR, R1, GPT_ICLR_OFFSET	; clear Timer A Time-out bit
+
+	ADD		R13, #IMU_DATA_BUFFER_SIZE	; return stack pointer
+	POP		{LR, R4}					; restore return address and used registers
+	BX		LR							; return
+
+
+; TestIMUStreamShowOnLCD
+;
+; Description:			Displays the last sample of a block of streamed
+;						samples on the LCD (see ShowAccelGyro).
+;
+; Arguments:			R0 = address of the block of samples
+;						R1 = number of samples in the block
+; Returns:				None
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Notes:				This function is the IMU stream callback, called from
+;						the SSI interrupt handler.  It is not meant to be
+;						called by the user.
+;
+; Error Handling:		None.
+;
+; Revision History:
+;	5/18/24	Adam Krivka		initial revision
+
+TestIMUStreamShowOnLCD:
+	PUSH	{LR, R4}						; save return address and used registers
+
+; create local IMU data buffer (rounded up to a word multiple)
+	SUBS	R13, #IMU_DATA_BUFFER_SIZE
+	MOV		R4, R13						; store pointer to it in R4
+
+	SUB		R1, #1						; get the last sample
+	MOV		R2, #IMU_STREAM_SAMPLE_SIZE
+	MLA		R0, R1, R2, R0
+	MOV		R1, R4						; put its values in the buffer
+	BL		IMUUnpack
+
+	MOV		R0, R4						; show them
+	BL		ShowAccelGyro
+
+	ADD		R13, #IMU_DATA_BUFFER_SIZE	; return stack pointer
+	POP		{LR, R4}					; restore return address and used registers
+	BX		LR							; return
+
+
+; ShowAccelGyro
+;
+; Description:			Displays the accelerometer and gyroscope X, Y, Z
+;						values on the LCD like this:
+;						| Accel X | Gyro X |
+;						| Accel Y | Gyro Y |
+;						| Accel Z | Gyro Z |
+;						| 				   |
+;
+; Arguments:			R0 = address of the IMU data structure (see IMU_DATA_*
+;						in imu_symbols.inc)
+; Returns:				None
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:		None.
+;
+; Revision History:
+;	5/18/24	Adam Krivka		initial revision (from TestIMUAccelGyroShowOnLCD)
+
+ShowAccelGyro:
+	PUSH	{LR, R4, R5}					; save return address and used registers
+
 ; create local 8-byte string buffer
 	SUBS	R13, #8			
 	MOV		R4, R13						; store pointer to it in R4
+	MOV		R5, R0						; store the structure pointer in R5
 
-	BL		GetAccelX					; get accelerometer X value
+	LDRSH	R0, [R5, #IMU_DATA_ACCEL_X]	; get accelerometer X value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #ACCEL_X_ROW			; set row
@@ -82,7 +174,7 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	BL		GetGyroX					; get gyroscope X value
+	LDRSH	R0, [R5, #IMU_DATA_GYRO_X]	; get gyroscope X value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #GYRO_X_ROW				; set row
@@ -91,7 +183,7 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	BL		GetAccelY					; get accelerometer Y value
+	LDRSH	R0, [R5, #IMU_DATA_ACCEL_Y]	; get accelerometer Y value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #ACCEL_Y_ROW			; set row
@@ -100,7 +192,7 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	BL		GetGyroY					; get gyroscope Y value
+	LDRSH	R0, [R5, #IMU_DATA_GYRO_Y]	; get gyroscope Y value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #GYRO_Y_ROW				; set row
@@ -109,7 +201,7 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	BL		GetAccelZ					; get accelerometer Z value
+	LDRSH	R0, [R5, #IMU_DATA_ACCEL_Z]	; get accelerometer Z value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #ACCEL_Z_ROW			; set row
@@ -118,7 +210,7 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	BL		GetGyroZ					; get gyroscope Z value
+	LDRSH	R0, [R5, #IMU_DATA_GYRO_Z]	; get gyroscope Z value
 	MOV		R1, R4						; string buffer pointer
 	BL		i16ToString					; convert to string
 	MOV		R0, #GYRO_Z_ROW				; set row
@@ -127,12 +219,8 @@ TestIMUAccelGyroShowOnLCD:
 	MOV		R3, #DISPLAY_LENGTH			; display exactly DISPLAY_LENGTH characters
 	BL		Display						; display string
 
-	; Clear interrupt
-	MOV32	R1, TESTTIMER_BASE_ADDR	; prepare timer base address
-	STREG	GPT_ICLR_TATOCINT_CLEAR, R1, GPT_ICLR_OFFSET	; clear Timer A Time-out bit
-
 	ADD		R13, #8						; return stack pointer
-	POP		{LR, R4}						; restore return address and used registers
+	POP		{LR, R4, R5}					; restore return address and used registers
 	BX		LR							; return
 
 
@@ -275,4 +363,31 @@ TestIMUMagnet:
 	STR		R0, [R1, #(BYTES_PER_WORD * TESTTIMER_EXCEPTION_NUMBER)] ; store event handler
 
 	POP		{LR}						; restore return address and used registers
-	BX		LR							; return
\ No newline at end of file
+	BX		LR							; return
+
+
+; TestIMUStream
+;
+; Description:			Streams the IMU accelerometer and gyroscope samples
+;						with uDMA at IMU_TEST_STREAM_ODR, displaying the last
+;						sample of each block on the LCD in a grid fashion,
+;						and then returns (the caller is responsible for
+;						looping).
+;
+; Arguments:			None
+; Returns:				R0 = FUNCTION_SUCCESS if streaming was started,
+;						FUNCTION_FAIL otherwise.
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+
+TestIMUStream:
+	PUSH	{LR}						; save return address and used registers
+
+	MOV		R0, #IMU_TEST_STREAM_ODR	; stream at the test rate
+	MOVA	R1, TestIMUStreamShowOnLCD	; showing each block
+	BL		IMUStreamStart
+
+	POP		{LR}						; restore return address and used registers
+	BX		LR							; return
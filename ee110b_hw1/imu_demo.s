@@ -9,9 +9,11 @@
 ; in subfolder imu/. The demo can test either the accelerometer and the 
 ; gyroscope functionality, or the magnetometer functionality (switch
 ; the test function in the main loop). Both tests display the current
-; x,y,z values on the LCD
+; x,y,z values on the LCD. The accelerometer and gyroscope can also be
+; streamed with uDMA (TestIMUStream).
 ;
 ; Revision History: 
+;	5/18/24	Adam Krivka		initialize uDMA, added the streaming test
 debounce
 
 
@@ -29,6 +31,8 @@ debounce
     .ref StackInit
     .ref GPTClockInit
     .ref SSIClockInit
+    .ref DMAClockInit
+    .ref UDMAInit
 	.ref MoveVecTable
 
 	.ref InitIMU
@@ -36,6 +40,7 @@ debounce
     .ref InitSSI
     .ref TestIMUAccelGyro
     .ref TestIMUMagnet
+    .ref TestIMUStream
     .ref i16ToString
     .ref Display
 
@@ -74,8 +79,10 @@ main:
     BL      GPIOClockInit				; turn on GPIO clock
     BL      GPTClockInit				; turn on GPT clock
     BL      SSIClockInit				; turn on GPT clock
+    BL      DMAClockInit				; turn on uDMA clock
     BL      StackInit					; initialize stack in SRAM
 	BL		MoveVecTable				; move interrupt vector table
+	BL		UDMAInit					; enable uDMA controller
 
 ; initialize IMU
 	BL		InitSSI					    ; initialize Serial Interface
@@ -88,6 +95,7 @@ main:
 
 ; test IMU
 ;    BL      TestIMUAccelGyro            ; test accelerometer and gyroscope
+;    BL      TestIMUStream               ; test streamed accel and gyro
     BL      TestIMUMagnet               ; test magnetometer
 
 ; infinite loop
@@ -10,8 +10,10 @@
 ; 
 ; This file defines functions:
 ;		SSITransact - sends and receives data over the SPI interface
+;		SSIBurst - sends and receives several frames in one transaction
 ; 
 ; Revision History:
+;	5/16/24	Adam Krivka		added SSIBurst
 
 
 
@@ -27,6 +29,7 @@
 ; export functions to other files
 	.def InitSSI
 	.def SSITransact
+	.def SSIBurst
 
 
 
@@ -120,3 +123,99 @@ SSITransactDone:
 	POP		{LR}						; restore return address
 	BX		LR							; return
 
+
+
+; SSIBurst
+;
+; Description:          Sends and receives several frames over the serial
+;						interface in one transaction (chip select stays
+;						asserted for all of them).  The first frame is passed,
+;						the rest are sent as zeros, and every received frame
+;						is stored.
+;
+; Operation:            Waits for any transfer in progress to finish and
+;						empties the receive FIFO.  All the frames are then
+;						written to the transmit FIFO at once, so the bus never
+;						waits for the CPU and chip select is not released
+;						between frames.  The received frames are read as they
+;						arrive and stored as halfwords.
+;
+; Arguments:            R0 = first frame to send.
+;						R1 = address of the buffer for the received frames
+;						(halfword aligned).
+;						R2 = number of frames (1 to SSI_FIFO_SIZE).
+; Return Values:        R0 = FUNCTION_SUCCESS, or FUNCTION_FAIL if the number
+;						of frames doesn't fit in the FIFO.
+;
+; Local Variables:      R3 = SSI base address, R12 = status register, then
+;						frames left to send.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Error Handling:       Bad frame counts return FUNCTION_FAIL without sending
+;						anything.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          1
+;
+; Revision History:
+;	5/16/24	Adam Krivka		initial revision
+
+SSIBurst:
+	PUSH	{LR}						; save return address
+
+	MOV32	R3, SSI_BASE_ADDR			; prepare SSI base address
+
+	; check the number of frames fits in the FIFO
+	CMP		R2, #0
+	BEQ		SSIBurstFail				; no frames, fail
+	CMP		R2, #SSI_FIFO_SIZE
+	BHI		SSIBurstFail				; too many frames, fail
+	;B		SSIBurstIdle
+
+SSIBurstIdle:
+	LDR		R12, [R3, #SR_OFFSET]		; load status register
+	TST		R12, #SR_BSY_BUSY			; wait for the bus to be idle
+	BNE		SSIBurstIdle
+	TST		R12, #SR_RNE_NOTEMPTY		; check for old received data
+	BEQ		SSIBurstStart				; none, start the burst
+	;B		SSIBurstFlush
+
+SSIBurstFlush:
+	LDR		R12, [R3, #DR_OFFSET]		; throw away old received data
+	B		SSIBurstIdle
+
+SSIBurstStart:
+	STR		R0, [R3, #DR_OFFSET]		; send the first frame
+	MOV		R0, #0						; the rest are zeros
+	SUB		R12, R2, #1					; frames left to send
+	;B		SSIBurstSend
+
+SSIBurstSend:
+	CMP		R12, #0						; check for frames left to send
+	BEQ		SSIBurstReceive				; all sent, receive them
+	STR		R0, [R3, #DR_OFFSET]		; send a zero frame
+	SUB		R12, #1
+	B		SSIBurstSend
+
+SSIBurstReceive:
+	LDR		R12, [R3, #SR_OFFSET]		; load status register
+	TST		R12, #SR_RNE_NOTEMPTY		; wait for a received frame
+	BEQ		SSIBurstReceive
+	LDR		R0, [R3, #DR_OFFSET]		; get it
+	STRH	R0, [R1], #2				; and store it
+	SUBS	R2, #1						; check for more frames
+	BNE		SSIBurstReceive				; more, receive them
+	;B		SSIBurstSuccess
+
+SSIBurstSuccess:
+	MOV		R0, #FUNCTION_SUCCESS		; return success
+	B		SSIBurstDone
+
+SSIBurstFail:
+	MOV		R0, #FUNCTION_FAIL			; return function fail
+	;B		SSIBurstDone
+
+SSIBurstDone:
+	POP		{LR}						; restore return address
+	BX		LR							; return
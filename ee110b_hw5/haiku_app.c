@@ -12,6 +12,8 @@
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       5/14/24 Adam Krivka      key events go through a lock-free ring instead
+                                of allocated queue messages
 */
 
 
@@ -25,7 +27,8 @@
 #include <xdc/runtime/System.h>
 #include <ti/sysbios/knl/Task.h>
 #include  <ti/sysbios/knl/Swi.h>
-#include  <ti/sysbios/runtime/Memory.h>
+#include  <ti/sysbios/knl/Event.h>
+#include  <ti/sysbios/BIOS.h>
 
 /* interface includes */
 #include "lcd/lcd_rtos_intf.h"
@@ -44,23 +47,43 @@ static  Task_Struct  appTask;
 #pragma DATA_ALIGN(appTaskStack, 8)
 static  uint8_t  appTaskStack[APP_TASK_STACK_SIZE];
 
-/* queue object used for app messages */
-static Queue_Handle  appMsgQueue;
+/* event the app task waits on */
+static Event_Struct  appEvent;
+static Event_Handle  appEventHandle;
+
+/* key events from the keypad to the app task - only KeyPressed writes the
+   tail and only the task writes the head, so no lock is needed */
+static volatile uint32_t  keyRing[APP_KEY_RING_SIZE];
+static volatile uint16_t  keyRingHead = 0;
+static volatile uint16_t  keyRingTail = 0;
+
+/* key events lost because the ring was full */
+static uint32_t  keyRingOverruns = 0;
 
 /* 
     KeyPressed(uint32_t keyEvt)
     
-    Description:    This function is called by the keypad interrupt handler
-                    when a key is pressed. It creates an event and enqueues
-                    it to the app message queue.
+    Description:    This function is called by the keypad scan when a key
+                    is pressed. It puts the event at the tail of the key
+                    ring and wakes up the app task. Nothing is allocated and
+                    nothing is locked, the event is written before the tail
+                    is advanced so the task never sees half of it. If the
+                    ring is full the event is dropped and counted.
 */
 void KeyPressed(uint32_t keyEvt) {
-    /* create event struct */
-    event_t *evt = Memory_alloc(NULL, sizeof(event_t), 0, NULL);
-    evt->data = keyEvt;
+    /* variables */
+    uint16_t tail = keyRingTail;        /* where the event goes */
+
+    /* drop it if the ring is full */
+    if ((uint16_t)(tail - keyRingHead) >= APP_KEY_RING_SIZE) {
+        keyRingOverruns++;
+        return;
+    }
 
-    /* enqueue to the app message queue */
-    Queue_enqueue(appMsgQueue, &(evt->elem));
+    /* add it, then let the task see it */
+    keyRing[tail % APP_KEY_RING_SIZE] = keyEvt;
+    keyRingTail = tail + 1;
+    Event_post(appEventHandle, APP_KEY_EVENT_ID);
 
     return;
 }
@@ -91,15 +114,13 @@ void App_createTask(void) {
 /*
     App_init()
     
-    Description:    This function initializes the app. It creates the app
-                    message queue.
+    Description:    This function initializes the app. It creates the event
+                    the app task waits on for key events.
 */
 void App_init(void) {
-    /* create the app event queue */
-    appMsgQueue = Queue_create(NULL, NULL);
-    if (appMsgQueue == NULL) {
-        System_abort("Queue create failed!");
-    }
+    /* create the app event */
+    Event_construct(&appEvent, NULL);
+    appEventHandle = Event_handle(&appEvent);
 
     return;
 }
@@ -107,12 +128,14 @@ void App_init(void) {
 /*
     App_run()
     
-    Description:    This function is the main loop of the app. It processes
-                    events from the app message queue.
+    Description:    This function is the main loop of the app. It waits for
+                    key events and processes all of them from the key ring
+                    each time it wakes up.
 */
 static void App_run(UArg a0, UArg a1) {
     /* variables */
-    event_t* evt;
+    uint16_t head;                      /* next key event to read */
+    uint32_t keyEvt;                    /* the key event */
 
     /* initialize the app */
     App_init();
@@ -123,32 +146,35 @@ static void App_run(UArg a0, UArg a1) {
 
     /* main loop */
     while (true) {
+        /* wait for key events */
+        Event_pend(appEventHandle, Event_Id_NONE, APP_KEY_EVENT_ID,
+                   BIOS_WAIT_FOREVER);
+
         /* process events while there are any */
-        while (!Queue_empty(appMsgQueue)) {
-            /* dequeue the event */
-            evt = Queue_dequeue(appMsgQueue);
+        head = keyRingHead;
+        while (head != keyRingTail) {
+            /* copy the event out and free its slot */
+            keyEvt = keyRing[head % APP_KEY_RING_SIZE];
+            keyRingHead = ++head;
 
             /* process the event */
-            App_processEvent(evt);
-
-            /* free because we shouldn't need event struct anymore */
-            Memory_free(NULL, evt, sizeof(event_t));
+            App_processEvent(keyEvt);
         }
     }
 }
 
 
 /*
-    App_processEvent(event_t* evt)
+    App_processEvent(uint32_t keyEvt)
     
-    Description:    This function processes an event from the app message
-                    queue. It displays the haiku on the LCD based on the
-                    keypad input.
+    Description:    This function processes a key event from the key ring.
+                    It displays the haiku on the LCD based on the keypad
+                    input.
 */
-void App_processEvent(event_t* evt) {
+void App_processEvent(uint32_t keyEvt) {
     /* variables */
-    uint8_t col = evt->data & 0b11111111;
-    uint8_t row = evt->data >> 8;
+    uint8_t col = keyEvt & 0b11111111;
+    uint8_t row = keyEvt >> 8;
     haiku_t haiku;
     line_t line;
 
@@ -8,11 +8,12 @@
 /* Haiku Application Header. Functions declared are:
         App_init() - initialize the application
         App_run() - main application task
-        App_processEvent() - process events from the event queue
+        App_processEvent() - process a key event from the key ring
         haiku1, haiku2, haiku3, haiku4 - haiku data to display
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       5/14/24 Adam Krivka      key events go through a ring instead of a queue
 */
 
 #ifndef  __HAIKU_APP_H__
@@ -24,13 +25,10 @@
 #define APP_TASK_PRIORITY          	2
 #define APP_TASK_STACK_SIZE 		1024
 
-/* structs */
+#define APP_KEY_RING_SIZE           16              // key events that can wait (power of 2)
+#define APP_KEY_EVENT_ID            Event_Id_00     // event posted for new key events
 
-/* event struct */
-typedef struct event {
-    Queue_Elem elem;
-    uint32_t data;
-} event_t;
+/* structs */
 
 /* line part struct */
 typedef struct part {
@@ -53,7 +51,7 @@ typedef struct haiku {
 /* internal function declarations */
 void App_init(void);
 static void App_run(UArg a0, UArg a1);
-void App_processEvent(event_t* evt);
+void App_processEvent(uint32_t keyEvt);
 
 
 /* haiku data */
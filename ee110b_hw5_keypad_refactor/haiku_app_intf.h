@@ -6,11 +6,12 @@
 /****************************************************************************/
 
 /* Haiku Application Interface. Functions declared are:
-        KeyPressed() - enqueue events to application event queue
+        KeyPressed() - put key events in the application key ring
         App_createTask() - create main app task
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       5/14/24 Adam Krivka      key events go through a ring
 */
 
 #ifndef  __HAIKU_APP_INTF_H__
@@ -20,8 +21,8 @@
 #include <stdint.h>
 
 
-void KeyPressed(uint32_t _evt); /* enqueue events to application event queue */
+void KeyPressed(uint32_t _evt); /* put key events in the application key ring */
 
 void App_createTask(); /* create main app task */
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
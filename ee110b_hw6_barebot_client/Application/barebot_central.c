@@ -11,24 +11,73 @@
  central device for the Barebot demo.  The global functions included
  are:
  BarebotCentral_createTask  - create the barebot central task
+ BarebotCentral_getPoolStats - get the message pool statistics
+ BarebotCentral_getConnStats - get the connection parameter statistics
+ BarebotCentral_getScanStats - get the advertising report statistics
+ BarebotCentral_noteActivity - note user activity (keeps the link fast)
  BarebotCentral_getState    - get the current state of the central
- BarebotCentral_read        - read a characteristic
+ BarebotCentral_getMissedStates - get the missed robot state notifications
+ BarebotCentral_getWriteErrors - get the writes the server refused
+ BarebotCentral_read        - read a characteristic (blocking)
+ BarebotCentral_readAsync   - start reading a characteristic
+ BarebotCentral_sendCommand - send a speed or turn update command
+ BarebotCentral_setStreaming - turn streaming of update commands on/off
  BarebotCentral_write       - write a characteristic
 
  The local functions included are:
+ BarebotCentral_allowAddress      - add an address to the scan allow list
+ BarebotCentral_blockingReadCb    - completion callback for blocking reads
+ BarebotCentral_cacheEntry        - find the cache entry for a characteristic
+ BarebotCentral_cacheInvalidate   - forget all the cached values
+ BarebotCentral_cacheRead         - get a fresh value from the cache
+ BarebotCentral_cacheUpdate       - store a value in the cache
+ BarebotCentral_checkDbHash       - check the saved handles against the hash
+ BarebotCentral_connClockCb       - connection policy clock callback
+ BarebotCentral_connPolicy        - pick the connection parameters to use
+ BarebotCentral_connUpdateFailed  - handle a failed parameter update
+ BarebotCentral_completeRead      - finish a read and call its callback
  BarebotCentral_enqueueMsg        - enqueue a message for the task
+ BarebotCentral_expireReads       - time out (or fail) outstanding reads
+ BarebotCentral_filterAdvReport   - decide whether to forward an adv report
+ BarebotCentral_nameHash          - hash a device name
  BarebotCentral_init              - initialize barebot central task
  BarebotCentral_processAppMsg     - process messages from the task
  BarebotCentral_processGapMessage - process GAP messages
  BarebotCentral_processStackMsg   - process BLE stack messages
+ BarebotCentral_readClockCb       - read timeout clock callback
+ BarebotCentral_requestConnParams - request connection parameters
+ BarebotCentral_saveHandles       - save the discovered handles in SNV
+ BarebotCentral_sendNextRead      - send the next queued read
+ BarebotCentral_setMoving         - note whether the robot is moving
  BarebotCentral_spin              - infinite loop (for debugging)
  BarebotCentral_taskFxn           - run the barebot central task
  BarebotCentral_setState          - set the state of the central
+ BarebotCentral_startDiscovery    - discover the characteristic handles
+ BarebotCentral_startHandleCheck  - start checking for saved handles
  BarebotCentral_startScanning     - start scanning for devices
 
 
  Revision History:
  3/10/22  Glen George      initial revision
+ 4/4/24   Adam Krivka      queued messages come from a fixed-size pool
+ 4/8/24   Adam Krivka      use the robot state notifications
+ 4/10/24  Adam Krivka      added streamed update commands
+ 4/12/24  Adam Krivka      asynchronous pipelined reads
+ 4/14/24  Adam Krivka      cache of characteristic values
+ 4/16/24  Adam Krivka      discovered handles are saved in SNV
+ 4/18/24  Adam Krivka      advertising reports are filtered in the callback
+ 4/20/24  Adam Krivka      adaptive connection parameters
+ 5/18/24  Adam Krivka      missed state notifications restart counting on
+                           each connection
+ 5/18/24  Adam Krivka      device name parsing steps over each AD item
+                           correctly and returns FALSE if there is no name
+ 5/18/24  Adam Krivka      unused arguments marked, cache fully initialized
+ 5/18/24  Adam Krivka      read callback argument is pointer sized (so a
+                           host build can pass a pointer in it)
+ 5/18/24  Adam Krivka      advertising reports still queued when the scan
+                           stops don't start another connection
+ 5/18/24  Adam Krivka      a refused write is counted and its cached value
+                           dropped, the link stays up
  */
 
 /* RTOS include files */
@@ -36,6 +85,7 @@
 #include  <ti/sysbios/knl/Clock.h>
 #include  <ti/sysbios/knl/Event.h>
 #include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/hal/Hwi.h>
 #include  <xdc/runtime/System.h>
 
 /* BLE include files */
@@ -46,6 +96,7 @@
 #include  <devinfoservice.h>
 #include  "ti_ble_config.h"
 #include  "osal.h"
+#include  "osal_snv.h"
 
 /* C library include files */
 #include  <string.h>
@@ -55,6 +106,7 @@
 #include "barebot_ui_intf.h"
 #include "barebot_server_constants.h"
 #include "barebot_synch.h"
+#include "lib/msg_pool.h"
 
 /* shared variables */
 
@@ -81,9 +133,65 @@ static Queue_Handle appMsgQueueHandle;
 static Event_Struct readEvent;
 static Event_Handle readEventHandle;
 
-/* read response buffers */
-static uint16 readLen;
-static uint8 readValue[BC_MAX_READ_VALUE_LENGTH];
+/* outstanding asynchronous reads - a ring of entries in request order, */
+/*    only the oldest one is ever sent to the server */
+static bcReadEntry_t readTable[BC_MAX_READS];
+static uint8_t readHead;
+static uint8_t readCount;
+
+/* whether a read request is on the air (its response may still arrive */
+/*    after the read timed out) and the last request ID handed out */
+static bool readOnAir;
+static uint8_t lastReadID;
+
+/* clock for checking the read timeouts */
+static Clock_Struct readClock;
+
+/* cache of the readable characteristic values - kept up to date by */
+/*    notifications, read responses, and write responses */
+static bcCacheEntry_t valueCache[BC_CACHE_SIZE] = {
+    { BAREBOTPROFILE_SPEED,     BC_CACHE_NOTIFIED_AGE_MS,  FALSE, 0, 0, { 0 } },
+    { BAREBOTPROFILE_TURN,      BC_CACHE_NOTIFIED_AGE_MS,  FALSE, 0, 0, { 0 } },
+    { BAREBOTPROFILE_STATE,     BC_CACHE_NOTIFIED_AGE_MS,  FALSE, 0, 0, { 0 } },
+    { BAREBOTPROFILE_THOUGHTS,  BC_CACHE_READ_AGE_MS,      FALSE, 0, 0, { 0 } }
+};
+
+/* handles for the current peer (saved in SNV once discovered), whether */
+/*    its database hash is being read, whether the hash in the record is */
+/*    valid (and not saved yet), the record slot to save it in, and the */
+/*    slot to replace next when saving a new peer */
+static bcHandleRecord_t handleRecord;
+static bool readingDbHash;
+static bool dbHashValid;
+static uint8_t handleSlot;
+static uint8_t nextHandleRecord;
+
+/* advertising report pre-filter - addresses that are always forwarded */
+/*    (known servers), hash of the server name, and statistics */
+static uint8_t allowList[BC_SCAN_ALLOW_LIST_SIZE][B_ADDR_LEN];
+static uint8_t numAllowed;
+static uint32_t serverNameHash;
+static bcScanStats_t scanStats;
+
+/* connection parameter policy - mode last requested, mode the link is */
+/*    in, whether an update is in progress, failed attempts at the */
+/*    requested mode and when to try again, when the user was last */
+/*    active, whether the robot is moving, the policy clock, and statistics */
+static uint8_t connModeWanted;
+static uint8_t connModeActual;
+static bool connUpdatePending;
+static uint8_t connRetries;
+static uint32_t connRetryTick;
+static uint32_t lastActivityTick;
+static bool robotMoving;
+static Clock_Struct connClock;
+static bcConnStats_t connStats;
+
+/* characteristic with a write request outstanding (its new value is */
+/*    already in the cache, but not valid until the server accepts it), */
+/*    and the number of writes the server refused */
+static uint8_t pendingWriteChar = BC_CACHE_NONE;
+static uint32_t writeErrors;
 
 /* error response buffer */
 static attErrorRsp_t errorRsp;
@@ -96,10 +204,41 @@ static uint16_t turnCharHandle;
 static uint16_t speedUpdateCharHandle;
 static uint16_t turnUpdateCharHandle;
 static uint16_t thoughtsCharHandle;
+static uint16_t stateCharHandle;
+
+/* sequence number of the last robot state notification, whether there has */
+/*    been one on this connection, and the number of state notifications */
+/*    that were missed */
+static uint8_t lastStateSeq;
+static bool stateSeqValid;
+static uint32_t missedStates;
+
+/* update commands - whether they are streamed (write without response), */
+/*    the sequence number for the next one, and the number that could not */
+/*    be sent */
+static bool streamCommands;
+static uint8_t cmdSeq;
+static uint32_t cmdsNotSent;
 
 /* state of the central */
 static uint8 centralState;
 
+#if BC_USE_MSG_POOL
+/* pool for the queued messages */
+MSG_POOL_STORAGE(evtPoolStorage, sizeof(bpEvt_t), BC_EVT_POOL_SIZE);
+static MsgPool_t evtPool;
+
+/* message memory comes from the pool */
+#define  BC_EVT_ALLOC()       MsgPool_alloc(&evtPool)
+#define  BC_EVT_FREE(p)       MsgPool_free(&evtPool, (p))
+#define  BC_EVT_DEQUEUE(q)    MsgPool_dequeue(q)
+#else
+/* message memory comes from the ICall heap */
+#define  BC_EVT_ALLOC()       ICall_malloc(sizeof(bpEvt_t))
+#define  BC_EVT_FREE(p)       ICall_free(p)
+#define  BC_EVT_DEQUEUE(q)    Util_dequeueMsg(q)
+#endif
+
 /* functions */
 
 /*
@@ -183,9 +322,26 @@ static void BarebotCentral_init(void)
     /* create an RTOS queue for message from profile to be sent to app */
     appMsgQueueHandle = Util_constructQueue(&appMsgQueue);
 
+#if BC_USE_MSG_POOL
+    /* set up the message pool */
+    MsgPool_init(&evtPool, evtPoolStorage, sizeof(bpEvt_t), BC_EVT_POOL_SIZE);
+#endif
+
     /* initialize read event struct */
     readEventHandle = Event_construct(&readEvent, NULL);
 
+    /* hash of the server name for the advertising report pre-filter */
+    serverNameHash = BarebotCentral_nameHash(
+            (uint8_t*) BAREBOT_SERVER_LOCAL_NAME, BC_SERVER_NAME_LEN);
+
+    /* clock for the read timeouts, only runs while there are reads */
+    Util_constructClock(&readClock, BarebotCentral_readClockCb,
+                        BC_READ_TICK_MS, BC_READ_TICK_MS, FALSE, 0);
+
+    /* clock for the connection parameter policy, runs while connected */
+    Util_constructClock(&connClock, BarebotCentral_connClockCb,
+                        BC_CONN_TICK_MS, BC_CONN_TICK_MS, FALSE, 0);
+
     /* set the Device Name characteristic in the GAP GATT Service */
     GGS_SetParameter(GGS_DEVICE_NAME_ATT, GAP_DEVICE_NAME_LEN, attDeviceName);
 
@@ -259,6 +415,10 @@ static void BarebotCentral_taskFxn(UArg a0, UArg a1)
 
     uint8_t safeToDealloc = TRUE; /* whether or not to deallocate message */
 
+    /* the task arguments are not used */
+    (void) a0;
+    (void) a1;
+
     /* wait for UI to initialize */
     Event_pend(uiInitDoneHandle, Event_Id_NONE, INIT_ALL_EVENTS,
     ICALL_TIMEOUT_FOREVER);
@@ -338,7 +498,7 @@ static void BarebotCentral_taskFxn(UArg a0, UArg a1)
                 {
 
                     /* dequeue the message */
-                    pEvtMsg = (bpEvt_t*) Util_dequeueMsg(appMsgQueueHandle);
+                    pEvtMsg = (bpEvt_t*) BC_EVT_DEQUEUE(appMsgQueueHandle);
 
                     /* check if got a message */
                     if (pEvtMsg != NULL)
@@ -347,7 +507,7 @@ static void BarebotCentral_taskFxn(UArg a0, UArg a1)
                         /* got a message so process the message */
                         BarebotCentral_processAppMsg(pEvtMsg);
                         /* now can free the memory allocated to the message */
-                        ICall_free(pEvtMsg);
+                        BC_EVT_FREE(pEvtMsg);
                     }
                 }
             }
@@ -372,7 +532,9 @@ static void BarebotCentral_taskFxn(UArg a0, UArg a1)
  Link established events cause the connection handle to be
  stored and advertising to stop.  Link termination events
  forget the saved connection handle and start advertising
- again.  Unknown opcodes/event types are ignored.
+ again.  Link parameter update events record the
+ parameters the link is now using for the connection
+ parameter policy.  Unknown opcodes/event types are ignored.
 
  Arguments:        pMsg (gapEventHdr_t *) - pointer to the GAP event message
  to process.
@@ -382,20 +544,27 @@ static void BarebotCentral_taskFxn(UArg a0, UArg a1)
  Inputs:           None.
  Outputs:          None.
 
- Error Handling:   Unknown event opcodes are silently ignored.  In the debug
- version if a BLE function fails the system goes into an
- infinite loop.
+ Error Handling:   Unknown event opcodes are silently ignored.  A refused
+ write or read only fails that access, other error
+ responses put the central in the error state.  In the
+ debug version if a BLE function fails the system goes
+ into an infinite loop.
 
  Algorithms:       None.
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   4/20/24   Adam Krivka      link parameter update events
+                   5/18/24   Adam Krivka      reset the state sequence
  */
 static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
 {
     /* variables */
     uint8_t temp8; /* 8-bit buffer to hold configuration values */
     uint16_t temp16; /* 16-bit buffer to hold configuration values */
+#if BC_USE_HANDLE_CACHE
+    bcHandleRecord_t saved; /* a saved handle record */
+#endif
 
     /* process the message based on the opcode that generated it */
     switch (pMsg->opcode)
@@ -407,7 +576,7 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
             break;
 
         /* register callback to process Scanner events */
-        GapScan_registerCb(BarebotCentral_scanCb, NULL);
+        GapScan_registerCb(BarebotCentral_scanCb, 0);
 
         /* we only need advertising reports */
         GapScan_setEventMask(
@@ -442,6 +611,14 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
 
         /* ===at this point all scanning and initiating parameters are set up == */
 
+#if BC_USE_HANDLE_CACHE
+        /* servers with saved handles are known, always forward them */
+        for (temp8 = 0; temp8 < BC_NUM_HANDLE_RECORDS; temp8++)
+            if (osal_snv_read(BC_HANDLE_NVID_START + temp8,
+                              sizeof(bcHandleRecord_t), &saved) == SUCCESS)
+                BarebotCentral_allowAddress(saved.peerAddr);
+#endif
+
         BarebotCentral_startScanning();
 
         break;
@@ -457,27 +634,60 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
             /* stop scanning */
             GapScan_disable();
 
-            /* discover barebot profile service */
-            //GATT_DiscPrimaryServiceByUUID(curr_conn_handle,
-            //                              &barebotProfileServUUID, 2,
-            //                              selfEntity);
-            //Display(0, 0, "Disc service", 16);
-            /* service discovery doesn't work well, hardcode start and end handles for now */
-            barebotProfileServiceStartHandle = 0x020;
-            barebotProfileServiceEndHandle = 0xFFFF;
-
-            /* discover all characteristics */
-            GATT_DiscAllChars(curr_conn_handle,
-                              barebotProfileServiceStartHandle,
-                              barebotProfileServiceEndHandle, centralEntity);
-
-            /* set state to discovering characteristics */
-            BarebotCentral_setState(BC_STATE_DISC_CHARS);
+            /* this is a known server from now on */
+            BarebotCentral_allowAddress(((gapEstLinkReqEvent_t*) pMsg)->devAddr);
+
+            /* start the connection parameter policy, the link starts out */
+            /*    with the default parameters and the user active */
+            connModeWanted = BC_CONN_MODE_NONE;
+            connModeActual = BC_CONN_MODE_NONE;
+            connUpdatePending = FALSE;
+            connRetries = 0;
+            robotMoving = FALSE;
+            lastActivityTick = Clock_getTicks();
+            connStats.interval = ((gapEstLinkReqEvent_t*) pMsg)->connInterval;
+            connStats.latency = ((gapEstLinkReqEvent_t*) pMsg)->connLatency;
+            Util_startClock(&connClock);
+
+            /* the server's state sequence is unknown until its first */
+            /*    notification on this connection */
+            stateSeqValid = FALSE;
+            missedStates = 0;
+
+            /* use the saved handles for this peer if they are still */
+            /*    valid, otherwise discover them */
+            BarebotCentral_startHandleCheck(
+                    ((gapEstLinkReqEvent_t*) pMsg)->devAddr);
 
             break;
         }
         break;
 
+    case GAP_LINK_PARAM_UPDATE_EVENT:
+        /* connection parameters changed (or an update failed) */
+        if (((gapLinkUpdateEvent_t*) pMsg)->connectionHandle
+                == curr_conn_handle)
+        {
+            connUpdatePending = FALSE;
+            if (((gapLinkUpdateEvent_t*) pMsg)->status == SUCCESS)
+            {
+                /* remember what the link is using now */
+                connStats.accepted++;
+                connStats.interval =
+                        ((gapLinkUpdateEvent_t*) pMsg)->connInterval;
+                connStats.latency = ((gapLinkUpdateEvent_t*) pMsg)->connLatency;
+                connModeActual = (connStats.interval <= BC_ACTIVE_INT_MAX) ?
+                        BC_CONN_MODE_ACTIVE : BC_CONN_MODE_IDLE;
+                connRetries = 0;
+            }
+            else
+            {
+                /* try again later */
+                BarebotCentral_connUpdateFailed();
+            }
+        }
+        break;
+
     case GAP_LINK_TERMINATED_EVENT:
         /* link was terminated, be sure it was this link */
         if (curr_conn_handle
@@ -487,6 +697,19 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
             /* indicate there is no connected handle */
             curr_conn_handle = LINKDB_CONNHANDLE_INVALID;
 
+            /* no responses are coming for the outstanding reads */
+            BarebotCentral_expireReads(TRUE);
+
+            /* the cached values may be out of date by the next connection */
+            BarebotCentral_cacheInvalidate();
+            pendingWriteChar = BC_CACHE_NONE;
+
+            /* no database hash is coming either */
+            readingDbHash = FALSE;
+
+            /* no connection parameters to manage */
+            Util_stopClock(&connClock);
+
             /* start scanning again */
             BarebotCentral_startScanning();
         }
@@ -511,7 +734,9 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
 
  Operation:        The function processes the messages based on the type of
  event that generated the message.  Unknown event types are
- ignored.
+ ignored.  An advertising report only starts a connection
+ while scanning, reports queued before the scan stopped are
+ dropped.
 
  Arguments:        pMsg (bpEvt_t *) - pointer to the task message to process.
  Return Value:     None.
@@ -526,11 +751,12 @@ static void BarebotCentral_processGapMessage(gapEventHdr_t *pMsg)
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   5/18/24   Adam Krivka      connect only while scanning
  */
 static void BarebotCentral_processAppMsg(bpEvt_t *pMsg)
 {
     /* variables */
-    bool dealloc; /* whether should deallocate message data */
+    bool dealloc = TRUE; /* whether should deallocate message data */
     GapScan_Evt_AdvRpt_t *pAdvRpt; /* event advertising report data */
     char deviceName[DEVICE_NAME_MAX_LENGTH];
 
@@ -545,8 +771,11 @@ static void BarebotCentral_processAppMsg(bpEvt_t *pMsg)
         BarebotCentral_findDeviceName((uint8_t*) pAdvRpt->pData,
                                       pAdvRpt->dataLen, (char*) deviceName, 16);
 
-        /* check if name matches the server board */
-        if (osal_memcmp(deviceName, BAREBOT_SERVER_LOCAL_NAME, 2))
+        /* check if name matches the server board, and the central is */
+        /*    still looking for it (not already connecting or connected) */
+        if ((centralState == BC_STATE_SCANNING)
+                && osal_memcmp(deviceName, BAREBOT_SERVER_LOCAL_NAME,
+                               BC_SERVER_NAME_LEN))
         {
             /* connect to it */
             GapInit_connect(pAdvRpt->addrType, pAdvRpt->addr, DEFAULT_INIT_PHY,
@@ -568,6 +797,22 @@ static void BarebotCentral_processAppMsg(bpEvt_t *pMsg)
     case BC_EVT_SCAN_PRD_ENDED:
         BarebotCentral_setState(BC_STATE_SCANNING);
         break;
+    case BC_EVT_READ_REQ:
+        /* a read was added to the table, send it if the link is idle */
+        BarebotCentral_sendNextRead();
+        dealloc = FALSE;
+        break;
+    case BC_EVT_READ_TICK:
+        /* time out old reads (the next one is sent if any expired) */
+        BarebotCentral_expireReads(FALSE);
+        dealloc = FALSE;
+        break;
+    case BC_EVT_CONN_TICK:
+    case BC_EVT_CONN_ACTIVITY:
+        /* check whether the connection parameters should change */
+        BarebotCentral_connPolicy();
+        dealloc = FALSE;
+        break;
         /* case BC_EVT_SVC_DISCOVERED:
          GATT_DiscAllChars(curr_conn_handle, barebotProfileServiceStartHandle,
          barebotProfileServiceEndHandle, centralEntity);
@@ -590,9 +835,15 @@ static void BarebotCentral_processAppMsg(bpEvt_t *pMsg)
 /*
  BarebotCentral_processGattMessage(gattMsgEvent_t *)
 
- Description:
+ Description:      This function processes the GATT messages (ATT responses
+ and notifications) received by this task from the BLE
+ stack.
 
- Operation:
+ Operation:        Read responses are copied for the waiting reader,
+ notifications update the UI (robot state notifications
+ carry speed and turn together), and read by type responses
+ fill in the characteristic handles.  The ATT payload is
+ freed when done.
 
  Arguments:        pMsg (gattMsgEvent_t *) - pointer to the GATT event message
  to process.
@@ -609,12 +860,26 @@ static void BarebotCentral_processAppMsg(bpEvt_t *pMsg)
  Algorithms:       None.
  Data Structures:  None.
 
- Revision History:
+ Revision History: 3/15/24  Adam Krivka      initial revision
+                   4/8/24   Adam Krivka      robot state notifications, free
+                                             the ATT payload
+                   4/12/24  Adam Krivka      complete asynchronous reads and
+                                             send the next one
+                   4/14/24  Adam Krivka      keep the value cache up to date
+                   4/16/24  Adam Krivka      database hash for the saved
+                                             handles, save discovered handles
+                   5/18/24  Adam Krivka      first state notification on a
+                                             connection only syncs the sequence
+                   5/18/24  Adam Krivka      a refused write is counted and
+                                             the link stays up
  */
 static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
 {
     /* variables */
     bpAttReadByTypeHandlePair_t *handle_pair;
+    bpRobotState_t state; /* robot state from a notification */
+    bcCacheEntry_t *pEntry; /* cache entry of a refused write */
+    UInt key; /* interrupt state to restore */
 
     /* check status*/
     if (pMsg->hdr.status != SUCCESS)
@@ -627,20 +892,79 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
     case ATT_ERROR_RSP:
         /* error received */
         errorRsp = pMsg->msg.errorRsp;
-        BarebotCentral_setState(BC_STATE_ERROR);
+        if (errorRsp.reqOpcode == ATT_WRITE_REQ)
+        {
+            /* a write failed, only that write is affected - the value */
+            /*    written never became valid, so drop it from the cache */
+            pEntry = BarebotCentral_cacheEntry(pendingWriteChar);
+            if (pEntry != NULL)
+            {
+                key = Hwi_disable();
+                pEntry->valid = FALSE;
+                pEntry->len = 0;
+                Hwi_restore(key);
+            }
+            pendingWriteChar = BC_CACHE_NONE;
+            writeErrors++;
+        }
+        else if ((errorRsp.reqOpcode == ATT_READ_BY_TYPE_REQ) && readingDbHash)
+        {
+            /* the server has no database hash, handles can't be saved */
+            readingDbHash = FALSE;
+            BarebotCentral_startDiscovery();
+        }
+        else if ((errorRsp.reqOpcode == ATT_READ_REQ) && readOnAir)
+        {
+            /* a read failed, only that read is affected */
+            readOnAir = FALSE;
+            if (readTable[readHead].state == BC_READ_SENT)
+                BarebotCentral_completeRead(&readTable[readHead], FAILURE,
+                                            NULL, 0);
+        }
+        else
+        {
+            BarebotCentral_setState(BC_STATE_ERROR);
+        }
         break;
     case ATT_READ_RSP:
-        /* read response received */
-        /* copy its contents to shared variable */
-        readLen = pMsg->msg.readRsp.len;
-        osal_memcpy(readValue, pMsg->msg.readRsp.pValue, readLen);
-        /* unblock function that initiated read operation */
-        Event_post(readEventHandle, BC_ALL_EVENTS);
+        /* read response received - it is for the oldest read unless that */
+        /*    one already timed out */
+        if (readOnAir)
+        {
+            readOnAir = FALSE;
+            if (readTable[readHead].state == BC_READ_SENT)
+            {
+                BarebotCentral_cacheUpdate(readTable[readHead].charID,
+                                           pMsg->msg.readRsp.pValue,
+                                           pMsg->msg.readRsp.len);
+                BarebotCentral_completeRead(&readTable[readHead], SUCCESS,
+                                            pMsg->msg.readRsp.pValue,
+                                            pMsg->msg.readRsp.len);
+            }
+        }
+        break;
+    case ATT_WRITE_RSP:
+        /* the server accepted the write, the value written is now valid */
+        if (pendingWriteChar != BC_CACHE_NONE)
+        {
+            BarebotCentral_cacheUpdate(pendingWriteChar, NULL, 0);
+            pendingWriteChar = BC_CACHE_NONE;
+        }
         break;
     case ATT_HANDLE_VALUE_NOTI:
         /* notification received */
         if (pMsg->msg.handleValueNoti.handle == speedCharHandle)
         {
+            /* keep the cache up to date */
+            BarebotCentral_cacheUpdate(BAREBOTPROFILE_SPEED,
+                                       pMsg->msg.handleValueNoti.pValue,
+                                       pMsg->msg.handleValueNoti.len);
+
+            /* the robot keeps the link fast while it is moving */
+            BarebotCentral_setMoving(
+                    (int16) BUILD_UINT16(pMsg->msg.handleValueNoti.pValue[0],
+                                         pMsg->msg.handleValueNoti.pValue[1]));
+
             /* update speed value in UI */
             BarebotUI_speedChanged(
                     (int16) BUILD_UINT16(pMsg->msg.handleValueNoti.pValue[0],
@@ -649,20 +973,75 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
         }
         else if (pMsg->msg.handleValueNoti.handle == turnCharHandle)
         {
+            /* keep the cache up to date */
+            BarebotCentral_cacheUpdate(BAREBOTPROFILE_TURN,
+                                       pMsg->msg.handleValueNoti.pValue,
+                                       pMsg->msg.handleValueNoti.len);
+
             /* update turn value in UI */
             BarebotUI_turnChanged(
                     (int16) BUILD_UINT16(pMsg->msg.handleValueNoti.pValue[0],
                                          pMsg->msg.handleValueNoti.pValue[1]));
 
         }
+        else if ((pMsg->msg.handleValueNoti.handle == stateCharHandle)
+                && (pMsg->msg.handleValueNoti.len == BAREBOTPROFILE_STATE_LEN))
+        {
+            /* robot state snapshot, speed and turn arrive together */
+            memcpy(&state, pMsg->msg.handleValueNoti.pValue,
+                   BAREBOTPROFILE_STATE_LEN);
+
+            /* count notifications that were lost on the way (the first */
+            /*    one on a connection just syncs to the server's sequence) */
+            if (stateSeqValid)
+                missedStates += (uint8_t) (state.seq - lastStateSeq - 1);
+            lastStateSeq = state.seq;
+            stateSeqValid = TRUE;
+
+            /* the snapshot always has the current speed and turn */
+            BarebotCentral_cacheUpdate(BAREBOTPROFILE_STATE,
+                                       pMsg->msg.handleValueNoti.pValue,
+                                       BAREBOTPROFILE_STATE_LEN);
+            BarebotCentral_cacheUpdate(BAREBOTPROFILE_SPEED,
+                                       (uint8*) &state.speed,
+                                       BAREBOTPROFILE_SPEED_LEN);
+            BarebotCentral_cacheUpdate(BAREBOTPROFILE_TURN,
+                                       (uint8*) &state.turn,
+                                       BAREBOTPROFILE_TURN_LEN);
+
+            /* the robot keeps the link fast while it is moving */
+            BarebotCentral_setMoving(state.speed);
+
+            /* update the values that changed in the UI */
+            if (state.flags & BP_STATE_SPEED_CHANGED)
+                BarebotUI_speedChanged(state.speed);
+            if (state.flags & BP_STATE_TURN_CHANGED)
+                BarebotUI_turnChanged(state.turn);
+        }
         break;
     case ATT_READ_BY_TYPE_RSP:
+        /* the database hash comes back as a read by type response too */
+        if (readingDbHash)
+        {
+            readingDbHash = FALSE;
+            if ((pMsg->hdr.status == SUCCESS)
+                    && (pMsg->msg.readByTypeRsp.numPairs != 0)
+                    && (pMsg->msg.readByTypeRsp.len
+                            == (2 + BC_DB_HASH_LEN)))
+                /* skip the handle in front of the hash */
+                BarebotCentral_checkDbHash(
+                        &pMsg->msg.readByTypeRsp.pDataList[2]);
+            else
+                BarebotCentral_startDiscovery();
+            break;
+        }
+
         /* if we've already discovered all characteristics, ignore these responses */
         if (speedCharHandle != 0 && turnCharHandle != 0
                 && speedUpdateCharHandle != 0 && turnUpdateCharHandle != 0
-                && thoughtsCharHandle != 0)
+                && thoughtsCharHandle != 0 && stateCharHandle != 0)
         {
-            return;
+            break;
         }
 
         /* loop over the response and find UUID<>handle pairs */
@@ -688,14 +1067,18 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
             case BAREBOTPROFILE_THOUGHTS_UUID:
                 thoughtsCharHandle = handle_pair->handle;
                 break;
+            case BAREBOTPROFILE_STATE_UUID:
+                stateCharHandle = handle_pair->handle;
+                break;
             }
         }
 
-        /* if all handles discovered, display ready */
+        /* if all handles discovered, save them and display ready */
         if (speedCharHandle != 0 && turnCharHandle != 0
                 && speedUpdateCharHandle != 0 && turnUpdateCharHandle != 0
-                && thoughtsCharHandle != 0)
+                && thoughtsCharHandle != 0 && stateCharHandle != 0)
         {
+            BarebotCentral_saveHandles();
             BarebotCentral_setState(BC_STATE_READY);
         }
         break;
@@ -716,6 +1099,13 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
     default:
         break;
     }
+
+    /* free the ATT payload (read values, notification values, ...) */
+    GATT_bm_free(&pMsg->msg, pMsg->method);
+
+    /* the link may be free for a read now, send the next one right away */
+    BarebotCentral_sendNextRead();
+
     return;
 }
 
@@ -724,11 +1114,18 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
 /*
  BarebotCentral_scanCb(uint32_t event, void *pBuf, uintptr_t arg)
 
- Description:
+ Description:      This function is the callback for scanner events.  It is
+ called from the BLE stack task.
 
- Operation:
+ Operation:        Advertising reports are run through the pre-filter first
+ and reports that can't be from the server are freed right
+ away, before any message is allocated.  The remaining
+ events are forwarded to the central task.
 
- Arguments:
+ Arguments:        evt (uint32_t)  - scanner event.
+ pMsg (void *)   - event data (an advertising report for
+ GAP_EVT_ADV_REPORT).
+ arg (uintptr_t) - callback argument (unused).
  Return Value:     None.
  Exceptions:       None.
 
@@ -742,17 +1139,30 @@ static void BarebotCentral_processGattMessage(gattMsgEvent_t *pMsg)
  Algorithms:       None.
  Data Structures:  None.
 
- Revision History:
+ Revision History: 3/15/24  Adam Krivka      initial revision
+                   4/18/24  Adam Krivka      pre-filter advertising reports
  */
 static void BarebotCentral_scanCb(uint32_t evt, void *pMsg, uintptr_t arg)
 {
     /* variables */
     uint8_t event;
 
+    /* the callback argument is not used */
+    (void) arg;
+
     /* this function is called from the BLE stack task, so
      * we should forward these events to the central task */
     if (evt & GAP_EVT_ADV_REPORT)
     {
+        /* drop reports that can't be from the server right here */
+        scanStats.reportsSeen++;
+        if (!BarebotCentral_filterAdvReport((GapScan_Evt_AdvRpt_t*) pMsg))
+        {
+            ICall_free(((GapScan_Evt_AdvRpt_t*) pMsg)->pData);
+            ICall_free(pMsg);
+            return;
+        }
+        scanStats.reportsForwarded++;
         event = BC_EVT_ADV_REPORT;
     }
     else if (evt & GAP_EVT_SCAN_DUR_ENDED)
@@ -774,279 +1184,1475 @@ static void BarebotCentral_scanCb(uint32_t evt, void *pMsg, uintptr_t arg)
 
     if (BarebotCentral_enqueueMsg(event, (bpEvtData_t) pMsg) != SUCCESS)
     {
+        /* couldn't queue it, free the report data and the event buffer */
+        if ((event == BC_EVT_ADV_REPORT) && (pMsg != NULL))
+            ICall_free(((GapScan_Evt_AdvRpt_t*) pMsg)->pData);
         ICall_free(pMsg);
     }
     return;
 }
 
-/* helper functions */
-
-
 /*
- BarebotCentral_enqueueMsg(uint8_t, bpEvtData_t)
+ BarebotCentral_readClockCb(UArg)
 
- Description:      Starts scanning for devices.
+ Description:      This function is the callback for the read timeout clock.
+ It is called every BC_READ_TICK_MS while there are
+ outstanding reads.
 
- Operation:        
+ Operation:        The clock callback runs in a Swi, so a message is queued
+ for the central task which then checks the read timeouts.
 
- Arguments:        None.
+ Arguments:        arg (UArg) - clock argument (unused).
+ Return Value:     None.
+ Exceptions:       None.
 
  Inputs:           None.
  Outputs:          None.
 
- Error Handling:   None
+ Error Handling:   If the message can't be queued the check is done on the
+ next tick.
 
  Algorithms:       None.
  Data Structures:  None.
 
- Revision History:  /15/24  Adam Krivka      initial revision
-
+ Revision History: 4/12/24  Adam Krivka      initial revision
  */
-static void BarebotCentral_startScanning()
+static void BarebotCentral_readClockCb(UArg arg)
 {
-    /* start scanning */
-    GapScan_enable(BC_SCAN_PERIOD, DEFAULT_SCAN_DURATION, 0);
+    /* variables */
+    bpEvtData_t data; /* message data (none) */
 
-    /* set state to scanning */
-    BarebotCentral_setState(BC_STATE_SCANNING);
+    /* the clock argument is not used */
+    (void) arg;
+
+    /* let the central task check the timeouts */
+    data.pData = NULL;
+    BarebotCentral_enqueueMsg(BC_EVT_READ_TICK, data);
+
+    return;
 }
 
 /*
- BarebotCentral_enqueueMsg(uint8_t, bpEvtData_t)
+ BarebotCentral_connClockCb(UArg)
 
- Description:      This function creates a message and puts it into the
- RTOS queue.
+ Description:      This function is the callback for the connection
+ parameter policy clock.  It is called every
+ BC_CONN_TICK_MS while connected.
 
- Operation:        The function dynamically allocates memory for the message
- and then copies the passed event and data into this
- message.  The message is then enqueued using the RTOS
- function that also creates an event on enqueuing.
+ Operation:        The clock callback runs in a Swi, so a message is queued
+ for the central task which then runs the policy.
 
- Arguments:        event (uint8_t)    - event ID for the message to enqueue.
- data (bpEvtData_t) - data for the message to enqueue.
- Return Value:     (status_t) - SUCCESS if the message was successfully
- enqueued, FAILURE if there was an error engueuing the
- message, and bleMemAllocError if there was an error
- allocating memory for the message.
+ Arguments:        arg (UArg) - clock argument (unused).
+ Return Value:     None.
  Exceptions:       None.
 
  Inputs:           None.
  Outputs:          None.
 
- Error Handling:   If there is an error allocating memory for the message,
- no message is enqueued and bleMemAllocError is returned.
- If there is an error enqueuing the message, FAILURE is
- returned.
+ Error Handling:   If the message can't be queued the policy runs on the
+ next tick.
 
  Algorithms:       None.
  Data Structures:  None.
 
- Revision History: 03/10/22  Glen George      initial revision
+ Revision History: 4/20/24  Adam Krivka      initial revision
  */
-static status_t BarebotCentral_enqueueMsg(uint8_t event, bpEvtData_t data)
+static void BarebotCentral_connClockCb(UArg arg)
 {
     /* variables */
-    bpEvt_t *pMsg; /* the dynamically allocated enqueued message */
-
-    status_t success; /* whether or not enqueuing was successful */
-
-    /* allocate memory for the message */
-    pMsg = ICall_malloc(sizeof(bpEvt_t));
-
-    /* check if memory got allocated */
-    if (pMsg != NULL)
-    {
-
-        /* memory was allocated, create the event message */
-        pMsg->event = event;
-        pMsg->data = data;
+    bpEvtData_t data; /* message data (none) */
 
-        /* enqueue the message, watching for errors */
-        if (Util_enqueueMsg(appMsgQueueHandle, syncEvent, (uint8_t*) pMsg))
-            /* successfully enqueued the message */
-            success = SUCCESS;
-        else
-            /* there was an error enqueuing the message */
-            /*    note - Util_enqueueMsg() freed the message on failure */
-            success = FAILURE;
-    }
-    else
-    {
+    /* the clock argument is not used */
+    (void) arg;
 
-        /* memory allocation error, let caller know */
-        success = bleMemAllocError;
-    }
+    /* let the central task run the policy */
+    data.pData = NULL;
+    BarebotCentral_enqueueMsg(BC_EVT_CONN_TICK, data);
 
-    /* done enqueuing the message, return the error status */
-    return success;
+    return;
 }
 
-/*
- BarebotCentral_findDeviceName(uint8_t *, uint16_t, char *, uint8_t)
-
- Description:       This function finds the device name in the advertisement
-                    data.
-
- Operation:         The function parses the advertisement data looking for
-                    the device name.  If it finds the device name it copies
-                    it into the passed buffer.
+/* helper functions */
 
- Arguments:         pData (uint8_t *) - pointer to the advertisement data.
-                    dataLen (uint16_t) - length of the advertisement data.
-                    deviceName (char *) - buffer to hold the device name.
-                    maxNameLength (uint8_t) - maximum length of the device name.
- Return Value:      (bool) - TRUE if the device name was found, FALSE if it
-                    was not found.
- Exceptions:        None.
+/*
+ BarebotCentral_filterAdvReport(GapScan_Evt_AdvRpt_t *)
+
+ Description:      This function decides whether an advertising report may
+ be from the server and should be forwarded to the central
+ task.  It is called from the scanner callback, so it only
+ does cheap checks and allocates nothing.
+
+ Operation:        Reports from an address on the allow list (servers that
+ have been connected to before) are always forwarded.
+ Otherwise the advertising data is walked once.  The report
+ is forwarded if it has a local name whose first
+ BC_SERVER_NAME_LEN characters hash to the server name hash
+ and, if it lists 16-bit service UUIDs, the barebot profile
+ service is one of them.  The central task still checks the
+ name itself before connecting.
+
+ Arguments:        pAdvRpt (GapScan_Evt_AdvRpt_t *) - the report to check.
+ Return Value:     (bool) - TRUE if the report should be forwarded, FALSE
+ if it should be dropped.
+ Exceptions:       None.
 
- Inputs:            None.
- Outputs:           None.
+ Inputs:           None.
+ Outputs:          None.
 
- Error Handling:    None.
+ Error Handling:   Reports with malformed advertising data are dropped.
 
- Algorithms:        None.
- Data Structures:   None.
+ Algorithms:       FNV-1a hash of the name.
+ Data Structures:  None.
 
- Source: https://e2e.ti.com/support/wireless-connectivity/bluetooth-group/bluetooth/f/bluetooth-forum/1258776/cc2642r-display-advertiser-name-in-simple_central/4773912?tisearch=e2e-sitesearch&keymatch=get%252520device%252520name%252520from%252520advertising%252520report#4773912
+ Revision History: 4/18/24  Adam Krivka      initial revision
  */
-static bool BarebotCentral_findDeviceName(uint8_t *pData, uint16_t dataLen,
-                                          char *deviceName,
-                                          uint8_t maxNameLength)
+static bool BarebotCentral_filterAdvReport(GapScan_Evt_AdvRpt_t *pAdvRpt)
 {
-    uint8_t adLen;
-    uint8_t adType;
-    uint8_t *pEnd;
-
-    // Erase the content of deviceName
+    /* variables */
+    uint8_t *pData = pAdvRpt->pData; /* advertising data */
+    uint16_t i = 0; /* index of the AD structure in the data */
+    uint8_t adLen; /* length of the AD structure (type and data) */
+    uint8_t adType; /* type of the AD structure */
+    uint8_t j; /* index into the AD structure data */
+    bool haveUUIDs = FALSE; /* whether service UUIDs are listed */
+    bool uuidMatch = FALSE; /* whether the server UUID is listed */
+    bool nameMatch = FALSE; /* whether the name hash matches */
+
+    /* known servers are always forwarded */
+    for (j = 0; j < numAllowed; j++)
     {
-        int i;
-        for (i = 0; i < maxNameLength; i++)
+        if (memcmp(allowList[j], pAdvRpt->addr, B_ADDR_LEN) == 0)
         {
-            deviceName[i] = '\0';
+            scanStats.allowListHits++;
+            return (TRUE);
         }
     }
 
-    // Parse the advertisement data
-    if (dataLen > 0)
-    {
-        pEnd = pData + dataLen - 1;
-
-        // While end of data not reached
-        while (pData < pEnd)
-        {
-            // Get length of next AD item
-            adLen = *pData++;
-
-            if (adLen > 0)
-            {
-                adType = *pData++;
+    /* no data means no name, can't be the server */
+    if (pData == NULL)
+        return (FALSE);
 
-                // If AD type is for device name
-                if ((adType == GAP_ADTYPE_LOCAL_NAME_SHORT)
-                        || (adType == GAP_ADTYPE_LOCAL_NAME_COMPLETE))
-                {
-                    // For the whole length of the device name found
-                    int i;
-                    for (i = 0; i <= adLen - 1; i++) // looping until (adLen-1) because adLen also accounts for the size of the adType (1 byte)
-                    {
-                        if (i < maxNameLength)
-                        {
-                            deviceName[i] = (char) *pData++;
-                        }
-                    }
+    /* walk the AD structures */
+    while ((i + 1) < pAdvRpt->dataLen)
+    {
+        adLen = pData[i];
+        adType = pData[i + 1];
 
-                    return TRUE;
-                }
+        /* stop at the end (a zero length) or if the data is malformed */
+        if (adLen == 0)
+            break;
+        if ((i + 1 + adLen) > pAdvRpt->dataLen)
+            return (FALSE);
 
-                else
-                {
-                    // Go to next item
-                    pData += adLen;
-                }
-            }
+        if ((adType == GAP_ADTYPE_16BIT_MORE)
+                || (adType == GAP_ADTYPE_16BIT_COMPLETE))
+        {
+            /* list of 16-bit service UUIDs */
+            haveUUIDs = TRUE;
+            for (j = 2; (j + 1) <= adLen; j += 2)
+                if (BUILD_UINT16(pData[i + j], pData[i + j + 1])
+                        == BAREBOTPROFILE_SERV_UUID)
+                    uuidMatch = TRUE;
+        }
+        else if ((adType == GAP_ADTYPE_LOCAL_NAME_SHORT)
+                || (adType == GAP_ADTYPE_LOCAL_NAME_COMPLETE))
+        {
+            /* device name, compare the hash of its start */
+            nameMatch = (adLen > BC_SERVER_NAME_LEN)
+                    && (BarebotCentral_nameHash(&pData[i + 2],
+                                                BC_SERVER_NAME_LEN)
+                            == serverNameHash);
         }
+
+        /* next AD structure */
+        i += 1 + adLen;
     }
+
+    /* need the name, and the service if any services are listed */
+    return (nameMatch && (!haveUUIDs || uuidMatch));
 }
 
 /*
- BarebotCentral_read(uint8)
-
- Description:       This function reads a characteristic from the server.
+ BarebotCentral_nameHash(uint8_t *, uint8_t)
 
- Operation:         The function sends a read request to the server and waits
-                    for the response.
+ Description:      This function computes a compact hash of a device name.
 
- Arguments:         charID (uint8) - ID of the characteristic to read.
- Return Value:      (bcReadRsp_t) - response to the read request.
- Exceptions:        None.
+ Operation:        The FNV-1a hash of the passed bytes is computed.
 
- Inputs:            None.
- Outputs:           None.
+ Arguments:        pName (uint8_t *) - the name.
+ len (uint8_t)     - number of bytes of the name to hash.
+ Return Value:     (uint32_t) - hash of the name.
+ Exceptions:       None.
 
- Error Handling:    None.
+ Inputs:           None.
+ Outputs:          None.
 
- Algorithms:        None.
- Data Structures:   None.
+ Error Handling:   None.
 
- Revision History:  3/15/24  Adam Krivka      initial revision
+ Algorithms:       FNV-1a (xor in each byte, then multiply by the prime).
+ Data Structures:  None.
 
+ Revision History: 4/18/24  Adam Krivka      initial revision
  */
-bcReadRsp_t BarebotCentral_read(uint8_t charID)
+static uint32_t BarebotCentral_nameHash(uint8_t *pName, uint8_t len)
 {
     /* variables */
-    attReadReq_t req; /* read request struct */
-    uint32_t events; /* read event */
+    uint32_t hash = BC_NAME_HASH_INIT; /* hash being computed */
 
-    /* get associated char handle */
-    switch (charID)
+    /* hash every byte */
+    while (len-- > 0)
     {
-    case BAREBOTPROFILE_SPEED:
-        req.handle = speedCharHandle;
-        break;
-    case BAREBOTPROFILE_TURN:
-        req.handle = turnCharHandle;
-        break;
-    case BAREBOTPROFILE_THOUGHTS:
-        req.handle = thoughtsCharHandle;
-        break;
-    default:
-        // handle invalid charID
-        break;
+        hash ^= *pName++;
+        hash *= BC_NAME_HASH_PRIME;
     }
 
-    /* start a read operation */
-    GATT_ReadCharValue(curr_conn_handle, &req, centralEntity);
-
-    /* wait until read operation is done */
-    events = Event_pend(readEventHandle, Event_Id_NONE, BC_ALL_EVENTS,
-    ICALL_TIMEOUT_FOREVER);
-
-    /* received event */
-    if (events & UTIL_QUEUE_EVENT_ID)
-    {
-        /* allocate a new struct for the response */
-        bcReadRsp_t rsp;
-        rsp.len = readLen;
-        rsp.pValue = ICall_malloc(readLen * sizeof(uint8));
-
-        /* copy the data into it */
-        memcpy(rsp.pValue, readValue, readLen);
-
-        /* return struct */
-        return rsp;
-    }
+    return (hash);
 }
 
 /*
- BarebotCentral_write(uint8, uint8 *)
+ BarebotCentral_allowAddress(uint8_t *)
 
- Description:       This function writes a characteristic to the server.
+ Description:      This function adds an address to the advertising report
+ allow list.  Reports from addresses on the list are always
+ forwarded to the central task.
 
- Operation:         The function sends a write request to the server.
+ Operation:        If the address isn't on the list yet it is added.  When
+ the list is full the oldest address is dropped.  It must
+ only be called while not scanning (the list is read in the
+ scanner callback).
 
- Arguments:         charID (uint8) - ID of the characteristic to write.
-                    newValue (uint8 *) - new value to write to the characteristic.
- Return Value:      (bool) - TRUE if the write was successful, FALSE if it was not.
+ Arguments:        addr (uint8_t *) - address to add.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/18/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_allowAddress(uint8_t *addr)
+{
+    /* variables */
+    uint8_t i; /* loop index */
+
+    /* nothing to do if it is already there */
+    for (i = 0; i < numAllowed; i++)
+        if (memcmp(allowList[i], addr, B_ADDR_LEN) == 0)
+            return;
+
+    /* make room by dropping the oldest address if the list is full */
+    if (numAllowed == BC_SCAN_ALLOW_LIST_SIZE)
+    {
+        memmove(allowList[0], allowList[1],
+                (BC_SCAN_ALLOW_LIST_SIZE - 1) * B_ADDR_LEN);
+        numAllowed--;
+    }
+
+    /* add the address at the end */
+    memcpy(allowList[numAllowed++], addr, B_ADDR_LEN);
+
+    return;
+}
+
+/*
+ BarebotCentral_connPolicy()
+
+ Description:      This function decides which connection parameters the
+ link should use and requests them if the link isn't using
+ them yet.
+
+ Operation:        The link should be in the active mode (short interval,
+ no latency) while the robot is moving or the user was
+ active in the last BC_IDLE_TIMEOUT_MS, and in the idle
+ mode (long interval with peripheral latency) otherwise.
+ Nothing is done until the central is ready or while an
+ update is in progress.  If the link isn't in the wanted
+ mode the parameters are requested.  A failed request is
+ retried after BC_CONN_RETRY_MS, up to BC_CONN_MAX_RETRIES
+ times (the count starts over when the wanted mode
+ changes).
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          A connection parameter update may be requested.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/20/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_connPolicy(void)
+{
+    /* variables */
+    uint32_t now = Clock_getTicks(); /* current time */
+    uint8_t mode; /* mode the link should be in */
+
+    /* only manage a ready link without an update in progress */
+    if ((centralState != BC_STATE_READY) || connUpdatePending)
+        return;
+
+    /* pick the mode */
+    if (robotMoving
+            || ((now - lastActivityTick) < BC_MS_TO_TICKS(BC_IDLE_TIMEOUT_MS)))
+        mode = BC_CONN_MODE_ACTIVE;
+    else
+        mode = BC_CONN_MODE_IDLE;
+
+    /* nothing to do if the link is already there */
+    if (mode == connModeActual)
+        return;
+
+    /* a failed request for this mode waits before being retried, and is */
+    /*    only retried a few times */
+    if ((mode == connModeWanted) && (connRetries != 0)
+            && ((connRetries > BC_CONN_MAX_RETRIES)
+                    || ((int32_t) (now - connRetryTick) < 0)))
+        return;
+
+    /* a new mode gets all the retries */
+    if (mode != connModeWanted)
+        connRetries = 0;
+
+    /* ask for the parameters */
+    BarebotCentral_requestConnParams(mode);
+
+    return;
+}
+
+/*
+ BarebotCentral_requestConnParams(uint8_t)
+
+ Description:      This function requests the connection parameters for the
+ passed mode.
+
+ Operation:        A link parameter update is requested with the interval
+ range and peripheral latency for the mode.  The result
+ arrives as a GAP_LINK_PARAM_UPDATE_EVENT.
+
+ Arguments:        mode (uint8_t) - BC_CONN_MODE_ACTIVE or BC_CONN_MODE_IDLE.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          A connection parameter update is requested.
+
+ Error Handling:   If the request can't be made it is handled like a failed
+ update (retried later).
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/20/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_requestConnParams(uint8_t mode)
+{
+    /* variables */
+    gapUpdateLinkParamReq_t req; /* parameter update request */
+
+    /* fill in the parameters for the mode */
+    req.connectionHandle = curr_conn_handle;
+    if (mode == BC_CONN_MODE_ACTIVE)
+    {
+        req.intervalMin = BC_ACTIVE_INT_MIN;
+        req.intervalMax = BC_ACTIVE_INT_MAX;
+        req.connLatency = BC_ACTIVE_LATENCY;
+    }
+    else
+    {
+        req.intervalMin = BC_IDLE_INT_MIN;
+        req.intervalMax = BC_IDLE_INT_MAX;
+        req.connLatency = BC_IDLE_LATENCY;
+    }
+    req.connTimeout = BC_CONN_SUPERVISION_TIMEOUT;
+
+    /* request it */
+    connModeWanted = mode;
+    connStats.requested++;
+    if (GAP_UpdateLinkParamReq(&req) == SUCCESS)
+        connUpdatePending = TRUE;
+    else
+        BarebotCentral_connUpdateFailed();
+
+    return;
+}
+
+/*
+ BarebotCentral_connUpdateFailed()
+
+ Description:      This function handles a connection parameter update that
+ failed or could not be requested.
+
+ Operation:        The failure is counted and a retry is scheduled for
+ BC_CONN_RETRY_MS from now.
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/20/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_connUpdateFailed(void)
+{
+    /* count it and retry later */
+    connStats.failed++;
+    connRetries++;
+    connRetryTick = Clock_getTicks() + BC_MS_TO_TICKS(BC_CONN_RETRY_MS);
+
+    return;
+}
+
+/*
+ BarebotCentral_setMoving(int16_t)
+
+ Description:      This function notes whether the robot is moving from its
+ speed.  The link is kept in the active mode while it is.
+
+ Operation:        The robot is moving if the speed isn't zero.  When it
+ starts moving the policy is run right away so the link
+ speeds up without waiting for the next policy tick.
+
+ Arguments:        speed (int16_t) - current speed of the robot.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/20/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_setMoving(int16_t speed)
+{
+    /* variables */
+    bool wasMoving = robotMoving; /* whether it was moving before */
+
+    /* moving if the speed isn't zero */
+    robotMoving = (speed != 0);
+
+    /* speed up the link right away when it starts */
+    if (robotMoving && !wasMoving)
+        BarebotCentral_connPolicy();
+
+    return;
+}
+
+
+/*
+ BarebotCentral_enqueueMsg(uint8_t, bpEvtData_t)
+
+ Description:      Starts scanning for devices.
+
+ Operation:        
+
+ Arguments:        None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History:  /15/24  Adam Krivka      initial revision
+
+ */
+static void BarebotCentral_startScanning()
+{
+    /* start scanning */
+    GapScan_enable(BC_SCAN_PERIOD, DEFAULT_SCAN_DURATION, 0);
+
+    /* set state to scanning */
+    BarebotCentral_setState(BC_STATE_SCANNING);
+}
+
+/*
+ BarebotCentral_enqueueMsg(uint8_t, bpEvtData_t)
+
+ Description:      This function creates a message and puts it into the
+ RTOS queue.
+
+ Operation:        The function allocates memory for the message (from the
+ event pool or the heap) and then copies the passed event
+ and data into this message.  The message is then enqueued
+ and the queue event is posted to the task.
+
+ Arguments:        event (uint8_t)    - event ID for the message to enqueue.
+ data (bpEvtData_t) - data for the message to enqueue.
+ Return Value:     (status_t) - SUCCESS if the message was successfully
+ enqueued, FAILURE if there was an error engueuing the
+ message, and bleMemAllocError if there was an error
+ allocating memory for the message.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   If there is an error allocating memory for the message,
+ no message is enqueued and bleMemAllocError is returned.
+ If there is an error enqueuing the message, FAILURE is
+ returned.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 03/10/22  Glen George      initial revision
+                   4/4/24    Adam Krivka      allocate from the event pool
+ */
+static status_t BarebotCentral_enqueueMsg(uint8_t event, bpEvtData_t data)
+{
+    /* variables */
+    bpEvt_t *pMsg; /* the dynamically allocated enqueued message */
+
+    status_t success; /* whether or not enqueuing was successful */
+
+    /* allocate memory for the message */
+    pMsg = BC_EVT_ALLOC();
+
+    /* check if memory got allocated */
+    if (pMsg != NULL)
+    {
+
+        /* memory was allocated, create the event message */
+        pMsg->event = event;
+        pMsg->data = data;
+
+#if BC_USE_MSG_POOL
+        /* pool messages carry their own queue link, so enqueuing can't fail */
+        MsgPool_enqueue(appMsgQueueHandle, syncEvent, pMsg);
+        success = SUCCESS;
+#else
+        /* enqueue the message, watching for errors */
+        if (Util_enqueueMsg(appMsgQueueHandle, syncEvent, (uint8_t*) pMsg))
+            /* successfully enqueued the message */
+            success = SUCCESS;
+        else
+            /* there was an error enqueuing the message */
+            /*    note - Util_enqueueMsg() freed the message on failure */
+            success = FAILURE;
+#endif
+    }
+    else
+    {
+
+        /* memory allocation error, let caller know */
+        success = bleMemAllocError;
+    }
+
+    /* done enqueuing the message, return the error status */
+    return success;
+}
+
+/*
+ BarebotCentral_findDeviceName(uint8_t *, uint16_t, char *, uint8_t)
+
+ Description:       This function finds the device name in the advertisement
+                    data.
+
+ Operation:         The function parses the advertisement data looking for
+                    the device name.  If it finds the device name it copies
+                    it into the passed buffer.
+
+ Arguments:         pData (uint8_t *) - pointer to the advertisement data.
+                    dataLen (uint16_t) - length of the advertisement data.
+                    deviceName (char *) - buffer to hold the device name.
+                    maxNameLength (uint8_t) - maximum length of the device name.
+ Return Value:      (bool) - TRUE if the device name was found, FALSE if it
+                    was not found.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Source: https://e2e.ti.com/support/wireless-connectivity/bluetooth-group/bluetooth/f/bluetooth-forum/1258776/cc2642r-display-advertiser-name-in-simple_central/4773912?tisearch=e2e-sitesearch&keymatch=get%252520device%252520name%252520from%252520advertising%252520report#4773912
+ */
+static bool BarebotCentral_findDeviceName(uint8_t *pData, uint16_t dataLen,
+                                          char *deviceName,
+                                          uint8_t maxNameLength)
+{
+    uint8_t adLen;
+    uint8_t adType;
+    uint8_t *pEnd;
+
+    // Erase the content of deviceName
+    {
+        int i;
+        for (i = 0; i < maxNameLength; i++)
+        {
+            deviceName[i] = '\0';
+        }
+    }
+
+    // Parse the advertisement data
+    if (dataLen > 0)
+    {
+        pEnd = pData + dataLen - 1;
+
+        // While end of data not reached
+        while (pData < pEnd)
+        {
+            // Get length of next AD item
+            adLen = *pData++;
+
+            if (adLen > 0)
+            {
+                adType = *pData++;
+
+                // If AD type is for device name
+                if ((adType == GAP_ADTYPE_LOCAL_NAME_SHORT)
+                        || (adType == GAP_ADTYPE_LOCAL_NAME_COMPLETE))
+                {
+                    // For the whole length of the device name found
+                    int i;
+                    for (i = 0; i < adLen - 1; i++) // looping until (adLen-1) because adLen also accounts for the size of the adType (1 byte)
+                    {
+                        if (i < maxNameLength)
+                        {
+                            deviceName[i] = (char) *pData++;
+                        }
+                    }
+
+                    return TRUE;
+                }
+
+                else
+                {
+                    // Go to next item (the type was already read)
+                    pData += adLen - 1;
+                }
+            }
+        }
+    }
+
+    // no device name in the data
+    return FALSE;
+}
+
+/*
+ BarebotCentral_read(uint8)
+
+ Description:       This function reads a characteristic from the server and
+                    waits for the value.
+
+ Operation:         The function starts an asynchronous read with a callback
+                    that copies the value into the response and posts the
+                    read event, then waits for that event.  Every read is
+                    completed (possibly by timing out), so the wait always
+                    ends.  It must not be called from the central task.
+
+ Arguments:         charID (uint8) - ID of the characteristic to read.
+ Return Value:      (bcReadRsp_t) - response to the read request, pValue is
+                    allocated with ICall_malloc and must be freed by the
+                    caller.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    If the read can't be started, fails, or times out, len
+                    is 0 and pValue is NULL.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  3/15/24  Adam Krivka      initial revision
+                    4/12/24  Adam Krivka      wrapper around the asynchronous
+                                              read
+
+ */
+bcReadRsp_t BarebotCentral_read(uint8_t charID)
+{
+    /* variables */
+    bcReadRsp_t rsp; /* response to return */
+
+    /* nothing read yet */
+    rsp.len = 0;
+    rsp.pValue = NULL;
+
+    /* start the read and wait for it to complete */
+    if (BarebotCentral_readAsync(charID, BarebotCentral_blockingReadCb,
+                                 (uintptr_t) &rsp, BC_READ_TIMEOUT_MS)
+            != BC_READ_ID_NONE)
+        Event_pend(readEventHandle, Event_Id_NONE, BC_ALL_EVENTS,
+                   ICALL_TIMEOUT_FOREVER);
+
+    /* return the response */
+    return rsp;
+}
+
+/*
+ BarebotCentral_blockingReadCb(bcReadResult_t *, uintptr_t)
+
+ Description:       This function is the completion callback for reads
+                    started by BarebotCentral_read().
+
+ Operation:         The value is copied into newly allocated memory in the
+                    waiting caller's response and the read event is posted
+                    to wake up the caller.
+
+ Arguments:         pResult (bcReadResult_t *) - result of the read.
+                    arg (uintptr_t) - the caller's response (bcReadRsp_t *).
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    If the read failed or memory can't be allocated the
+                    response is left empty.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_blockingReadCb(bcReadResult_t *pResult,
+                                          uintptr_t arg)
+{
+    /* variables */
+    bcReadRsp_t *pRsp = (bcReadRsp_t*) arg; /* the caller's response */
+
+    /* copy the value if there is one */
+    if ((pResult->status == SUCCESS) && (pResult->len != 0))
+    {
+        pRsp->pValue = ICall_malloc(pResult->len);
+        if (pRsp->pValue != NULL)
+        {
+            pRsp->len = pResult->len;
+            memcpy(pRsp->pValue, pResult->pValue, pResult->len);
+        }
+    }
+
+    /* unblock the caller */
+    Event_post(readEventHandle, BC_ALL_EVENTS);
+
+    return;
+}
+
+/*
+ BarebotCentral_readAsync(uint8, bcReadCb_t, uintptr_t, uint32)
+
+ Description:       This function starts reading a characteristic from the
+                    server without waiting for the value.  When the read
+                    completes the passed callback is called (from the
+                    central task) with the result and the passed argument.
+
+ Operation:         If the cache has a fresh value for the characteristic
+                    the read completes right away and the callback is
+                    called from the calling task.  Otherwise the read is
+                    added to the end of the read table with its
+                    timeout deadline and a message is queued for the central
+                    task, which sends the reads in order.  As soon as the
+                    response for one read arrives the next one is sent, so
+                    several reads go back to back without a round trip
+                    through the calling task.  The timeout clock is started
+                    so the read is completed even if no response arrives.
+
+ Arguments:         charID (uint8) - ID of the characteristic to read.
+                    pfnCb (bcReadCb_t) - function to call when the read
+                                         completes (may be NULL).
+                    arg (uintptr_t) - argument passed to the callback.
+                    timeoutMs (uint32) - time in ms for the read to complete.
+ Return Value:      (uint8) - request ID for the read (passed to the
+                    callback), BC_READ_ID_NONE if the read was not started.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    If the characteristic can't be read (or hasn't been
+                    discovered) or the read table is full BC_READ_ID_NONE is
+                    returned and the callback is never called.
+
+ Algorithms:        None.
+ Data Structures:   Ring of read table entries in request order.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+                    4/14/24  Adam Krivka      serve fresh values from the cache
+ */
+uint8 BarebotCentral_readAsync(uint8 charID, bcReadCb_t pfnCb, uintptr_t arg,
+                               uint32 timeoutMs)
+{
+    /* variables */
+    bcReadEntry_t *pEntry; /* table entry for the read */
+    uint16_t handle; /* handle of the characteristic */
+    uint8 reqID = BC_READ_ID_NONE; /* request ID for the read */
+    bpEvtData_t data; /* message data (none) */
+    bcReadResult_t result; /* result for a read served from the cache */
+    uint8 cacheValue[BC_CACHE_VALUE_LEN]; /* value from the cache */
+    UInt key; /* interrupt state to restore */
+
+    /* get the associated char handle */
+    switch (charID)
+    {
+    case BAREBOTPROFILE_SPEED:
+        handle = speedCharHandle;
+        break;
+    case BAREBOTPROFILE_TURN:
+        handle = turnCharHandle;
+        break;
+    case BAREBOTPROFILE_THOUGHTS:
+        handle = thoughtsCharHandle;
+        break;
+    case BAREBOTPROFILE_STATE:
+        handle = stateCharHandle;
+        break;
+    default:
+        /* not a characteristic that can be read */
+        handle = 0;
+        break;
+    }
+    if (handle == 0)
+        return (BC_READ_ID_NONE);
+
+    /* serve the read from the cache if the value there is fresh */
+    if (BarebotCentral_cacheRead(charID, cacheValue, &result.len))
+    {
+        /* still gets a request ID of its own */
+        key = Hwi_disable();
+        if (++lastReadID == BC_READ_ID_NONE)
+            lastReadID++;
+        reqID = lastReadID;
+        Hwi_restore(key);
+
+        /* done already, let the caller know */
+        result.reqID = reqID;
+        result.charID = charID;
+        result.status = SUCCESS;
+        result.pValue = cacheValue;
+        if (pfnCb != NULL)
+            pfnCb(&result, arg);
+
+        return (reqID);
+    }
+
+    /* add the read to the end of the table (the central task removes */
+    /*    entries from the front) */
+    key = Hwi_disable();
+    if (readCount < BC_MAX_READS)
+    {
+        /* get the next request ID, never BC_READ_ID_NONE */
+        if (++lastReadID == BC_READ_ID_NONE)
+            lastReadID++;
+        reqID = lastReadID;
+
+        pEntry = &readTable[(readHead + readCount) % BC_MAX_READS];
+        pEntry->state = BC_READ_QUEUED;
+        pEntry->reqID = reqID;
+        pEntry->charID = charID;
+        pEntry->handle = handle;
+        pEntry->pfnCb = pfnCb;
+        pEntry->arg = arg;
+        pEntry->deadline = Clock_getTicks()
+                + (timeoutMs * 1000) / Clock_tickPeriod;
+        readCount++;
+
+        /* make sure the timeouts get checked */
+        Util_startClock(&readClock);
+    }
+    Hwi_restore(key);
+
+    /* let the central task know there is a read to send */
+    /*    (if this fails it is sent on the next clock tick) */
+    if (reqID != BC_READ_ID_NONE)
+    {
+        data.pData = NULL;
+        BarebotCentral_enqueueMsg(BC_EVT_READ_REQ, data);
+    }
+
+    return (reqID);
+}
+
+/*
+ BarebotCentral_sendNextRead()
+
+ Description:       This function sends the oldest queued read to the server
+                    if no read is on the air.
+
+ Operation:         Completed entries are removed from the front of the read
+                    table and, if nothing is on the air, a read request is
+                    sent for the entry now at the front.  If the stack is
+                    busy with another ATT request (blePending) the read is
+                    left queued and sent after the next GATT message or
+                    clock tick.  Any other error completes the read with
+                    that status and the next read is tried.  The timeout
+                    clock is stopped once the table is empty.
+
+ Arguments:         None.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           A read request may be sent to the server.
+
+ Error Handling:    Reads that can't be sent are completed with the error.
+
+ Algorithms:        None.
+ Data Structures:   Ring of read table entries in request order.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_sendNextRead(void)
+{
+    /* variables */
+    bcReadEntry_t *pEntry; /* read at the front of the table */
+    attReadReq_t req; /* read request struct */
+    bStatus_t status; /* status of sending the request */
+    UInt key; /* interrupt state to restore */
+
+    /* keep going until a read is on the air or there are none left */
+    while (!readOnAir)
+    {
+        /* remove the completed reads from the front of the table */
+        key = Hwi_disable();
+        while ((readCount != 0) && (readTable[readHead].state == BC_READ_FREE))
+        {
+            readHead = (readHead + 1) % BC_MAX_READS;
+            readCount--;
+        }
+        if (readCount == 0)
+            Util_stopClock(&readClock);
+        Hwi_restore(key);
+
+        /* done if there is nothing to send */
+        if (readCount == 0)
+            break;
+
+        /* send the read at the front */
+        pEntry = &readTable[readHead];
+        req.handle = pEntry->handle;
+        status = GATT_ReadCharValue(curr_conn_handle, &req, centralEntity);
+
+        if (status == SUCCESS)
+        {
+            /* sent, wait for the response */
+            pEntry->state = BC_READ_SENT;
+            readOnAir = TRUE;
+        }
+        else if (status == blePending)
+        {
+            /* another ATT request is outstanding, try again later */
+            break;
+        }
+        else
+        {
+            /* can't be sent at all, fail it and try the next one */
+            BarebotCentral_completeRead(pEntry, status, NULL, 0);
+        }
+    }
+
+    return;
+}
+
+/*
+ BarebotCentral_completeRead(bcReadEntry_t *, bStatus_t, uint8 *, uint16)
+
+ Description:       This function completes a read from the read table and
+                    calls its callback with the result.
+
+ Operation:         The result is filled in from the entry, the entry is
+                    marked free (it is removed when it reaches the front of
+                    the table), and the callback is called.
+
+ Arguments:         pEntry (bcReadEntry_t *) - read to complete.
+                    status (bStatus_t) - status of the read.
+                    pValue (uint8 *) - value read (NULL if none).
+                    len (uint16) - length of the value.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_completeRead(bcReadEntry_t *pEntry,
+                                        bStatus_t status, uint8 *pValue,
+                                        uint16 len)
+{
+    /* variables */
+    bcReadResult_t result; /* result passed to the callback */
+
+    /* build the result */
+    result.reqID = pEntry->reqID;
+    result.charID = pEntry->charID;
+    result.status = status;
+    result.len = len;
+    result.pValue = pValue;
+
+    /* done with the entry */
+    pEntry->state = BC_READ_FREE;
+
+    /* let the caller know */
+    if (pEntry->pfnCb != NULL)
+        pEntry->pfnCb(&result, pEntry->arg);
+
+    return;
+}
+
+/*
+ BarebotCentral_expireReads(bool)
+
+ Description:       This function completes the reads that have timed out,
+                    or all outstanding reads if all is TRUE (the link is
+                    gone).
+
+ Operation:         Every entry in the read table that is not free is
+                    checked against its deadline and completed with
+                    bleTimeout if it passed (bleNotConnected if all is
+                    TRUE).  If the read on the air timed out its response
+                    may still arrive, so nothing else is sent until it does
+                    (the ATT timeout drops the link if it never does).
+                    Finally the next read is sent if possible.
+
+ Arguments:         all (bool) - TRUE to complete all the reads.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   Ring of read table entries in request order.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_expireReads(bool all)
+{
+    /* variables */
+    bcReadEntry_t *pEntry; /* entry being checked */
+    uint32_t now = Clock_getTicks(); /* current time */
+    uint8_t count = readCount; /* reads in the table when called */
+    uint8_t i; /* loop index */
+
+    /* check every read in the table */
+    for (i = 0; i < count; i++)
+    {
+        pEntry = &readTable[(readHead + i) % BC_MAX_READS];
+        if (pEntry->state == BC_READ_FREE)
+            continue;
+
+        if (all)
+            BarebotCentral_completeRead(pEntry, bleNotConnected, NULL, 0);
+        else if ((int32_t) (now - pEntry->deadline) >= 0)
+            BarebotCentral_completeRead(pEntry, bleTimeout, NULL, 0);
+    }
+
+    /* without a link no response is coming for the read on the air */
+    if (all)
+        readOnAir = FALSE;
+
+    /* send the next read (this also stops the clock if there are none) */
+    BarebotCentral_sendNextRead();
+
+    return;
+}
+
+/*
+ BarebotCentral_cacheEntry(uint8)
+
+ Description:       This function finds the cache entry for a
+                    characteristic.
+
+ Operation:         The cache is searched for an entry with the passed
+                    characteristic ID.
+
+ Arguments:         charID (uint8) - ID of the characteristic.
+ Return Value:      (bcCacheEntry_t *) - the cache entry, NULL if the
+                    characteristic is not cached.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        Linear search (the cache is tiny).
+ Data Structures:   None.
+
+ Revision History:  4/14/24  Adam Krivka      initial revision
+ */
+static bcCacheEntry_t *BarebotCentral_cacheEntry(uint8 charID)
+{
+    /* variables */
+    uint8_t i; /* loop index */
+
+    /* look for the characteristic */
+    for (i = 0; i < BC_CACHE_SIZE; i++)
+        if (valueCache[i].charID == charID)
+            return (&valueCache[i]);
+
+    /* not cached */
+    return (NULL);
+}
+
+/*
+ BarebotCentral_cacheUpdate(uint8, uint8 *, uint16)
+
+ Description:       This function stores a new value for a characteristic in
+                    the cache and marks it fresh.
+
+ Operation:         The value (truncated to the cache entry size) is copied
+                    into the cache entry with interrupts disabled, so a
+                    reader in another task never sees half a value, and the
+                    entry is timestamped.  If pValue is NULL the value
+                    already in the entry (from a write) is made valid.
+
+ Arguments:         charID (uint8) - ID of the characteristic.
+                    pValue (uint8 *) - the new value (NULL to keep the value
+                                       in the entry).
+                    len (uint16) - length of the new value.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    Characteristics that are not cached are ignored.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/14/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_cacheUpdate(uint8 charID, uint8 *pValue,
+                                       uint16 len)
+{
+    /* variables */
+    bcCacheEntry_t *pEntry; /* cache entry for the characteristic */
+    UInt key; /* interrupt state to restore */
+
+    /* find the entry */
+    pEntry = BarebotCentral_cacheEntry(charID);
+    if (pEntry == NULL)
+        return;
+
+    /* store the value */
+    key = Hwi_disable();
+    if (pValue != NULL)
+    {
+        if (len > BC_CACHE_VALUE_LEN)
+            len = BC_CACHE_VALUE_LEN;
+        memcpy(pEntry->value, pValue, len);
+        pEntry->len = len;
+    }
+    pEntry->valid = TRUE;
+    pEntry->timestamp = Clock_getTicks();
+    Hwi_restore(key);
+
+    return;
+}
+
+/*
+ BarebotCentral_cacheRead(uint8, uint8 *, uint16 *)
+
+ Description:       This function gets the cached value of a characteristic
+                    if it is fresh.
+
+ Operation:         If the cache entry is valid and younger than its maximum
+                    age the value is copied out with interrupts disabled.
+
+ Arguments:         charID (uint8) - ID of the characteristic.
+                    pValue (uint8 *) - where to copy the value (must hold
+                                       BC_CACHE_VALUE_LEN bytes).
+                    pLen (uint16 *) - where to store the value length.
+ Return Value:      (bool) - TRUE if a fresh value was copied, FALSE if not.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/14/24  Adam Krivka      initial revision
+ */
+static bool BarebotCentral_cacheRead(uint8 charID, uint8 *pValue,
+                                     uint16 *pLen)
+{
+    /* variables */
+    bcCacheEntry_t *pEntry; /* cache entry for the characteristic */
+    bool fresh = FALSE; /* whether a fresh value was found */
+    UInt key; /* interrupt state to restore */
+
+    /* find the entry */
+    pEntry = BarebotCentral_cacheEntry(charID);
+    if (pEntry == NULL)
+        return (FALSE);
+
+    /* copy the value if it is fresh */
+    key = Hwi_disable();
+    if (pEntry->valid
+            && ((Clock_getTicks() - pEntry->timestamp)
+                    < (pEntry->maxAgeMs * 1000) / Clock_tickPeriod))
+    {
+        memcpy(pValue, pEntry->value, pEntry->len);
+        *pLen = pEntry->len;
+        fresh = TRUE;
+    }
+    Hwi_restore(key);
+
+    return (fresh);
+}
+
+/*
+ BarebotCentral_cacheInvalidate()
+
+ Description:       This function forgets all the cached values.  It is
+                    called when the link goes down.
+
+ Operation:         Every cache entry is marked invalid.
+
+ Arguments:         None.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/14/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_cacheInvalidate(void)
+{
+    /* variables */
+    uint8_t i; /* loop index */
+
+    /* mark every entry invalid */
+    for (i = 0; i < BC_CACHE_SIZE; i++)
+        valueCache[i].valid = FALSE;
+
+    return;
+}
+
+/*
+ BarebotCentral_write(uint8, uint8 *)
+
+ Description:       This function writes a characteristic to the server.
+
+ Operation:         The function sends a write request to the server.
+
+ Arguments:         charID (uint8) - ID of the characteristic to write.
+                    newValue (uint8 *) - new value to write to the characteristic.
+ Return Value:      (bool) - TRUE if the write was successful, FALSE if it was not.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  3/15/24  Adam Krivka      initial revision
+                    4/10/24  Adam Krivka      allocate the whole value, free it
+                                              on errors
+                    4/14/24  Adam Krivka      cache the value written
+ */
+bool BarebotCentral_write(uint8 charID, uint8 *newValue)
+{
+    /* variables */
+    attWriteReq_t req; /* write request struct */
+    bStatus_t status; /* status of sending the request */
+    bcCacheEntry_t *pEntry; /* cache entry for the characteristic */
+    UInt key; /* interrupt state to restore */
+
+    /* get handle and length */
+    switch (charID)
+    {
+    case BAREBOTPROFILE_SPEED:
+        req.handle = speedCharHandle;
+        req.len = BAREBOTPROFILE_SPEED_LEN;
+        break;
+    case BAREBOTPROFILE_TURN:
+        req.handle = turnCharHandle;
+        req.len = BAREBOTPROFILE_TURN_LEN;
+        break;
+    case BAREBOTPROFILE_SPEEDUPDATE:
+        req.handle = speedUpdateCharHandle;
+        req.len = BAREBOTPROFILE_SPEEDUPDATE_LEN;
+        break;
+    case BAREBOTPROFILE_TURNUPDATE:
+        req.handle = turnUpdateCharHandle;
+        req.len = BAREBOTPROFILE_TURNUPDATE_LEN;
+        break;
+    case BAREBOTPROFILE_THOUGHTS:
+        req.handle = thoughtsCharHandle;
+        req.len = BAREBOTPROFILE_THOUGHTS_LEN;
+        break;
+    default:
+        /* not a characteristic that can be written */
+        return (false);
+    }
+
+    /* allocate data with GATT specific function */
+    req.pValue = GATT_bm_alloc(curr_conn_handle, ATT_WRITE_REQ, req.len, NULL);
+    if (req.pValue == NULL)
+        return (false);
+    memcpy(req.pValue, newValue, req.len);
+
+    /* not signed and not a write command */
+    req.sig = FALSE;
+    req.cmd = FALSE;
+
+    /* put the new value in the cache, it becomes valid when the server */
+    /*    responds to the write */
+    pEntry = BarebotCentral_cacheEntry(charID);
+    if (pEntry != NULL)
+    {
+        key = Hwi_disable();
+        memcpy(pEntry->value, newValue, req.len);
+        pEntry->len = req.len;
+        pEntry->valid = FALSE;
+        Hwi_restore(key);
+        pendingWriteChar = charID;
+    }
+
+    /* send write request, the stack only frees the value if it is sent */
+    status = GATT_WriteCharValue(curr_conn_handle, &req, centralEntity);
+    if (status != SUCCESS)
+    {
+        GATT_bm_free((gattMsg_t*) &req, ATT_WRITE_REQ);
+        pendingWriteChar = BC_CACHE_NONE;
+    }
+
+    return (status == SUCCESS);
+}
+
+/*
+ BarebotCentral_sendCommand(uint8, int16)
+
+ Description:       This function sends a speed or turn update command (an
+                    increment to the current value) to the server.
+
+ Operation:         The increment is sent with a sequence number byte so the
+                    server can count commands that never arrive.  In
+                    streaming mode the command is sent as a Write Command
+                    (write without response), so several commands can go out
+                    in one connection interval without waiting for a
+                    response to each.  Otherwise a Write Request is sent.
+
+ Arguments:         charID (uint8) - BAREBOTPROFILE_SPEEDUPDATE or
+                                     BAREBOTPROFILE_TURNUPDATE.
+                    increment (int16) - amount to change the value by.
+ Return Value:      (bool) - TRUE if the command was sent, FALSE if not.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    If the command can't be sent (no buffers or the stack is
+                    busy) it is dropped, counted, and FALSE is returned.  The
+                    sequence number is still used up so the server sees the
+                    gap.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/10/24  Adam Krivka      initial revision
+ */
+bool BarebotCentral_sendCommand(uint8 charID, int16 increment)
+{
+    /* variables */
+    attWriteReq_t req; /* write request/command struct */
+    uint8_t method; /* ATT method used to send */
+    bStatus_t status; /* status of sending the command */
+
+    /* get the handle */
+    if (charID == BAREBOTPROFILE_SPEEDUPDATE)
+        req.handle = speedUpdateCharHandle;
+    else if (charID == BAREBOTPROFILE_TURNUPDATE)
+        req.handle = turnUpdateCharHandle;
+    else
+        return (false);
+
+    /* build the value - increment followed by the sequence number */
+    method = streamCommands ? ATT_WRITE_CMD : ATT_WRITE_REQ;
+    req.len = BAREBOTPROFILE_SPEEDUPDATE_LEN + BAREBOTPROFILE_UPDATE_SEQ_LEN;
+    req.pValue = GATT_bm_alloc(curr_conn_handle, method, req.len, NULL);
+    if (req.pValue == NULL)
+    {
+        cmdsNotSent++;
+        cmdSeq++;
+        return (false);
+    }
+    req.pValue[0] = LO_UINT16(increment);
+    req.pValue[1] = HI_UINT16(increment);
+    req.pValue[2] = cmdSeq++;
+
+    /* not signed */
+    req.sig = FALSE;
+
+    /* send it, the stack only frees the value if it is sent */
+    if (streamCommands)
+    {
+        req.cmd = TRUE;
+        status = GATT_WriteNoRsp(curr_conn_handle, &req);
+    }
+    else
+    {
+        req.cmd = FALSE;
+        status = GATT_WriteCharValue(curr_conn_handle, &req, centralEntity);
+    }
+    if (status != SUCCESS)
+    {
+        GATT_bm_free((gattMsg_t*) &req, method);
+        cmdsNotSent++;
+    }
+
+    return (status == SUCCESS);
+}
+
+/*
+ BarebotCentral_setStreaming(bool)
+
+ Description:       This function turns streaming of update commands on or
+                    off.  When streaming, update commands are sent without
+                    waiting for a response.
+
+ Arguments:         streaming (bool) - TRUE to stream update commands.
+ Return Value:      None.
  Exceptions:        None.
 
  Inputs:            None.
@@ -1057,50 +2663,267 @@ bcReadRsp_t BarebotCentral_read(uint8_t charID)
  Algorithms:        None.
  Data Structures:   None.
 
- Revision History:  3/15/24  Adam Krivka      initial revision
+ Revision History:  4/10/24  Adam Krivka      initial revision
  */
-bool BarebotCentral_write(uint8 charID, uint8 *newValue)
+void BarebotCentral_setStreaming(bool streaming)
+{
+    streamCommands = streaming;
+}
+
+/*
+ BarebotCentral_startHandleCheck(uint8_t *)
+
+ Description:      This function starts finding the characteristic handles
+ for a new connection.  It is called when the link is
+ established.
+
+ Operation:        The handles from the last connection are forgotten and
+ the server's GATT Database Hash is read.  When it arrives
+ it is compared with the hash saved with the handles for
+ this peer (see BarebotCentral_checkDbHash).  If the hash
+ can't be read (or the handle cache is disabled) the
+ handles are discovered.
+
+ Arguments:        peerAddr (uint8_t *) - address of the peer.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          A read by type request is sent to the server.
+
+ Error Handling:   If the hash read can't be sent the handles are
+ discovered.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/16/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_startHandleCheck(uint8_t *peerAddr)
 {
     /* variables */
-    attWriteReq_t req; /* write request struct */
+    attReadByTypeReq_t req; /* request for the database hash */
+
+    /* forget the handles from the last connection */
+    speedCharHandle = 0;
+    turnCharHandle = 0;
+    speedUpdateCharHandle = 0;
+    turnUpdateCharHandle = 0;
+    thoughtsCharHandle = 0;
+    stateCharHandle = 0;
+
+    /* start a new record for this peer */
+    memcpy(handleRecord.peerAddr, peerAddr, B_ADDR_LEN);
+    dbHashValid = FALSE;
+
+    /* set state to discovering characteristics */
+    BarebotCentral_setState(BC_STATE_DISC_CHARS);
+
+#if BC_USE_HANDLE_CACHE
+    /* read the database hash (anywhere in the database) */
+    req.startHandle = 0x0001;
+    req.endHandle = 0xFFFF;
+    req.type.len = ATT_BT_UUID_SIZE;
+    req.type.uuid[0] = LO_UINT16(BC_DB_HASH_UUID);
+    req.type.uuid[1] = HI_UINT16(BC_DB_HASH_UUID);
+    if (GATT_ReadUsingCharUUID(curr_conn_handle, &req, centralEntity)
+            == SUCCESS)
+    {
+        /* wait for the hash */
+        readingDbHash = TRUE;
+        return;
+    }
+#endif
 
-    /* get handle and length */
-    switch (charID)
+    /* can't check saved handles, discover them */
+    BarebotCentral_startDiscovery();
+
+    return;
+}
+
+/*
+ BarebotCentral_checkDbHash(uint8_t *)
+
+ Description:      This function checks the server's database hash against
+ the hash saved with the handles for the peer and uses the
+ saved handles if they match.
+
+ Operation:        The saved records are searched for the peer's address.
+ If one is found and its hash matches, the database hasn't
+ changed since the handles were discovered, so they are
+ used and the central is ready without discovery.
+ Otherwise the hash is kept to be saved with the handles
+ and discovery is started.  The record is later saved in
+ the peer's old slot, a free slot, or the next slot in
+ turn, in that order of preference.
+
+ Arguments:        pHash (uint8_t *) - the server's database hash.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           The saved handle records are read from SNV.
+ Outputs:          None.
+
+ Error Handling:   Records that can't be read are treated as free.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/16/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_checkDbHash(uint8_t *pHash)
+{
+    /* variables */
+    bcHandleRecord_t saved; /* a saved record */
+    bool haveFree = FALSE; /* whether a free slot was found */
+    uint8_t i; /* loop index */
+
+    /* keep the hash to save with the handles */
+    memcpy(handleRecord.dbHash, pHash, BC_DB_HASH_LEN);
+    dbHashValid = TRUE;
+
+    /* replace the next record in turn unless a better slot is found */
+    handleSlot = nextHandleRecord;
+
+    /* look for this peer in the saved records */
+    for (i = 0; i < BC_NUM_HANDLE_RECORDS; i++)
     {
-    case BAREBOTPROFILE_SPEED:
-        req.handle = speedCharHandle;
-        req.len = BAREBOTPROFILE_SPEED_LEN;
-        break;
-    case BAREBOTPROFILE_TURN:
-        req.handle = turnCharHandle;
-        req.len = BAREBOTPROFILE_TURN_LEN;
-        break;
-    case BAREBOTPROFILE_SPEEDUPDATE:
-        req.handle = speedUpdateCharHandle;
-        req.len = BAREBOTPROFILE_SPEEDUPDATE_LEN;
-        break;
-    case BAREBOTPROFILE_TURNUPDATE:
-        req.handle = turnUpdateCharHandle;
-        req.len = BAREBOTPROFILE_TURNUPDATE_LEN;
-        break;
-    case BAREBOTPROFILE_THOUGHTS:
-        req.handle = thoughtsCharHandle;
-        req.len = BAREBOTPROFILE_THOUGHTS_LEN;
-        break;
+        if (osal_snv_read(BC_HANDLE_NVID_START + i, sizeof(bcHandleRecord_t),
+                          &saved) != SUCCESS)
+        {
+            /* nothing saved here, use it if the peer isn't found */
+            if (!haveFree)
+                handleSlot = i;
+            haveFree = TRUE;
+        }
+        else if (memcmp(saved.peerAddr, handleRecord.peerAddr, B_ADDR_LEN)
+                == 0)
+        {
+            /* found the peer, new handles replace these */
+            handleSlot = i;
+
+            /* if the database hasn't changed the handles are still good */
+            if (memcmp(saved.dbHash, pHash, BC_DB_HASH_LEN) == 0)
+            {
+                barebotProfileServiceStartHandle = saved.svcStartHandle;
+                barebotProfileServiceEndHandle = saved.svcEndHandle;
+                speedCharHandle = saved.speedHandle;
+                turnCharHandle = saved.turnHandle;
+                speedUpdateCharHandle = saved.speedUpdateHandle;
+                turnUpdateCharHandle = saved.turnUpdateHandle;
+                thoughtsCharHandle = saved.thoughtsHandle;
+                stateCharHandle = saved.stateHandle;
+
+                /* nothing to save, ready to go */
+                dbHashValid = FALSE;
+                BarebotCentral_setState(BC_STATE_READY);
+                return;
+            }
+            break;
+        }
     }
 
-    /* allocate data with GATT specific function */
-    req.pValue = GATT_bm_alloc(curr_conn_handle, ATT_WRITE_REQ, 1, NULL);
-    memcpy(req.pValue, newValue, req.len);
+    /* no usable saved handles, discover them */
+    BarebotCentral_startDiscovery();
+
+    return;
+}
+
+/*
+ BarebotCentral_startDiscovery()
+
+ Description:      This function starts discovering the characteristic
+ handles of the barebot profile.
+
+ Operation:        All characteristics in the barebot profile service are
+ discovered.  The responses are handled in
+ BarebotCentral_processGattMessage.
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          A discovery request is sent to the server.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/16/24  Adam Krivka      initial revision (moved from
+                                             the link established event)
+ */
+static void BarebotCentral_startDiscovery(void)
+{
+    /* discover barebot profile service */
+    //GATT_DiscPrimaryServiceByUUID(curr_conn_handle,
+    //                              &barebotProfileServUUID, 2,
+    //                              selfEntity);
+    //Display(0, 0, "Disc service", 16);
+    /* service discovery doesn't work well, hardcode start and end handles for now */
+    barebotProfileServiceStartHandle = 0x020;
+    barebotProfileServiceEndHandle = 0xFFFF;
+
+    /* discover all characteristics */
+    GATT_DiscAllChars(curr_conn_handle, barebotProfileServiceStartHandle,
+                      barebotProfileServiceEndHandle, centralEntity);
+
+    return;
+}
+
+/*
+ BarebotCentral_saveHandles()
+
+ Description:      This function saves the discovered handles for the peer
+ in SNV so they can be used on the next connection.
+
+ Operation:        If the database hash was read for this connection the
+ handles are stored with it in the record slot chosen by
+ BarebotCentral_checkDbHash.
 
-    /* no signature or command (not really sure what they do) */
-    req.sig = 0;
-    req.cmd = 0;
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          The handle record is written to SNV.
+
+ Error Handling:   Without a database hash the handles are not saved (they
+ couldn't be checked later).  A failed write is ignored (the
+ handles are discovered again next time).
+
+ Algorithms:       None.
+ Data Structures:  None.
 
-    /* send write request */
-    BC_VERIFY(GATT_WriteCharValue(curr_conn_handle, &req, centralEntity));
+ Revision History: 4/16/24  Adam Krivka      initial revision
+ */
+static void BarebotCentral_saveHandles(void)
+{
+#if BC_USE_HANDLE_CACHE
+    /* only handles that can be checked are saved */
+    if (!dbHashValid)
+        return;
+    dbHashValid = FALSE;
+
+    /* fill in the handles */
+    handleRecord.svcStartHandle = barebotProfileServiceStartHandle;
+    handleRecord.svcEndHandle = barebotProfileServiceEndHandle;
+    handleRecord.speedHandle = speedCharHandle;
+    handleRecord.turnHandle = turnCharHandle;
+    handleRecord.speedUpdateHandle = speedUpdateCharHandle;
+    handleRecord.turnUpdateHandle = turnUpdateCharHandle;
+    handleRecord.thoughtsHandle = thoughtsCharHandle;
+    handleRecord.stateHandle = stateCharHandle;
+
+    /* save it, moving on to the next slot if this one was taken in turn */
+    if ((osal_snv_write(BC_HANDLE_NVID_START + handleSlot,
+                        sizeof(bcHandleRecord_t), &handleRecord) == SUCCESS)
+            && (handleSlot == nextHandleRecord))
+        nextHandleRecord = (nextHandleRecord + 1) % BC_NUM_HANDLE_RECORDS;
+#endif
 
-    return (true);
+    return;
 }
 
 /*
@@ -1154,6 +2977,211 @@ uint8 BarebotCentral_getState()
     return centralState;
 }
 
+/*
+ BarebotCentral_getMissedStates(void)
+
+ Description:       This function gets the number of robot state
+                    notifications missed on the current connection.
+
+ Operation:         The function returns the count of gaps in the state
+                    notification sequence numbers since the connection was
+                    established.
+
+ Arguments:         None.
+ Return Value:      (uint32_t) - number of missed state notifications.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  5/18/24  Adam Krivka      initial revision
+ */
+uint32_t BarebotCentral_getMissedStates(void)
+{
+    return missedStates;
+}
+
+/*
+ BarebotCentral_getWriteErrors(void)
+
+ Description:       This function gets the number of writes the server
+                    refused (answered with an error response).
+
+ Operation:         The function returns the count of write error responses
+                    since the central was started.
+
+ Arguments:         None.
+ Return Value:      (uint32_t) - number of refused writes.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  5/18/24  Adam Krivka      initial revision
+ */
+uint32_t BarebotCentral_getWriteErrors(void)
+{
+    return writeErrors;
+}
+
+/*
+ BarebotCentral_getPoolStats(msgPoolStats_t *)
+
+ Description:       This function returns a copy of the usage statistics
+                    (in use, high-water mark, and allocation failures) of the
+                    event message pool.
+
+ Operation:         The statistics are read from the pool.  If the pool is
+                    not being used (BC_USE_MSG_POOL is zero) the statistics
+                    are all returned as zero.
+
+ Arguments:         pStats (msgPoolStats_t *) - where to store the statistics.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/4/24   Adam Krivka      initial revision
+ */
+void BarebotCentral_getPoolStats(msgPoolStats_t *pStats)
+{
+#if BC_USE_MSG_POOL
+    /* get the statistics from the pool */
+    MsgPool_getStats(&evtPool, pStats);
+#else
+    /* no pool, no statistics */
+    memset(pStats, 0, sizeof(msgPoolStats_t));
+#endif
+}
+
+/*
+ BarebotCentral_getScanStats(bcScanStats_t *)
+
+ Description:       This function returns a copy of the advertising report
+                    pre-filter statistics.
+
+ Operation:         The statistics are copied with interrupts disabled so the
+                    copy is consistent.
+
+ Arguments:         pStats (bcScanStats_t *) - where to store the statistics.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/18/24  Adam Krivka      initial revision
+ */
+void BarebotCentral_getScanStats(bcScanStats_t *pStats)
+{
+    /* variables */
+    UInt key; /* interrupt state to restore */
+
+    /* copy the statistics atomically */
+    key = Hwi_disable();
+    *pStats = scanStats;
+    Hwi_restore(key);
+}
+
+/*
+ BarebotCentral_noteActivity()
+
+ Description:       This function lets the central know the user is active
+                    (pressed a key).  The link is kept in the active mode
+                    (short connection interval) for BC_IDLE_TIMEOUT_MS after
+                    the last activity.
+
+ Operation:         The time of the activity is recorded.  If the link is
+                    not in the active mode a message is queued so the
+                    central task runs the connection parameter policy right
+                    away.
+
+ Arguments:         None.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    If the message can't be queued the policy runs on the
+                    next policy tick.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/20/24  Adam Krivka      initial revision
+ */
+void BarebotCentral_noteActivity(void)
+{
+    /* variables */
+    bpEvtData_t data; /* message data (none) */
+
+    /* remember when */
+    lastActivityTick = Clock_getTicks();
+
+    /* speed up the link now if it is idle */
+    if (connModeWanted != BC_CONN_MODE_ACTIVE)
+    {
+        data.pData = NULL;
+        BarebotCentral_enqueueMsg(BC_EVT_CONN_ACTIVITY, data);
+    }
+}
+
+/*
+ BarebotCentral_getConnStats(bcConnStats_t *)
+
+ Description:       This function returns a copy of the connection parameter
+                    policy statistics.
+
+ Operation:         The statistics are copied with interrupts disabled so the
+                    copy is consistent.
+
+ Arguments:         pStats (bcConnStats_t *) - where to store the statistics.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    None.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/20/24  Adam Krivka      initial revision
+ */
+void BarebotCentral_getConnStats(bcConnStats_t *pStats)
+{
+    /* variables */
+    UInt key; /* interrupt state to restore */
+
+    /* copy the statistics atomically */
+    key = Hwi_disable();
+    *pStats = connStats;
+    Hwi_restore(key);
+}
+
 /*
  BarebotCentral_spin()
 
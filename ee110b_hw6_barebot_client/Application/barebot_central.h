@@ -15,6 +15,13 @@
 
    Revision History:
       3/10/22  Glen George       initial revision
+      4/4/24   Adam Krivka       added message pool configuration
+      4/12/24  Adam Krivka       added the asynchronous read table
+      4/14/24  Adam Krivka       added the characteristic value cache
+      4/16/24  Adam Krivka       added the persistent handle cache
+      4/18/24  Adam Krivka       added the advertising report pre-filter
+      4/20/24  Adam Krivka       added the connection parameter policy
+      5/18/24  Adam Krivka       read callback argument is pointer sized
 */
 
 
@@ -30,6 +37,7 @@
 
 /* local include files */
 #include "barebot_central_intf.h"
+#include "barebot_server_constants.h"
 
 
 
@@ -44,6 +52,49 @@
     #define  BC_TASK_STACK_SIZE    1024
 #endif
 
+/* queued messages come from a fixed-size pool (1) or the ICall heap (0) */
+#ifndef BC_USE_MSG_POOL
+    #define  BC_USE_MSG_POOL       1
+#endif
+
+/* number of bpEvt_t messages in the pool */
+#define  BC_EVT_POOL_SIZE          16
+
+/* asynchronous reads */
+#define  BC_MAX_READS              4     /* reads that can be outstanding */
+#define  BC_READ_TIMEOUT_MS        500   /* timeout for blocking reads */
+#define  BC_READ_TICK_MS           50    /* period of the timeout check */
+
+/* states of a read table entry */
+#define  BC_READ_FREE              0     /* done, waiting to be removed */
+#define  BC_READ_QUEUED            1     /* waiting to be sent */
+#define  BC_READ_SENT              2     /* sent, waiting for the response */
+
+/* characteristic value cache */
+#define  BC_CACHE_SIZE             4     /* characteristics that are cached */
+#define  BC_CACHE_VALUE_LEN        BAREBOTPROFILE_THOUGHTS_LEN  /* longest */
+#define  BC_CACHE_NONE             0xFF  /* no characteristic */
+
+/* how long cached values are fresh - notified values are kept up to date */
+/*    by the server so they are only re-read once in a long while in case */
+/*    a notification was missed */
+#define  BC_CACHE_NOTIFIED_AGE_MS  30000
+#define  BC_CACHE_READ_AGE_MS      2000
+
+/* discovered handles are saved in SNV (1) or discovered every time (0) */
+#ifndef BC_USE_HANDLE_CACHE
+    #define  BC_USE_HANDLE_CACHE   1
+#endif
+
+/* saved handle records - one SNV item per peer */
+#define  BC_HANDLE_NVID_START      BLE_NVID_CUST_START
+#define  BC_NUM_HANDLE_RECORDS     2
+
+/* GATT Database Hash characteristic (changes whenever the server's */
+/*    database does) */
+#define  BC_DB_HASH_UUID           0x2B2A
+#define  BC_DB_HASH_LEN            16
+
 
 /* application events */
 #define  BC_EVT_ADV_REPORT          1
@@ -51,6 +102,10 @@
 #define  BC_EVT_SCAN_PRD_ENDED      3
 #define  BC_EVT_INSUFFICIENT_MEM    4
 #define  BC_EVT_SVC_DISCOVERED      5
+#define  BC_EVT_READ_REQ            6
+#define  BC_EVT_READ_TICK           7
+#define  BC_EVT_CONN_TICK           8
+#define  BC_EVT_CONN_ACTIVITY       9
 
 /* only system events are the ICALL message and queue events */
 #define  BC_ALL_EVENTS            ( ICALL_MSG_EVENT_ID  |  UTIL_QUEUE_EVENT_ID )
@@ -63,8 +118,41 @@
 
 #define DEVICE_NAME_MAX_LENGTH      20
 
+/* advertising report pre-filter */
+#define BC_SCAN_ALLOW_LIST_SIZE     4       /* addresses always forwarded */
+#define BC_SERVER_NAME_LEN          (sizeof(BAREBOT_SERVER_LOCAL_NAME) - 1)
+#define BC_NAME_HASH_INIT           2166136261UL    /* FNV-1a constants */
+#define BC_NAME_HASH_PRIME          16777619UL
+
+/* connection parameter policy - short interval while driving, long */
+/*    interval with peripheral latency while idle */
+/*    (intervals in 1.25 ms units, supervision timeout in 10 ms units) */
+#define BC_CONN_MODE_NONE           0
+#define BC_CONN_MODE_ACTIVE         1
+#define BC_CONN_MODE_IDLE           2
+
+#define BC_ACTIVE_INT_MIN           6       /* 7.5 ms */
+#define BC_ACTIVE_INT_MAX           12      /* 15 ms */
+#define BC_ACTIVE_LATENCY           0
+#define BC_IDLE_INT_MIN             80      /* 100 ms */
+#define BC_IDLE_INT_MAX             160     /* 200 ms */
+#define BC_IDLE_LATENCY             4
+#define BC_CONN_SUPERVISION_TIMEOUT 400     /* 4 s */
+
+/* time without keys (and with the robot stopped) before going idle */
+#ifndef BC_IDLE_TIMEOUT_MS
+    #define BC_IDLE_TIMEOUT_MS      5000
+#endif
+
+#define BC_CONN_TICK_MS             250     /* policy check period */
+#define BC_CONN_RETRY_MS            1000    /* wait before a retry */
+#define BC_CONN_MAX_RETRIES         3       /* retries of a failed update */
+
 /* macros */
 
+/* convert a time in ms to Clock ticks */
+#define BC_MS_TO_TICKS(ms)  (((ms) * 1000) / Clock_tickPeriod)
+
 /* spin if the function is not successful (return is not SUCCESS) */
 #define BC_VERIFY(expr)   \
     if ((expr) != SUCCESS)  \
@@ -98,6 +186,41 @@ typedef  struct  {
              void      *pBuf;           /* event data */
          }  bpGapAdvEventData_t;
 
+/* an asynchronous read in the read table */
+typedef  struct  {
+             uint8_t      state;        /* BC_READ_FREE, _QUEUED, or _SENT */
+             uint8_t      reqID;        /* request ID given to the caller */
+             uint8_t      charID;       /* characteristic being read */
+             uint16_t     handle;       /* handle of the characteristic */
+             bcReadCb_t   pfnCb;        /* completion callback */
+             uintptr_t    arg;          /* argument for the callback */
+             uint32_t     deadline;     /* Clock tick the read times out at */
+         }  bcReadEntry_t;
+
+/* a cached characteristic value */
+typedef  struct  {
+             uint8_t      charID;       /* characteristic that is cached */
+             uint32_t     maxAgeMs;     /* how long a value stays fresh */
+             bool         valid;        /* whether value holds a value */
+             uint16_t     len;          /* length of the value */
+             uint32_t     timestamp;    /* Clock tick the value was stored */
+             uint8_t      value[BC_CACHE_VALUE_LEN];  /* the value */
+         }  bcCacheEntry_t;
+
+/* discovered handles for a peer, saved in SNV */
+typedef  struct  {
+             uint8_t      peerAddr[B_ADDR_LEN];    /* peer address */
+             uint8_t      dbHash[BC_DB_HASH_LEN];  /* its database hash */
+             uint16_t     svcStartHandle;   /* barebot profile service */
+             uint16_t     svcEndHandle;
+             uint16_t     speedHandle;      /* characteristic values */
+             uint16_t     turnHandle;
+             uint16_t     speedUpdateHandle;
+             uint16_t     turnUpdateHandle;
+             uint16_t     thoughtsHandle;
+             uint16_t     stateHandle;
+         }  bcHandleRecord_t;
+
 /* reverse-engineered ATT response structs*/
 /* need to pack structs to match memory layout exactly */
 #pragma pack(1)
@@ -144,6 +267,38 @@ static void      BarebotCentral_processAppMsg(bpEvt_t *);
 
 /* local functions - callbacks */
 static void      BarebotCentral_scanCb(uint32_t, void *, uintptr_t);
+static void      BarebotCentral_readClockCb(UArg);
+static void      BarebotCentral_blockingReadCb(bcReadResult_t *, uintptr_t);
+
+/* local functions - asynchronous reads */
+static void      BarebotCentral_sendNextRead(void);
+static void      BarebotCentral_completeRead(bcReadEntry_t *, bStatus_t,
+                                             uint8 *, uint16);
+static void      BarebotCentral_expireReads(bool);
+
+/* local functions - characteristic value cache */
+static bcCacheEntry_t *BarebotCentral_cacheEntry(uint8);
+static void      BarebotCentral_cacheUpdate(uint8, uint8 *, uint16);
+static bool      BarebotCentral_cacheRead(uint8, uint8 *, uint16 *);
+static void      BarebotCentral_cacheInvalidate(void);
+
+/* local functions - handle discovery and the saved handles */
+static void      BarebotCentral_startHandleCheck(uint8_t *);
+static void      BarebotCentral_checkDbHash(uint8_t *);
+static void      BarebotCentral_startDiscovery(void);
+static void      BarebotCentral_saveHandles(void);
+
+/* local functions - advertising report pre-filter */
+static bool      BarebotCentral_filterAdvReport(GapScan_Evt_AdvRpt_t *);
+static uint32_t  BarebotCentral_nameHash(uint8_t *, uint8_t);
+static void      BarebotCentral_allowAddress(uint8_t *);
+
+/* local functions - connection parameter policy */
+static void      BarebotCentral_connClockCb(UArg);
+static void      BarebotCentral_connPolicy(void);
+static void      BarebotCentral_requestConnParams(uint8_t);
+static void      BarebotCentral_connUpdateFailed(void);
+static void      BarebotCentral_setMoving(int16_t);
 
 /* local funtions - utility */
 static bool      BarebotCentral_findDeviceName(uint8_t *, uint16_t, char *, uint8_t);
@@ -21,6 +21,9 @@
        2/18/22  Glen George      initial revision
        3/10/22  Glen George      updated to include BLE stack
     3/15/24  Adam Krivka      change to barebot demo
+    4/24/24  Adam Krivka      LCD writes go through the LCD queue
+    5/18/24  Adam Krivka      formatting timed with LCD_FORMAT_TIMING
+    5/18/24  Adam Krivka      define the ui done initializing event here
 */
 
 
@@ -39,6 +42,7 @@
 /* interface includes */
 #include "cc26x2r/cc26x2r_rtos_intf.h"
 #include "lcd/lcd_rtos_intf.h"
+#include "lcd/lcd_util.h"
 #include "keypad/keypad_rtos_intf.h"
 #include "barebot_central_intf.h"
 #include "barebot_ui_intf.h"
@@ -52,6 +56,15 @@
 // use the default BLE user defined configuration
 icall_userCfg_t  user0Cfg = BLE_USER_CFG;
 
+// ui done initializing event (see barebot_synch.h)
+static Event_Object  uiInitDone;
+Event_Handle  uiInitDoneHandle;
+
+#if LCD_FORMAT_TIMING
+// formatting time (read it with the debugger)
+lcdFormatStats_t  formatStats;
+#endif
+
 
 
 
@@ -88,7 +101,10 @@ int  main(){
     uiInitDoneHandle = Event_construct(&uiInitDone, NULL);
 
     /* initialize hardware */
-    LCDInit();
+    LCDInit_RTOS();
+#if LCD_FORMAT_TIMING
+    Display_measureFormat(&formatStats);    /* time the formatters */
+#endif
     ClearDisplay();
     KeypadInit_RTOS();
 
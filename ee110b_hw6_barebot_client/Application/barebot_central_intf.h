@@ -15,6 +15,15 @@
 
    Revision History:
       3/10/22  Glen George       initial revision
+      4/4/24   Adam Krivka       added message pool statistics
+      4/10/24  Adam Krivka       added update commands and streaming mode
+      4/12/24  Adam Krivka       added asynchronous reads
+      4/14/24  Adam Krivka       reads may be served from the value cache
+      4/18/24  Adam Krivka       added scan statistics
+      4/20/24  Adam Krivka       added the connection parameter policy
+      5/18/24  Adam Krivka       added the missed state notification count
+      5/18/24  Adam Krivka       read callback argument is pointer sized
+      5/18/24  Adam Krivka       added the refused write count
 */
 
 
@@ -28,7 +37,7 @@
     /* none */
 
 /* local include files */
-    /* none */
+#include  "lib/msg_pool.h"
 
 
 
@@ -44,6 +53,9 @@
 #define BC_STATE_ERROR          5
 #define BC_STATE_READY          10
 
+/* request ID returned when a read could not be started */
+#define BC_READ_ID_NONE         0
+
 
 
 /* structures, unions, and typedefs */
@@ -55,6 +67,39 @@ typedef struct
   uint8 *pValue; /* len bytes of read data */
 } bcReadRsp_t;
 
+/* result of an asynchronous read, pValue is only valid in the callback */
+typedef struct
+{
+  uint8 reqID;      /* request ID returned by BarebotCentral_readAsync */
+  uint8 charID;     /* characteristic that was read */
+  bStatus_t status; /* SUCCESS, bleTimeout, bleNotConnected, or FAILURE */
+  uint16 len;       /* length of value */
+  uint8 *pValue;    /* len bytes of read data */
+} bcReadResult_t;
+
+/* advertising report pre-filter statistics */
+typedef struct
+{
+  uint32 reportsSeen;       /* reports received from the stack */
+  uint32 reportsForwarded;  /* reports passed on to the central task */
+  uint32 allowListHits;     /* forwarded because of the address allow list */
+} bcScanStats_t;
+
+/* connection parameter policy statistics */
+typedef struct
+{
+  uint32 requested;  /* parameter updates requested */
+  uint32 accepted;   /* updates that completed successfully */
+  uint32 failed;     /* updates that failed or could not be requested */
+  uint16 interval;   /* current connection interval (1.25 ms units) */
+  uint16 latency;    /* current peripheral latency */
+} bcConnStats_t;
+
+/* read completion callback, called from the central task (or from the */
+/*    caller when the value comes from the cache) */
+/*    it should copy what it needs and queue it to its own task */
+typedef void (*bcReadCb_t)(bcReadResult_t *pResult, uintptr_t arg);
+
 
 
 
@@ -66,10 +111,38 @@ void  BarebotCentral_createTask(void);
 /* get current state of central */
 uint8 BarebotCentral_getState(void);
 
-/* read a characteristic */
+/* get the number of robot state notifications missed on this connection */
+uint32_t BarebotCentral_getMissedStates(void);
+
+/* get the number of writes the server refused */
+uint32_t BarebotCentral_getWriteErrors(void);
+
+/* read a characteristic (blocks until the read completes) */
 bcReadRsp_t BarebotCentral_read(uint8_t charID);
 
+/* start reading a characteristic, returns the request ID */
+uint8 BarebotCentral_readAsync(uint8 charID, bcReadCb_t pfnCb, uintptr_t arg,
+                               uint32 timeoutMs);
+
 /* write a characteristic */
 bool BarebotCentral_write(uint8 charID, uint8 *newValue);
 
+/* send a speed or turn update command */
+bool BarebotCentral_sendCommand(uint8 charID, int16 increment);
+
+/* send update commands without waiting for responses (TRUE) or not */
+void BarebotCentral_setStreaming(bool streaming);
+
+/* get a copy of the message pool statistics */
+void BarebotCentral_getPoolStats(msgPoolStats_t *);
+
+/* get a copy of the advertising report pre-filter statistics */
+void BarebotCentral_getScanStats(bcScanStats_t *);
+
+/* let the central know the user is active (keeps the link fast) */
+void BarebotCentral_noteActivity(void);
+
+/* get a copy of the connection parameter policy statistics */
+void BarebotCentral_getConnStats(bcConnStats_t *);
+
 #endif
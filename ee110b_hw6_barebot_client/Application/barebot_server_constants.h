@@ -13,6 +13,9 @@
 
    Revision History:
       3/15/24 Adam Krivka       initial revision
+      4/8/24  Adam Krivka       added robot state characteristic
+      4/10/24 Adam Krivka       added command sequence numbers
+      5/16/24 Adam Krivka       added the emergency stop state flag
 */
 
 #ifndef  __BAREBOT_SERVER_CONSTANTS_H__
@@ -46,5 +49,28 @@
 #define BAREBOTPROFILE_TURNUPDATE   4
 #define BAREBOTPROFILE_TURNUPDATE_UUID 0xFFF5
 #define BAREBOTPROFILE_TURNUPDATE_LEN  2
+// Update (command) values may have a sequence number byte after the
+// increment so dropped commands can be counted
+#define BAREBOTPROFILE_UPDATE_SEQ_LEN  1
+// Characteristic defines
+#define BAREBOTPROFILE_STATE   5
+#define BAREBOTPROFILE_STATE_UUID 0xFFF6
+#define BAREBOTPROFILE_STATE_LEN  6
+
+// Robot state flags (which values changed since the last state notification)
+#define BP_STATE_SPEED_CHANGED      0x01
+#define BP_STATE_TURN_CHANGED       0x02
+#define BP_STATE_RESET              0x04    // changed by a button on the robot
+#define BP_STATE_STOP               0x08    // emergency stop (long press on the robot)
+
+// Robot state characteristic value - one snapshot of speed and turn
+// (no padding, so it matches the BAREBOTPROFILE_STATE_LEN byte value)
+typedef struct
+{
+  int16_t  speed;     // current speed
+  int16_t  turn;      // current turn
+  uint8_t  seq;       // incremented on every state notification
+  uint8_t  flags;     // BP_STATE_ flags for what changed
+} bpRobotState_t;
 
 #endif
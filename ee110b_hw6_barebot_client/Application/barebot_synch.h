@@ -13,6 +13,7 @@
 
    Revision History:
       3/15/24 Adam Krivka       initial revision
+      5/18/24 Adam Krivka       the event is defined in barebot_central_demo.c
 */
 
 #ifndef __BAREBOT_SYNCH_H__
@@ -22,8 +23,7 @@
 
 #define INIT_ALL_EVENTS 0xffffffff
 
-/* ui done initializing event */
-static Event_Object uiInitDone;
-Event_Handle uiInitDoneHandle;
+/* ui done initializing event (defined in barebot_central_demo.c) */
+extern Event_Handle uiInitDoneHandle;
 
 #endif
@@ -14,7 +14,8 @@
 
    The public functions are:
         BarebotUI_createTask  - create the barebot ui task
-        BarebotUI_uiStateChanged - alert the UI taht the ui state changed
+        BarebotUI_centralStateChanged - alert the UI that the central state
+                                        changed
         BarebotUI_speedChanged - alert the UI that the speed changed
         BarebotUI_turnChanged - alert the UI that the turn changed
 
@@ -22,6 +23,7 @@
         BarebotUI_init - initialize the barebot ui task
         BarebotUI_taskFxn - the main function for the barebot ui task
         BarebotUI_processUIMsg - process a UI message
+        BarebotUI_processKeys - process the key events in the key ring
         BarebotUI_handleKey - handle a key press
         BarebotUI_enqueueMsg - enqueue a message
         BarebotUI_spin - spin if the function is not successful
@@ -29,6 +31,15 @@
 
  Revision History:
     3/15/24  Adam Krivka       initial revision
+    4/10/24  Adam Krivka       arrow keys stream update commands
+    4/12/24  Adam Krivka       screens are filled in by asynchronous reads
+    4/20/24  Adam Krivka       key presses keep the link fast
+    4/26/24  Adam Krivka       numbers shown with the typed display helpers
+    4/30/24  Adam Krivka       long thoughts scroll
+    5/10/24  Adam Krivka       key releases are reported by the keypad
+    5/12/24  Adam Krivka       keys auto-repeat, stale repeats are dropped
+    5/14/24  Adam Krivka       key events go through a lock-free ring
+    5/18/24  Adam Krivka       read callback argument is pointer sized
  */
 
 /* RTOS include files */
@@ -51,12 +62,14 @@
 #include  <string.h>
 
 /* local include files */
+#include "barebot_central_intf.h"
 #include "barebot_ui.h"
 #include "barebot_UI_intf.h"
 #include "barebot_server_constants.h"
 #include "barebot_synch.h"
 #include "lcd/lcd_rtos_intf.h"
 #include "lcd/lcd_util.h"
+#include "lcd/lcd_marquee.h"
 #include "keypad/keypad_rtos_intf.h"
 
 /* shared variables */
@@ -80,6 +93,21 @@ static Queue_Handle uiMsgQueueHandle;
 /* screen state */
 static uint8_t screenState;
 
+/* clock for stepping scrolling text, runs while text is scrolling */
+static Clock_Struct marqueeClock;
+
+/* time from the last key event to handling it, and the longest (ticks) */
+static uint32_t keyLatency = 0;
+static uint32_t keyLatencyMax = 0;
+
+/* key events from the keypad clock to the UI task, written only by */
+/*    KeyPressed (at the tail) and read only by the task (at the head), so */
+/*    no lock is needed, and the events lost because the ring was full */
+static volatile buiKeyEvt_t keyRing[BUI_KEY_RING_SIZE];
+static volatile uint16_t keyRingHead = 0;
+static volatile uint16_t keyRingTail = 0;
+static uint32_t keyRingOverruns = 0;
+
 /* functions */
 
 /*
@@ -163,6 +191,10 @@ static void BarebotUI_init(void)
     /* create an RTOS queue for message from profile to be sent to app */
     uiMsgQueueHandle = Util_constructQueue(&uiMsgQueue);
 
+    /* clock for scrolling text */
+    Util_constructClock(&marqueeClock, BarebotUI_marqueeClockCb,
+                        BUI_MARQUEE_STEP_MS, BUI_MARQUEE_STEP_MS, FALSE, 0);
+
     /* signalize that UI is done initializing */
     Event_post(uiInitDoneHandle, INIT_ALL_EVENTS);
 
@@ -176,7 +208,7 @@ static void BarebotUI_init(void)
  Description:      This function runs the task that implements the Barebot UI.
 
  Operation:        The function loops forever processing messages and events
-                   from the UI queue. 
+                   from the UI queue and key events from the key ring. 
 
  Arguments:        a1 (UArg) - first argument (unused).
  a2 (UArg) - second argument (unused).
@@ -193,6 +225,7 @@ static void BarebotUI_init(void)
 
  Revision History:
     03/15/24  Adam Krivka      initial revision
+    05/14/24  Adam Krivka      key events from the key ring
  */
 static void BarebotUI_taskFxn(UArg a0, UArg a1)
 {
@@ -215,6 +248,10 @@ static void BarebotUI_taskFxn(UArg a0, UArg a1)
         /* if there is an event, process it */
         if (events)
         {
+            /* first handle any key events */
+            if (events & BUI_KEY_EVENT_ID)
+                BarebotUI_processKeys();
+
             /* next check if got an RTOS queue event */
             if (events & UTIL_QUEUE_EVENT_ID)
             {
@@ -265,36 +302,69 @@ static void BarebotUI_taskFxn(UArg a0, UArg a1)
 
  Revision History: 
     03/15/24  Adam Krivka      initial revision
+    04/30/24  Adam Krivka      thoughts scroll on marquee ticks
+    05/12/24  Adam Krivka      key latency measured, stale repeats dropped
+    05/14/24  Adam Krivka      keys moved to BarebotUI_processKeys
  */
 static void BarebotUI_processUIMsg(buiEvt_t *pMsg)
 {
     /* variables */
-    bool dealloc; /* whether should deallocate message data */
+    bool dealloc = FALSE; /* whether should deallocate message data */
+    buiReadValue_t *pRead; /* value from a completed read */
+    uint8_t *pValue; /* bytes of the value read */
 
     /* figure out what to do based on the message/event type */
     switch (pMsg->event)
     {
-    case BUI_EVT_KEY_PRESSED:
-        /* handle the key press */
-        /*                       row                   col */
-        BarebotUI_handleKey(pMsg->data.word >> 8, pMsg->data.word & 0b11111111);
-        break;
     case BUI_EVT_SPEED_CHANGED:
         /* speed value changed, update it */
         if (screenState == BUI_STATE_CONTROL)
         {
-            Display_printf(1, 8, 4, "%d", (int16_t) pMsg->data.hword);
+            Display_int(1, 8, 4, (int16_t) pMsg->data.hword);
         }
         break;
     case BUI_EVT_TURN_CHANGED:
         /* turn value changed, update it */
         if (screenState == BUI_STATE_CONTROL)
         {
-            Display_printf(2, 8, 4, "%d", (int16_t) pMsg->data.hword);
+            Display_int(2, 8, 4, (int16_t) pMsg->data.hword);
+        }
+        break;
+    case BUI_EVT_READ_DONE:
+        /* a read completed, show the value if its screen is still up */
+        pRead = (buiReadValue_t*) pMsg->data.pData;
+        pValue = (uint8_t*) (pRead + 1);
+        if ((screenState == BUI_STATE_CONTROL)
+                && (pRead->charID == BAREBOTPROFILE_SPEED)
+                && (pRead->len >= BAREBOTPROFILE_SPEED_LEN))
+        {
+            Display_labelInt(1, 0, 12, "Speed:  ",
+                             (int16_t) (pValue[0] | (pValue[1] << 8)));
+        }
+        else if ((screenState == BUI_STATE_CONTROL)
+                && (pRead->charID == BAREBOTPROFILE_TURN)
+                && (pRead->len >= BAREBOTPROFILE_TURN_LEN))
+        {
+            Display_labelInt(2, 0, 12, "Turn:   ",
+                             (int16_t) (pValue[0] | (pValue[1] << 8)));
+        }
+        else if ((screenState == BUI_STATE_THOUGHTS)
+                && (pRead->charID == BAREBOTPROFILE_THOUGHTS))
+        {
+            /* scroll the thoughts if they don't fit on the row */
+            MarqueeStart(BUI_THOUGHTS_REGION, 1, 0, 16, (char*) pValue);
+            Util_startClock(&marqueeClock);
         }
+        dealloc = TRUE;
+        break;
+    case BUI_EVT_MARQUEE_TICK:
+        /* move the scrolling text, stop the clock once nothing scrolls */
+        if (!MarqueeStep())
+            Util_stopClock(&marqueeClock);
         break;
     case BUI_EVT_CENTRAL_STATE_CHANGED:
         /* clear display */
+        BarebotUI_stopMarquee();
         ClearDisplay();
 
         /* display state */
@@ -334,6 +404,67 @@ static void BarebotUI_processUIMsg(buiEvt_t *pMsg)
     return;
 }
 
+/*
+ BarebotUI_processKeys()
+
+ Description:      This function processes the key events waiting in the
+                   key ring.
+
+ Operation:        The events are taken from the head of the ring until it
+                   is empty.  The head is only advanced after an event has
+                   been copied out, so KeyPressed never overwrites an event
+                   being read.  For each event the time since the key event
+                   is noted, repeats of the menu keys and repeats older than
+                   BUI_KEY_STALE_MS are dropped, and the key is handled.
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  Single producer, single consumer ring buffer.
+
+ Revision History:
+    05/14/24  Adam Krivka      initial revision
+ */
+static void BarebotUI_processKeys(void)
+{
+    /* variables */
+    uint16_t head = keyRingHead; /* next event to read */
+    uint32_t evt; /* the key event */
+    uint32_t time; /* tick count of the key event */
+
+    /* handle every waiting event */
+    while (head != keyRingTail)
+    {
+        /* copy it out and free its slot */
+        evt = keyRing[head % BUI_KEY_RING_SIZE].evt;
+        time = keyRing[head % BUI_KEY_RING_SIZE].time;
+        keyRingHead = ++head;
+
+        /* note how long the key waited */
+        keyLatency = Clock_getTicks() - time;
+        if (keyLatency > keyLatencyMax)
+            keyLatencyMax = keyLatency;
+
+        /* repeats only move the arrows, and old ones are dropped */
+        if ((evt & KEY_EVT_REPEAT) &&
+            ((KEY_EVT_ROW(evt) == 3) ||
+             (keyLatency > BUI_KEY_STALE_MS * (1000 / Clock_tickPeriod))))
+            continue;
+
+        /* handle the key press */
+        BarebotUI_handleKey(KEY_EVT_ROW(evt), KEY_EVT_COL(evt));
+    }
+
+    return;
+}
+
 /*
  BarebotUI_handleKey(uint8_t row, uint8, col)
 
@@ -341,7 +472,8 @@ static void BarebotUI_processUIMsg(buiEvt_t *pMsg)
 
  Operation:         The function handles the key press based on the current
                     screen state.  The function also handles the menu
-                    buttons.
+                    buttons.  Every key press counts as user activity for
+                    the connection parameter policy.
 
  Arguments:         row (uint8_t) - the row of the key pressed.
                     col (uint8_t) - the column of the key pressed.
@@ -358,16 +490,21 @@ static void BarebotUI_processUIMsg(buiEvt_t *pMsg)
 
  Revision History:
     03/15/24  Adam Krivka      initial revision
+    04/20/24  Adam Krivka      note user activity
  */
 void BarebotUI_handleKey(uint8_t row, uint8_t col)
 {
     /* variables */
     int16_t update;
 
+    /* the user is active, keep the link fast */
+    BarebotCentral_noteActivity();
+
     /* menu buttons */
     if (row == 3)
     {
         /* clear display */
+        BarebotUI_stopMarquee();
         ClearDisplay();
 
         /* menu */
@@ -377,20 +514,18 @@ void BarebotUI_handleKey(uint8_t row, uint8_t col)
             /* change the screen state */
             screenState = BUI_STATE_CONTROL;
 
+            /* arrow keys stream commands without waiting for responses */
+            BarebotCentral_setStreaming(TRUE);
+
             /* display menu title */
             Display(0, 0, "CONTROL", 16);
 
-            /* read current speed and turn values */
-            bcReadRsp_t speedRsp = BarebotUI_read(BAREBOTPROFILE_SPEED);
-            bcReadRsp_t turnRsp = BarebotUI_read(BAREBOTPROFILE_TURN);
-
-            /* display them */
-            Display_printf(1, 0, 12, "Speed:  %d", speedRsp.pValue[0]);
-            Display_printf(2, 0, 12, "Turn:   %d", turnRsp.pValue[0]);
-
-            /* free response data */
-            ICall_free(speedRsp.pValue);
-            ICall_free(turnRsp.pValue);
+            /* read current speed and turn values, both go out back to */
+            /*    back and are displayed when they arrive */
+            BarebotCentral_readAsync(BAREBOTPROFILE_SPEED, BarebotUI_readDone,
+                                     0, BUI_READ_TIMEOUT_MS);
+            BarebotCentral_readAsync(BAREBOTPROFILE_TURN, BarebotUI_readDone,
+                                     0, BUI_READ_TIMEOUT_MS);
 
             return;
         }
@@ -400,18 +535,16 @@ void BarebotUI_handleKey(uint8_t row, uint8_t col)
             /* change the screen state */
             screenState = BUI_STATE_THOUGHTS;
 
+            /* no commands from this screen */
+            BarebotCentral_setStreaming(FALSE);
+
             /* display menu title */
             Display(0, 0, "THOUGHTS", 16);
 
-            /* read current thoughts */
-            bcReadRsp_t thoughtsRsp = BarebotUI_read(
-            BAREBOTPROFILE_THOUGHTS);
-
-            /* display thoughts */
-            Display(1, 0, (char*)thoughtsRsp.pValue, 16);
-
-            /* free response data */
-            ICall_free(thoughtsRsp.pValue);
+            /* read current thoughts, displayed when they arrive */
+            BarebotCentral_readAsync(BAREBOTPROFILE_THOUGHTS,
+                                     BarebotUI_readDone, 0,
+                                     BUI_READ_TIMEOUT_MS);
 
             return;
         }
@@ -425,22 +558,22 @@ void BarebotUI_handleKey(uint8_t row, uint8_t col)
         if (row == 0 && col == 2) /* left */
         {
             update = -1;
-            BarebotUI_write(BAREBOTPROFILE_TURNUPDATE, &update);
+            BarebotCentral_sendCommand(BAREBOTPROFILE_TURNUPDATE, update);
         }
         else if (row == 0 && col == 1) /* down */
         {
             update = -1;
-            BarebotUI_write(BAREBOTPROFILE_SPEEDUPDATE, &update);
+            BarebotCentral_sendCommand(BAREBOTPROFILE_SPEEDUPDATE, update);
         }
         else if (row == 0 && col == 0) /* right */
         {
             update = +1;
-            BarebotUI_write(BAREBOTPROFILE_TURNUPDATE, &update);
+            BarebotCentral_sendCommand(BAREBOTPROFILE_TURNUPDATE, update);
         }
         else if (row == 1 && col == 1) /* up */
         {
             update = +1;
-            BarebotUI_write(BAREBOTPROFILE_SPEEDUPDATE, &update);
+            BarebotCentral_sendCommand(BAREBOTPROFILE_SPEEDUPDATE, update);
         }
         break;
     case BUI_STATE_THOUGHTS:
@@ -452,13 +585,68 @@ void BarebotUI_handleKey(uint8_t row, uint8_t col)
 /* message queing */
 
 /*
- KeyPressed(uint32_t keyEvt)
+ KeyPressed(uint32_t keyEvt, uint32_t time)
+
+ Description:       This function is called from the keypad clock when a
+                    key is pressed or repeats.
+ Operation:         The event and its time are put at the tail of the key
+                    ring and the UI task is woken up.  Nothing is allocated
+                    and nothing is locked: only this function writes the
+                    tail and only the task writes the head.  The event is
+                    written before the tail is advanced, so the task never
+                    sees a half written event.  If the ring is full the event
+                    is dropped and counted as an overrun.
 
- Description:       This function is called when a key is pressed.
- Operation:         The function creates a message and puts it into the
-                    UI queue.
+ Arguments:         keyEvt (uint32_t) - the key event.
+                    time (uint32_t) - tick count of the key event.
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    Events that don't fit in the ring are counted in
+                    keyRingOverruns.
+
+ Algorithms:        None.
+ Data Structures:   Single producer, single consumer ring buffer.
+
+ Revision History:
+    03/15/24  Adam Krivka      initial revision
+    05/12/24  Adam Krivka      events are timestamped
+    05/14/24  Adam Krivka      events go in the key ring
+ */
+void KeyPressed(uint32_t keyEvt, uint32_t time)
+{
+    uint16_t tail = keyRingTail; /* where the event goes */
+
+    /* drop it if the ring is full */
+    if ((uint16_t)(tail - keyRingHead) >= BUI_KEY_RING_SIZE)
+    {
+        keyRingOverruns++;
+        return;
+    }
+
+    /* add it, then let the task see it */
+    keyRing[tail % BUI_KEY_RING_SIZE].evt = keyEvt;
+    keyRing[tail % BUI_KEY_RING_SIZE].time = time;
+    keyRingTail = tail + 1;
+    if (syncEvent != NULL)
+        Event_post(syncEvent, BUI_KEY_EVENT_ID);
+
+    return;
+}
+
+/*
+ KeyReleased(uint32_t keyEvt, uint32_t time)
+
+ Description:       This function is called when a key is released.  Every
+                    key is debounced on its own, so other keys may still be
+                    down (and keep working) when one is released.
+ Operation:         The UI only acts on key presses, so nothing is done.
 
  Arguments:         keyEvt (uint32_t) - the key event.
+                    time (uint32_t) - tick count of the key event.
  Return Value:      None.
  Exceptions:        None.
 
@@ -471,13 +659,11 @@ void BarebotUI_handleKey(uint8_t row, uint8_t col)
  Data Structures:   None.
 
  Revision History:
-    03/15/24  Adam Krivka      initial revision
+    05/10/24  Adam Krivka      initial revision
+    05/12/24  Adam Krivka      events are timestamped
  */
-void KeyPressed(uint32_t keyEvt)
+void KeyReleased(uint32_t keyEvt, uint32_t time)
 {
-    buiEvtData_t data;
-    data.word = keyEvt;
-    BarebotUI_enqueueMsg(BUI_EVT_KEY_PRESSED, data);
     return;
 }
 
@@ -571,8 +757,130 @@ void BarebotUI_turnChanged(int16 newTurn)
     BarebotUI_enqueueMsg(BUI_EVT_TURN_CHANGED, data);
 }
 
+/*
+ BarebotUI_readDone(bcReadResult_t *, uintptr_t)
+
+ Description:       This function is the completion callback for the reads
+                    the UI starts.  It is called from the central task.
+
+ Operation:         The value is copied into newly allocated memory which is
+                    sent to the UI task in a BUI_EVT_READ_DONE message.  The
+                    value is NUL terminated so strings can be displayed
+                    directly.
+
+ Arguments:         pResult (bcReadResult_t *) - result of the read.
+                    arg (uintptr_t) - callback argument (unused).
+ Return Value:      None.
+ Exceptions:        None.
+
+ Inputs:            None.
+ Outputs:           None.
+
+ Error Handling:    Failed reads are ignored (the screen keeps its old
+                    contents).  If memory can't be allocated or the message
+                    can't be queued the value is dropped.
+
+ Algorithms:        None.
+ Data Structures:   None.
+
+ Revision History:  4/12/24  Adam Krivka      initial revision
+ */
+static void BarebotUI_readDone(bcReadResult_t *pResult, uintptr_t arg)
+{
+    /* variables */
+    buiReadValue_t *pRead; /* copy of the value for the UI task */
+    buiEvtData_t data; /* message data */
+
+    /* nothing to show if the read failed */
+    if (pResult->status != SUCCESS)
+        return;
+
+    /* copy the value (followed by a NUL) */
+    pRead = ICall_malloc(sizeof(buiReadValue_t) + pResult->len + 1);
+    if (pRead == NULL)
+        return;
+    pRead->charID = pResult->charID;
+    pRead->len = pResult->len;
+    memcpy(pRead + 1, pResult->pValue, pResult->len);
+    ((uint8_t*) (pRead + 1))[pResult->len] = '\0';
+
+    /* send it to the UI task */
+    data.pData = pRead;
+    if (BarebotUI_enqueueMsg(BUI_EVT_READ_DONE, data) != SUCCESS)
+        ICall_free(pRead);
+}
+
 /* helper functions */
 
+/*
+ BarebotUI_marqueeClockCb(UArg)
+
+ Description:      This function is the callback for the marquee clock.  It
+ is called every BUI_MARQUEE_STEP_MS while text is
+ scrolling.
+
+ Operation:        The clock callback runs in a Swi, so a message is queued
+ for the UI task which then steps the marquee (the display
+ is only written from the UI task).
+
+ Arguments:        arg (UArg) - clock argument (unused).
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   If the message can't be queued the step is skipped.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/30/24  Adam Krivka      initial revision
+ */
+static void BarebotUI_marqueeClockCb(UArg arg)
+{
+    /* variables */
+    buiEvtData_t data; /* message data (none) */
+
+    /* let the UI task step the marquee */
+    data.pData = NULL;
+    BarebotUI_enqueueMsg(BUI_EVT_MARQUEE_TICK, data);
+
+    return;
+}
+
+/*
+ BarebotUI_stopMarquee()
+
+ Description:      This function stops all scrolling text.  It is called
+ when the screen is cleared.
+
+ Operation:        The marquee regions are stopped and the marquee clock is
+ stopped.
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/30/24  Adam Krivka      initial revision
+ */
+static void BarebotUI_stopMarquee(void)
+{
+    /* stop the regions and the clock */
+    MarqueeStopAll();
+    Util_stopClock(&marqueeClock);
+
+    return;
+}
+
 
 /*
  BarebotUI_enqueueMsg(uint8_t, buiEvtData_t)
@@ -15,6 +15,11 @@
 
    Revision History:
         3/15/24 Adam Krivka       initial revision  
+        4/12/24 Adam Krivka       added read done event
+        4/30/24 Adam Krivka       added marquee tick event
+        5/12/24 Adam Krivka       messages carry a tick count
+        5/14/24 Adam Krivka       key events go through a ring, not messages
+        5/18/24 Adam Krivka       read callback argument is pointer sized
 */
 
 
@@ -42,19 +47,39 @@
     #define  BUI_TASK_STACK_SIZE    1024
 #endif
 
+/* time allowed for reading a value for the screen */
+#define  BUI_READ_TIMEOUT_MS        1000
+
+/* time between steps of scrolling text and the marquee region for the */
+/*    thoughts */
+#define  BUI_MARQUEE_STEP_MS        300
+#define  BUI_THOUGHTS_REGION        0
+
+/* oldest a key repeat can be and still be acted on (older repeats are */
+/*    dropped so they don't pile up while the UI is busy) */
+#define  BUI_KEY_STALE_MS           100
+
+/* key events that can wait for the UI task (power of 2) */
+#define  BUI_KEY_RING_SIZE          16
+
 
 /* UI events */
-#define  BUI_EVT_KEY_PRESSED            1
 #define  BUI_EVT_CENTRAL_STATE_CHANGED  2
 #define  BUI_EVT_SPEED_CHANGED          3
 #define  BUI_EVT_TURN_CHANGED           4
+#define  BUI_EVT_READ_DONE              5
+#define  BUI_EVT_MARQUEE_TICK           6
 
 /* UI states */
 #define BUI_STATE_CONTROL           1
 #define BUI_STATE_THOUGHTS          2
 
-/* only system events are the ICALL message and queue events */
-#define  BUI_ALL_EVENTS            ( ICALL_MSG_EVENT_ID  |  UTIL_QUEUE_EVENT_ID )
+/* event posted when key events are put in the key ring */
+#define  BUI_KEY_EVENT_ID          Event_Id_00
+
+/* system events are the ICALL message and queue events, plus the key ring */
+#define  BUI_ALL_EVENTS            ( ICALL_MSG_EVENT_ID  |  UTIL_QUEUE_EVENT_ID  |  \
+                                     BUI_KEY_EVENT_ID )
 
 
 /* macros */
@@ -86,6 +111,21 @@ typedef  struct  {
          }  buiEvt_t;
 
 
+/* key event in the key ring - the event from the keypad and its time */
+typedef  struct  {
+             uint32_t      evt;          /* key event [FLAGS][ROW][COLUMN] */
+             uint32_t      time;         /* tick count of the key event */
+         }  buiKeyEvt_t;
+
+
+/* value from a completed read - followed by the len bytes of the value */
+/*    and a terminating NUL */
+typedef  struct  {
+             uint8_t      charID;       /* characteristic that was read */
+             uint16_t     len;          /* length of the value */
+         }  buiReadValue_t;
+
+
 
 /* function declarations */
 
@@ -95,13 +135,17 @@ static void      BarebotUI_taskFxn(UArg, UArg);
 
 /* local functions - message and event processing */
 static void      BarebotUI_processUIMsg(buiEvt_t *);
+static void      BarebotUI_processKeys(void);
 void             BarebotUI_handleKey(uint8_t row, uint8_t col);
 
 /* local functions - callbacks */
+static void      BarebotUI_readDone(bcReadResult_t *, uintptr_t);
+static void      BarebotUI_marqueeClockCb(UArg);
 
 /* local funtions - utility */
 
 static status_t  BarebotUI_enqueueMsg(uint8_t, buiEvtData_t);
+static void      BarebotUI_stopMarquee(void);
 static void      BarebotUI_spin(void);
 
 
@@ -14,6 +14,8 @@
 
    Revision History:
       3/15/24 Adam Krivka       initial revision
+      5/18/24 Adam Krivka       declare BarebotUI_centralStateChanged (the
+                                function the central calls)
 */
 
 
@@ -50,8 +52,8 @@
 /* create the barebot ui task */
 void  BarebotUI_createTask(void);
 
-/* alert the UI taht the ui state changed */
-void  BarebotUI_uiStateChanged(uint8 newState);
+/* alert the UI that the central state changed */
+void  BarebotUI_centralStateChanged(uint8 newState);
 void  BarebotUI_speedChanged(int16 newSpeed);
 void  BarebotUI_turnChanged(int16 newTurn);
 
@@ -7,35 +7,64 @@
 
 ; This file contains the code for the keypad driver. It is responsible for
 ; scanning the keypad and debouncing the keys. It is also responsible for
-; generating events when keys are pressed and released.
+; generating events when keys are pressed and released.  The keys are
+; debounced by the shared debounce engine (lib/debounce.s): every sweep of
+; the rows is passed to it as a sample with one bit per key, and it calls
+; KeypadDebounceEvent for every key that changes.  The debounce engine must
+; be set up with an input per key by the caller (see keypad_rtos.c).
 ;
 ; The functions implemented in this file are:
 ;   KeypadInit - initializes the keypad driver
 ;   KeypadRegisterHwi - registers direct hardware interrupt for the keypad
 ;                       (for use in assembly-only code)
 ;   KeypadScanAndDebounce - scans the keypad and debounces the keys
+;   KeypadAnyKeyDown - checks all the rows for a key that is down
+;   KeypadIsIdle - checks whether no key is down or being debounced
+;   KeypadSetRepeatTicks - sets the auto-repeat timing
+;   KeypadDebounceEvent - reports a key debounced by the debounce engine
+;
+; The local functions are:
+;   KeyEventVector - converts a key number into an event vector
 ;
 ; The interface, expected to be implemented in a separate file for flexibility,
 ; is as follows:
-;  KeyPressed - gets called with {uint8_t row, uint8_t column} when key pressed
+;  KeyPressed - gets called with {uint8_t flags, uint8_t row, uint8_t column}
+;               and the tick count when a key is pressed or repeats
+;  KeyReleased - gets called with {uint8_t flags, uint8_t row, uint8_t column}
+;                and the tick count when a key is released
 ; 
 ; Revision History:
 ;     11/7/23  Adam Krivka      initial revision
 ;     3/4/24    Adam Krivka     expanded KeypadInit and created KeypadRegisterHwi
 ;     3/6/24    Adam Krivka     added comments and fixed formatting
 ;     3/14/24   Adam Krivka     ditched hardware and software interrupts, now using clocks
+;     5/8/24    Adam Krivka     added KeypadAnyKeyDown and KeypadIsIdle for the
+;                               idle scan
+;     5/10/24   Adam Krivka     debounce all the keys in parallel (vertical
+;                               counters), added KeyReleased
+;     5/12/24   Adam Krivka     added auto-repeat and event timestamps
+;     5/18/24   Adam Krivka     debounce with the shared debounce engine,
+;                               added KeypadDebounceEvent
 
 
 ; local include files
     .include "keypad_symbols.inc"
+    .include "../lib/debounce_symbols.inc"
     .include "../std.inc"
 
 ; import functions defined in other files
     .ref KeyPressed
+    .ref KeyReleased
+    .ref DebounceSample
+    .ref DebounceIsIdle
 
 ; export functions defined in this file
     .def KeypadInit
     .def KeypadScanAndDebounce
+    .def KeypadAnyKeyDown
+    .def KeypadIsIdle
+    .def KeypadSetRepeatTicks
+    .def KeypadDebounceEvent
 
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
@@ -44,15 +73,30 @@
     .data
     .align 8
 
-; CurrentRow - the current row being scanned, 0-3 (in binary)
-CurrentRow: .byte 0
+; KeySample - the keys read down so far in this sweep of the rows (bit
+;             ROW << KEY_ROW_SHIFT | column bit for each key, the key
+;             number is the input number in the debounce engine)
+KeySample: .word 0
+
+; RepeatDelay - ticks a key is held before it repeats (0 for no repeat)
+; RepeatRate - ticks between repeats
+; RepeatAccel - repeats before the repeats speed up
+; RepeatFastRate - ticks between repeats once they have sped up
+RepeatDelay: .word 0
+RepeatRate: .word 0
+RepeatAccel: .word 0
+RepeatFastRate: .word 0
 
-; DebounceCounter - the current debounce counter (debounce time is usually
-;                    less than 8 bits)
-DebounceCounter: .byte 0
+; RepeatNext - tick count of the next repeat
+; RepeatCount - repeats of the held key so far
+RepeatNext: .word 0
+RepeatCount: .word 0
 
-; PrevState - the previous state of one row of the keypad (one-hot encoding)
-PrevState: .byte 0
+; RepeatKey - number of the key that repeats (KEY_NONE if none)
+RepeatKey: .byte KEY_NONE
+
+; CurrentRow - the current row being scanned, 0-3 (in binary)
+CurrentRow: .byte 0
 
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
@@ -62,9 +106,9 @@ PrevState: .byte 0
 
 ; KeypadInit
 ;
-; Description:          Initializes the keypad driver by setting the current row to 0,
-;                       the debounce counter to DEBOUNCE_TIME, and the previous state
-;                       to 1111b (all keys up).
+; Description:          Initializes the keypad driver by setting the current row to 0
+;                       and the sample to no keys down.  The debounce engine is set
+;                       up separately (DebounceInit, see keypad_rtos.c).
 ;
 ; Arguments:            None.
 ; Return Values:        None.
@@ -85,6 +129,9 @@ PrevState: .byte 0
 ;       11/7/23     Adam Krivka      initial revision
 ;       3/4/24      Adam Krivka      included GPIO init and timer init functionality
 ;       3/6/24      Adam Krivka      added comments and fixed formatting
+;       5/10/24     Adam Krivka      initialize the per key debounce state
+;       5/12/24     Adam Krivka      initialize the auto-repeat
+;       5/18/24     Adam Krivka      the debounce state is in the debounce engine
 
 KeypadInit:
     PUSH    {LR}            ; save return address
@@ -96,15 +143,17 @@ KeypadInit:
     MOV     R1, #0
     STRB    R1, [R0]
 
-    ; initialize DebounceCounter to DEBOUNCE_TIME
-    MOVA    R0, DebounceCounter
-    MOV     R1, #DEBOUNCE_TIME
-    STRB    R1, [R0]
+    ; initialize KeySample to no keys down
+    MOVA    R0, KeySample
+    STR     R1, [R0]
 
-    ; initialize PrevState to 1111b
-    MOVA    R0, PrevState
-    MOV     R1, #1111b
+    ; initialize RepeatKey to no key and RepeatDelay to no repeat
+    MOV     R1, #KEY_NONE
+    MOVA    R0, RepeatKey
     STRB    R1, [R0]
+    MOV     R1, #0
+    MOVA    R0, RepeatDelay
+    STR     R1, [R0]
 
 ; configure GPIO pins for keypad
     MOV32   R1, IOC_BASE_ADDR   ; prepare IOC base address
@@ -128,209 +177,498 @@ KeypadInit:
 
 ; KeypadScanAndDebounce
 ;
-; Description:      Scans the keypad and debounces the keys. If a key is pressed,
-;                   for DEBOUNCE_TIME, the KeyPressed function is call with
-;                         [ROW][COLUMN]
-;                   where
-;                        ROW is the row of the key pressed (8-bit binary)
-;                        COLUMN is the column of the key pressed (8-bit binary)
-;
-; Operation:        This function is called periodically by the timer. Each
-;                   time it is called, it checks whether the debounce counter
-;                   is not its maximum value (DEBOUNCE_TIME), which indicates
-;                   that a key is being debounced, in which case it checks
-;                   whether that key is still being pressed, and if yes decrements
-;                   the debounce counter further, and if not resets it to 
-;                   its maximum value. If the debounce counter is zero, it enqueus
-;                   an event as described above. If no key is pressed, the curent
-;                   row is incremented and the function returns.
+; Description:      Scans the keypad and debounces all 16 keys in parallel.
+;                   When a key has been down for DEBOUNCE_SAMPLES samples the
+;                   KeyPressed function is called with
+;                         [FLAGS][ROW][COLUMN]
+;                   and when it has been up for DEBOUNCE_SAMPLES samples the
+;                   KeyReleased function is called with the same, where
+;                        FLAGS is KEY_EVT_REPEAT for a repeat, 0 otherwise
+;                        ROW is the row of the key (8-bit binary)
+;                        COLUMN is the column of the key (8-bit binary)
+;                   and the passed tick count as the second argument.  Every
+;                   key is debounced on its own, so any number of keys can be
+;                   down at once (chords).  The last key pressed repeats
+;                   while it is held, if repeat is enabled.
 ;
-; Arguments:        None.
+; Operation:        This function is called periodically by the clock.  Each
+;                   call selects one row, reads its columns, and adds them
+;                   to KeySample (one bit per key, set for a key that is
+;                   down).  The row is then advanced.  After the last row
+;                   the sample of all the keys is passed to DebounceSample,
+;                   which debounces every key with its vertical counters and
+;                   calls KeypadDebounceEvent for each key that changed (see
+;                   there for the events and the repeating key).  Then, once
+;                   the scheduled tick count of the repeating key is
+;                   reached, a repeat event is generated and the next one is
+;                   scheduled RepeatRate ticks later, or RepeatFastRate
+;                   ticks once RepeatAccel repeats have been generated.
+;
+; Arguments:        R0 - tick count (timestamp for the events).
 ; Return Values:    None.
 ;
 ; Local Variables:     
-;         R4 = CurrentRow address
-;         R5 = DebounceCounter address
-;         R6 = PrevState addresss
-;         R7 = CurrentRow value
-;         R8 = DebounceCounter value
-; Shared Variables: None.
+;         R4 = address of the variable being updated
+;         R5 = CurrentRow value
+;         R6 = KeySample address
+;         R9 = tick count
+; Shared Variables: CurrentRow - read and written.
+;                   KeySample - read and written.
+;                   RepeatKey, RepeatNext, RepeatCount - read and written.
+;                   RepeatDelay, RepeatRate, RepeatAccel,
+;                   RepeatFastRate - read.
 ; Global Variables: None.
 ;
 ; Inputs:           Keypad.
-; Outputs:          Calling KeyPressed function.
+; Outputs:          Calling KeyPressed and KeyReleased functions.
 ;
 ; Error Handling:   None.
 ;
-; Registers Changed: flags, R0, R1
-; Stack Depth:        6
+; Algorithms:       Vertical counters (in the debounce engine).
+; Data Structures:  None.
+;
+; Registers Changed: flags, R0, R1, R2, R3, R12
+; Stack Depth:        16 (DebounceSample and KeypadDebounceEvent)
 ;
 ; Revision History:
 ;     11/7/23  Adam Krivka      initial revision
 ;     3/6/24   Adam Krivka      change from EnqueueEvent to KeyPressed
+;     5/10/24  Adam Krivka      debounce every key in parallel, added
+;                               KeyReleased
+;     5/12/24  Adam Krivka      added auto-repeat and event timestamps
+;     5/18/24  Adam Krivka      debounce with the debounce engine
 
 
 KeypadScanAndDebounce:
-    PUSH    {LR, R4, R5, R6, R7, R8}        ; save return address and registers
+    PUSH    {LR, R4, R5, R6, R9, R10} ; save return address and registers
+                                    ; (R10 keeps the stack 8-byte aligned)
+    MOV     R9, R0                  ; keep the tick count for the events
 
     ; load CurrentRow address and value
     MOVA    R4, CurrentRow
-    LDRB    R7, [R4]
+    LDRB    R5, [R4]
 
-    ; load DebounceCounter address and value
-    MOVA    R5, DebounceCounter
-    LDRB    R8, [R5]
-
-    ; compare DebounceCounter to DEBOUNCE_TIME
-    CMP     R8, #DEBOUNCE_TIME ; 
-    BNE     Read                ; if DebounceCounter != DEBOUNCE_TIME, 
-                                ; don't scan, skip to reading the current row
-    ;B      Scan                ; if DebounceCounter == DEBOUNCE_TIME), 
-                                ; scan the keypad (advance to the next row)
-
-
-
-Scan:
-    ; increment CurrentRow
-    ADD     R7, #1
-    AND     R7, #CURRENT_ROW_MASK        ; take just lower two bits
-    STRB    R7, [R4]                     ; update CurrentRow in memory
-    
     ; select the current row
-    MOV     R0, R7                      ; copy current row value
-
-    AND     R0, #11b                    ; clear upper bits
-    LSL     R0, #ROWSEL_A_PIN           ; move to position in gpio
-
     MOV32   R1, GPIO_BASE_ADDR          ; prepare GPIO base address
+    LSL     R0, R5, #ROWSEL_A_PIN       ; row bits in position in gpio
     STR     R0, [R1, #GPIO_DOUTSET_OFFSET] ; set pins
-    MOV     R0, R7                      ; copy current row value again
-    EOR     R0, #11b                    ; negate because we'll be clearing bits
+    EOR     R0, R5, #CURRENT_ROW_MASK   ; negate because we'll be clearing bits
     LSL     R0, #ROWSEL_A_PIN           ; move to position in gpio
     STR     R0, [R1, #GPIO_DOUTCLR_OFFSET] ; clear pins
 
-Read:
-    ; read the current state of the keypad
-    MOV32   R1, GPIO_BASE_ADDR
+    ; read the current row of the keypad
     LDR     R0, [R1, #GPIO_DIN_OFFSET]
     LSR     R0, #COLUMN_0_PIN       ; shift to the right to get the column bits
-    AND     R0, #1111b              ; mask off the upper bits
-    ;B      Compare               ; compare CurState to PrevState
+    MVN     R0, R0                  ; keys that are down read low, make them 1
+    AND     R0, #COLUMN_MASK        ; mask off the upper bits
 
-Compare:
-    ; load PrevState address and value
-    MOVA    R6, PrevState
-    LDRB    R1, [R6]
+    ; add the row to the sample
+    LSL     R2, R5, #KEY_ROW_SHIFT  ; bit of the row's first key
+    LSL     R0, R0, R2              ; move the row there
+    MOVA    R6, KeySample
+    LDR     R1, [R6]
+    ORR     R1, R0
 
-    ; if PrevState != CurState, reset debounce state
-    CMP     R0, R1
-    BNE     ResetDebounce
+    ; advance to the next row
+    ADD     R0, R5, #1
+    AND     R0, #CURRENT_ROW_MASK   ; take just lower two bits
+    STRB    R0, [R4]                ; update CurrentRow in memory
 
-    ; if PrevState == CurState AND CurState == 1111, no key is pressed
-    ; nor was it pressed last time, so we can just end the function
-    CMP     R0, #COLUMN_ALL_KEYS_UP
-    BEQ     KeypadScanAndDebounceEnd
+    ; debounce once every row has been read
+    CMP     R5, #LAST_ROW
+    BEQ     Debounce                ; have the whole keypad, debounce it
+    ;B      SaveSample              ; otherwise keep building the sample
 
-    ; if PrevState == CurState AND CurState != 1111 (meaning key is continuously
-    ; being pressed), debounce
-    ;B      Debounce
+SaveSample:
+    STR     R1, [R6]                ; save the sample so far
+    B       KeypadScanAndDebounceEnd ; end function
 
 
 
-; Debounce current keypress using DebounceCounter
+; Debounce every key with the debounce engine (R1 = sample of all keys)
 Debounce:
-    SUBS    R8, #1               ; decrement DebounceCounter value
+    ; start a new sample
+    MOV     R0, #0
+    STR     R0, [R6]
+
+    ; debounce the keys, the ones that changed are reported through
+    ;    KeypadDebounceEvent
+    MOV     R0, R1                  ; the sample of all the keys
+    MOV     R1, R9                  ; with the tick count
+    BL      DebounceSample
+    ;B      CheckRepeat
+
+
+
+; Repeat the held key if it is time to
+CheckRepeat:
+    MOVA    R1, RepeatDelay         ; check whether repeat is enabled
+    LDR     R0, [R1]
+    CMP     R0, #0
+    BEQ     KeypadScanAndDebounceEnd ; it isn't, done
+
+    MOVA    R4, RepeatKey           ; check for a key to repeat
+    LDRB    R0, [R4]
+    CMP     R0, #KEY_NONE
+    BEQ     KeypadScanAndDebounceEnd ; none, done
+
+    MOVA    R5, RepeatNext          ; check whether it is time to repeat
+    LDR     R6, [R5]
+    SUBS    R1, R9, R6              ; (compare as a difference so the tick
+    BMI     KeypadScanAndDebounceEnd ;  count can wrap), not yet, done
+    ;B      CountRepeat
+
+CountRepeat:
+    MOVA    R1, RepeatCount         ; count the repeat
+    LDR     R2, [R1]
+    ADD     R2, #1
+    STR     R2, [R1]
+
+    MOVA    R1, RepeatAccel         ; check whether to speed up
+    LDR     R3, [R1]
+    CMP     R2, R3
+    BHS     RepeatFast              ; enough repeats, speed up
+    ;B      RepeatSlow              ; otherwise keep the normal rate
+
+RepeatSlow:
+    MOVA    R1, RepeatRate          ; next repeat at the normal rate
+    B       ScheduleRepeat
+
+RepeatFast:
+    MOVA    R1, RepeatFastRate      ; next repeat at the fast rate
+    ;B      ScheduleRepeat
+
+ScheduleRepeat:
+    LDR     R2, [R1]                ; schedule the next repeat
+    ADD     R6, R2
+    STR     R6, [R5]
+
+    BL      KeyEventVector          ; convert to [ROW][COLUMN]
+    ORR     R0, #KEY_EVT_REPEAT     ; it is a repeat
+    MOV     R1, R9                  ; with the tick count
+    BL      KeyPressed              ; and report it
+    ;B      KeypadScanAndDebounceEnd
 
-    ; if DebounceCounter < 0
-    BMI     DebounceCounterNegative 
 
-    ; if DebounceCounter > 0
-    BNE     DebounceEnd 
+KeypadScanAndDebounceEnd:
+    POP     {LR, R4, R5, R6, R9, R10} ; restore return address and registers
+    BX      LR
 
-    ; if DebounceCounter == 0
-    ;B      DebounceCounterZero 
 
-DebounceCounterZero:
-    ; We have successfully registered a key press!
-    ; In this section:
-    ;  - prepare event vector by converting column one-hot encoding to binary,
-    ;    merging with row information, and EVENT_KEYDOWN value
-    ;  - call EnqueueEvent(event_vector)
 
-    ; Use jump table convert from one-hot encoding to binary
-JumpTable:
-    CMP     R0, #COLUMN_0_PRESSED_ONE_HOT
-    BEQ     COLUMN_0_PRESSED
+; KeypadDebounceEvent
+;
+; Description:      Reports a key debounced by the debounce engine.  It is
+;                   the callback passed to DebounceInit, so it is called from
+;                   DebounceSample in KeypadScanAndDebounce.  For a press
+;                   KeyPressed is called and for a release KeyReleased,
+;                   with [ROW][COLUMN] of the key and the tick count (see
+;                   KeypadScanAndDebounce).  The key pressed last is the one
+;                   that repeats.
+;
+; Operation:        The key number (the input of the engine) is taken from
+;                   the event.  A press makes the key the repeating key and
+;                   schedules its first repeat RepeatDelay ticks later, a
+;                   release of the repeating key stops the repeat.  The key
+;                   number is then converted to the event vector and
+;                   reported.  The keys have no long press or repeat time in
+;                   the engine (the keypad times its own repeats), so other
+;                   events are ignored.
+;
+; Arguments:        R0 - event (key number | DEBOUNCE_EVT_PRESS or
+;                        DEBOUNCE_EVT_RELEASE).
+;                   R1 - tick count (timestamp for the event).
+; Return Values:    None.
+;
+; Local Variables:  R4 = tick count
+; Shared Variables: RepeatKey - read and written.
+;                   RepeatNext, RepeatCount - written.
+;                   RepeatDelay - read.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          Calling KeyPressed or KeyReleased.
+;
+; Error Handling:   Events other than a press or release are ignored.
+;
+; Algorithms:       None.
+; Data Structures:  None.
+;
+; Registers Changed: flags, R0, R1, R2, R3, R12
+; Stack Depth:        2
+;
+; Revision History:
+;     5/18/24  Adam Krivka      initial revision (from KeypadScanAndDebounce)
+
+KeypadDebounceEvent:
+    PUSH    {LR, R4}                ; save return address and register
+    MOV     R4, R1                  ; keep the tick count for the event
+
+    ; split the event into its type and the key number
+    AND     R2, R0, #DEBOUNCE_EVT_TYPE
+    AND     R0, #DEBOUNCE_EVT_DIO
+    CMP     R2, #DEBOUNCE_EVT_PRESS
+    BEQ     ReportPressed           ; a key went down
+    CMP     R2, #DEBOUNCE_EVT_RELEASE
+    BEQ     ReportReleased          ; a key went up
+    B       KeypadDebounceEventEnd  ; nothing else is reported
+
+
+; Report a key that was pressed (R0 = key number)
+ReportPressed:
+    ; the key pressed last is the one that repeats
+    MOVA    R1, RepeatKey
+    STRB    R0, [R1]
+    MOVA    R1, RepeatCount         ; it hasn't repeated yet
+    MOV     R2, #0
+    STR     R2, [R1]
+    MOVA    R1, RepeatDelay         ; first repeat is after the delay
+    LDR     R2, [R1]
+    ADD     R2, R4
+    MOVA    R1, RepeatNext
+    STR     R2, [R1]
+
+    BL      KeyEventVector          ; convert to [ROW][COLUMN]
+    MOV     R1, R4                  ; with the tick count
+    BL      KeyPressed              ; and report it
+    B       KeypadDebounceEventEnd
+
+
+; Report a key that was released (R0 = key number)
+ReportReleased:
+    ; stop the repeat if it is the repeating key
+    MOVA    R1, RepeatKey
+    LDRB    R2, [R1]
+    CMP     R0, R2
+    BNE     ReportReleasedEvent     ; another key, just report it
+    ;B      StopRepeat
+
+StopRepeat:
+    MOV     R2, #KEY_NONE           ; no key repeats now
+    STRB    R2, [R1]
+    ;B      ReportReleasedEvent
+
+ReportReleasedEvent:
+    BL      KeyEventVector          ; convert to [ROW][COLUMN]
+    MOV     R1, R4                  ; with the tick count
+    BL      KeyReleased             ; and report it
+    ;B      KeypadDebounceEventEnd
+
+
+KeypadDebounceEventEnd:
+    POP     {LR, R4}                ; restore return address and register
+    BX      LR
 
-    CMP     R0, #COLUMN_1_PRESSED_ONE_HOT
-    BEQ     COLUMN_1_PRESSED
 
-    CMP     R0, #COLUMN_2_PRESSED_ONE_HOT
-    BEQ     COLUMN_2_PRESSED
 
-    CMP     R0, #COLUMN_3_PRESSED_ONE_HOT
-    BEQ     COLUMN_3_PRESSED
+; KeyEventVector
+;
+; Description:      Converts a key number (the bit of the key in KeySample)
+;                   into the event vector passed to KeyPressed and
+;                   KeyReleased, [ROW][COLUMN].
+;
+; Operation:        The row is the key number divided by the keys in a row.
+;                   The column bits are read with column 0 in the highest
+;                   bit, so the column is LAST_COLUMN minus the bit in the
+;                   row.  The row is shifted into the upper byte and the
+;                   column is put in the lower byte.
+;
+; Arguments:        R0 - key number (0-15).
+; Return Values:    R0 - event vector [ROW][COLUMN].
+;
+; Local Variables:  R1 = row of the key.
+; Shared Variables: None.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          None.
+;
+; Error Handling:   None.
+;
+; Registers Changed: R0, R1
+; Stack Depth:        0
+;
+; Revision History:
+;     5/10/24  Adam Krivka      initial revision
+
+KeyEventVector:
+    LSR     R1, R0, #KEY_ROW_SHIFT  ; row of the key
+    AND     R0, #COLUMN_BIT_MASK    ; bit of the key in the row
+    RSB     R0, R0, #LAST_COLUMN    ; column 0 is the highest bit
+    ORR     R0, R0, R1, LSL #KEY_INFO_SEGMENT_BITS ; merge with the row
+    BX      LR
 
-COLUMN_0_PRESSED:
-    MOV     R0, #COLUMN_0_PRESSED_BINARY
-    B       JumpTableEnd
 
-COLUMN_1_PRESSED:
-    MOV     R0, #COLUMN_1_PRESSED_BINARY
-    B       JumpTableEnd
 
-COLUMN_2_PRESSED:
-    MOV     R0, #COLUMN_2_PRESSED_BINARY
-    B       JumpTableEnd
+; KeypadAnyKeyDown
+;
+; Description:      Checks whether any key on the keypad is down by reading
+;                   every row once.  It is used while the keypad is idle to
+;                   check all the rows at a low rate instead of scanning one
+;                   row every call.  It doesn't debounce or generate events.
+;
+; Operation:        Each row is selected in turn and the columns are read.
+;                   If any column is low (pulled down by a key) the function
+;                   returns TRUE right away.  The row select is left on the
+;                   last row read, which is fine since KeypadScanAndDebounce
+;                   selects its row before every read.
+;
+; Arguments:        None.
+; Return Values:    R0 - TRUE if any key is down, FALSE otherwise.
+;
+; Local Variables:
+;         R1 = GPIO base address
+;         R2 = row being read
+;         R3 = row select pins to clear
+; Shared Variables: None.
+; Global Variables: None.
+;
+; Inputs:           Keypad.
+; Outputs:          None.
+;
+; Error Handling:   None.
+;
+; Registers Changed: flags, R0, R1, R2, R3
+; Stack Depth:        0
+;
+; Revision History:
+;     5/8/24   Adam Krivka      initial revision
+;     5/10/24  Adam Krivka      updated comments for the parallel debounce
 
-COLUMN_3_PRESSED:
-    MOV     R0, #COLUMN_3_PRESSED_BINARY
-    B       JumpTableEnd
+KeypadAnyKeyDown:
+    MOV32   R1, GPIO_BASE_ADDR          ; prepare GPIO base address
+    MOV     R2, #0                      ; start at the first row
+    ;B      KeypadAnyKeyDownLoop
 
-JumpTableEnd:
+KeypadAnyKeyDownLoop:
+    ; select the row
+    LSL     R0, R2, #ROWSEL_A_PIN       ; row bits in position in gpio
+    STR     R0, [R1, #GPIO_DOUTSET_OFFSET] ; set pins
+    EOR     R3, R2, #11b                ; negate because we'll be clearing bits
+    LSL     R3, #ROWSEL_A_PIN           ; move to position in gpio
+    STR     R3, [R1, #GPIO_DOUTCLR_OFFSET] ; clear pins
 
-    ; merge with row information    
-    LSL     R7, #KEY_INFO_SEGMENT_BITS ; we don't need R7 after this, so we can cobble it
-    ORR     R0, R7
+    ; read the columns of the row
+    LDR     R0, [R1, #GPIO_DIN_OFFSET]
+    LSR     R0, #COLUMN_0_PIN           ; shift to the right to get the column bits
+    AND     R0, #1111b                  ; mask off the upper bits
+    CMP     R0, #COLUMN_ALL_KEYS_UP
+    BNE     KeypadAnyKeyDownTrue        ; a key is down in this row
+    ;B      KeypadAnyKeyDownNext        ; otherwise try the next row
 
-    ; Call Enqueue(EventVector) (R0)
-    ; (no need to save R0, R1, R2, R3, because we're not using them 
-    ;  in the rest of the function)
-    BL      KeyPressed
-    B       DebounceEnd
+KeypadAnyKeyDownNext:
+    ADD     R2, #1                      ; next row
+    CMP     R2, #CURRENT_ROW_MASK
+    BLS     KeypadAnyKeyDownLoop        ; loop until all the rows are read
+    ;B      KeypadAnyKeyDownFalse       ; no key down in any row
 
-DebounceCounterNegative:
-    ; We need to reset DebounceCounter to zero so we don't overflow in the negatives
-    MOV     R8, #0 
-    ;B      DebounceEnd
+KeypadAnyKeyDownFalse:
+    MOV     R0, #FALSE                  ; no key is down
+    BX      LR
 
-DebounceEnd:
-    ; store new DebounceCounter value (always done regardless of DebounceCounter
-    ; value)
-    STRB    R8, [R5] 
-    B       KeypadScanAndDebounceEnd        ; end function
+KeypadAnyKeyDownTrue:
+    MOV     R0, #TRUE                   ; a key is down
+    BX      LR
 
-; Reset DebounceCounter
-ResetDebounce:
-    STRB    R0, [R6]                        ; update PrevState, because in this 
-                                            ; clause we know that PrevState != CurState
 
-    ; Reset Debounce Counter
-    MOV     R8, #DEBOUNCE_TIME
 
-    ; If a key is pressed, decrement DebounceCounter to start 
-    ; debouncing in the next call
-    CMP     R0, #COLUMN_ALL_KEYS_UP
-    BEQ     ResetDebounceEnd
-    ;B        KeyStartPressed
+; KeypadIsIdle
+;
+; Description:      Checks whether the keypad is idle, that is no key is
+;                   down or being debounced.
+;
+; Operation:        The keypad is idle if no key is down in the sample being
+;                   built and the debounce engine is idle (no key is down
+;                   or changing, see DebounceIsIdle).
+;
+; Arguments:        None.
+; Return Values:    R0 - TRUE if the keypad is idle, FALSE otherwise.
+;
+; Local Variables:  None.
+; Shared Variables: KeySample - read.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          None.
+;
+; Error Handling:   None.
+;
+; Registers Changed: flags, R0, R1, R2
+; Stack Depth:        2 (DebounceIsIdle)
+;
+; Revision History:
+;     5/8/24   Adam Krivka      initial revision
+;     5/10/24  Adam Krivka      check the state of every key
+;     5/18/24  Adam Krivka      debounced keys checked by DebounceIsIdle
+
+KeypadIsIdle:
+    PUSH    {LR, R4}                    ; save return address
+                                        ; (R4 keeps the stack 8-byte aligned)
+
+    ; check for keys down in the sample being built
+    MOVA    R1, KeySample
+    LDR     R0, [R1]
+    CMP     R0, #0
+    BNE     KeypadIsIdleFalse           ; a key is down
+    ;B      KeypadIsIdleDebounced
+
+KeypadIsIdleDebounced:
+    BL      DebounceIsIdle              ; idle if no debounced key is down
+    B       KeypadIsIdleEnd             ; or changing
+
+KeypadIsIdleFalse:
+    MOV     R0, #FALSE                  ; a key is down
+    ;B      KeypadIsIdleEnd
+
+KeypadIsIdleEnd:
+    POP     {LR, R4}                    ; restore return address
+    BX      LR
 
-KeyStartPressed:
-    SUB     R8, #1          ; decrement DebounceCounter so we start debouncing next time
 
-ResetDebounceEnd:
-    STRB    R8, [R5]                        ; store new DebounceCounter value in memory
-    ;B        KeypadScanAndDebounceEnd      ; end function
 
-KeypadScanAndDebounceEnd:
-    POP     {LR, R4, R5, R6, R7, R8}        ; restore return address and registers
+; KeypadSetRepeatTicks
+;
+; Description:      Sets the auto-repeat timing of the keypad.  A key held
+;                   down repeats after delay ticks, then every rate ticks,
+;                   and every fastRate ticks after accel repeats.  A delay
+;                   of 0 turns the auto-repeat off.
+;
+; Operation:        The arguments are stored in RepeatDelay, RepeatRate,
+;                   RepeatAccel, and RepeatFastRate.  A key already
+;                   repeating keeps its next scheduled repeat.
+;
+; Arguments:        R0 - delay before the first repeat in ticks (0 for no
+;                        repeat).
+;                   R1 - ticks between repeats.
+;                   R2 - repeats before the repeats speed up.
+;                   R3 - ticks between repeats once they have sped up.
+; Return Values:    None.
+;
+; Local Variables:  None.
+; Shared Variables: RepeatDelay - written.
+;                   RepeatRate - written.
+;                   RepeatAccel - written.
+;                   RepeatFastRate - written.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          None.
+;
+; Error Handling:   None.
+;
+; Registers Changed: R12
+; Stack Depth:        0
+;
+; Revision History:
+;     5/12/24  Adam Krivka      initial revision
+
+KeypadSetRepeatTicks:
+    MOVA    R12, RepeatRate         ; store the timing
+    STR     R1, [R12]
+    MOVA    R12, RepeatAccel
+    STR     R2, [R12]
+    MOVA    R12, RepeatFastRate
+    STR     R3, [R12]
+    MOVA    R12, RepeatDelay        ; last, since it enables the repeat
+    STR     R0, [R12]
     BX      LR
@@ -8,26 +8,67 @@
 /* 4x4 Keypad RTOS C wrapper code. Functions included:
         KeypadInit_RTOS() - initialize the keypad using RTOS hardware and 
                             software interrupts
+        KeypadGetStats() - get the keypad clock statistics
+        KeypadSetRepeat() - set the auto-repeat timing
+
+   Local functions:
+        KeypadClockCB() - clock function, scans the keypad
+        KeypadSetPeriod() - change the period of the keypad clock
+
+   With KEYPAD_IDLE_SCAN set, once no key has been down for KEYPAD_IDLE_MS
+   the keypad clock slows down to KEYPAD_IDLE_PERIOD_MS and each tick only
+   checks all the rows for a key that is down.  When one is, the clock goes
+   back to scanning every PERIOD_MILISECONDS.  The rows are selected through
+   a decoder (only one row is ever driven), so the columns can't be used to
+   wake on any key and the idle keypad is still checked on a clock, just
+   much less often.
+
+   The keys are debounced by the shared debounce engine (lib/debounce.s),
+   one input per key numbered the way keypad.s numbers them in its sample.
+   The engine is only fed the sweeps of the rows (DebounceSample), it never
+   reads the GPIOs itself, and it reports the keys to KeypadDebounceEvent.
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
        3/14/24 Adam Krivka      switched to using Clock
+       5/8/24  Adam Krivka      added the idle scan and statistics
+       5/12/24 Adam Krivka      added the auto-repeat, events are timestamped
+       5/18/24 Adam Krivka      keys debounced by the shared debounce engine
 */
 
 
 
 /* library includes */
 #include  "util.h"
+#include  <ti/sysbios/hal/Hwi.h>
 
 
 /* local includes */
 #include "keypad_rtos_intf.h"
+#include "../lib/debounce.h"
 
 /* declarations */
 void KeypadInit();
-void KeypadScanAndDebounce();
+void KeypadScanAndDebounce(uint32_t ticks);
+void KeypadSetRepeatTicks(uint32_t delay, uint32_t rate, uint32_t accel,
+                          uint32_t fastRate);
+int  KeypadAnyKeyDown();
+int  KeypadIsIdle();
+void KeypadDebounceEvent(uint32_t event, uint32_t ticks);
+
+/* compile options */
+#ifndef KEYPAD_IDLE_SCAN
+#define KEYPAD_IDLE_SCAN        1       /* slow the clock down when idle */
+#endif
 
 #define PERIOD_MILISECONDS 1
+#define KEYPAD_IDLE_PERIOD_MS   10      /* clock period while idle */
+#define KEYPAD_IDLE_MS          500     /* time with no keys down before */
+                                        /*    going idle */
+
+/* keys on the keypad, numbered row << 2 | column bit in the sample (see */
+/*    keypad_symbols.inc) */
+#define NUM_KEYS                16
 
 
 /* local variables */
@@ -36,9 +77,90 @@ void KeypadScanAndDebounce();
 static Clock_Struct clock;
 static Clock_Handle clockHandle;
 
+/* whether the keypad is idle and how long it has had no keys down (ms) */
+static bool keypadIdle = false;
+static uint16_t keypadUpTime = 0;
+
+/* clock statistics */
+static keypadStats_t keypadStats = { 0, 0, 0 };
+
+/* debounce engine input table, the sample has a 1 for a key that is down */
+/*    and the keypad times its own repeats */
+static const debounceInput_t keypadInputs[NUM_KEYS] = {
+    {  0, FALSE, 0, 0, 0 }, {  1, FALSE, 0, 0, 0 },
+    {  2, FALSE, 0, 0, 0 }, {  3, FALSE, 0, 0, 0 },
+    {  4, FALSE, 0, 0, 0 }, {  5, FALSE, 0, 0, 0 },
+    {  6, FALSE, 0, 0, 0 }, {  7, FALSE, 0, 0, 0 },
+    {  8, FALSE, 0, 0, 0 }, {  9, FALSE, 0, 0, 0 },
+    { 10, FALSE, 0, 0, 0 }, { 11, FALSE, 0, 0, 0 },
+    { 12, FALSE, 0, 0, 0 }, { 13, FALSE, 0, 0, 0 },
+    { 14, FALSE, 0, 0, 0 }, { 15, FALSE, 0, 0, 0 }
+};
+
+/* local functions */
+static void KeypadSetPeriod(uint32_t periodMs);
+
+
+/*
+   KeypadClockCB()
+
+   Description:     This function is the keypad clock function.  It scans
+                    the keypad, or while the keypad is idle checks it for a
+                    key that is down.
+
+   Operation:       While idle, every row is read with KeypadAnyKeyDown and
+                    if a key is down the keypad wakes up, going back to
+                    scanning every PERIOD_MILISECONDS.  Otherwise the keypad
+                    is scanned and debounced and the time with no key down
+                    is counted (the tick count is passed to time stamp the
+                    key events), after KEYPAD_IDLE_MS of it the clock slows
+                    down to KEYPAD_IDLE_PERIOD_MS.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           Keypad.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
 
+   Revision History: 3/14/24 Adam Krivka        initial revision
+                     5/8/24  Adam Krivka        added the idle scan
+                     5/12/24 Adam Krivka        pass the tick count
+*/
 void KeypadClockCB(){
-    KeypadScanAndDebounce();
+#if KEYPAD_IDLE_SCAN
+    /* while idle just check for a key */
+    if (keypadIdle) {
+        keypadStats.idleTicks++;
+        if (KeypadAnyKeyDown()) {
+            /* wake up and scan it */
+            keypadStats.wakeups++;
+            keypadIdle = false;
+            keypadUpTime = 0;
+            KeypadSetPeriod(PERIOD_MILISECONDS);
+        }
+        return;
+    }
+#endif
+
+    /* scan and debounce */
+    keypadStats.scanTicks++;
+    KeypadScanAndDebounce(Clock_getTicks());
+
+#if KEYPAD_IDLE_SCAN
+    /* go idle after a while with no keys down */
+    if (!KeypadIsIdle())
+        keypadUpTime = 0;
+    else if ((keypadUpTime += PERIOD_MILISECONDS) >= KEYPAD_IDLE_MS) {
+        keypadIdle = true;
+        KeypadSetPeriod(KEYPAD_IDLE_PERIOD_MS);
+    }
+#endif
 }
 
 /*
@@ -51,7 +173,9 @@ void KeypadClockCB(){
 
    Operation:       Initializes the hardware and software interrupts, and then
                     calls the KeypadInit function which configures the GPIOs
-                    , variables, and timer (it also starts it).
+                    , variables, and timer (it also starts it).  The
+                    debounce engine is set up with an input per key and the
+                    auto-repeat is set to the default timing.
 
    Arguments:        None.
    Return Value:     None.
@@ -67,6 +191,8 @@ void KeypadClockCB(){
    Data Structures:  None.
 
    Revision History: 3/6/24  Adam Krivka        initial revision
+                     5/12/24 Adam Krivka        set the default auto-repeat
+                     5/18/24 Adam Krivka        set up the debounce engine
 */
 void KeypadInit_RTOS() {
     /* variables */
@@ -74,6 +200,13 @@ void KeypadInit_RTOS() {
     /* call assembly init function (inits GPIOs, variables) */
     KeypadInit();
 
+    /* debounce the keys, all up to start */
+    DebounceInit(keypadInputs, NUM_KEYS, KeypadDebounceEvent);
+
+    /* default auto-repeat */
+    KeypadSetRepeat(KEYPAD_REPEAT_DELAY_MS, KEYPAD_REPEAT_RATE_MS,
+                    KEYPAD_REPEAT_ACCEL, KEYPAD_REPEAT_FAST_MS);
+
     /* set up clock */
     clockHandle = Util_constructClock(&clock, KeypadClockCB, PERIOD_MILISECONDS, PERIOD_MILISECONDS, false, 0);
 
@@ -82,3 +215,121 @@ void KeypadInit_RTOS() {
 
     return;
 }
+
+/*
+   KeypadGetStats(keypadStats_t *)
+
+   Description:     This function gets the keypad clock statistics.  The
+                    fraction of the time spent scanning is scanTicks *
+                    PERIOD_MILISECONDS over the total time, and the clock
+                    runs scanTicks + idleTicks times in all.
+
+   Operation:       The statistics are copied with interrupts disabled.
+
+   Arguments:        pStats (keypadStats_t *) - where to copy the statistics.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/8/24  Adam Krivka        initial revision
+*/
+void KeypadGetStats(keypadStats_t *pStats) {
+    /* variables */
+    UInt key;                           /* interrupt state to restore */
+
+    /* copy them all at once */
+    key = Hwi_disable();
+    *pStats = keypadStats;
+    Hwi_restore(key);
+
+    return;
+}
+
+/*
+   KeypadSetRepeat(uint32_t, uint32_t, uint32_t, uint32_t)
+
+   Description:     This function sets the auto-repeat timing.  A key held
+                    down repeats (KeyPressed is called with KEY_EVT_REPEAT)
+                    after delayMs, then every rateMs, and every fastRateMs
+                    once it has repeated accel times.  A delayMs of 0 turns
+                    the auto-repeat off.
+
+   Operation:       The times are converted to clock ticks (at least one)
+                    and passed to the keypad driver.
+
+   Arguments:        delayMs (uint32_t) - hold time before the first repeat
+                                          in ms (0 for no repeat).
+                     rateMs (uint32_t) - time between repeats in ms.
+                     accel (uint32_t) - repeats before speeding up.
+                     fastRateMs (uint32_t) - time between repeats once sped
+                                             up in ms.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/12/24 Adam Krivka        initial revision
+*/
+void KeypadSetRepeat(uint32_t delayMs, uint32_t rateMs, uint32_t accel,
+                     uint32_t fastRateMs) {
+    /* variables */
+    uint32_t delay = 0;                 /* delay in ticks (0 for no repeat) */
+    uint32_t rate;                      /* repeat rate in ticks */
+    uint32_t fastRate;                  /* fast repeat rate in ticks */
+
+    /* convert to ticks, keeping every time nonzero */
+    if (delayMs != 0)
+        delay = delayMs * (1000 / Clock_tickPeriod);
+    rate = ((rateMs != 0) ? rateMs : 1) * (1000 / Clock_tickPeriod);
+    fastRate = ((fastRateMs != 0) ? fastRateMs : 1) * (1000 / Clock_tickPeriod);
+
+    /* and set them */
+    KeypadSetRepeatTicks(delay, rate, accel, fastRate);
+
+    return;
+}
+
+/*
+   KeypadSetPeriod(uint32_t)
+
+   Description:     This function changes the period of the keypad clock.
+                    It can be called from the clock function.
+
+   Operation:       The clock is stopped, given the new period, and started
+                    again with its first timeout one period away.
+
+   Arguments:        periodMs (uint32_t) - new period in ms.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/8/24  Adam Krivka        initial revision
+*/
+static void KeypadSetPeriod(uint32_t periodMs) {
+    /* stop it, change the period, and restart it */
+    Clock_stop(clockHandle);
+    Clock_setPeriod(clockHandle, periodMs * (1000 / Clock_tickPeriod));
+    Util_restartClock(&clock, periodMs);
+
+    return;
+}
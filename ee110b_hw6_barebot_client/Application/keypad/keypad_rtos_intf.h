@@ -9,14 +9,46 @@
     set up and use the keypad code). Functions declared are:
         KeypadInit_RTOS() - initialize the keypad using RTOS hardware and 
                             software interrupts
+        KeypadGetStats() - get the keypad clock statistics
+        KeypadSetRepeat() - set the auto-repeat timing
+
+   The key events passed to KeyPressed and KeyReleased are
+   [FLAGS][ROW][COLUMN] (a byte each, with the flags in bits 16-23) along
+   with the tick count of the event.  The flags are 0 for a key going down
+   or up, so events without flags are the same as before.
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       5/8/24  Adam Krivka      added the clock statistics
+       5/12/24 Adam Krivka      added the auto-repeat and event format
 */
 
 #ifndef KEYPAD_RTOS_INTF_H
     #define KEYPAD_RTOS_INTF_H
 
+#include  <stdint.h>
+
+/* key event format */
+#define KEY_EVT_REPEAT          (1UL << 16)     /* flag for an auto-repeat */
+#define KEY_EVT_ROW(evt)        (((evt) >> 8) & 0xFF)   /* row of the key */
+#define KEY_EVT_COL(evt)        ((evt) & 0xFF)          /* column of the key */
+
+/* default auto-repeat timing */
+#define KEYPAD_REPEAT_DELAY_MS  400     /* hold time before the first repeat */
+#define KEYPAD_REPEAT_RATE_MS   150     /* time between repeats */
+#define KEYPAD_REPEAT_ACCEL     5       /* repeats before speeding up */
+#define KEYPAD_REPEAT_FAST_MS   50      /* time between fast repeats */
+
+/* keypad clock statistics */
+typedef struct {
+    uint32_t wakeups;                   /* times a key woke the idle keypad */
+    uint32_t scanTicks;                 /* clock ticks spent scanning */
+    uint32_t idleTicks;                 /* clock ticks spent idle */
+} keypadStats_t;
+
 void KeypadInit_RTOS();
+void KeypadGetStats(keypadStats_t *pStats);
+void KeypadSetRepeat(uint32_t delayMs, uint32_t rateMs, uint32_t accel,
+                     uint32_t fastRateMs);
 
 #endif
\ No newline at end of file
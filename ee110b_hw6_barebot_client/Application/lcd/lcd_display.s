@@ -11,10 +11,26 @@
 ;   Display - display a string
 ;   DisplayChar - display a single character
 ;   ClearDisplay
+;   ResetShadow - mark the whole display blank in the shadow
+;   LCDInvalidateCursor - forget where the LCD cursor is
+;
+; The LCD writes are queued with LCDEnqueue (see lcd_rtos.c), so these
+; functions return without waiting for the LCD.
+; The characters on the display are kept in a shadow buffer in RAM, together
+; with the address the LCD cursor is at.  A character is only written if it
+; differs from the shadow, and the cursor address is only set when it isn't
+; already where the LCD auto-increment left it, so redrawing a line that
+; barely changed costs almost no bus traffic.  Everything written to DDRAM
+; has to go through this file for the shadow to stay correct.
 ; 
 ; Revision History:
 ;     11/22/23  Adam Krivka     initial revision
 ;     3/6/24   Adam Krivka      added target-length functionality
+;     4/22/24  Adam Krivka      added shadow buffer, only changed cells are
+;                               written
+;     4/24/24  Adam Krivka      writes are queued instead of waiting for the
+;                               LCD
+;     5/2/24   Adam Krivka      added LCDInvalidateCursor
 
 
 
@@ -24,13 +40,34 @@
     .include "../lib/ascii.inc"
 
 ; import functions from other files
-    .ref LCDWrite
-    .ref LCDWaitForNotBusy
+    .ref LCDEnqueue
 
 ; export functions to other files
     .def Display
     .def DisplayChar
     .def ClearDisplay
+    .def ResetShadow
+    .def LCDInvalidateCursor
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; MEMORY
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+    .data
+    .align 4
+
+; Shadow - characters on the display, row by row (NUM_COLS per row)
+Shadow: .space NUM_ROWS * NUM_COLS
+
+; CursorAddr - DDRAM address the LCD cursor is at (CURSOR_ADDR_UNKNOWN if
+;              it isn't known)
+CursorAddr: .byte CURSOR_ADDR_UNKNOWN
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Code
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+    .text
 
 
 ; CursorBaseAddr
@@ -39,9 +76,9 @@
 CursorBaseAddr:
     .byte ROW_0_START, ROW_1_START, ROW_2_START, ROW_3_START
 
-; SetCursorPos
+; CheckCursorPos
 ;
-; Description:          Sets cursor position on the LCD. 
+; Description:          Checks that a cursor position is on the LCD.
 ;
 ; Arguments:            r in R0, c in R1
 ; Return Values:        success/fail in R0.
@@ -50,58 +87,115 @@ CursorBaseAddr:
 ; Shared Variables:     None.
 ; Global Variables:     None.
 ;
-; Error Handling:       If incorrect row and column values are passed, 
+; Error Handling:       If incorrect row and column values are passed,
 ;                       returns FUNCTION_FAIL
 ;
-; Registers Changed:    flags, R0, R1, R2, R3
+; Registers Changed:    flags, R0
 ; Stack Depth:          0
-; 
+;
 ; Revision History:
-;     11/22/23  Adam Krivka      initial revision
-
-SetCursorPos:
-    PUSH    {LR, R4, R5}                ; save return address and used registers
+;     11/22/23  Adam Krivka      initial revision (as SetCursorPos)
+;     4/22/24   Adam Krivka      only checks the position, the cursor is
+;                                set by WriteCell
 
+CheckCursorPos:
 ; check that row and column are in bounds
     CMP     R0, #0              ; check if r >= 0
-    BLT     SetCursorPosFail    ; if r < 0, fail
+    BLT     CheckCursorPosFail  ; if r < 0, fail
 
     CMP     R0, #NUM_ROWS       ; check if r < NUM_ROWS
-    BGE     SetCursorPosFail    ; if r >= NUM_ROWS, fail
+    BGE     CheckCursorPosFail  ; if r >= NUM_ROWS, fail
 
     CMP     R1, #0              ; check if c >= 0
-    BLT     SetCursorPosFail    ; if c < 0, fail
+    BLT     CheckCursorPosFail  ; if c < 0, fail
 
     CMP     R1, #NUM_COLS       ; check if c < NUM_COLS
-    BGE     SetCursorPosFail    ; if c >= NUM_COLS
-    ;B      SetCursorPosValid
+    BGE     CheckCursorPosFail  ; if c >= NUM_COLS
+    ;B      CheckCursorPosSuccess
 
-SetCursorPosValid:
-    MOVA    R4, CursorBaseAddr   ; load address of cursor base addresses
-    LDRB    R5, [R4, R0]         ; load CursorBaseAddr[r] to R5
-    ADD     R5, R1               ; add c to address
-    ;B      SetCursorPosWrite
+CheckCursorPosSuccess:
+    MOV32   R0, FUNCTION_SUCCESS; prepare success return value
+    BX      LR                  ; return
+
+CheckCursorPosFail:
+    MOV32   R0, FUNCTION_FAIL   ; prepare fail return value
+    BX      LR                  ; return
 
-SetCursorPosWrite:
-    BL      LCDWaitForNotBusy   ; wait for LCD to be ready
 
-    ORR     R5, #SET_DDRAM_ADDR ; prepare a set DDRAM command
-    MOV     R1, R5
-    MOV32   R0, 0               ; RS = 0
-    BL      LCDWrite            ; write set DDRAM command to LCD
+; WriteCell
+;
+; Description:          Writes a character to the given cell of the LCD if
+;                       it isn't already showing it.
+;
+; Operation:            The character is compared with the shadow and nothing
+;                       is done if they match.  Otherwise the shadow is
+;                       updated, the DDRAM address is set if the cursor isn't
+;                       already at the cell, and the character is written
+;                       (both are queued).
+;                       The LCD increments the cursor after the write, so
+;                       consecutive changed cells need only one set address
+;                       command.
+;
+; Arguments:            r in R0, c in R1, ch in R2 (the position must be
+;                       valid)
+; Return Values:        None.
+;
+; Local Variables:      shadow index in R4, DDRAM address in R5,
+;                       ch in R6
+; Shared Variables:     Shadow - read and updated.
+;                       CursorAddr - read and updated.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2, R3
+; Stack Depth:          4
+;
+; Revision History:
+;     4/22/24   Adam Krivka      initial revision
+;     4/24/24   Adam Krivka      queue the writes
 
-    B       SetCursorPosSuccess
+WriteCell:
+    PUSH    {LR, R4, R5, R6}    ; save return address and used registers
 
-SetCursorPosFail:
-    MOV32   R0, FUNCTION_FAIL   ; prepare fail return value
-    B       SetCursorPosDone
+    MOV     R3, #NUM_COLS       ; get index of the cell in the shadow
+    MLA     R4, R0, R3, R1      ;   (r * NUM_COLS + c)
+    MOVA    R3, Shadow          ; load address of the shadow
+    LDRB    R5, [R3, R4]        ; load character that is on the display
+    CMP     R5, R2              ; check if it's already there
+    BEQ     WriteCellDone       ; if so, nothing to write
 
-SetCursorPosSuccess:
-    MOV32   R0, FUNCTION_SUCCESS; prepare success return value
-    ;B      SetCursorPosDone
+    STRB    R2, [R3, R4]        ; store new character in the shadow
+    MOV     R6, R2              ; save character
+
+    MOVA    R3, CursorBaseAddr  ; load address of cursor base addresses
+    LDRB    R5, [R3, R0]        ; load CursorBaseAddr[r] to R5
+    ADD     R5, R1              ; add c to get address of the cell
+
+    MOVA    R3, CursorAddr      ; load address the cursor is at
+    LDRB    R4, [R3]
+    CMP     R4, R5              ; check if the cursor is already at the cell
+    BEQ     WriteCellData       ; if so, just write the character
+    ;B      WriteCellSetAddr    ; else move the cursor first
+
+WriteCellSetAddr:
+    MOV32   R0, 0               ; RS = 0
+    ORR     R1, R5, #SET_DDRAM_ADDR ; prepare a set DDRAM command
+    BL      LCDEnqueue          ; queue set DDRAM command for the LCD
+    ;B      WriteCellData
+
+WriteCellData:
+    MOV32   R0, 1               ; RS = 1
+    MOV     R1, R6              ; copy character
+    BL      LCDEnqueue          ; queue data for the LCD
 
-SetCursorPosDone:
-    POP     {LR, R4, R5}        ; restore return address and used registers
+    ADD     R5, #1              ; the LCD moved the cursor to the next cell
+    MOVA    R3, CursorAddr
+    STRB    R5, [R3]            ; remember where it is
+    ;B      WriteCellDone
+
+WriteCellDone:
+    POP     {LR, R4, R5, R6}    ; restore return address and used registers
     BX      LR                  ; return
 
 
@@ -112,8 +206,10 @@ SetCursorPosDone:
 ;                       set on the LCD. If the string is longer than the
 ;                       row, it will be truncated and an error will be returned.
 ;                       If the string is shorter than the row, the rest of the
-;                       row will be padded with spaces, up to target length.
+;                       row will be padded with spaces, up to target length
+;                       (the padding stops at the end of the row).
 ;                       If the target length is -1, no padding will be done.
+;                       Only the cells that change are written to the LCD.
 ;
 ; Arguments:            R0: row,
 ;                       R1: column
@@ -122,7 +218,8 @@ SetCursorPosDone:
 ;
 ; Return Values:        success/fail in R0.
 ;
-; Local Variables:      r, c, character in R3
+; Local Variables:      c in R4, str pointer in R5, character in R6,
+;                       target length in R7, r in R8
 ; Shared Variables:     None.
 ; Global Variables:     None.
 ;
@@ -130,24 +227,27 @@ SetCursorPosDone:
 ;                       the function returns a fail value
 ;
 ; Registers Changed:    flags, R0, R1, R2, R3
-; Stack Depth:          4
-; 
+; Stack Depth:          6
+;
 ; Revision History:
 ;   11/22/23    Adam Krivka     initial revision
 ;   1/16/24     Adam Krivka     added target-length functionality
 ;   3/4/        Adam Krivka     fixed bug with target-length argument being 0
+;   4/22/24     Adam Krivka     write only changed cells (WriteCell), padding
+;                               stops at the end of the row
 
 
 Display:
-    PUSH    {LR, R4, R5, R6, R7}        ; save return address and used registers
+    PUSH    {LR, R4, R5, R6, R7, R8}    ; save return address and used registers
 
+    MOV     R8, R0                  ; save row
     MOV     R4, R1                  ; save column
     MOV     R5, R2                  ; save string pointer
     MOV     R7, R3                  ; save target length
 
-    BL      SetCursorPos            ; set cursor position based on r, c
+    BL      CheckCursorPos          ; check the position r, c
 
-    CMP     R0, #FUNCTION_FAIL      ; check if setting cursor failed
+    CMP     R0, #FUNCTION_FAIL      ; check if the position is bad
     BEQ     DisplayFail             ; fail this function too if so
 
     SUB		R4, #1					; subtract 1 from column so that it is
@@ -162,12 +262,11 @@ DisplayLoop:
     CMP     R4, #NUM_COLS           ; check if we're off screen
     BGE     DisplayFail             ; if yes, stop and return fail value
 
-    BL      LCDWaitForNotBusy       ; wait for LCD to be ready
-
-    ; prepare arguments for writing to LCD
-    MOV32   R0, 1                   ; RS = 1
-    MOV     R1, R6                  ; copy character
-    BL      LCDWrite                ; write data to LCD
+    ; write the character if it changed
+    MOV     R0, R8                  ; row
+    MOV     R1, R4                  ; column
+    MOV     R2, R6                  ; character
+    BL      WriteCell
 
     CMP     R7, #-1                 ; check if we need to worry about target length
     BEQ     DisplayLoop
@@ -186,13 +285,16 @@ DisplayPadRest:
     CMP     R7, #-1                 ; check if we need to worry about target length
     BEQ     DisplaySuccess
 
-    BL      LCDWaitForNotBusy       ; wait for LCD to be ready
+    CMP     R4, #NUM_COLS           ; check if we're at the end of the row
+    BGE     DisplaySuccess          ; if yes, nothing left to pad
 
-    ; prepare arguments for writing to LCD
-    MOV32   R0, 1                   ; RS = 1
-    MOV     R1, #ASCII_SPACE        ; copy space character
-    BL      LCDWrite                ; write data to LCD
+    ; write a space if the cell changed
+    MOV     R0, R8                  ; row
+    MOV     R1, R4                  ; column
+    MOV     R2, #ASCII_SPACE        ; space character
+    BL      WriteCell
 
+    ADD     R4, #1                  ; add 1 to column
     SUB     R7, #1                  ; decrement target length
     CMP     R7, #0                  ; check if we've reached target length
     BEQ     DisplaySuccess          ; if yes, we're done printing the string
@@ -204,7 +306,7 @@ DisplaySuccess:
     ;B      DisplayDone
 
 DisplayDone:
-    POP     {LR, R4, R5, R6, R7}        ; restore return address and used registers
+    POP     {LR, R4, R5, R6, R7, R8}    ; restore return address and used registers
     BX      LR                      ; return
 
 
@@ -212,6 +314,7 @@ DisplayDone:
 ; DisplayChar
 ;
 ; Description:          Displays a single character at the given row and column.
+;                       Nothing is written if the character is already there.
 ;
 ; Arguments:            r, c, ch
 ; Return Values:        None.
@@ -224,41 +327,32 @@ DisplayDone:
 ;                       returns a fail value.
 ;
 ; Registers Changed:    flags, R0, R1, R2, R3
-; Stack Depth:          3
-; 
+; Stack Depth:          5
+;
 ; Revision History:
 ;   11/22/23    Adam Krivka     initial revision
+;   4/22/24     Adam Krivka     write through the shadow (WriteCell)
 
 DisplayChar:
-    PUSH    {LR, R4, R5}        ; save return address and used registers
-
-    MOV     R4, R1              ; save column
-    MOV     R5, R2              ; save character
+    PUSH    {LR, R4}            ; save return address and used registers
 
-    BL      SetCursorPos        ; set cursor position based on r, c
+    MOV     R4, R0              ; save row
 
-    CMP     R0, #FUNCTION_FAIL  ; check if setting cursor failed
-    BEQ     DisplayCharFail     ; fail this function too if so
+    BL      CheckCursorPos      ; check the position r, c
 
-    BL      LCDWaitForNotBusy   ; wait for LCD to not be busy
+    CMP     R0, #FUNCTION_FAIL  ; check if the position is bad
+    BEQ     DisplayCharDone     ; fail this function too if so (R0 is
+                                ;   already the fail value)
 
-    ; write character to LCD
-    MOV32   R0, 1               ; RS = 1
-    MOV     R1, R5              ; copy character
-    BL      LCDWrite            ; write data to LCD
-
-    B       DisplayCharSuccess  ; we've successfully written the character
-
-DisplayCharFail:
-    MOV32   R0, FUNCTION_FAIL   ; prepare fail return value
-    B       DisplayCharDone
+    ; write character to LCD if it changed
+    MOV     R0, R4              ; row (column and character still in R1, R2)
+    BL      WriteCell
 
-DisplayCharSuccess:
     MOV32   R0, FUNCTION_SUCCESS; prepare success return value
     ;B      DisplayCharDone
 
 DisplayCharDone:
-    POP     {LR, R4, R5}        ; restore return address and used registers
+    POP     {LR, R4}            ; restore return address and used registers
     BX      LR                  ; return
 
 
@@ -271,25 +365,102 @@ DisplayCharDone:
 ; Return Values:        None.
 ;
 ; Local Variables:      None.
-; Shared Variables:     None.
+; Shared Variables:     CursorAddr - set to the top left.
 ; Global Variables:     None.
 ;
 ; Error Handling:       None.
 ;
 ; Registers Changed:    flags, R0, R1, R2, R3
 ; Stack Depth:          1
-; 
+;
 ; Revision History:
 ;     11/22/23  Adam Krivka      initial revision
+;     4/22/24   Adam Krivka      keep the shadow in sync
+;     4/24/24   Adam Krivka      queue the command
 
 ClearDisplay:
     PUSH    {LR}                ; store return address
 
-    BL      LCDWaitForNotBusy   ; wait for LCD to not be busy
-
     MOV32   R0, 0               ; RS = 0
     MOV32   R1, CLEAR_DISPLAY   ; command = CLEAR_DISPLAY
-    BL      LCDWrite            ; call LCDWrite(CLEAR_DISPLAY, RS = 0)
+    BL      LCDEnqueue          ; call LCDEnqueue(RS = 0, CLEAR_DISPLAY)
+
+    BL      ResetShadow         ; the display is all spaces now
+
+    MOV32   R0, ROW_0_START     ; clearing moves the cursor to the top left
+    MOVA    R1, CursorAddr
+    STRB    R0, [R1]
 
     POP     {LR}                ; restore return address
     BX      LR                  ; return
+
+
+
+; ResetShadow
+;
+; Description:          Marks the display as blank in the shadow.  Must be
+;                       called whenever the display is cleared without
+;                       ClearDisplay (e.g. by LCDInit).
+;
+; Arguments:            None
+; Return Values:        None.
+;
+; Local Variables:      None.
+; Shared Variables:     Shadow - filled with spaces.
+;                       CursorAddr - set to unknown.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2
+; Stack Depth:          0
+;
+; Revision History:
+;     4/22/24   Adam Krivka      initial revision
+
+ResetShadow:
+    MOVA    R0, Shadow                      ; start of the shadow
+    MOV32   R1, NUM_ROWS * NUM_COLS         ; number of cells
+    MOV32   R2, ASCII_SPACE                 ; blank cell
+
+ResetShadowLoop:
+    STRB    R2, [R0], #1                    ; blank the cell
+    SUBS    R1, #1                          ; one less cell left
+    BNE     ResetShadowLoop                 ; loop until all are done
+
+    MOV32   R2, CURSOR_ADDR_UNKNOWN         ; cursor position isn't known
+    MOVA    R0, CursorAddr
+    STRB    R2, [R0]
+
+    BX      LR                              ; return
+
+
+
+; LCDInvalidateCursor
+;
+; Description:          Forgets where the LCD cursor is, so the next write
+;                       sets the DDRAM address.  Must be called after
+;                       anything else moves the LCD address counter (e.g.
+;                       writing custom glyphs to CGRAM).
+;
+; Arguments:            None
+; Return Values:        None.
+;
+; Local Variables:      None.
+; Shared Variables:     CursorAddr - set to unknown.
+; Global Variables:     None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    R0, R1
+; Stack Depth:          0
+;
+; Revision History:
+;     5/2/24    Adam Krivka      initial revision
+
+LCDInvalidateCursor:
+    MOV32   R0, CURSOR_ADDR_UNKNOWN         ; cursor position isn't known
+    MOVA    R1, CursorAddr
+    STRB    R0, [R1]
+
+    BX      LR                              ; return
@@ -0,0 +1,313 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               lcd_glyph.c                                */
+/*                         LCD Custom Glyph Manager                         */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the custom glyph manager for the LCD.  The LCD can
+   hold 8 custom 5x8 glyphs in its CGRAM at once.  Up to GLYPH_MAX glyphs
+   can be registered, and each one is given a CGRAM slot when a character
+   for it is asked for, replacing the least recently used glyph if all the
+   slots are taken.  The patterns are not sent to the LCD right away, the
+   slots that changed are sent together by GlyphUpload, so a redraw that
+   uses glyphs already on the LCD sends nothing.  Functions included are:
+        GlyphRegister - register a glyph pattern
+        GlyphChar     - get the character for a glyph
+        GlyphUpload   - send the changed glyph patterns to the LCD
+        Display_bar   - display a horizontal bar graph
+
+   Replacing a glyph changes every cell on the display that shows its slot,
+   so anything using more than GLYPH_NUM_SLOTS glyphs should redraw the
+   cells of glyphs that were dropped.
+
+   Revision History:
+       5/2/24  Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <xdc/std.h>
+#include  <stdbool.h>
+#include  <stddef.h>
+
+/* local includes */
+#include "lcd_glyph.h"
+#include "lcd_util.h"
+#include "lcd_rtos_intf.h"
+
+/* declarations of the assembly functions */
+void LCDEnqueue(UArg rs, UArg data);
+void LCDInvalidateCursor();
+
+/* constants */
+#define BAR_COLS        5       /* pixel columns in a character */
+
+/* shared/global variables */
+
+/* registered glyphs, their patterns and slots */
+static const uint8_t *glyphPattern[GLYPH_MAX];
+static uint8_t glyphSlot[GLYPH_MAX];
+static uint8_t numGlyphs = 0;
+
+/* CGRAM slots, the glyph in each, when it was last used, and which slots */
+/*    still need to be sent to the LCD (one bit per slot) */
+static uint8_t slotGlyph[GLYPH_NUM_SLOTS] = { GLYPH_NONE, GLYPH_NONE,
+        GLYPH_NONE, GLYPH_NONE, GLYPH_NONE, GLYPH_NONE, GLYPH_NONE,
+        GLYPH_NONE };
+static uint16_t slotLastUse[GLYPH_NUM_SLOTS];
+static uint16_t useCount = 0;
+static uint8_t dirtySlots = 0;
+
+/* partial bar graph cells (1 to 4 columns lit from the left) */
+static const uint8_t barPatterns[BAR_COLS - 1][GLYPH_ROWS] = {
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 },
+    { 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18 },
+    { 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C },
+    { 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E }
+};
+static uint8_t barGlyphs[BAR_COLS - 1] = { GLYPH_NONE, GLYPH_NONE,
+        GLYPH_NONE, GLYPH_NONE };
+
+
+
+/* functions */
+
+/*
+   GlyphRegister(const uint8_t *)
+
+   Description:      This function registers a custom glyph.
+
+   Operation:        The pattern is added to the registered glyphs.  It isn't
+                     given a CGRAM slot until a character for it is asked
+                     for with GlyphChar.
+
+   Arguments:        pattern (const uint8_t *) - GLYPH_ROWS rows of the glyph
+                     from the top, the low 5 bits of each are the pixels
+                     (must stay valid, it isn't copied).
+   Return Value:     (uint8_t) - the glyph number, GLYPH_NONE if no more
+                     glyphs can be registered.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   GLYPH_NONE is returned if the table is full.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/2/24  Adam Krivka      initial revision
+*/
+uint8_t GlyphRegister(const uint8_t *pattern) {
+    /* check for room */
+    if (numGlyphs == GLYPH_MAX)
+        return (GLYPH_NONE);
+
+    /* add it without a slot */
+    glyphPattern[numGlyphs] = pattern;
+    glyphSlot[numGlyphs] = GLYPH_NONE;
+
+    return (numGlyphs++);
+}
+
+/*
+   GlyphChar(uint8_t)
+
+   Description:      This function gets the character to display for a
+                     glyph.  GlyphUpload must be called after the characters
+                     for a redraw have been gotten so newly loaded glyphs
+                     are sent to the LCD.
+
+   Operation:        If the glyph is in a CGRAM slot that slot is used.
+                     Otherwise it is put in a free slot or the least
+                     recently used one, and the slot is marked to be sent.
+                     The slot's last use is updated and its character code
+                     is returned (the mirrored codes are used since code 0
+                     would end the string).
+
+   Arguments:        glyph (uint8_t) - the glyph number.
+   Return Value:     (char) - character code for the glyph, a space for a
+                     bad glyph number.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Bad glyph numbers give a space.
+
+   Algorithms:       Least recently used replacement.
+   Data Structures:  None.
+
+   Revision History: 5/2/24  Adam Krivka      initial revision
+*/
+char GlyphChar(uint8_t glyph) {
+    /* variables */
+    uint8_t slot;                       /* slot of the glyph */
+    uint8_t i;                          /* loop index */
+
+    /* check the glyph */
+    if (glyph >= numGlyphs)
+        return (' ');
+
+    /* give it a slot if it doesn't have one */
+    slot = glyphSlot[glyph];
+    if (slot == GLYPH_NONE) {
+        /* find a free slot, or else the least recently used one */
+        slot = 0;
+        for (i = 0; i < GLYPH_NUM_SLOTS; i++) {
+            if (slotGlyph[i] == GLYPH_NONE) {
+                slot = i;
+                break;
+            }
+            if ((uint16_t)(useCount - slotLastUse[i])
+                    > (uint16_t)(useCount - slotLastUse[slot]))
+                slot = i;
+        }
+
+        /* take it over */
+        if (slotGlyph[slot] != GLYPH_NONE)
+            glyphSlot[slotGlyph[slot]] = GLYPH_NONE;
+        slotGlyph[slot] = glyph;
+        glyphSlot[glyph] = slot;
+        dirtySlots |= (1 << slot);
+    }
+
+    /* note the use */
+    slotLastUse[slot] = ++useCount;
+
+    return (GLYPH_CHAR_BASE + slot);
+}
+
+/*
+   GlyphUpload()
+
+   Description:      This function sends the glyph patterns that changed to
+                     the LCD.
+
+   Operation:        The slots are gone through in order.  For each run of
+                     changed slots the CGRAM address is set once and the
+                     patterns are written back to back (the LCD increments
+                     the address).  Since the LCD address counter is then in
+                     CGRAM, the display is told it no longer knows where the
+                     cursor is.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The patterns are written to the LCD CGRAM (queued).
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/2/24  Adam Krivka      initial revision
+*/
+void GlyphUpload() {
+    /* variables */
+    bool inRun = false;                 /* whether in a run of changed slots */
+    uint8_t slot;                       /* slot being checked */
+    uint8_t row;                        /* row of the pattern */
+
+    /* nothing to do if nothing changed */
+    if (dirtySlots == 0)
+        return;
+
+    /* send every changed slot */
+    for (slot = 0; slot < GLYPH_NUM_SLOTS; slot++) {
+        if ((dirtySlots & (1 << slot)) == 0) {
+            inRun = false;
+            continue;
+        }
+
+        /* set the address at the start of a run */
+        if (!inRun)
+            LCDEnqueue(0, LCD_SET_CGRAM_ADDR | (slot * GLYPH_ROWS));
+        inRun = true;
+
+        /* write the pattern */
+        for (row = 0; row < GLYPH_ROWS; row++)
+            LCDEnqueue(1, glyphPattern[slotGlyph[slot]][row]);
+    }
+    dirtySlots = 0;
+
+    /* the next display write has to set the DDRAM address */
+    LCDInvalidateCursor();
+
+    return;
+}
+
+/*
+   Display_bar(UArg, UArg, UArg, uint16_t, uint16_t)
+
+   Description:      This function displays a horizontal bar graph of a
+                     value at the passed row and column.
+
+   Operation:        The length of the bar in pixel columns is found from the
+                     value.  Whole characters of the bar are the full block
+                     character and the last partial character is one of the
+                     bar glyphs (registered the first time they are needed),
+                     the rest of the width is spaces.  The glyphs are sent
+                     and the bar is displayed.
+
+   Arguments:        r (UArg) - row to display at.
+                     c (UArg) - column to display at.
+                     width (UArg) - width of the bar graph in characters.
+                     value (uint16_t) - the value to show.
+                     max (uint16_t) - value of a full bar graph.
+   Return Value:     (int) - value returned by Display.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The bar graph is displayed.
+
+   Error Handling:   Values above max show a full bar graph, a max of 0
+                     shows an empty one.  The width is limited to one row.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/2/24  Adam Krivka      initial revision
+*/
+int Display_bar(UArg r, UArg c, UArg width, uint16_t value, uint16_t max) {
+    /* variables */
+    char textBuf[TEXT_BUF_SIZE];        /* text buffer */
+    uint32_t pixels;                    /* lit pixel columns */
+    uint8_t i;                          /* character index */
+
+    /* limit the arguments */
+    if (width > TEXT_BUF_SIZE - 1)
+        width = TEXT_BUF_SIZE - 1;
+    if (value > max)
+        value = max;
+
+    /* length of the bar */
+    pixels = (max == 0) ? 0 : ((uint32_t)value * width * BAR_COLS) / max;
+
+    /* build the bar graph */
+    for (i = 0; i < width; i++) {
+        if (pixels >= BAR_COLS) {
+            /* a whole character */
+            textBuf[i] = LCD_FULL_BLOCK;
+            pixels -= BAR_COLS;
+        }
+        else if (pixels > 0) {
+            /* the partial end of the bar */
+            if (barGlyphs[pixels - 1] == GLYPH_NONE)
+                barGlyphs[pixels - 1] = GlyphRegister(barPatterns[pixels - 1]);
+            textBuf[i] = GlyphChar(barGlyphs[pixels - 1]);
+            pixels = 0;
+        }
+        else {
+            /* past the end of the bar */
+            textBuf[i] = ' ';
+        }
+    }
+    textBuf[i] = '\0';
+
+    /* send any new glyphs and show it */
+    GlyphUpload();
+    return Display(r, c, textBuf, width);
+}
@@ -0,0 +1,40 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               lcd_glyph.h                                */
+/*                         LCD Custom Glyph Manager                         */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the constants and declarations for the custom glyph
+    manager defined in lcd_glyph.c.  It also serves as the interface include
+    file.
+
+   Revision History:
+       5/2/24  Adam Krivka      initial revision
+*/
+
+#ifndef LCD_GLYPH_H
+    #define LCD_GLYPH_H
+
+#include  <stdint.h>
+
+/* constants */
+#define GLYPH_MAX               16      /* glyphs that can be registered */
+#define GLYPH_NUM_SLOTS         8       /* glyphs the LCD holds at once */
+#define GLYPH_ROWS              8       /* rows of a 5x8 glyph pattern */
+#define GLYPH_NONE              0xFF    /* no glyph/slot */
+#define GLYPH_CHAR_BASE         8       /* character code of slot 0 (codes */
+                                        /*    8-15 mirror 0-7, 0 ends strings) */
+
+/* LCD instructions */
+#define LCD_SET_CGRAM_ADDR      0x40    /* set CGRAM address instruction */
+#define LCD_FULL_BLOCK          0xFF    /* ROM character with every pixel on */
+
+/* function declarations */
+uint8_t GlyphRegister(const uint8_t *pattern);
+char    GlyphChar(uint8_t glyph);
+void    GlyphUpload();
+int     Display_bar(UArg r, UArg c, UArg width, uint16_t value, uint16_t max);
+
+#endif
@@ -25,6 +25,7 @@
     .ref   LCDWaitForNotBusy
     .ref   LCDWrite
     .ref   LCDConfigureForWrite
+    .ref   ResetShadow
 
 ; export functions to other files
     .def   LCDInit
@@ -42,7 +43,7 @@
     .align 4 ; align to word
 LCDInitTab:
            ;Command         Delay Count
-    .word   00111000b,     15000 * LOOPS_PER_US   ; wait for 150ms
+    .word   00111000b,     15000 * LOOPS_PER_US   ; wait for 15ms
     .word   00111000b,     4100 * LOOPS_PER_US    ; wait for 4.1ms
     .word   00111000b,     100 * LOOPS_PER_US     ; wait for 100us
     .word   00111000b,     -1      ; function set
@@ -79,6 +80,7 @@ EndLCDInitTab:
 ; 
 ; Revision History:
 ;     11/22/23  Adam Krivka      initial revision
+;     4/22/24   Adam Krivka      reset the display shadow
 
 
 LCDInit:
@@ -141,6 +143,9 @@ LCDInitLoopWrite:
     CMP     R4, R5
     BNE     LCDInitLoop
 
+    ; the table cleared the display, so the shadow is blank too
+    BL      ResetShadow
+
 LCDInitEnd:
     POP     {LR, R4, R5, R6, R7}        ; restore return address and used registers
     BX      LR                          ; return
@@ -15,9 +15,13 @@
 ;   LCDWrite
 ;   LCDRead
 ;   LCDWaitForNotBusy
+;   LCDIsBusy
 ; 
 ; Revision History:
 ;     11/22/23  Adam Krivka      initial revision
+;     4/24/24   Adam Krivka      added LCDIsBusy
+;     5/18/24   Adam Krivka      LCDRead reads the data before E goes low
+;     5/18/24   Adam Krivka      clear the stale timer match before each pulse
 
 
 
@@ -32,6 +36,7 @@
     .def LCDWrite
     .def LCDRead
     .def LCDWaitForNotBusy
+    .def LCDIsBusy
     .def LCDConfigureForWrite
     .def LCDConfigureForRead
 
@@ -161,6 +166,7 @@ LCDConfigureForWrite:
 ; 
 ; Revision History:
 ;     11/22/23  Adam Krivka      initial revision
+;     5/18/24   Adam Krivka      clear the stale timer match before the pulse
 
 ; R4 = GPIO_BASE_ADDR
 ; R5 = TIMER_BASE_ADDR
@@ -179,8 +185,9 @@ LCDWriteWaitTimeOut:
     TST     R2, #GPT_RIS_TATORIS     ; check if timer A timed out
     BEQ     LCDWriteWaitTimeOut      ; if not, wait
 
-    ; clear interrupt
-    MOVW    R2, #GPT_ICLR_TATOCINT_CLEAR
+    ; clear the time-out and the match left from the last run (the timer
+    ;   passes the match again after it is cleared at the end of the pulse)
+    MOVW    R2, #(GPT_ICLR_TATOCINT_CLEAR | GPT_ICLR_TAMCINT_CLEAR)
     STR     R2, [R5, #GPT_ICLR_OFFSET] ; write to interrupt clear register
 
     ; write RS based on argument and R/W low
@@ -265,6 +272,8 @@ LCDWriteDone:
 ; 
 ; Revision History:
 ;     11/22/23  Adam Krivka      initial revision
+;     5/18/24   Adam Krivka      read the data while E is still high
+;     5/18/24   Adam Krivka      clear the stale timer match before the pulse
 
 
 ; R4 = GPIO_BASE_ADDR
@@ -285,8 +294,8 @@ LCDReadWaitTimeOut:
     TST     R2, #GPT_RIS_TATORIS     ; check if timer A timed out
     BEQ     LCDReadWaitTimeOut       ; if not, wait
 
-    ; clear interrupt
-    MOVW    R2, #GPT_ICLR_TATOCINT_CLEAR
+    ; clear the time-out and the match left from the last run
+    MOVW    R2, #(GPT_ICLR_TATOCINT_CLEAR | GPT_ICLR_TAMCINT_CLEAR)
     STR     R2, [R5, #GPT_ICLR_OFFSET]; write to interrupt clear register
 
     ; write RS based on argument and R/W low
@@ -302,7 +311,7 @@ LCDReadWaitTimeOut:
     CPSIE i   ; enable interrupts
 
     ; wait for 140ns 
-    MOV     R2, #4
+    MOV     R2, #LOOPS_IN_SETUP
 LCDReadWaitSetup:
     SUBS    R2, #1              ; decrement counter
     BNE     LCDReadWaitSetup
@@ -327,6 +336,10 @@ LCDReadWaitPulse:
     ; clear interrupt
     STREG   GPT_ICLR_TAMCINT_CLEAR, R5, GPT_ICLR_OFFSET; write to interrupt clear register
 
+    ; read the data while E is still high (the LCD only holds it for
+    ;   5ns after E goes low)
+    LDR     R3, [R4, #GPIO_DIN_OFFSET]  ; read DIN
+
     ; write E low
     CPSID i   ; disable interrupts because if interrupted we could overwrite 
             ; changes to DOUT
@@ -337,8 +350,7 @@ LCDReadWaitPulse:
     CPSIE i   ; enable interrupts
 
     ; recover data
-    LDR     R0, [R4, #GPIO_DIN_OFFSET]  ; read DIN
-    LSR     R0, #DATA_0_PIN             ; shift data to the right
+    LSR     R0, R3, #DATA_0_PIN         ; shift data to the right
     AND     R0, #DATA_MASK              ; mask out the rest of the bits
 
 LCDReadEnd:
@@ -390,3 +402,59 @@ LCDWaitForNotBusyDone:
     
     POP     {LR}                ; restore return address
     BX      LR                  ; return
+
+
+
+; LCDIsBusy
+;
+; Description:          Reads the busy flag of the LCD once, without waiting
+;                       for it to be cleared.
+;
+; Arguments:            None.
+; Return Values:        TRUE in R0 if the LCD is busy, FALSE if not.
+;
+; Local Variables:      None.
+; Shared Variables:     None.
+; Global Variables:     None.
+;
+; Inputs:               None.
+; Outputs:              None.
+;
+; Error Handling:       None.
+;
+; Registers Changed:    flags, R0, R1, R2, R3
+; Stack Depth:          5
+; 
+; Revision History:
+;     4/24/24   Adam Krivka      initial revision
+
+LCDIsBusy:
+    PUSH    {LR, R4}            ; store return address and used register
+
+    ; configure pins for read
+    BL      LCDConfigureForRead
+
+    ; read busy flag
+    MOV     R0, #0              ; RS = 0
+    BL      LCDRead             ; call LCDRead(RS)
+    MOV     R4, R0              ; save status
+
+    ; configure pins back for write
+    BL      LCDConfigureForWrite
+
+    ; test if busy flag is set
+    TST     R4, #BUSY_FLAG_MASK
+    BNE     LCDIsBusyTrue       ; if set, it is busy
+    ;B      LCDIsBusyFalse      ; if not set, it isn't
+
+LCDIsBusyFalse:
+    MOV32   R0, FALSE           ; return not busy
+    B       LCDIsBusyDone
+
+LCDIsBusyTrue:
+    MOV32   R0, TRUE            ; return busy
+    ;B      LCDIsBusyDone
+
+LCDIsBusyDone:
+    POP     {LR, R4}            ; restore return address and used register
+    BX      LR                  ; return
@@ -0,0 +1,302 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              lcd_marquee.c                               */
+/*                          LCD Scrolling Marquee                           */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a scrolling marquee for showing text longer than the
+   space it has on the LCD.  Each region is a window of a row that shows
+   part of its text, and moves one character on every step.  The caller
+   steps the marquee from its own task (usually on a clock tick), so the
+   display functions are never called from two threads at once.  Only the
+   cells that change are written to the LCD (Display compares the window
+   with the display shadow).  Functions included are:
+        MarqueeStart   - show text in a region, scrolling it if it is long
+        MarqueeStop    - stop scrolling a region
+        MarqueeStopAll - stop scrolling all the regions
+        MarqueeStep    - move every scrolling region one character
+
+   Local functions:
+        MarqueeDraw - display the window of a region
+
+   Revision History:
+       4/30/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <xdc/std.h>
+#include  <stddef.h>
+
+/* local includes */
+#include "lcd_marquee.h"
+#include "lcd_util.h"
+#include "lcd_rtos_intf.h"
+
+/* structures */
+
+/* a scrolling region */
+typedef struct {
+    bool     active;                    /* whether the region is scrolling */
+    uint8_t  row;                       /* row of the window */
+    uint8_t  col;                       /* first column of the window */
+    uint8_t  width;                     /* width of the window */
+    uint8_t  len;                       /* length of the text */
+    uint8_t  offset;                    /* text position at the window start */
+    uint8_t  pause;                     /* steps left to hold the position */
+    char     text[MARQUEE_TEXT_SIZE];   /* the text */
+} marquee_t;
+
+/* shared/global variables */
+
+/* the regions */
+static marquee_t regions[MARQUEE_NUM_REGIONS];
+
+/* local functions */
+static void MarqueeDraw(marquee_t *pRegion);
+
+
+
+/* functions */
+
+/*
+   MarqueeStart(uint8_t, UArg, UArg, UArg, const char *)
+
+   Description:      This function shows text in a region of the LCD.  If the
+                     text doesn't fit in the region it scrolls (on calls to
+                     MarqueeStep), otherwise it is displayed padded to the
+                     region width and stays put.
+
+   Operation:        The text is copied into the region (so the caller's
+                     buffer can be freed) and the start of it is displayed.
+                     Long text is held at its start for MARQUEE_PAUSE_STEPS
+                     steps before it starts moving.
+
+   Arguments:        region (uint8_t) - region to use.
+                     r (UArg) - row of the region.
+                     c (UArg) - first column of the region.
+                     width (UArg) - width of the region.
+                     str (const char *) - text to show.
+   Return Value:     (int) - value returned by Display, -1 for a bad region.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The start of the text is displayed.
+
+   Error Handling:   Text longer than MARQUEE_TEXT_SIZE - 1 is truncated and
+                     a region wider than a row is narrowed to one row.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/30/24 Adam Krivka      initial revision
+*/
+int MarqueeStart(uint8_t region, UArg r, UArg c, UArg width, const char *str) {
+    /* variables */
+    marquee_t *pRegion;                 /* the region */
+    uint8_t len = 0;                    /* length of the text */
+
+    /* check the region */
+    if (region >= MARQUEE_NUM_REGIONS)
+        return (-1);
+    pRegion = &regions[region];
+
+    /* copy the text */
+    while ((len < MARQUEE_TEXT_SIZE - 1) && (str[len] != '\0')) {
+        pRegion->text[len] = str[len];
+        len++;
+    }
+    pRegion->text[len] = '\0';
+
+    /* set up the region */
+    if (width > TEXT_BUF_SIZE - 1)
+        width = TEXT_BUF_SIZE - 1;
+    pRegion->row = r;
+    pRegion->col = c;
+    pRegion->width = width;
+    pRegion->len = len;
+    pRegion->offset = 0;
+    pRegion->pause = MARQUEE_PAUSE_STEPS;
+
+    /* short text doesn't need to scroll */
+    pRegion->active = (len > width);
+    if (!pRegion->active)
+        return Display(r, c, pRegion->text, width);
+
+    /* show the start of the text */
+    MarqueeDraw(pRegion);
+
+    return (0);
+}
+
+/*
+   MarqueeStop(uint8_t)
+
+   Description:      This function stops a region from scrolling.  The
+                     window stays as it is on the display.
+
+   Operation:        The region is marked inactive.
+
+   Arguments:        region (uint8_t) - region to stop.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Bad regions are ignored.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/30/24 Adam Krivka      initial revision
+*/
+void MarqueeStop(uint8_t region) {
+    /* stop it if it exists */
+    if (region < MARQUEE_NUM_REGIONS)
+        regions[region].active = false;
+
+    return;
+}
+
+/*
+   MarqueeStopAll()
+
+   Description:      This function stops all the regions from scrolling, e.g.
+                     when the screen changes.
+
+   Operation:        Every region is marked inactive.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/30/24 Adam Krivka      initial revision
+*/
+void MarqueeStopAll() {
+    /* variables */
+    uint8_t i;                          /* loop index */
+
+    /* stop every region */
+    for (i = 0; i < MARQUEE_NUM_REGIONS; i++)
+        regions[i].active = false;
+
+    return;
+}
+
+/*
+   MarqueeStep()
+
+   Description:      This function moves every scrolling region one
+                     character to the left.  It must be called from the task
+                     that does the rest of the displaying.
+
+   Operation:        For each active region that isn't holding its position
+                     the offset is advanced, wrapping around after the text
+                     and the gap.  When the text is back at its start it is
+                     held there again for MARQUEE_PAUSE_STEPS steps.  The
+                     window is then redrawn.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any region is still scrolling (the
+                     caller can stop its clock if not).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The windows are redrawn.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/30/24 Adam Krivka      initial revision
+*/
+bool MarqueeStep() {
+    /* variables */
+    marquee_t *pRegion;                 /* region being stepped */
+    bool running = false;               /* whether any region is scrolling */
+    uint8_t i;                          /* loop index */
+
+    /* step every active region */
+    for (i = 0; i < MARQUEE_NUM_REGIONS; i++) {
+        pRegion = &regions[i];
+        if (!pRegion->active)
+            continue;
+        running = true;
+
+        /* hold the start for a while */
+        if (pRegion->pause > 0) {
+            pRegion->pause--;
+            continue;
+        }
+
+        /* move one character, wrapping after the gap */
+        pRegion->offset++;
+        if (pRegion->offset >= pRegion->len + MARQUEE_GAP) {
+            pRegion->offset = 0;
+            pRegion->pause = MARQUEE_PAUSE_STEPS;
+        }
+
+        /* show it */
+        MarqueeDraw(pRegion);
+    }
+
+    return (running);
+}
+
+
+
+/* local functions */
+
+/*
+   MarqueeDraw(marquee_t *)
+
+   Description:      This function displays the window of a region.
+
+   Operation:        The window is built from the text starting at the
+                     region offset, with MARQUEE_GAP spaces after the end of
+                     the text before it starts over, and passed to Display.
+                     Display only writes the cells that changed.
+
+   Arguments:        pRegion (marquee_t *) - region to display.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The window is displayed.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/30/24 Adam Krivka      initial revision
+*/
+static void MarqueeDraw(marquee_t *pRegion) {
+    /* variables */
+    char window[TEXT_BUF_SIZE];         /* the window contents */
+    uint8_t pos = pRegion->offset;      /* position in the text and gap */
+    uint8_t i;                          /* position in the window */
+
+    /* fill in the window */
+    for (i = 0; i < pRegion->width; i++) {
+        window[i] = (pos < pRegion->len) ? pRegion->text[pos] : ' ';
+        if (++pos >= pRegion->len + MARQUEE_GAP)
+            pos = 0;
+    }
+    window[i] = '\0';
+
+    /* and show it */
+    Display(pRegion->row, pRegion->col, window, pRegion->width);
+
+    return;
+}
@@ -0,0 +1,35 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              lcd_marquee.h                               */
+/*                          LCD Scrolling Marquee                           */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the constants and declarations for the scrolling
+    marquee defined in lcd_marquee.c.  It also serves as the interface
+    include file.
+
+   Revision History:
+       4/30/24 Adam Krivka      initial revision
+*/
+
+#ifndef LCD_MARQUEE_H
+    #define LCD_MARQUEE_H
+
+#include  <stdint.h>
+#include  <stdbool.h>
+
+/* constants */
+#define MARQUEE_NUM_REGIONS     2       /* independent scrolling regions */
+#define MARQUEE_TEXT_SIZE       128     /* longest text that can scroll */
+#define MARQUEE_GAP             3       /* spaces between end and start */
+#define MARQUEE_PAUSE_STEPS     4       /* steps to hold the start of the text */
+
+/* function declarations */
+int  MarqueeStart(uint8_t region, UArg r, UArg c, UArg width, const char *str);
+void MarqueeStop(uint8_t region);
+void MarqueeStopAll();
+bool MarqueeStep();
+
+#endif
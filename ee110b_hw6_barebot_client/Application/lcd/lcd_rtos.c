@@ -0,0 +1,644 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 lcd_rtos.c                               */
+/*                         LCD RTOS C wrapper code                          */
+/*                                                                          */
+/****************************************************************************/
+
+/* 14-pin LCD RTOS C wrapper code.  After initialization every operation on
+   the LCD goes through a queue that a clock function drains one operation at
+   a time whenever the LCD isn't busy, so the tasks writing to the display
+   never wait for the LCD.  Functions included:
+        LCDInit_RTOS() - initialize the LCD and its operation queue
+        LCDEnqueue()   - queue a write to the LCD
+        LCDFlush()     - wait for all queued operations to be done
+        LCDGetStats()  - get the queue timing statistics
+
+   Local functions:
+        LCDQueueStep() - clock function, does the next queued operation
+        LCDQueueDrainOne() - does the oldest operation, waiting for the LCD
+        LCDWriteOp()   - write an operation and note how long it takes
+        LCDMeasureTiming() - measure the LCD write time and set the step
+                             period from it
+
+   With LCD_ADAPTIVE_TIMING set the queue steps are paced to the write time
+   measured at initialization instead of the worst case LCD_STEP_US, and a
+   step that comes at least the measured time (plus the margin) after the
+   last write writes without reading the busy flag first.  Every other
+   step reads the busy flag before writing, except the steps a slow command
+   (clear display, return home) is known to take, which are skipped
+   without reading the LCD.
+
+   Revision History:
+       4/24/24 Adam Krivka      initial revision
+       5/4/24  Adam Krivka      added adaptive timing and timing statistics
+       5/18/24 Adam Krivka      timed writes skip the busy read, slow
+                                commands skip their steps
+*/
+
+
+
+/* library includes */
+#include  <ti/sysbios/BIOS.h>
+#include  <ti/sysbios/knl/Clock.h>
+#include  <ti/sysbios/knl/Swi.h>
+#include  <ti/sysbios/knl/Semaphore.h>
+#include  <ti/sysbios/hal/Hwi.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+
+/* driverlib includes */
+#include  <inc/hw_types.h>
+#include  <inc/hw_memmap.h>
+#include  <inc/hw_cpu_dwt.h>
+#include  <inc/hw_cpu_scs.h>
+
+
+/* local includes */
+#include "lcd_rtos_intf.h"
+
+/* declarations of the assembly functions */
+void LCDInit();
+void LCDWrite(UArg rs, UArg data);
+void LCDWaitForNotBusy();
+int  LCDIsBusy();
+void LCDInvalidateCursor();
+
+/* compile options */
+#ifndef LCD_ADAPTIVE_TIMING
+#define LCD_ADAPTIVE_TIMING     1       /* pace the queue to measured timing */
+#endif
+
+/* constants */
+#define LCD_QUEUE_SIZE  128     /* operations that can be queued (enough for */
+                                /*    every cell plus its address command)   */
+#define LCD_STEP_US     50      /* time between queue steps in us (about the */
+                                /*    time the LCD takes for a command)      */
+#define LCD_OP_RS       0x100   /* operation bit set for a data register write */
+#define LCD_OP_DATA     0xFF    /* operation bits holding the byte to write */
+#define LCD_SLOW_CMD_END 0x04   /* commands below this (clear display and */
+                                /*    return home) are slow */
+#define LCD_SLOW_US     1520    /* time a slow command takes in us */
+
+#define LCD_CPU_MHZ             48      /* CPU clock (cycle counter) in MHz */
+#define LCD_SET_DDRAM_ADDR      0x80    /* command timed (harmless, address 0) */
+#define LCD_MEASURE_SAMPLES     4       /* writes timed at initialization */
+#define LCD_MEASURE_MAX_US      2000    /* longest a timed write may take */
+#define LCD_TIMING_MARGIN       5       /* margin on the measured time in % */
+
+
+/* local variables */
+
+/* queue of operations (written at head + count, done from head) */
+static uint16_t lcdQueue[LCD_QUEUE_SIZE];
+static uint16_t lcdQueueHead = 0;
+static uint16_t lcdQueueCount = 0;
+
+/* clock draining the queue (NULL until initialized) */
+static Clock_Struct lcdClock;
+static Clock_Handle lcdClockHandle = NULL;
+
+/* semaphore posted when the queue empties */
+static Semaphore_Struct lcdFlushSem;
+static Semaphore_Handle lcdFlushSemHandle;
+
+/* timing statistics, cycle count at the last write, and whether the queue */
+/*    has been busy since then */
+static lcdStats_t lcdStats = { 0, 0, 0, 0, 0, LCD_STEP_US, 0 };
+static uint32_t lcdLastWrite = 0;
+static bool lcdPacing = false;
+
+/* cycles after a write the LCD is sure to be ready (0 if not measured), */
+/*    whether the last write was a slow command, and steps left that it is */
+/*    known to take */
+static uint32_t lcdReadyCycles = 0;
+static bool lcdSlowCmd = false;
+static uint16_t lcdSkipSteps = 0;
+
+/* local functions */
+static void LCDQueueStep(UArg arg);
+static void LCDQueueDrainOne();
+static void LCDWriteOp(uint16_t op);
+static void LCDMeasureTiming();
+static void LCDCountWrite();
+
+
+
+/*
+   LCDInit_RTOS()
+
+   Description:     This function initializes the LCD and the queue of LCD
+                    operations.  It is called once at the start of the
+                    program, before anything is displayed.
+
+   Operation:       The LCD is initialized with LCDInit (which waits for the
+                    LCD directly) and, with LCD_ADAPTIVE_TIMING, the time
+                    the LCD takes for a write is measured.  Then the clock
+                    that drains the queue (with a period of the step time
+                    rounded up to ticks) and the flush semaphore are
+                    constructed.  The clock is only started when there is
+                    something in the queue.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The LCD is initialized.
+
+   Error Handling:   None.  The clock and semaphore are constructed with no
+                     error checking, but they should not fail.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/24/24  Adam Krivka        initial revision
+                     5/4/24   Adam Krivka        added timing measurement
+*/
+void LCDInit_RTOS() {
+    /* variables */
+    Clock_Params clockParams;           /* parameters for the queue clock */
+    Semaphore_Params semParams;         /* parameters for the flush semaphore */
+    UInt32 period;                      /* clock period in ticks */
+
+    /* initialize the LCD itself */
+    LCDInit();
+
+    /* enable the cycle counter for the timing statistics */
+    HWREG(CPU_SCS_BASE + CPU_SCS_O_DEMCR) |= CPU_SCS_DEMCR_TRCENA;
+    HWREG(CPU_DWT_BASE + CPU_DWT_O_CTRL) |= CPU_DWT_CTRL_CYCCNTENA;
+
+#if LCD_ADAPTIVE_TIMING
+    /* find out how fast this LCD is */
+    LCDMeasureTiming();
+#endif
+
+    /* set up the clock, at least one tick between steps */
+    period = (lcdStats.stepUs + Clock_tickPeriod - 1) / Clock_tickPeriod;
+    if (period == 0)
+        period = 1;
+    lcdStats.stepTicks = period;
+    Clock_Params_init(&clockParams);
+    clockParams.period = period;
+    clockParams.startFlag = FALSE;
+    Clock_construct(&lcdClock, LCDQueueStep, period, &clockParams);
+
+    /* set up the flush semaphore */
+    Semaphore_Params_init(&semParams);
+    semParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&lcdFlushSem, 0, &semParams);
+    lcdFlushSemHandle = Semaphore_handle(&lcdFlushSem);
+
+    /* the queue can be used now */
+    lcdClockHandle = Clock_handle(&lcdClock);
+
+    return;
+}
+
+
+/*
+   LCDEnqueue(UArg, UArg)
+
+   Description:     This function queues a write to the LCD.  It returns
+                    without waiting for the LCD, the write is done later by
+                    the queue clock in the order it was queued.
+
+   Operation:       The operation is added to the end of the queue with
+                    interrupts disabled and the queue clock is started if it
+                    isn't running.  If the queue is full the oldest
+                    operation is done right away (waiting for the LCD) to
+                    make room, so no operation is ever lost.  Before the
+                    queue is initialized the write is done directly.
+
+   Arguments:        rs (UArg)   - register select (0 for a command, 1 for
+                                   data).
+                     data (UArg) - byte to write.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The byte is written to the LCD (later).
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Ring buffer of operations.
+
+   Revision History: 4/24/24  Adam Krivka        initial revision
+*/
+void LCDEnqueue(UArg rs, UArg data) {
+    /* variables */
+    uint16_t op;                        /* the operation to queue */
+    UInt key;                           /* interrupt state to restore */
+
+    /* without the queue just write it */
+    if (lcdClockHandle == NULL) {
+        LCDWaitForNotBusy();
+        LCDWrite(rs, data);
+        return;
+    }
+
+    /* build the operation */
+    op = (data & LCD_OP_DATA);
+    if (rs != 0)
+        op |= LCD_OP_RS;
+
+    /* make room if the queue is full (only this task adds to it) */
+    if (lcdQueueCount == LCD_QUEUE_SIZE)
+        LCDQueueDrainOne();
+
+    /* add it to the end and make sure the queue is being drained */
+    key = Hwi_disable();
+    lcdQueue[(lcdQueueHead + lcdQueueCount) % LCD_QUEUE_SIZE] = op;
+    lcdQueueCount++;
+    if (!Clock_isActive(lcdClockHandle))
+        Clock_start(lcdClockHandle);
+    Hwi_restore(key);
+
+    return;
+}
+
+
+/*
+   LCDFlush()
+
+   Description:     This function waits until every queued LCD operation has
+                    been done.  It is the fence to use when something has to
+                    happen only after the display is up to date.  It must be
+                    called from a task.
+
+   Operation:       While the queue isn't empty the function waits on the
+                    semaphore posted by the queue clock when it empties the
+                    queue.  The count is checked again after every wakeup
+                    since the semaphore may have been posted by an earlier
+                    flush.  Before the queue is initialized there is nothing
+                    to wait for.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/24/24  Adam Krivka        initial revision
+*/
+void LCDFlush() {
+    /* wait for the queue to be empty */
+    while ((lcdClockHandle != NULL) && (lcdQueueCount != 0))
+        Semaphore_pend(lcdFlushSemHandle, BIOS_WAIT_FOREVER);
+
+    return;
+}
+
+
+/*
+   LCDGetStats(lcdStats_t *)
+
+   Description:     This function gets the LCD queue timing statistics.  The
+                    average time per byte while the queue is draining is
+                    pacedCycles / pacedBytes CPU cycles.
+
+   Operation:       The statistics are copied with interrupts disabled.
+
+   Arguments:        pStats (lcdStats_t *) - where to copy the statistics.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/4/24  Adam Krivka        initial revision
+*/
+void LCDGetStats(lcdStats_t *pStats) {
+    /* variables */
+    UInt key;                           /* interrupt state to restore */
+
+    /* copy them all at once */
+    key = Hwi_disable();
+    *pStats = lcdStats;
+    Hwi_restore(key);
+
+    return;
+}
+
+
+/*
+   LCDQueueStep(UArg)
+
+   Description:     This function is the queue clock function.  It does the
+                    oldest queued operation if the LCD is ready for it.
+
+   Operation:       If the queue is empty the clock is stopped and the flush
+                    semaphore is posted.  Otherwise, unless the step is one
+                    a slow command is known to take, the oldest operation is
+                    written and removed from the queue if the LCD is ready:
+                    it is if the measured time has passed since the last
+                    write (and that wasn't a slow command), else the busy
+                    flag is read once.  The LCD is busy right after a write,
+                    so one operation is done per step.
+                    Skipped steps and writes are counted for the timing
+                    statistics.
+
+   Arguments:        arg (UArg) - unused.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           The LCD busy flag is read.
+   Outputs:          A byte may be written to the LCD.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Ring buffer of operations.
+
+   Revision History: 4/24/24  Adam Krivka        initial revision
+                     5/4/24   Adam Krivka        added timing statistics
+                     5/18/24  Adam Krivka        skip the steps of slow
+                                                 commands, no busy read
+                                                 once the measured time
+                                                 has passed
+*/
+static void LCDQueueStep(UArg arg) {
+    /* variables */
+    uint16_t op;                        /* the operation to do */
+    UInt key;                           /* interrupt state to restore */
+
+    /* the clock argument is not used */
+    (void) arg;
+
+    /* stop if there is nothing left (checked with interrupts off so an */
+    /*    operation queued now restarts the clock) */
+    key = Hwi_disable();
+    if (lcdQueueCount == 0) {
+        Clock_stop(lcdClockHandle);
+        lcdPacing = false;
+        Hwi_restore(key);
+        Semaphore_post(lcdFlushSemHandle);
+        return;
+    }
+    Hwi_restore(key);
+
+    /* try again next step if the LCD is still busy (it certainly is */
+    /*    during a slow command, and certainly isn't once the measured */
+    /*    time has passed, no need to read it then) */
+    if (lcdSkipSteps != 0) {
+        lcdSkipSteps--;
+        lcdStats.busySteps++;
+        return;
+    }
+    if (((lcdReadyCycles == 0) || lcdSlowCmd
+            || ((HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT) - lcdLastWrite)
+                < lcdReadyCycles))
+            && LCDIsBusy()) {
+        lcdStats.busySteps++;
+        return;
+    }
+
+    /* do the oldest operation */
+    op = lcdQueue[lcdQueueHead];
+    LCDWriteOp(op);
+
+    /* and remove it */
+    key = Hwi_disable();
+    lcdQueueHead = (lcdQueueHead + 1) % LCD_QUEUE_SIZE;
+    lcdQueueCount--;
+    Hwi_restore(key);
+
+    return;
+}
+
+
+/*
+   LCDQueueDrainOne()
+
+   Description:     This function does the oldest queued operation right
+                    away, waiting for the LCD if it is busy.  It is used to
+                    make room in a full queue.
+
+   Operation:       Software interrupts are disabled so the queue clock
+                    can't do an operation at the same time, then the function
+                    waits for the LCD, writes the oldest operation, and
+                    removes it from the queue.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           The LCD busy flag is read.
+   Outputs:          A byte is written to the LCD.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Ring buffer of operations.
+
+   Revision History: 4/24/24  Adam Krivka        initial revision
+                     5/4/24   Adam Krivka        added timing statistics
+*/
+static void LCDQueueDrainOne() {
+    /* variables */
+    uint16_t op;                        /* the operation to do */
+    UInt swiKey;                        /* software interrupt state to restore */
+    UInt key;                           /* interrupt state to restore */
+
+    /* keep the queue clock out */
+    swiKey = Swi_disable();
+
+    /* the clock may have emptied some of it already */
+    if (lcdQueueCount != 0) {
+        /* do the oldest operation */
+        op = lcdQueue[lcdQueueHead];
+        LCDWaitForNotBusy();
+        LCDWriteOp(op);
+
+        /* and remove it */
+        key = Hwi_disable();
+        lcdQueueHead = (lcdQueueHead + 1) % LCD_QUEUE_SIZE;
+        lcdQueueCount--;
+        Hwi_restore(key);
+    }
+
+    Swi_restore(swiKey);
+
+    return;
+}
+
+
+/*
+   LCDWriteOp(uint16_t)
+
+   Description:     This function writes a queued operation to the LCD.  The
+                    LCD must not be busy.
+
+   Operation:       The byte is written to the register the operation
+                    selects and counted for the timing statistics.  For a
+                    slow command the steps it is known to take (LCD_SLOW_US
+                    over the step period) are set to be skipped and the busy
+                    flag must be read after them, for any other write no
+                    steps are skipped.
+
+   Arguments:        op (uint16_t) - the operation (LCD_OP_RS and the byte).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          A byte is written to the LCD.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/18/24  Adam Krivka        initial revision
+*/
+static void LCDWriteOp(uint16_t op) {
+    /* count it and write it */
+    LCDCountWrite();
+    LCDWrite(((op & LCD_OP_RS) != 0), (op & LCD_OP_DATA));
+
+    /* the steps the LCD is sure to be busy for */
+    lcdSlowCmd = (((op & LCD_OP_RS) == 0) && ((op & LCD_OP_DATA) != 0)
+                  && ((op & LCD_OP_DATA) < LCD_SLOW_CMD_END));
+    if (lcdSlowCmd)
+        lcdSkipSteps = LCD_SLOW_US / (lcdStats.stepTicks * Clock_tickPeriod);
+    else
+        lcdSkipSteps = 0;
+
+    return;
+}
+
+
+/*
+   LCDMeasureTiming()
+
+   Description:     This function measures how long the LCD takes to finish
+                    a write and sets the queue step period from it.  It is
+                    called once at initialization, before the queue is used.
+
+   Operation:       A set DDRAM address command is written
+                    LCD_MEASURE_SAMPLES times and the cycles from the start
+                    of the write until the busy flag clears are counted (the
+                    cycle counter must be enabled), keeping the longest.  The step time is that
+                    plus LCD_TIMING_MARGIN percent, but never more than the
+                    worst case LCD_STEP_US.  The same time in cycles is when
+                    the LCD is sure to be ready after the start of a write
+                    (LCDCountWrite saves it), so a step that late doesn't
+                    need to read the busy flag (a busy
+                    read and a write don't fit in a 40 us step, the write
+                    alone does).  Any earlier step still reads the busy
+                    flag, so a slow module (or a slow command like clear
+                    display) is only delayed, never written early.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           The LCD busy flag is read.
+   Outputs:          Commands are written to the LCD.
+
+   Error Handling:   If the busy flag doesn't clear within LCD_MEASURE_MAX_US
+                     the worst case period is kept.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/4/24  Adam Krivka        initial revision
+                     5/18/24 Adam Krivka        sets the ready time
+*/
+static void LCDMeasureTiming() {
+    /* variables */
+    uint32_t start;                     /* cycle count at the write */
+    uint32_t cycles;                    /* cycles until the LCD was ready */
+    uint32_t maxCycles = 0;             /* longest time measured */
+    uint32_t stepUs;                    /* step period in us */
+    uint8_t i;                          /* sample index */
+
+    /* time some writes */
+    for (i = 0; i < LCD_MEASURE_SAMPLES; i++) {
+        LCDWaitForNotBusy();
+        start = HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT);
+        LCDWrite(0, LCD_SET_DDRAM_ADDR);
+        do {
+            cycles = HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT) - start;
+        } while (LCDIsBusy()
+                 && (cycles < LCD_MEASURE_MAX_US * LCD_CPU_MHZ));
+
+        /* give up on a busy flag that doesn't clear */
+        if (cycles >= LCD_MEASURE_MAX_US * LCD_CPU_MHZ)
+            return;
+        if (cycles > maxCycles)
+            maxCycles = cycles;
+    }
+
+    /* the address counter moved */
+    LCDInvalidateCursor();
+
+    /* pace the steps to the measured time plus the margin */
+    lcdReadyCycles = (maxCycles * (100 + LCD_TIMING_MARGIN)) / 100;
+    stepUs = (lcdReadyCycles + LCD_CPU_MHZ - 1) / LCD_CPU_MHZ;
+    if (stepUs > LCD_STEP_US) {
+        /* too slow to be worth timing, read the busy flag every step */
+        stepUs = LCD_STEP_US;
+        lcdReadyCycles = 0;
+    }
+    lcdStats.busyUs = maxCycles / LCD_CPU_MHZ;
+    lcdStats.stepUs = stepUs;
+
+    return;
+}
+
+
+/*
+   LCDCountWrite()
+
+   Description:     This function updates the timing statistics for a write
+                    to the LCD.  It is called right before every queued
+                    write.
+
+   Operation:       The byte is counted.  If the queue has been busy since
+                    the last write, the cycles since that write are added to
+                    the paced time, so pacedCycles / pacedBytes is the
+                    average time per byte while the queue is draining.  The
+                    cycle count of this write is saved.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/4/24  Adam Krivka        initial revision
+*/
+static void LCDCountWrite() {
+    /* variables */
+    uint32_t now;                       /* cycle count of this write */
+
+    /* count it and time it from the last write */
+    now = HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT);
+    lcdStats.bytes++;
+    if (lcdPacing) {
+        lcdStats.pacedBytes++;
+        lcdStats.pacedCycles += now - lcdLastWrite;
+    }
+    lcdLastWrite = now;
+    lcdPacing = true;
+
+    return;
+}
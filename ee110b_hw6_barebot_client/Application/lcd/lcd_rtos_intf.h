@@ -8,14 +8,40 @@
 /* 14-pin 16x4 Character LCD RTOS Interface. Functions declared are:
         LCDInit() - initialize the LCD using RTOS hardware and software 
                     interrupts
+        LCDInit_RTOS() - initialize the LCD and the queue of LCD operations
+        LCDFlush() - wait for all queued LCD operations to be done
         Display() - display a string on the LCD at the specified row and 
                     column
         ClearDisplay() - clear the LCD display
+        LCDGetStats() - get the LCD queue timing statistics
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       4/24/24 Adam Krivka      added the operation queue
+       5/4/24  Adam Krivka      added the timing statistics
 */
 
+#ifndef LCD_RTOS_INTF_H
+    #define LCD_RTOS_INTF_H
+
+#include  <stdint.h>
+
+/* LCD queue timing statistics */
+typedef struct {
+    uint32_t bytes;                     /* bytes written from the queue */
+    uint32_t busySteps;                 /* steps skipped for a busy LCD */
+    uint32_t pacedBytes;                /* bytes written back to back */
+    uint32_t pacedCycles;               /* CPU cycles for the paced bytes */
+    uint32_t busyUs;                    /* measured write time in us */
+    uint32_t stepUs;                    /* time between queue steps in us */
+    uint32_t stepTicks;                 /* time between queue steps in ticks */
+} lcdStats_t;
+
 void    LCDInit();
 int     Display(UArg r, UArg c, char* str, UArg len);
 void    ClearDisplay();
+void    LCDInit_RTOS();
+void    LCDFlush();
+void    LCDGetStats(lcdStats_t *pStats);
+
+#endif
@@ -6,36 +6,705 @@
 /****************************************************************************/
 
 /* This file contains utility functions for the LCD. Functions included are:
-        Display_printf - print a formatted string to the LCD
+        Display_printf   - print a formatted string to the LCD
+        Display_int      - print an integer to the LCD
+        Display_fixed    - print a fixed-point number to the LCD
+        Display_labelInt - print a label followed by an integer to the LCD
+        Display_measureFormat - time the formatters (with LCD_FORMAT_TIMING)
+
+   Local functions:
+        FormatVa  - format a string into a buffer
+        FormatInt - format an integer into a buffer
+        FormatStr - copy a padded string into a buffer
+        FormatOld - format with System_sprintf_va (with LCD_FORMAT_TIMING)
+        FormatNew - format with FormatVa (with LCD_FORMAT_TIMING)
+
+   The formatting is done here instead of with System_sprintf_va, into a
+   buffer that holds one LCD row.  Display_printf supports %d, %i, %u, %x,
+   %c, %s and %%, with the '-' (left justify) and '0' (zero pad) flags and a
+   field width.  A precision on %d, %i or %u gives the number of fixed-point
+   decimals (the value is in units of 10^-precision), so "%.2d" prints 1234
+   as "12.34".  A precision on %s is the maximum number of characters.
+
+   With LCD_FORMAT_TIMING set, Display_measureFormat times the formatting
+   with the cycle counter, so it can be compared with System_sprintf_va
+   (what Display_printf used before) on the board.  The formats themselves
+   are checked on a host by testing/lcd_format (make).
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       4/26/24 Adam Krivka      own formatter, typed display helpers
+       5/18/24 Adam Krivka      added the formatting time measurement
 */
 
 /* includes */
-#include  <xdc/runtime/System.h>
+#include  <xdc/std.h>
+#include  <stdarg.h>
+#include  <stddef.h>
+#include  <stdbool.h>
 
 /* local includes */
 #include "lcd_util.h"
 #include "lcd_rtos_intf.h"
 
+#if LCD_FORMAT_TIMING
+/* cycle counter and the formatter being compared against */
+#include  <xdc/runtime/System.h>
+#include  <inc/hw_types.h>
+#include  <inc/hw_memmap.h>
+#include  <inc/hw_cpu_dwt.h>
+
+/* constants */
+#define FMT_TIMING_RUNS     16          /* times each value is formatted */
+#define FMT_TIMING_LABEL    "Speed:  "  /* label timed (as barebot_ui.c) */
+
+/* values timed, from short to as long as the formats allow */
+static const int32_t fmtTimingValues[] = { 0, 7, -42, 1234, -32768, 100000 };
+#define FMT_TIMING_VALUES   (sizeof(fmtTimingValues) / sizeof(int32_t))
+#define FMT_TIMING_CALLS    (FMT_TIMING_RUNS * FMT_TIMING_VALUES)
+
+/* room for System_sprintf_va, which doesn't stop at the end of a row */
+#define FMT_TIMING_BUF_SIZE 32
+
+/* the cycle counter (enabled by LCDInit_RTOS) */
+#define FMT_CYCLES()        HWREG(CPU_DWT_BASE + CPU_DWT_O_CYCCNT)
+#endif
+
 /* shared/global variables */
     /* none */
 
+/* local functions */
+static int FormatVa(char *buf, int size, const char *fmt, va_list args);
+static char *FormatInt(char *pOut, char *pEnd, uint32_t value, bool negative,
+                       uint8_t base, uint8_t decimals, uint8_t width,
+                       char pad, bool left);
+static char *FormatStr(char *pOut, char *pEnd, const char *str,
+                       uint8_t maxLen, uint8_t width, bool left);
+#if LCD_FORMAT_TIMING
+static void FormatOld(char *buf, const char *fmt, ...);
+static void FormatNew(char *buf, const char *fmt, ...);
+#endif
+
 
 
 /* functions */
 
+/*
+   Display_printf(UArg, UArg, UArg, char *, ...)
+
+   Description:      This function prints a formatted string to the LCD at
+                     the passed row and column (see the file header for the
+                     supported formats).
+
+   Operation:        The string is formatted into a row-sized buffer on the
+                     stack and passed to Display.
+
+   Arguments:        r (UArg) - row to display at.
+                     c (UArg) - column to display at.
+                     len (UArg) - target length (see Display).
+                     fmt (char *) - format string.
+                     ... - values for the format.
+   Return Value:     (int) - value returned by Display.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The string is displayed.
+
+   Error Handling:   Output that doesn't fit in one row is truncated.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 3/6/24  Adam Krivka      initial revision
+                     4/26/24 Adam Krivka      use FormatVa
+*/
 int Display_printf(UArg r, UArg c, UArg len, char *fmt, ...) {
     /* variables */
     char textBuf[TEXT_BUF_SIZE]; /* text buffer */
     va_list arg__va;                /* variable argument list */
 
-    /* print to textBuf (must use variadac args version here)*/
+    /* print to textBuf */
     (void)va_start(arg__va, fmt);
-    System_sprintf_va(textBuf, fmt, arg__va);
+    FormatVa(textBuf, TEXT_BUF_SIZE, fmt, arg__va);
     va_end(arg__va);
 
     /* display to LCD and return that value */
     return Display(r, c, textBuf, len);
 }
+
+/*
+   Display_int(UArg, UArg, UArg, int32_t)
+
+   Description:      This function prints an integer to the LCD at the
+                     passed row and column.  It does the same as
+                     Display_printf with "%d" without the format parsing.
+
+   Operation:        The integer is formatted into a row-sized buffer and
+                     passed to Display.
+
+   Arguments:        r (UArg) - row to display at.
+                     c (UArg) - column to display at.
+                     len (UArg) - target length (see Display).
+                     value (int32_t) - the integer to print.
+   Return Value:     (int) - value returned by Display.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The integer is displayed.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+*/
+int Display_int(UArg r, UArg c, UArg len, int32_t value) {
+    /* print it with no decimals */
+    return Display_fixed(r, c, len, value, 0);
+}
+
+/*
+   Display_fixed(UArg, UArg, UArg, int32_t, uint8_t)
+
+   Description:      This function prints a fixed-point number to the LCD at
+                     the passed row and column.  The value is in units of
+                     10^-decimals, so 1234 with 2 decimals prints "12.34".
+
+   Operation:        The number is formatted into a row-sized buffer and
+                     passed to Display.
+
+   Arguments:        r (UArg) - row to display at.
+                     c (UArg) - column to display at.
+                     len (UArg) - target length (see Display).
+                     value (int32_t) - the number to print.
+                     decimals (uint8_t) - number of decimal places.
+   Return Value:     (int) - value returned by Display.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The number is displayed.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+*/
+int Display_fixed(UArg r, UArg c, UArg len, int32_t value, uint8_t decimals) {
+    /* variables */
+    char textBuf[TEXT_BUF_SIZE]; /* text buffer */
+    char *pOut;                  /* end of the formatted number */
+
+    /* format the number (negated as unsigned so INT32_MIN works) */
+    pOut = FormatInt(textBuf, &textBuf[TEXT_BUF_SIZE - 1],
+                     (value < 0) ? -(uint32_t)value : (uint32_t)value,
+                     (value < 0), 10, decimals, 0, ' ', false);
+    *pOut = '\0';
+
+    /* display to LCD and return that value */
+    return Display(r, c, textBuf, len);
+}
+
+/*
+   Display_labelInt(UArg, UArg, UArg, const char *, int32_t)
+
+   Description:      This function prints a label followed by an integer to
+                     the LCD at the passed row and column.  It does the same
+                     as Display_printf with "<label>%d" without the format
+                     parsing.
+
+   Operation:        The label and the integer are formatted into a
+                     row-sized buffer and passed to Display.
+
+   Arguments:        r (UArg) - row to display at.
+                     c (UArg) - column to display at.
+                     len (UArg) - target length (see Display).
+                     label (const char *) - label to print first.
+                     value (int32_t) - the integer to print.
+   Return Value:     (int) - value returned by Display.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The label and integer are displayed.
+
+   Error Handling:   Output that doesn't fit in one row is truncated.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+*/
+int Display_labelInt(UArg r, UArg c, UArg len, const char *label,
+                     int32_t value) {
+    /* variables */
+    char textBuf[TEXT_BUF_SIZE]; /* text buffer */
+    char *pEnd = &textBuf[TEXT_BUF_SIZE - 1]; /* room for the NUL */
+    char *pOut;                  /* end of the formatted text */
+
+    /* format the label then the integer */
+    pOut = FormatStr(textBuf, pEnd, label, TEXT_BUF_SIZE, 0, false);
+    pOut = FormatInt(pOut, pEnd,
+                     (value < 0) ? -(uint32_t)value : (uint32_t)value,
+                     (value < 0), 10, 0, 0, ' ', false);
+    *pOut = '\0';
+
+    /* display to LCD and return that value */
+    return Display(r, c, textBuf, len);
+}
+
+
+#if LCD_FORMAT_TIMING
+/*
+   Display_measureFormat(lcdFormatStats_t *)
+
+   Description:      This function times formatting an integer the way
+                     Display_printf used to (System_sprintf_va), the way it
+                     does now (FormatVa), and the way Display_int and
+                     Display_labelInt do, both alone and after a label.
+                     Nothing is displayed.  It must be called after
+                     LCDInit_RTOS (which enables the cycle counter) and
+                     before BIOS_start, so nothing preempts it.
+
+   Operation:        Each way formats every value in fmtTimingValues
+                     FMT_TIMING_RUNS times between two reads of the cycle
+                     counter, and the cycles are divided by the number of
+                     calls.  The loop overhead is the same for every way.
+
+   Arguments:        pStats (lcdFormatStats_t *) - where to store the
+                        cycles per call.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/18/24 Adam Krivka      initial revision
+*/
+void Display_measureFormat(lcdFormatStats_t *pStats) {
+    /* variables */
+    char textBuf[FMT_TIMING_BUF_SIZE];  /* text buffer */
+    char *pEnd = &textBuf[TEXT_BUF_SIZE - 1]; /* end of a row, for the NUL */
+    char *pOut;                         /* end of the formatted text */
+    int32_t value;                      /* value being formatted */
+    uint32_t start;                     /* cycle count at the start */
+    uint8_t run;                        /* run index */
+    uint8_t i;                          /* value index */
+
+    /* "%d" the old way, then with FormatVa, then like Display_int */
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++)
+        for (i = 0; i < FMT_TIMING_VALUES; i++)
+            FormatOld(textBuf, "%d", fmtTimingValues[i]);
+    pStats->sprintfCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++)
+        for (i = 0; i < FMT_TIMING_VALUES; i++)
+            FormatNew(textBuf, "%d", fmtTimingValues[i]);
+    pStats->printfCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++) {
+        for (i = 0; i < FMT_TIMING_VALUES; i++) {
+            value = fmtTimingValues[i];
+            pOut = FormatInt(textBuf, pEnd,
+                             (value < 0) ? -(uint32_t)value : (uint32_t)value,
+                             (value < 0), 10, 0, 0, ' ', false);
+            *pOut = '\0';
+        }
+    }
+    pStats->intCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    /* the same after a label, like Display_labelInt */
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++)
+        for (i = 0; i < FMT_TIMING_VALUES; i++)
+            FormatOld(textBuf, FMT_TIMING_LABEL "%d", fmtTimingValues[i]);
+    pStats->labelSprintfCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++)
+        for (i = 0; i < FMT_TIMING_VALUES; i++)
+            FormatNew(textBuf, FMT_TIMING_LABEL "%d", fmtTimingValues[i]);
+    pStats->labelPrintfCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    start = FMT_CYCLES();
+    for (run = 0; run < FMT_TIMING_RUNS; run++) {
+        for (i = 0; i < FMT_TIMING_VALUES; i++) {
+            value = fmtTimingValues[i];
+            pOut = FormatStr(textBuf, pEnd, FMT_TIMING_LABEL, TEXT_BUF_SIZE,
+                             0, false);
+            pOut = FormatInt(pOut, pEnd,
+                             (value < 0) ? -(uint32_t)value : (uint32_t)value,
+                             (value < 0), 10, 0, 0, ' ', false);
+            *pOut = '\0';
+        }
+    }
+    pStats->labelIntCycles = (FMT_CYCLES() - start) / FMT_TIMING_CALLS;
+
+    return;
+}
+#endif
+
+
+/* local functions */
+
+/*
+   FormatVa(char *, int, const char *, va_list)
+
+   Description:      This function formats a string into a buffer (see the
+                     file header for the supported formats).
+
+   Operation:        The format string is copied into the buffer until a '%'
+                     is found.  Then the flags, width, precision and
+                     conversion are parsed and the next argument is
+                     formatted with FormatInt or FormatStr.  Unknown
+                     conversions are copied as they are.
+
+   Arguments:        buf (char *) - buffer to format into.
+                     size (int) - size of the buffer (at least 1).
+                     fmt (const char *) - format string.
+                     args (va_list) - values for the format.
+   Return Value:     (int) - length of the formatted string.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Output that doesn't fit in the buffer is truncated, the
+                     buffer is always NUL terminated.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+*/
+static int FormatVa(char *buf, int size, const char *fmt, va_list args) {
+    /* variables */
+    char *pOut = buf;                   /* next character to write */
+    char *pEnd = &buf[size - 1];        /* room left for the NUL */
+    const char *pConv;                  /* start of the conversion */
+    bool left;                          /* whether to left justify */
+    char pad;                           /* padding character */
+    uint8_t width;                      /* field width */
+    uint8_t precision;                  /* decimals or string length */
+    bool havePrecision;                 /* whether a precision was given */
+    int32_t value;                      /* signed argument */
+    char chStr[2];                      /* character argument as a string */
+
+    /* go through the format string */
+    while ((*fmt != '\0') && (pOut < pEnd)) {
+
+        /* plain characters are copied */
+        if (*fmt != '%') {
+            *pOut++ = *fmt++;
+            continue;
+        }
+
+        /* parse the flags */
+        pConv = fmt++;
+        left = false;
+        pad = ' ';
+        while ((*fmt == '-') || (*fmt == '0')) {
+            if (*fmt == '-')
+                left = true;
+            else
+                pad = '0';
+            fmt++;
+        }
+
+        /* parse the width */
+        width = 0;
+        while ((*fmt >= '0') && (*fmt <= '9'))
+            width = (width * 10) + (*fmt++ - '0');
+
+        /* parse the precision */
+        precision = 0;
+        havePrecision = false;
+        if (*fmt == '.') {
+            fmt++;
+            havePrecision = true;
+            while ((*fmt >= '0') && (*fmt <= '9'))
+                precision = (precision * 10) + (*fmt++ - '0');
+        }
+
+        /* do the conversion */
+        switch (*fmt) {
+        case 'd':
+        case 'i':
+            value = va_arg(args, int32_t);
+            pOut = FormatInt(pOut, pEnd,
+                             (value < 0) ? -(uint32_t)value : (uint32_t)value,
+                             (value < 0), 10, precision, width, pad, left);
+            break;
+        case 'u':
+            pOut = FormatInt(pOut, pEnd, va_arg(args, uint32_t), false, 10,
+                             precision, width, pad, left);
+            break;
+        case 'x':
+            pOut = FormatInt(pOut, pEnd, va_arg(args, uint32_t), false, 16, 0,
+                             width, pad, left);
+            break;
+        case 'c':
+            chStr[0] = (char)va_arg(args, int);
+            chStr[1] = '\0';
+            pOut = FormatStr(pOut, pEnd, chStr, 1, width, left);
+            break;
+        case 's':
+            pOut = FormatStr(pOut, pEnd, va_arg(args, const char *),
+                             havePrecision ? precision : TEXT_BUF_SIZE,
+                             width, left);
+            break;
+        case '%':
+            *pOut++ = '%';
+            break;
+        default:
+            /* not a conversion, copy it as it is */
+            while ((pConv <= fmt) && (*pConv != '\0') && (pOut < pEnd))
+                *pOut++ = *pConv++;
+            break;
+        }
+
+        /* past the conversion character */
+        if (*fmt != '\0')
+            fmt++;
+    }
+
+    /* terminate the string */
+    *pOut = '\0';
+
+    return (pOut - buf);
+}
+
+/*
+   FormatInt(char *, char *, uint32_t, bool, uint8_t, uint8_t, uint8_t, char,
+             bool)
+
+   Description:      This function formats an integer into a buffer.
+
+   Operation:        The digits are generated from the least significant
+                     end into a small local buffer, inserting the decimal
+                     point after the passed number of decimals and making
+                     sure there is at least one digit before it.  Then the
+                     sign, padding and digits are copied out in order.  Zero
+                     padding goes between the sign and the digits, space
+                     padding in front of the sign (or after the digits when
+                     left justifying).
+
+   Arguments:        pOut (char *) - where to write.
+                     pEnd (char *) - end of the room in the buffer.
+                     value (uint32_t) - magnitude of the integer.
+                     negative (bool) - whether the integer is negative.
+                     base (uint8_t) - 10 or 16.
+                     decimals (uint8_t) - digits after the decimal point.
+                     width (uint8_t) - minimum field width.
+                     pad (char) - padding character (' ' or '0').
+                     left (bool) - whether to left justify.
+   Return Value:     (char *) - where to write next.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Output past pEnd is dropped.  Too many decimals are
+                     limited to what fits in the local buffer.
+
+   Algorithms:       Repeated division by the base (the compiler turns the
+                     division by 10 into a multiplication).
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+*/
+static char *FormatInt(char *pOut, char *pEnd, uint32_t value, bool negative,
+                       uint8_t base, uint8_t decimals, uint8_t width,
+                       char pad, bool left) {
+    /* variables */
+    char digits[FMT_DIGITS_SIZE];       /* digits, least significant first */
+    uint8_t n = 0;                      /* number of digits */
+    uint8_t minDigits;                  /* digits needed (with the point) */
+    uint8_t len;                        /* length of the number */
+    uint8_t d;                          /* current digit */
+
+    /* generate the digits (at least one before the decimal point) */
+    if (decimals > FMT_DIGITS_SIZE - 12)
+        decimals = FMT_DIGITS_SIZE - 12;
+    minDigits = (decimals == 0) ? 1 : (decimals + 2);
+    do {
+        if ((decimals != 0) && (n == decimals)) {
+            digits[n++] = '.';
+        }
+        else {
+            d = value % base;
+            value /= base;
+            digits[n++] = (d < 10) ? ('0' + d) : ('a' + d - 10);
+        }
+    } while ((value != 0) || (n < minDigits));
+
+    /* length of the whole number */
+    len = n + (negative ? 1 : 0);
+
+    /* space padding in front */
+    if (!left && (pad == ' '))
+        for (; (width > len) && (pOut < pEnd); width--)
+            *pOut++ = ' ';
+
+    /* the sign */
+    if (negative && (pOut < pEnd))
+        *pOut++ = '-';
+
+    /* zero padding after the sign */
+    if (!left && (pad == '0'))
+        for (; (width > len) && (pOut < pEnd); width--)
+            *pOut++ = '0';
+
+    /* the digits, most significant first */
+    while ((n > 0) && (pOut < pEnd))
+        *pOut++ = digits[--n];
+
+    /* space padding after */
+    if (left)
+        for (; (width > len) && (pOut < pEnd); width--)
+            *pOut++ = ' ';
+
+    return (pOut);
+}
+
+/*
+   FormatStr(char *, char *, const char *, uint8_t, uint8_t, bool)
+
+   Description:      This function copies a string into a buffer, padded to
+                     a field width.
+
+   Operation:        If the string is right justified in a field, its
+                     length (up to maxLen) is found first for the padding in
+                     front.  Then the string is copied out, counting the
+                     characters for the padding after when left justifying.
+
+   Arguments:        pOut (char *) - where to write.
+                     pEnd (char *) - end of the room in the buffer.
+                     str (const char *) - the string.
+                     maxLen (uint8_t) - most characters to copy.
+                     width (uint8_t) - minimum field width.
+                     left (bool) - whether to left justify.
+   Return Value:     (char *) - where to write next.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Output past pEnd is dropped.  A NULL string is treated
+                     as empty.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 4/26/24 Adam Krivka      initial revision
+                     5/18/24 Adam Krivka      copied in one pass when there
+                                              is no padding in front
+*/
+static char *FormatStr(char *pOut, char *pEnd, const char *str,
+                       uint8_t maxLen, uint8_t width, bool left) {
+    /* variables */
+    uint8_t len = 0;                    /* length of the string */
+
+    if (str == NULL)
+        str = "";
+
+    /* padding in front, the length is only needed for it */
+    if (!left && (width > 0)) {
+        while ((len < maxLen) && (str[len] != '\0'))
+            len++;
+        for (; (width > len) && (pOut < pEnd); width--)
+            *pOut++ = ' ';
+    }
+
+    /* the string, counting its length */
+    for (len = 0; (len < maxLen) && (str[len] != '\0') && (pOut < pEnd); len++)
+        *pOut++ = str[len];
+
+    /* padding after */
+    if (left)
+        for (; (width > len) && (pOut < pEnd); width--)
+            *pOut++ = ' ';
+
+    return (pOut);
+}
+
+
+#if LCD_FORMAT_TIMING
+/*
+   FormatOld(char *, const char *, ...)
+
+   Description:      This function formats a string into a buffer with
+                     System_sprintf_va, the way Display_printf used to.  It
+                     is only used to time it against FormatNew.
+
+   Operation:        The arguments are passed on to System_sprintf_va.
+
+   Arguments:        buf (char *) - buffer to format into (with room for the
+                        whole string, it isn't limited).
+                     fmt (const char *) - format string.
+                     ... - values for the format.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/18/24 Adam Krivka      initial revision
+*/
+static void FormatOld(char *buf, const char *fmt, ...) {
+    /* variables */
+    va_list args;                       /* variable argument list */
+
+    (void)va_start(args, fmt);
+    System_sprintf_va(buf, (CString)fmt, args);
+    va_end(args);
+}
+
+/*
+   FormatNew(char *, const char *, ...)
+
+   Description:      This function formats a string into a row-sized buffer
+                     with FormatVa, the way Display_printf does.  It is only
+                     used to time it against FormatOld.
+
+   Operation:        The arguments are passed on to FormatVa.
+
+   Arguments:        buf (char *) - buffer to format into (TEXT_BUF_SIZE).
+                     fmt (const char *) - format string.
+                     ... - values for the format.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Output that doesn't fit in one row is truncated.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History: 5/18/24 Adam Krivka      initial revision
+*/
+static void FormatNew(char *buf, const char *fmt, ...) {
+    /* variables */
+    va_list args;                       /* variable argument list */
+
+    (void)va_start(args, fmt);
+    FormatVa(buf, TEXT_BUF_SIZE, fmt, args);
+    va_end(args);
+}
+#endif
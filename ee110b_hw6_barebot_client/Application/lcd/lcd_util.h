@@ -11,10 +11,44 @@
 
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       4/26/24 Adam Krivka      own formatter, typed display helpers
+       5/18/24 Adam Krivka      added the formatting time measurement
 */
 
+#ifndef LCD_UTIL_H
+    #define LCD_UTIL_H
+
+#include  <stdint.h>
+
+/* compile options */
+#ifndef LCD_FORMAT_TIMING
+#define LCD_FORMAT_TIMING   0       /* compare the formatters at startup */
+#endif
+
 /* constants */
-#define TEXT_BUF_SIZE   100
+#define TEXT_BUF_SIZE   (16 + 1)    /* one LCD row and the terminating NUL */
+#define FMT_DIGITS_SIZE 24          /* room for the digits of any number */
 
 /* function declarations */
 int Display_printf(UArg r, UArg c, UArg len, char *fmt, ...);
+int Display_int(UArg r, UArg c, UArg len, int32_t value);
+int Display_fixed(UArg r, UArg c, UArg len, int32_t value, uint8_t decimals);
+int Display_labelInt(UArg r, UArg c, UArg len, const char *label,
+                     int32_t value);
+
+#if LCD_FORMAT_TIMING
+/* formatting time in CPU cycles per call, System_sprintf_va (what */
+/*    Display_printf used to do) against FormatVa and the typed helpers */
+typedef struct {
+    uint32_t sprintfCycles;             /* "%d" with System_sprintf_va */
+    uint32_t printfCycles;              /* "%d" with FormatVa */
+    uint32_t intCycles;                 /* Display_int formatting */
+    uint32_t labelSprintfCycles;        /* "Speed:  %d" with System_sprintf_va */
+    uint32_t labelPrintfCycles;         /* "Speed:  %d" with FormatVa */
+    uint32_t labelIntCycles;            /* Display_labelInt formatting */
+} lcdFormatStats_t;
+
+void Display_measureFormat(lcdFormatStats_t *pStats);
+#endif
+
+#endif
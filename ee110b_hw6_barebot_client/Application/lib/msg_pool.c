@@ -0,0 +1,317 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                msg_pool.c                                */
+/*                        Fixed-Size Message Block Pool                     */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+ This file contains a fixed-size block pool for the messages the BLE tasks
+ queue to themselves.  Every block has a queue link in front of the message
+ so a message can be queued without allocating a separate queue record (as
+ Util_enqueueMsg() does).  All operations are O(1) and may be called from
+ Hwi, Swi, or task context.  The functions included are:
+ MsgPool_alloc    - allocate a message from a pool
+ MsgPool_dequeue  - remove a pool message from a queue
+ MsgPool_enqueue  - put a pool message on a queue and post the queue event
+ MsgPool_free     - return a message to its pool
+ MsgPool_getStats - get the usage statistics for a pool
+ MsgPool_init     - set up a pool
+
+
+ Revision History:
+ 4/4/24   Adam Krivka      initial revision
+ */
+
+/* RTOS include files */
+#include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/knl/Event.h>
+#include  <ti/sysbios/hal/Hwi.h>
+
+/* BLE include files */
+#include  "util.h"
+
+/* local include files */
+#include  "msg_pool.h"
+
+/*
+ MsgPool_init(MsgPool_t *, uint32_t *, uint16_t, uint16_t)
+
+ Description:      This function sets up a pool of numBlocks messages of
+ msgSize bytes in the passed storage.  The storage must be
+ at least MSG_POOL_BLOCK_WORDS(msgSize) * numBlocks words
+ (declare it with MSG_POOL_STORAGE).
+
+ Operation:        The storage is cut into blocks and every block is linked
+ onto the free list.  The statistics are cleared.
+
+ Arguments:        pPool (MsgPool_t *)    - pool to set up.
+ pStorage (uint32_t *)  - storage for the blocks.
+ msgSize (uint16_t)     - size of a message in bytes.
+ numBlocks (uint16_t)   - number of blocks in the pool.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  Singly linked free list threaded through the blocks.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void MsgPool_init(MsgPool_t *pPool, uint32_t *pStorage, uint16_t msgSize,
+                  uint16_t numBlocks)
+{
+    /* variables */
+    uint8_t *pBlock; /* block being linked onto the free list */
+
+    /* remember the block layout */
+    pPool->blockSize = MSG_POOL_BLOCK_WORDS(msgSize) * sizeof(uint32_t);
+    pPool->pStart = (uint8_t*) pStorage;
+    pPool->pEnd = pPool->pStart + numBlocks * pPool->blockSize;
+
+    /* link all the blocks onto the free list (first block at the head) */
+    pPool->pFree = NULL;
+    for (pBlock = pPool->pEnd; pBlock > pPool->pStart;)
+    {
+        pBlock -= pPool->blockSize;
+        ((Queue_Elem*) pBlock)->next = pPool->pFree;
+        pPool->pFree = (Queue_Elem*) pBlock;
+    }
+
+    /* clear the statistics */
+    pPool->stats.numBlocks = numBlocks;
+    pPool->stats.inUse = 0;
+    pPool->stats.highWater = 0;
+    pPool->stats.allocFails = 0;
+
+    /* done setting up the pool, return */
+    return;
+}
+
+/*
+ MsgPool_alloc(MsgPool_t *)
+
+ Description:      This function allocates a message from the passed pool.
+
+ Operation:        The block at the head of the free list is removed with
+ interrupts disabled and the usage statistics are updated.
+ A pointer to the message area following the queue link is
+ returned.
+
+ Arguments:        pPool (MsgPool_t *) - pool to allocate from.
+ Return Value:     (void *) - pointer to the message, or NULL if the pool is
+ empty.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   If the pool is empty NULL is returned and the allocation
+ failure count is incremented.
+
+ Algorithms:       None.
+ Data Structures:  Singly linked free list threaded through the blocks.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void *MsgPool_alloc(MsgPool_t *pPool)
+{
+    /* variables */
+    Queue_Elem *pBlock; /* the allocated block */
+    UInt key; /* interrupt state to restore */
+
+    /* take the head of the free list */
+    key = Hwi_disable();
+    pBlock = pPool->pFree;
+    if (pBlock != NULL)
+    {
+        /* got a block, update the list and usage */
+        pPool->pFree = pBlock->next;
+        if (++pPool->stats.inUse > pPool->stats.highWater)
+            pPool->stats.highWater = pPool->stats.inUse;
+    }
+    else
+    {
+        /* pool is empty */
+        pPool->stats.allocFails++;
+    }
+    Hwi_restore(key);
+
+    /* return the message area of the block (if there is one) */
+    return (pBlock != NULL) ? (void*) (pBlock + 1) : NULL;
+}
+
+/*
+ MsgPool_free(MsgPool_t *, void *)
+
+ Description:      This function returns a message to the passed pool.
+
+ Operation:        The block holding the message is pushed onto the head of
+ the free list with interrupts disabled.
+
+ Arguments:        pPool (MsgPool_t *) - pool the message came from.
+ pMsg (void *)       - message to free.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   NULL pointers and pointers outside the pool storage are
+ ignored.
+
+ Algorithms:       None.
+ Data Structures:  Singly linked free list threaded through the blocks.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void MsgPool_free(MsgPool_t *pPool, void *pMsg)
+{
+    /* variables */
+    Queue_Elem *pBlock; /* block holding the message */
+    UInt key; /* interrupt state to restore */
+
+    /* get the block from the message pointer */
+    pBlock = (Queue_Elem*) pMsg - 1;
+
+    /* only free blocks that are in the pool */
+    if ((pMsg != NULL) && ((uint8_t*) pBlock >= pPool->pStart)
+            && ((uint8_t*) pBlock < pPool->pEnd))
+    {
+        /* push the block onto the free list */
+        key = Hwi_disable();
+        pBlock->next = pPool->pFree;
+        pPool->pFree = pBlock;
+        pPool->stats.inUse--;
+        Hwi_restore(key);
+    }
+
+    /* done freeing the message, return */
+    return;
+}
+
+/*
+ MsgPool_enqueue(Queue_Handle, Event_Handle, void *)
+
+ Description:      This function puts a pool message on an RTOS queue and
+ posts the queue event to the task waiting on it.
+
+ Operation:        The queue link in front of the message is put on the
+ queue (Queue_put is atomic) and then UTIL_QUEUE_EVENT_ID
+ is posted to the passed event (if it isn't NULL).  No
+ memory is allocated, so this cannot fail.
+
+ Arguments:        queue (Queue_Handle) - queue to put the message on.
+ event (Event_Handle) - event to post (may be NULL).
+ pMsg (void *)        - pool message to enqueue.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void MsgPool_enqueue(Queue_Handle queue, Event_Handle event, void *pMsg)
+{
+    /* variables */
+    /* none */
+
+    /* queue the block holding the message */
+    Queue_put(queue, (Queue_Elem*) pMsg - 1);
+
+    /* let the task know there is a message */
+    if (event != NULL)
+        Event_post(event, UTIL_QUEUE_EVENT_ID);
+
+    /* done enqueuing, return */
+    return;
+}
+
+/*
+ MsgPool_dequeue(Queue_Handle)
+
+ Description:      This function removes the next pool message from an RTOS
+ queue.
+
+ Operation:        The next queue element is removed (Queue_get is atomic)
+ and the message following its queue link is returned.
+
+ Arguments:        queue (Queue_Handle) - queue to get the message from.
+ Return Value:     (void *) - the message, or NULL if the queue is empty.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void *MsgPool_dequeue(Queue_Handle queue)
+{
+    /* variables */
+    Queue_Elem *pBlock; /* block removed from the queue */
+
+    /* get the next block, an empty queue returns the queue itself */
+    pBlock = Queue_get(queue);
+
+    /* return the message in the block */
+    return ((Queue_Handle) pBlock != queue) ? (void*) (pBlock + 1) : NULL;
+}
+
+/*
+ MsgPool_getStats(MsgPool_t *, msgPoolStats_t *)
+
+ Description:      This function returns a copy of the usage statistics for
+ the passed pool.
+
+ Operation:        The statistics are copied with interrupts disabled so the
+ copy is consistent.
+
+ Arguments:        pPool (MsgPool_t *)       - pool to get statistics for.
+ pStats (msgPoolStats_t *) - where to store the statistics.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void MsgPool_getStats(MsgPool_t *pPool, msgPoolStats_t *pStats)
+{
+    /* variables */
+    UInt key; /* interrupt state to restore */
+
+    /* copy the statistics atomically */
+    key = Hwi_disable();
+    *pStats = pPool->stats;
+    Hwi_restore(key);
+
+    /* done, return */
+    return;
+}
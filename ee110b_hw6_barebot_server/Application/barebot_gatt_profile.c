@@ -17,13 +17,35 @@
     BarebotProfile_SetParameter - sets a characteristic value
     BarebotProfile_GetParameter - gets a characteristic value
     BarebotProfile_NotifyParameter - notifies a characteristic value
+    BarebotProfile_NotifyState - updates and notifies the robot state
+    BarebotProfile_GetCmdStats - gets the update command counts
     BarebotProfile_ReadAttrCB - callback for reading an attribute
     BarebotProfile_WriteAttrCB - callback for writing an attribute
 
 
 
+ The local functions included are:
+    BarebotProfile_readFixed - read handler for fixed length values
+    BarebotProfile_writeFixed - write handler for fixed length values
+    BarebotProfile_writeString - write handler for the thoughts string
+    BarebotProfile_writeIncrement - write handler for the update values
+    BarebotProfile_writeCCC - write handler for the client configurations
+
+
+
  Revision History:
        3/15/24  Adam Krivka      initial revision
+       4/6/24   Adam Krivka      dispatch reads/writes through a table
+                                 indexed by attribute offset
+       4/8/24   Adam Krivka      added robot state characteristic
+       4/10/24  Adam Krivka      update values accept write commands and
+                                 sequence numbers
+       5/18/24  Adam Krivka      long values are read in pieces (Read Blob),
+                                 fixed length writes must be the full length
+       5/18/24  Adam Krivka      getting an update value copies only its byte
+       5/18/24  Adam Krivka      unused arguments marked
+       5/18/24  Adam Krivka      thoughts can be written in pieces (long
+                                 writes), fixed values only at offset 0
  */
 
 /*********************************************************************
@@ -73,11 +95,26 @@ CONST uint8 BarebotProfileTurnUpdateUUID[ATT_BT_UUID_SIZE] = {
         LO_UINT16(BAREBOTPROFILE_TURNUPDATE_UUID), HI_UINT16(
                 BAREBOTPROFILE_TURNUPDATE_UUID) };
 
+// State UUID
+CONST uint8 BarebotProfileStateUUID[ATT_BT_UUID_SIZE] = {
+        LO_UINT16(BAREBOTPROFILE_STATE_UUID), HI_UINT16(
+                BAREBOTPROFILE_STATE_UUID) };
+
 /*********************************************************************
  * LOCAL VARIABLES
  *********************************************************************/
 BarebotProfileCBs_t *BarebotProfile_AppCBs = NULL;
 
+// sequence number of the last state notification
+static uint8 BarebotProfileStateSeq = 0;
+
+// update command sequence tracking - the connection that sent the last
+// sequenced command, the sequence number expected next, and the counts
+static uint16 BarebotProfileCmdConn = LINKDB_CONNHANDLE_INVALID;
+static uint8 BarebotProfileCmdSeq = 0;
+static uint32 BarebotProfileCmdsReceived = 0;
+static uint32 BarebotProfileCmdsMissed = 0;
+
 /*********************************************************************
  * Profile Attributes - variables
  *********************************************************************/
@@ -115,18 +152,29 @@ static uint8 BarebotProfileTurnUserDesp[] = "Barebot's Turn (left/right)";
 gattCharCfg_t *BarebotProfileTurnConfig;
 
 // Characteristic "SpeedUpdate" Properties (for declaration)
-static uint8 BarebotProfileSpeedUpdateProps = GATT_PROP_WRITE;
+static uint8 BarebotProfileSpeedUpdateProps = GATT_PROP_WRITE
+        | GATT_PROP_WRITE_NO_RSP;
 // Characteristic "SpeedUpdate" Value variable
 uint8 BarebotProfileSpeedUpdate = 0x0;
 // Characteristic "SpeedUpdate" User Description
 static uint8 BarebotProfileSpeedUpdateUserDesp[] = "Update Barebot Speed";
 
 // Characteristic "TurnUpdate" Properties (for declaration)
-static uint8 BarebotProfileTurnUpdateProps = GATT_PROP_WRITE;
+static uint8 BarebotProfileTurnUpdateProps = GATT_PROP_WRITE
+        | GATT_PROP_WRITE_NO_RSP;
 // Characteristic "TurnUpdate" Value variable
 uint8 BarebotProfileTurnUpdate = 0x0;
 // Characteristic "TurnUpdate" User Description
 static uint8 BarebotProfileTurnUpdateUserDesp[] = "Update Barebot Turn";
+
+// Characteristic "State" Properties (for declaration)
+static uint8 BarebotProfileStateProps = GATT_PROP_NOTIFY | GATT_PROP_READ;
+// Characteristic "State" Value variable
+uint8 BarebotProfileState[BAREBOTPROFILE_STATE_LEN] = { 0x0 };
+// Characteristic "State" User Description
+static uint8 BarebotProfileStateUserDesp[] = "Barebot's State (speed/turn)";
+// Characteristic "State" CCCD
+gattCharCfg_t *BarebotProfileStateConfig;
 /*********************************************************************
  * Profile Attributes - Table
  *********************************************************************/
@@ -220,11 +268,55 @@ static gattAttribute_t BarebotProfileAttrTbl[] = { {
         GATT_PERMIT_READ,
           0, BarebotProfileTurnUpdateUserDesp },
 
+        // State Characteristic Declaration
+        { { ATT_BT_UUID_SIZE, characterUUID },
+        GATT_PERMIT_READ,
+          0, &BarebotProfileStateProps },
+
+        // State Characteristic Value
+        { { ATT_BT_UUID_SIZE, BarebotProfileStateUUID },
+        GATT_PERMIT_READ,
+          0, BarebotProfileState },
+
+        // Characteristic State User Description
+        { { ATT_BT_UUID_SIZE, charUserDescUUID },
+        GATT_PERMIT_READ,
+          0, BarebotProfileStateUserDesp },
+
+        // State configuration
+        { { ATT_BT_UUID_SIZE, clientCharCfgUUID },
+        GATT_PERMIT_READ | GATT_PERMIT_WRITE,
+          0, (uint8*) &BarebotProfileStateConfig },
+
 };
 
 /*********************************************************************
  * LOCAL FUNCTIONS
  *********************************************************************/
+static bStatus_t BarebotProfile_readFixed(const bpAttrDispatch_t *pEntry,
+                                          gattAttribute_t *pAttr,
+                                          uint8_t *pValue, uint16_t *pLen,
+                                          uint16_t offset, uint16_t maxLen);
+static bStatus_t BarebotProfile_writeFixed(const bpAttrDispatch_t *pEntry,
+                                           uint16_t connHandle,
+                                           gattAttribute_t *pAttr,
+                                           uint8_t *pValue, uint16_t len,
+                                           uint16_t offset);
+static bStatus_t BarebotProfile_writeString(const bpAttrDispatch_t *pEntry,
+                                            uint16_t connHandle,
+                                            gattAttribute_t *pAttr,
+                                            uint8_t *pValue, uint16_t len,
+                                            uint16_t offset);
+static bStatus_t BarebotProfile_writeIncrement(const bpAttrDispatch_t *pEntry,
+                                               uint16_t connHandle,
+                                               gattAttribute_t *pAttr,
+                                               uint8_t *pValue, uint16_t len,
+                                               uint16_t offset);
+static bStatus_t BarebotProfile_writeCCC(const bpAttrDispatch_t *pEntry,
+                                         uint16_t connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t len,
+                                         uint16_t offset);
 static bStatus_t BarebotProfile_ReadAttrCB(uint16_t connHandle,
                                                 gattAttribute_t *pAttr,
                                                 uint8_t *pValue, uint16_t *pLen,
@@ -236,6 +328,69 @@ static bStatus_t BarebotProfile_WriteAttrCB(uint16_t connHandle,
                                                  uint16_t offset,
                                                  uint8_t method);
 
+/*********************************************************************
+ * Profile Attributes - Dispatch Table
+ *********************************************************************/
+
+// Handlers for each attribute, in the same order as BarebotProfileAttrTbl
+// (see the BP_ATTR_ indices) so an access is a single indexed lookup.
+// Attributes the stack handles itself have no handlers.
+static const bpAttrDispatch_t BarebotProfileAttrDispatch[BP_NUM_ATTRS] = {
+        // Service
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+
+        // Thoughts Declaration, Value, User Description
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_THOUGHTS_LEN, GATT_PERMIT_READ | GATT_PERMIT_WRITE,
+          BAREBOTPROFILE_THOUGHTS,
+          BarebotProfile_readFixed, BarebotProfile_writeString, NULL },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+
+        // Speed Declaration, Value, User Description, Configuration
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_SPEED_LEN, GATT_PERMIT_READ | GATT_PERMIT_WRITE,
+          BAREBOTPROFILE_SPEED,
+          BarebotProfile_readFixed, BarebotProfile_writeFixed, NULL },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { 0, GATT_PERMIT_WRITE, NO_CHANGE,
+          NULL, BarebotProfile_writeCCC, NULL },
+
+        // Turn Declaration, Value, User Description, Configuration
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_TURN_LEN, GATT_PERMIT_READ | GATT_PERMIT_WRITE,
+          BAREBOTPROFILE_TURN,
+          BarebotProfile_readFixed, BarebotProfile_writeFixed, NULL },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { 0, GATT_PERMIT_WRITE, NO_CHANGE,
+          NULL, BarebotProfile_writeCCC, NULL },
+
+        // SpeedUpdate Declaration, Value, User Description
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_SPEEDUPDATE_LEN, GATT_PERMIT_WRITE,
+          BAREBOTPROFILE_SPEED,
+          NULL, BarebotProfile_writeIncrement, BarebotProfileSpeed },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+
+        // TurnUpdate Declaration, Value, User Description
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_TURNUPDATE_LEN, GATT_PERMIT_WRITE,
+          BAREBOTPROFILE_TURN,
+          NULL, BarebotProfile_writeIncrement, BarebotProfileTurn },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+
+        // State Declaration, Value, User Description, Configuration
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { BAREBOTPROFILE_STATE_LEN, GATT_PERMIT_READ, NO_CHANGE,
+          BarebotProfile_readFixed, NULL, NULL },
+        { 0, 0, NO_CHANGE, NULL, NULL, NULL },
+        { 0, GATT_PERMIT_WRITE, NO_CHANGE,
+          NULL, BarebotProfile_writeCCC, NULL },
+};
+
+// compile time check that the attribute table has BP_NUM_ATTRS entries
+typedef char BarebotProfileAttrTblCheck[
+        (GATT_NUM_ATTRS(BarebotProfileAttrTbl) == BP_NUM_ATTRS) ? 1 : -1];
+
 /*********************************************************************
  * PROFILE CALLBACKS
  *********************************************************************/
@@ -255,11 +410,14 @@ CONST gattServiceCBs_t BarebotProfileCBs = { BarebotProfile_ReadAttrCB, // Read
  attribute for the barebot profile.  It just gets the
  value from the attribute table and returns it.
 
- Operation:        The function looks up the value by 16-bit UUID and then
- returns that value via the passed pointers.  If the UUID
- is not 16-bits, or it is a blob read, or the UUID is
- unvalid, no data is returned (returned length is 0) and
- an error code is returned by the function.
+ Operation:        The offset of the attribute in the attribute table is used
+ to index the dispatch table and the read handler for that
+ entry returns the value, starting at the passed offset,
+ via the passed pointers.  Values longer than maxLen are
+ read in pieces with blob reads.  If it is a blob read of
+ a value that fits in one read, or the attribute has no
+ read handler, no data is returned (returned length is 0)
+ and an error code is returned by the function.
 
  Arguments:        connHandle (uint16_t)     - connection message was
  received on.
@@ -279,13 +437,17 @@ CONST gattServiceCBs_t BarebotProfileCBs = { BarebotProfile_ReadAttrCB, // Read
  Inputs:           None.
  Outputs:          None.
 
- Error Handling:   If a 128-bit UUID is used, ATT_ERR_INVALID_HANDLE is returned.  
- If the passed attribute does not exist ATT_ERR_ATTR_NOT_FOUND is returned.
+ Error Handling:   If the attribute is not in the table ATT_ERR_INVALID_HANDLE
+ is returned.  If the attribute can't be read here
+ ATT_ERR_READ_NOT_PERMITTED is returned.  Blob reads of
+ values that fit in one read return ATT_ERR_ATTR_NOT_LONG.
 
  Algorithms:       None.
- Data Structures:  None.
+ Data Structures:  Dispatch table indexed by attribute offset.
 
  Revision History:        3/15/24  Adam Krivka      initial revision
+                          4/6/24   Adam Krivka      table dispatch
+                          5/18/24  Adam Krivka      blob reads of long values
 
  */
 
@@ -296,60 +458,35 @@ bStatus_t BarebotProfile_ReadAttrCB(uint16_t connHandle,
                                          uint8_t method)
 {
     /* variables */
-    uint16 uuid; /* UUID of attribute */
+    uint16_t index; /* offset of attribute in the table */
+    const bpAttrDispatch_t *pEntry; /* dispatch entry for the attribute */
 
-    bStatus_t status = SUCCESS; /* return status, initially good */
-
-    /* only do the read if it is not a blob operation */
-    if (offset == 0)
-    {
+    bStatus_t status; /* return status */
 
-        /* make sure using 16-bit attributes */
-        if (pAttr->type.len == ATT_BT_UUID_SIZE)
-        {
+    /* the connection and the method don't change the read */
+    (void) connHandle;
+    (void) method;
 
-            /* get the 16-bit UUID */
-            uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+    /* nothing is returned unless the read works */
+    *pLen = 0;
 
-            /* handle the attributes based on UUID */
-            switch (uuid)
-            {
-            case BAREBOTPROFILE_SPEED_UUID:
-                *pLen = BAREBOTPROFILE_SPEED_LEN;
-                memcpy(pValue, pAttr->pValue, BAREBOTPROFILE_SPEED_LEN);
-                break;
-            case BAREBOTPROFILE_TURN_UUID:
-                *pLen = BAREBOTPROFILE_TURN_LEN;
-                memcpy(pValue, pAttr->pValue, BAREBOTPROFILE_TURN_LEN);
-                break;
-            case BAREBOTPROFILE_THOUGHTS_UUID:
-                *pLen = BAREBOTPROFILE_THOUGHTS_LEN;
-                memcpy(pValue, pAttr->pValue, BAREBOTPROFILE_THOUGHTS_LEN);
-                break;
-            default:
-                /* should never get here */
-                /* nothing to return and its an error */
-                *pLen = 0;
-                status = ATT_ERR_ATTR_NOT_FOUND;
-                break;
-            }
-        }
-        else
-        {
-
-            /* not using 16-bit UUID's - return nothing and its an error */
-            *pLen = 0;
-            status = ATT_ERR_INVALID_HANDLE;
-        }
-    }
-    else
-    {
+    /* get the dispatch entry from the attribute's place in the table */
+    /*    (pointers before the table wrap to large indices) */
+    index = (uint16_t) (pAttr - BarebotProfileAttrTbl);
 
-        /* have an offset and thus a blob request - return nothing and an error */
-        /* reject blob operations since no attributes in this profile are long */
-        *pLen = 0;
+    if (index >= BP_NUM_ATTRS)
+        /* not one of our attributes */
+        status = ATT_ERR_INVALID_HANDLE;
+    else if (!((pEntry = &BarebotProfileAttrDispatch[index])->permissions
+            & GATT_PERMIT_READ))
+        /* not something that is read here */
+        status = ATT_ERR_READ_NOT_PERMITTED;
+    else if ((offset != 0) && (pEntry->len <= maxLen))
+        /* blob reads are only for values too long for one read */
         status = ATT_ERR_ATTR_NOT_LONG;
-    }
+    else
+        /* let the handler do the read */
+        status = pEntry->pfnRead(pEntry, pAttr, pValue, pLen, offset, maxLen);
 
     /* all done, return with error status */
     return status;
@@ -364,12 +501,13 @@ bStatus_t BarebotProfile_ReadAttrCB(uint16_t connHandle,
  value to the attribute and then informs the peripheral of
  the new value.
 
- Operation:        The function looks up the value by 16-bit UUID and then
- writes the passed value.  If the UUID is not 16-bits, or
- it is a blob read, or the UUID is unvalid, no data is
- written and an error code is returned by the function.  If
- a value is successfully changed, the peripheral is
- notified through a callback function.
+ Operation:        The offset of the attribute in the attribute table is used
+ to index the dispatch table and the write handler for that
+ entry writes the passed value.  If the attribute has no
+ write handler no data is written and an error code is
+ returned by the function.  If a value is successfully
+ changed, the peripheral is notified of the parameter in
+ the dispatch entry through a callback function.
 
  Arguments:        connHandle (uint16_t)     - connection message was
  received on.
@@ -386,13 +524,15 @@ bStatus_t BarebotProfile_ReadAttrCB(uint16_t connHandle,
  Inputs:           None.
  Outputs:          None.
 
- Error Handling:   If a 128-bit UUID is used, ATT_ERR_INVALID_HANDLE is returned. 
- If the passed attribute does not exist ATT_ERR_ATTR_NOT_FOUND is returned.
+ Error Handling:   If the attribute is not in the table ATT_ERR_INVALID_HANDLE
+ is returned.  If the attribute can't be written here
+ ATT_ERR_WRITE_NOT_PERMITTED is returned.
 
  Algorithms:       None.
- Data Structures:  None.
+ Data Structures:  Dispatch table indexed by attribute offset.
 
  Revision History: 03/09/22  Glen George      initial revision
+                   4/6/24    Adam Krivka      table dispatch
  */
 bStatus_t BarebotProfile_WriteAttrCB(uint16_t connHandle,
                                           gattAttribute_t *pAttr,
@@ -400,98 +540,363 @@ bStatus_t BarebotProfile_WriteAttrCB(uint16_t connHandle,
                                           uint16_t offset, uint8_t method)
 {
     /* variables */
-    uint16 uuid; /* UUID of attribute */
+    uint16_t index; /* offset of attribute in the table */
+    const bpAttrDispatch_t *pEntry = NULL; /* dispatch entry for attribute */
+
+    bStatus_t status; /* return status */
+
+    /* the method doesn't change the write */
+    (void) method;
+
+    /* get the dispatch entry from the attribute's place in the table */
+    index = (uint16_t) (pAttr - BarebotProfileAttrTbl);
+
+    if (index >= BP_NUM_ATTRS)
+        /* not one of our attributes */
+        status = ATT_ERR_INVALID_HANDLE;
+    else if (!((pEntry = &BarebotProfileAttrDispatch[index])->permissions
+            & GATT_PERMIT_WRITE))
+        /* not something that is written here */
+        status = ATT_ERR_WRITE_NOT_PERMITTED;
+    else
+        /* let the handler do the write */
+        status = pEntry->pfnWrite(pEntry, connHandle, pAttr, pValue, len,
+                                  offset);
+
+    /* if a characteristic value changed then use the callback function to */
+    /*    notify the peripheral of the change (only if there is a callback) */
+    if ((status == SUCCESS) && (pEntry->changeID != NO_CHANGE)
+            && (BarebotProfile_AppCBs != NULL)
+            && (BarebotProfile_AppCBs->pfnSimpleProfileChange != NULL))
+
+        /* have a callback and there was a change, let the peripheral know */
+        BarebotProfile_AppCBs->pfnSimpleProfileChange(pEntry->changeID);
+
+    /* finally done, return with the error/success status */
+    return status;
+}
+
+/*
+ BarebotProfile_readFixed(const bpAttrDispatch_t *, gattAttribute_t *,
+ uint8_t *, uint16_t *, uint16_t, uint16_t)
+
+ Description:      This function is the read handler for attributes with a
+ fixed length value.
+
+ Operation:        The value from the passed offset to the length in the
+ dispatch entry is copied from the attribute value, at
+ most maxLen bytes of it (the client reads the rest with
+ blob reads).
+
+ Arguments:        pEntry (const bpAttrDispatch_t *) - dispatch entry.
+ pAttr (gattAttribute_t *) - attribute to read.
+ pValue (uint8_t *)        - where to store the value.
+ pLen (uint16_t *)         - where to store the length read.
+ offset (uint16_t)         - offset of the first byte to read.
+ maxLen (uint16_t)         - maximum length that can be read.
+ Return Value:     (bstatus_t) - SUCCESS, or ATT_ERR_INVALID_OFFSET if the
+ offset is past the end of the value.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   Nothing is read if the offset is past the end of the
+ value.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/6/24   Adam Krivka      initial revision
+                   5/18/24  Adam Krivka      reads from an offset, in pieces
+ */
+static bStatus_t BarebotProfile_readFixed(const bpAttrDispatch_t *pEntry,
+                                          gattAttribute_t *pAttr,
+                                          uint8_t *pValue, uint16_t *pLen,
+                                          uint16_t offset, uint16_t maxLen)
+{
+    /* variables */
+    bStatus_t status = SUCCESS; /* return status, initially good */
 
-    uint8 changeID = NO_CHANGE; /* ID of changed attribute */
+    /* copy as much of the value from the offset as fits */
+    if (offset <= pEntry->len)
+    {
+        *pLen = MIN(pEntry->len - offset, maxLen);
+        memcpy(pValue, pAttr->pValue + offset, *pLen);
+    }
+    else
+    {
+        status = ATT_ERR_INVALID_OFFSET;
+    }
+
+    /* done, return the status */
+    return status;
+}
+
+/*
+ BarebotProfile_writeFixed(const bpAttrDispatch_t *, uint16_t,
+ gattAttribute_t *, uint8_t *, uint16_t, uint16_t)
+
+ Description:      This function is the write handler for attributes with a
+ fixed length value.
+
+ Operation:        The passed value is copied to the attribute value if it
+ is written at offset 0 and is exactly the length in the
+ dispatch entry.
+
+ Arguments:        pEntry (const bpAttrDispatch_t *) - dispatch entry.
+ connHandle (uint16_t)     - connection (unused).
+ pAttr (gattAttribute_t *) - attribute to write.
+ pValue (uint8_t *)        - value to write.
+ len (uint16_t)            - length of the value.
+ offset (uint16_t)         - offset of the value.
+ Return Value:     (bstatus_t) - SUCCESS, ATT_ERR_ATTR_NOT_LONG if the
+ offset is not 0, or ATT_ERR_INVALID_VALUE_SIZE if the
+ value is the wrong length.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   Values of the wrong length or at an offset are not
+ written (a short write would leave part of the old value).
+
+ Algorithms:       None.
+ Data Structures:  None.
 
+ Revision History: 4/6/24   Adam Krivka      initial revision
+                   5/18/24  Adam Krivka      must be the full length
+                   5/18/24  Adam Krivka      must be at offset 0
+ */
+static bStatus_t BarebotProfile_writeFixed(const bpAttrDispatch_t *pEntry,
+                                           uint16_t connHandle,
+                                           gattAttribute_t *pAttr,
+                                           uint8_t *pValue, uint16_t len,
+                                           uint16_t offset)
+{
+    /* variables */
     bStatus_t status = SUCCESS; /* return status, initially good */
 
-    int16 current; /* current value of speed or turn */
+    /* the connection is not used */
+    (void) connHandle;
+
+    /* write the value if it is all of it at once */
+    if (offset != 0)
+        status = ATT_ERR_ATTR_NOT_LONG;
+    else if (len == pEntry->len)
+        memcpy(pAttr->pValue, pValue, len);
+    else
+        status = ATT_ERR_INVALID_VALUE_SIZE;
+
+    /* done, return the status */
+    return status;
+}
+
+/*
+ BarebotProfile_writeString(const bpAttrDispatch_t *, uint16_t,
+ gattAttribute_t *, uint8_t *, uint16_t, uint16_t)
+
+ Description:      This function is the write handler for the thoughts, a
+ string of up to the length in the dispatch entry.  A
+ string longer than a Write Request fits is written in
+ pieces with a long write (Prepare Write and Execute
+ Write), each piece at its offset.
+
+ Operation:        A piece that fits in the value from its offset is copied
+ there.  A write at offset 0 starts a new string, so the
+ rest of the value after it is cleared first, and a shorter
+ string doesn't keep the end of the old one.
+
+ Arguments:        pEntry (const bpAttrDispatch_t *) - dispatch entry.
+ connHandle (uint16_t)     - connection (unused).
+ pAttr (gattAttribute_t *) - attribute to write.
+ pValue (uint8_t *)        - piece of the string to write.
+ len (uint16_t)            - length of the piece.
+ offset (uint16_t)         - offset of the piece in the string.
+ Return Value:     (bstatus_t) - SUCCESS, ATT_ERR_INVALID_OFFSET if the
+ offset is past the end of the value, or
+ ATT_ERR_INVALID_VALUE_SIZE if the piece doesn't fit.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   Pieces that don't fit in the value are not written.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 5/18/24  Adam Krivka      initial revision
+ */
+static bStatus_t BarebotProfile_writeString(const bpAttrDispatch_t *pEntry,
+                                            uint16_t connHandle,
+                                            gattAttribute_t *pAttr,
+                                            uint8_t *pValue, uint16_t len,
+                                            uint16_t offset)
+{
+    /* variables */
+    bStatus_t status = SUCCESS; /* return status, initially good */
 
-    attHandleValueNoti_t noti;
+    /* the connection is not used */
+    (void) connHandle;
 
-    /* not a blob operation, check if using 16-bit UUIDs */
-    if (pAttr->type.len == ATT_BT_UUID_SIZE)
+    /* write the piece if it fits */
+    if (offset > pEntry->len)
     {
+        status = ATT_ERR_INVALID_OFFSET;
+    }
+    else if (len > pEntry->len - offset)
+    {
+        status = ATT_ERR_INVALID_VALUE_SIZE;
+    }
+    else
+    {
+        /* a new string clears the end of the old one */
+        if (offset == 0)
+            memset(pAttr->pValue + len, 0, pEntry->len - len);
+        memcpy(pAttr->pValue + offset, pValue, len);
+    }
 
-        /* 16-bit UUID, form the UUID */
-        uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+    /* done, return the status */
+    return status;
+}
+
+/*
+ BarebotProfile_writeIncrement(const bpAttrDispatch_t *, uint16_t,
+ gattAttribute_t *, uint8_t *, uint16_t, uint16_t)
+
+ Description:      This function is the write handler for the SpeedUpdate and
+ TurnUpdate attributes.  The written value is added to the
+ value the dispatch entry targets (speed or turn).  These
+ may be written with a Write Request or a Write Command
+ (write without response).
+
+ Operation:        The 16-bit increment is built from the passed value and
+ added to the 16-bit target value.  If the value also has
+ a sequence number byte it is checked against the next
+ expected sequence number from that connection and any gap
+ is counted as missed commands.
+
+ Arguments:        pEntry (const bpAttrDispatch_t *) - dispatch entry.
+ connHandle (uint16_t)     - connection (unused).
+ pAttr (gattAttribute_t *) - attribute to write (unused).
+ pValue (uint8_t *)        - increment to add.
+ len (uint16_t)            - length of the increment.
+ offset (uint16_t)         - offset of the value (unused).
+ Return Value:     (bstatus_t) - SUCCESS, or ATT_ERR_INVALID_VALUE_SIZE if
+ the increment is the wrong length.
+ Exceptions:       None.
 
-        /* handle operation based on UUID */
-        switch (uuid)
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   Increments of the wrong length are ignored.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/6/24   Adam Krivka      initial revision
+                   4/10/24  Adam Krivka      sequence numbers
+ */
+static bStatus_t BarebotProfile_writeIncrement(const bpAttrDispatch_t *pEntry,
+                                               uint16_t connHandle,
+                                               gattAttribute_t *pAttr,
+                                               uint8_t *pValue, uint16_t len,
+                                               uint16_t offset)
+{
+    /* variables */
+    int16 current; /* current value of speed or turn */
+
+    bStatus_t status = SUCCESS; /* return status, initially good */
+
+    /* the attribute and the offset are not used */
+    (void) pAttr;
+    (void) offset;
+
+    /* the increment must be a 16-bit value, maybe with a sequence number */
+    if ((len == pEntry->len)
+            || (len == pEntry->len + BAREBOTPROFILE_UPDATE_SEQ_LEN))
+    {
+        /* count the command and check its sequence number (if it has one) */
+        BarebotProfileCmdsReceived++;
+        if (len > pEntry->len)
         {
-        case BAREBOTPROFILE_SPEED_UUID:
-            memcpy(pAttr->pValue, pValue, len);
-            changeID = BAREBOTPROFILE_SPEED;
-            break;
-        case BAREBOTPROFILE_TURN_UUID:
-            memcpy(pAttr->pValue, pValue, len);
-            changeID = BAREBOTPROFILE_TURN;
-            break;
-        case BAREBOTPROFILE_SPEEDUPDATE_UUID:
-            /* get current speed from GATT table */
-            memcpy(&current, BarebotProfileSpeed, BAREBOTPROFILE_SPEED_LEN);
-
-            /* update it with the increment */
-            current += (int16_t)BUILD_UINT16(pValue[0], pValue[1]);
-
-            /* write it back */
-            memcpy(BarebotProfileSpeed, &current, len);
-
-            changeID = BAREBOTPROFILE_SPEED;
-            break;
-        case BAREBOTPROFILE_TURNUPDATE_UUID:
-            /* get current speed from GATT table */
-            memcpy(&current, BarebotProfileTurn, BAREBOTPROFILE_TURN_LEN);
-
-            /* update it with the increment */
-            current += (int16_t)BUILD_UINT16(pValue[0], pValue[1]);
-
-            /* write it back */
-            memcpy(BarebotProfileTurn, &current, len);
-
-            changeID = BAREBOTPROFILE_TURN;
-            break;
-        case BAREBOTPROFILE_THOUGHTS_UUID:
-            memcpy(pAttr->pValue, pValue, len);
-            changeID = BAREBOTPROFILE_THOUGHTS;
-            break;
-        case GATT_CLIENT_CHAR_CFG_UUID:
-            /* changing the client configuration */
-            /* let the GATT library code handle it */
-            /* this was originally necessary for turning on notifications from the phone app
-             * it is now not required because we turn on notifications automatically for all
-             * connections, but leaving it here because it still might be useful in some cases
-             */
-            status = GATTServApp_ProcessCCCWriteReq(connHandle, pAttr, pValue,
-                                                    len, offset,
-                                                    GATT_CLIENT_CFG_NOTIFY);
-            break;
-
-        default:
-            /* should never get here (no other attributes) */
-            /* nothing to return and its an error */
-            status = ATT_ERR_ATTR_NOT_FOUND;
-            break;
+            /* a new connection starts a new sequence */
+            if (connHandle != BarebotProfileCmdConn)
+            {
+                BarebotProfileCmdConn = connHandle;
+                BarebotProfileCmdSeq = pValue[pEntry->len];
+            }
+
+            /* any sequence numbers skipped are missed commands */
+            BarebotProfileCmdsMissed += (uint8) (pValue[pEntry->len]
+                    - BarebotProfileCmdSeq);
+            BarebotProfileCmdSeq = pValue[pEntry->len] + 1;
         }
+
+        /* get current value from GATT table */
+        memcpy(&current, pEntry->pTarget, sizeof(current));
+
+        /* update it with the increment */
+        current += (int16_t) BUILD_UINT16(pValue[0], pValue[1]);
+
+        /* write it back */
+        memcpy(pEntry->pTarget, &current, sizeof(current));
     }
     else
     {
-
-        /* not using 16-bit UUID's - its an error */
-        status = ATT_ERR_INVALID_HANDLE;
+        status = ATT_ERR_INVALID_VALUE_SIZE;
     }
 
-    /* if a characteristic value changed then use the callback function to */
-    /*    notify the peripheral of the change (only if there is a callback) */
-    if ((changeID != NO_CHANGE) && (BarebotProfile_AppCBs != NULL)
-            && (BarebotProfile_AppCBs->pfnSimpleProfileChange != NULL))
+    /* done, return the status */
+    return status;
+}
 
-        /* have a callback and there was a change, let the peripheral know */
-        BarebotProfile_AppCBs->pfnSimpleProfileChange(changeID);
+/*
+ BarebotProfile_writeCCC(const bpAttrDispatch_t *, uint16_t,
+ gattAttribute_t *, uint8_t *, uint16_t, uint16_t)
+
+ Description:      This function is the write handler for the client
+ characteristic configurations.
+
+ Operation:        The GATT library code handles the write.  This was
+ originally necessary for turning on notifications from the
+ phone app.  It is now not required because notifications
+ are turned on automatically for all connections, but it
+ still might be useful in some cases.
+
+ Arguments:        pEntry (const bpAttrDispatch_t *) - dispatch entry
+ (unused).
+ connHandle (uint16_t)     - connection being configured.
+ pAttr (gattAttribute_t *) - configuration attribute.
+ pValue (uint8_t *)        - new configuration.
+ len (uint16_t)            - length of the configuration.
+ offset (uint16_t)         - offset of the configuration.
+ Return Value:     (bstatus_t) - status from the GATT library.
+ Exceptions:       None.
 
-    /* finally done, return with the error/success status */
-    return status;
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/6/24   Adam Krivka      initial revision
+ */
+static bStatus_t BarebotProfile_writeCCC(const bpAttrDispatch_t *pEntry,
+                                         uint16_t connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8_t *pValue, uint16_t len,
+                                         uint16_t offset)
+{
+    /* the dispatch entry is not needed */
+    (void) pEntry;
+
+    /* let the GATT library code handle it */
+    return GATTServApp_ProcessCCCWriteReq(connHandle, pAttr, pValue, len,
+                                          offset, GATT_CLIENT_CFG_NOTIFY);
 }
 
 /*
@@ -524,6 +929,17 @@ bStatus_t BarebotProfile_AddService(uint32 services)
     // Initialize Client Characteristic Configuration attributes
     GATTServApp_InitCharCfg( LINKDB_CONNHANDLE_INVALID,
                             BarebotProfileTurnConfig);
+
+    // Allocate Client Characteristic Configuration table
+    BarebotProfileStateConfig = (gattCharCfg_t*) ICall_malloc(
+            sizeof(gattCharCfg_t) * MAX_NUM_BLE_CONNS);
+    if (BarebotProfileStateConfig == NULL)
+    {
+        return ( bleMemAllocError);
+    }
+    // Initialize Client Characteristic Configuration attributes
+    GATTServApp_InitCharCfg( LINKDB_CONNHANDLE_INVALID,
+                            BarebotProfileStateConfig);
     if (services)
     {
         // Register GATT attribute list and CBs with GATT Server App
@@ -679,6 +1095,60 @@ default:
     return ret;
 }
 
+/******************************************************************
+ * NotifyState - Updates the robot state snapshot and sends one
+ *               notification with it.
+ *
+ * flags - BP_STATE_ flags for what changed since the last state
+ *         notification
+ *
+ * The speed and turn are packed together with a new sequence number
+ * so a client gets both values from a single PDU and can spot
+ * notifications that were lost.
+ *
+ * Revision History:
+ *     4/8/24   Adam Krivka      initial revision
+ *
+ ******************************************************************/
+
+bStatus_t BarebotProfile_NotifyState(uint8 flags)
+{
+    bpRobotState_t state;
+
+    // Build the snapshot from the current values
+    memcpy(&state.speed, BarebotProfileSpeed, BAREBOTPROFILE_SPEED_LEN);
+    memcpy(&state.turn, BarebotProfileTurn, BAREBOTPROFILE_TURN_LEN);
+    state.seq = ++BarebotProfileStateSeq;
+    state.flags = flags;
+    memcpy(BarebotProfileState, &state, BAREBOTPROFILE_STATE_LEN);
+
+    // Try to send notification.
+    return GATTServApp_ProcessCharCfg(BarebotProfileStateConfig,
+                                      BarebotProfileState, FALSE,
+                                      BarebotProfileAttrTbl,
+                                      GATT_NUM_ATTRS(BarebotProfileAttrTbl),
+                                      INVALID_TASK_ID,
+                                      BarebotProfile_ReadAttrCB);
+}
+
+/******************************************************************
+ * GetCmdStats - Gets the update command counts.
+ *
+ * pReceived - where to store the number of update commands received
+ * pMissed   - where to store the number of update commands missed
+ *             (skipped sequence numbers)
+ *
+ * Revision History:
+ *     4/10/24  Adam Krivka      initial revision
+ *
+ ******************************************************************/
+
+void BarebotProfile_GetCmdStats(uint32 *pReceived, uint32 *pMissed)
+{
+    *pReceived = BarebotProfileCmdsReceived;
+    *pMissed = BarebotProfileCmdsMissed;
+}
+
 /******************************************************************
  * GetParameter - Get a service parameter.
  *
@@ -714,13 +1184,20 @@ bStatus_t BarebotProfile_GetParameter(uint8 param, void *value)
     case BAREBOTPROFILE_SPEEDUPDATE:
     {
         memcpy(value, &BarebotProfileSpeedUpdate,
-        BAREBOTPROFILE_SPEEDUPDATE_LEN);
+               sizeof(BarebotProfileSpeedUpdate));
         break;
     }
 
     case BAREBOTPROFILE_TURNUPDATE:
     {
-        memcpy(value, &BarebotProfileTurnUpdate, BAREBOTPROFILE_TURNUPDATE_LEN);
+        memcpy(value, &BarebotProfileTurnUpdate,
+               sizeof(BarebotProfileTurnUpdate));
+        break;
+    }
+
+    case BAREBOTPROFILE_STATE:
+    {
+        memcpy(value, BarebotProfileState, BAREBOTPROFILE_STATE_LEN);
         break;
     }
 
@@ -13,6 +13,10 @@
 
    Revision History:
        3/15/24  Adam Krivka      initial revision
+       4/6/24   Adam Krivka      added attribute indices and dispatch types
+       4/8/24   Adam Krivka      added robot state characteristic
+       4/10/24  Adam Krivka      added command sequence numbers
+       5/16/24  Adam Krivka      added the emergency stop state flag
 */
 
 
@@ -54,12 +58,88 @@
 #define BAREBOTPROFILE_TURNUPDATE   4
 #define BAREBOTPROFILE_TURNUPDATE_UUID 0xFFF5
 #define BAREBOTPROFILE_TURNUPDATE_LEN  2
+// Update (command) values may have a sequence number byte after the
+// increment so dropped commands can be counted
+#define BAREBOTPROFILE_UPDATE_SEQ_LEN  1
+// Characteristic defines
+#define BAREBOTPROFILE_STATE   5
+#define BAREBOTPROFILE_STATE_UUID 0xFFF6
+#define BAREBOTPROFILE_STATE_LEN  6
+
+// Robot state flags (which values changed since the last state notification)
+#define BP_STATE_SPEED_CHANGED      0x01
+#define BP_STATE_TURN_CHANGED       0x02
+#define BP_STATE_RESET              0x04    // changed by a button on the robot
+#define BP_STATE_STOP               0x08    // emergency stop (long press on the robot)
+
+// Attribute indices in BarebotProfileAttrTbl (the dispatch table uses the
+// same order, so keep them in step)
+#define BP_ATTR_SERVICE             0
+#define BP_ATTR_THOUGHTS_DECL       1
+#define BP_ATTR_THOUGHTS_VALUE      2
+#define BP_ATTR_THOUGHTS_DESC       3
+#define BP_ATTR_SPEED_DECL          4
+#define BP_ATTR_SPEED_VALUE         5
+#define BP_ATTR_SPEED_DESC          6
+#define BP_ATTR_SPEED_CCCD          7
+#define BP_ATTR_TURN_DECL           8
+#define BP_ATTR_TURN_VALUE          9
+#define BP_ATTR_TURN_DESC           10
+#define BP_ATTR_TURN_CCCD           11
+#define BP_ATTR_SPEEDUPDATE_DECL    12
+#define BP_ATTR_SPEEDUPDATE_VALUE   13
+#define BP_ATTR_SPEEDUPDATE_DESC    14
+#define BP_ATTR_TURNUPDATE_DECL     15
+#define BP_ATTR_TURNUPDATE_VALUE    16
+#define BP_ATTR_TURNUPDATE_DESC     17
+#define BP_ATTR_STATE_DECL          18
+#define BP_ATTR_STATE_VALUE         19
+#define BP_ATTR_STATE_DESC          20
+#define BP_ATTR_STATE_CCCD          21
+#define BP_NUM_ATTRS                22
 
 
 /*********************************************************************
  * TYPEDEFS
 *********************************************************************/
 
+// Robot state characteristic value - one snapshot of speed and turn
+// (no padding, so it matches the BAREBOTPROFILE_STATE_LEN byte value)
+typedef struct
+{
+  int16_t  speed;     // current speed
+  int16_t  turn;      // current turn
+  uint8_t  seq;       // incremented on every state notification
+  uint8_t  flags;     // BP_STATE_ flags for what changed
+} bpRobotState_t;
+
+struct bpAttrDispatch;
+
+// Attribute read handler - reads the value of the attribute at the passed
+// dispatch entry, starting at offset, into pValue and sets *pLen
+typedef bStatus_t (*bpAttrReadFxn_t)(const struct bpAttrDispatch *pEntry,
+                                     gattAttribute_t *pAttr, uint8_t *pValue,
+                                     uint16_t *pLen, uint16_t offset,
+                                     uint16_t maxLen);
+
+// Attribute write handler - writes len bytes from pValue to the attribute at
+// the passed dispatch entry
+typedef bStatus_t (*bpAttrWriteFxn_t)(const struct bpAttrDispatch *pEntry,
+                                      uint16_t connHandle,
+                                      gattAttribute_t *pAttr, uint8_t *pValue,
+                                      uint16_t len, uint16_t offset);
+
+// Dispatch table entry, one per entry of the attribute table
+typedef struct bpAttrDispatch
+{
+  uint16_t          len;          // length of the value in bytes
+  uint8_t           permissions;  // GATT_PERMIT_READ and/or GATT_PERMIT_WRITE
+  uint8_t           changeID;     // parameter reported on a write (or NO_CHANGE)
+  bpAttrReadFxn_t   pfnRead;      // read handler (if GATT_PERMIT_READ)
+  bpAttrWriteFxn_t  pfnWrite;     // write handler (if GATT_PERMIT_WRITE)
+  uint8_t          *pTarget;      // value changed by the write handler
+} bpAttrDispatch_t;
+
 /*********************************************************************
  * MACROS
 *********************************************************************/
@@ -119,6 +199,20 @@ extern bStatus_t BarebotProfile_GetParameter(uint8 param, void *value);
 
 extern bStatus_t BarebotProfile_NotifyParameter(uint8 param);
 
+/*
+ * _NotifyState - Update the robot state snapshot from the current speed and
+ *                turn and send one state notification.
+ *
+ *    flags - BP_STATE_ flags for what changed
+ */
+extern bStatus_t BarebotProfile_NotifyState(uint8 flags);
+
+/*
+ * _GetCmdStats - Get the number of update commands received and the number
+ *                that were missed (gaps in the command sequence numbers).
+ */
+extern void BarebotProfile_GetCmdStats(uint32 *pReceived, uint32 *pMissed);
+
 /*****************************************************
 Extern variables
 *****************************************************/
@@ -130,6 +224,8 @@ extern uint8 BarebotProfileSpeedUpdate;
 extern uint8 BarebotProfileTurnUpdate;
 extern gattCharCfg_t *BarebotProfileSpeedConfig;
 extern gattCharCfg_t *BarebotProfileTurnConfig;
+extern uint8 BarebotProfileState[BAREBOTPROFILE_STATE_LEN];
+extern gattCharCfg_t *BarebotProfileStateConfig;
 /*********************************************************************
 *********************************************************************/
 
@@ -11,10 +11,13 @@
  peripheral device for the Bluetooth demo.  The global functions included
  are:
  BarebotPeripheral_createTask  - create the barebot peripheral task
+ BarebotPeripheral_getPoolStats - get the message pool statistics
+ BarebotPeripheral_getTaskStats - get the task loop statistics
 
  The local functions included are:
  BarebotPeripheral_advCallback       - GAP advertising callback
  BarebotPeripheral_charValueChangeCB - GATT value change callback
+ BarebotPeripheral_emergencyStop     - stop the robot
  BarebotPeripheral_enqueueMsg        - enqueue a message for the task
  BarebotPeripheral_init              - initialize barebot peripheral task
  BarebotPeripheral_processAdvEvent   - process advertising events
@@ -28,6 +31,12 @@
 
  Revision History:
  3/10/22  Glen George      initial revision
+ 4/2/24   Adam Krivka      added task loop statistics
+ 4/4/24   Adam Krivka      queued messages come from fixed-size pools
+ 4/8/24   Adam Krivka      coalesced robot state notifications
+ 5/16/24  Adam Krivka      long press of a button is an emergency stop
+ 5/18/24  Adam Krivka      link terminated uses the terminate event's handle
+ 5/18/24  Adam Krivka      unused arguments marked, unused variable removed
  */
 
 /* RTOS include files */
@@ -35,6 +44,7 @@
 #include  <ti/sysbios/knl/Clock.h>
 #include  <ti/sysbios/knl/Event.h>
 #include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/hal/Hwi.h>
 
 /* BLE include files */
 #include  <icall.h>
@@ -51,6 +61,7 @@
 #include <barebot_peripheral.h>
 #include "button/button_rtos_intf.h"
 #include "barebot_gatt_profile.h"
+#include "lib/msg_pool.h"
 
 /* shared variables */
 
@@ -77,6 +88,36 @@ static Queue_Handle appMsgQueueHandle;
 static uint8 advHandleLegacy; /* handle for legacy advertising */
 static uint8 advHandleLongRange; /* handle for BLE long range advertising */
 
+/* robot state changes not yet notified (BP_STATE_ flags) */
+static uint8_t pendingStateFlags;
+
+#if BS_TASK_STATS
+/* task loop statistics (see BarebotPeripheral_getTaskStats) */
+static bpTaskStats_t taskStats;
+#endif
+
+#if BS_USE_MSG_POOL
+/* pools for the queued messages and the advertising event data */
+MSG_POOL_STORAGE(evtPoolStorage, sizeof(bpEvt_t), BS_EVT_POOL_SIZE);
+static MsgPool_t evtPool;
+MSG_POOL_STORAGE(advPoolStorage, sizeof(bpGapAdvEventData_t), BS_ADV_POOL_SIZE);
+static MsgPool_t advPool;
+
+/* message memory comes from the pools */
+#define  BS_EVT_ALLOC()       MsgPool_alloc(&evtPool)
+#define  BS_EVT_FREE(p)       MsgPool_free(&evtPool, (p))
+#define  BS_EVT_DEQUEUE(q)    MsgPool_dequeue(q)
+#define  BS_ADV_ALLOC()       MsgPool_alloc(&advPool)
+#define  BS_ADV_FREE(p)       MsgPool_free(&advPool, (p))
+#else
+/* message memory comes from the ICall heap */
+#define  BS_EVT_ALLOC()       ICall_malloc(sizeof(bpEvt_t))
+#define  BS_EVT_FREE(p)       ICall_free(p)
+#define  BS_EVT_DEQUEUE(q)    Util_dequeueMsg(q)
+#define  BS_ADV_ALLOC()       ICall_malloc(sizeof(bpGapAdvEventData_t))
+#define  BS_ADV_FREE(p)       ICall_free(p)
+#endif
+
 /* Simple GATT Profile Callbacks */
 static BarebotProfileCBs_t BarebotPeripheral_ProfileCBs = {
         BarebotPeripheral_charValueChangeCB, /* GATT Characteristic value change callback */
@@ -127,6 +168,100 @@ void BarebotPeripheral_createTask(void)
     return;
 }
 
+/*
+ BarebotPeripheral_getTaskStats(bpTaskStats_t *)
+
+ Description:      This function returns a copy of the statistics kept by the
+ task loop.  The app queue throughput in messages per tick
+ is appMsgs / (lastTick - firstTick).
+
+ Operation:        The statistics are copied with interrupts disabled so the
+ copy is consistent.  If BS_TASK_STATS is zero the
+ statistics are all returned as zero.
+
+ Arguments:        pStats (bpTaskStats_t *) - where to store the statistics.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/2/24   Adam Krivka      initial revision
+ */
+
+void BarebotPeripheral_getTaskStats(bpTaskStats_t *pStats)
+{
+    /* variables */
+#if BS_TASK_STATS
+    UInt key; /* interrupt state to restore */
+
+    /* copy the statistics atomically */
+    key = Hwi_disable();
+    *pStats = taskStats;
+    Hwi_restore(key);
+#else
+    /* statistics aren't being kept */
+    memset(pStats, 0, sizeof(bpTaskStats_t));
+#endif
+
+    /* done, return */
+    return;
+}
+
+/*
+ BarebotPeripheral_getPoolStats(msgPoolStats_t *, msgPoolStats_t *)
+
+ Description:      This function returns copies of the usage statistics
+ (in use, high-water mark, and allocation failures) of the
+ event message pool and the advertising data pool.
+
+ Operation:        The statistics are read from the pools.  If the pools are
+ not being used (BS_USE_MSG_POOL is zero) the statistics are
+ all returned as zero.
+
+ Arguments:        pEvtStats (msgPoolStats_t *) - where to store the event
+ message pool statistics.
+ pAdvStats (msgPoolStats_t *) - where to store the advertising
+ data pool statistics.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 4/4/24   Adam Krivka      initial revision
+ */
+
+void BarebotPeripheral_getPoolStats(msgPoolStats_t *pEvtStats,
+                                    msgPoolStats_t *pAdvStats)
+{
+    /* variables */
+    /* none */
+
+#if BS_USE_MSG_POOL
+    /* get the statistics from the pools */
+    MsgPool_getStats(&evtPool, pEvtStats);
+    MsgPool_getStats(&advPool, pAdvStats);
+#else
+    /* no pools, no statistics */
+    memset(pEvtStats, 0, sizeof(msgPoolStats_t));
+    memset(pAdvStats, 0, sizeof(msgPoolStats_t));
+#endif
+
+    /* done, return */
+    return;
+}
+
 /*
  BarebotPeripheral_init()
 
@@ -169,6 +304,13 @@ static void BarebotPeripheral_init(void)
     /* create an RTOS queue for message from profile to be sent to app */
     appMsgQueueHandle = Util_constructQueue(&appMsgQueue);
 
+#if BS_USE_MSG_POOL
+    /* set up the message pools */
+    MsgPool_init(&evtPool, evtPoolStorage, sizeof(bpEvt_t), BS_EVT_POOL_SIZE);
+    MsgPool_init(&advPool, advPoolStorage, sizeof(bpGapAdvEventData_t),
+                 BS_ADV_POOL_SIZE);
+#endif
+
     /* initialize connection handle array */
     for (int i = 0; i < BS_MAX_BLE_CONNS; i++)
     {
@@ -217,7 +359,11 @@ static void BarebotPeripheral_init(void)
 
  Operation:        The function loops forever processing messages and events
  from the application and Bluetooth stack.  The messages
- and events are processed using helper functions.
+ and events are processed using helper functions.  Once
+ the application queue is empty any speed and turn changes
+ from it are sent as one robot state notification.  The
+ stack task runs at a higher priority, so all the writes
+ from one connection event are queued by then.
 
  Arguments:        a1 (UArg) - first argument (unused).
  a2 (UArg) - second argument (unused).
@@ -233,6 +379,7 @@ static void BarebotPeripheral_init(void)
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   4/8/24    Adam Krivka      send the coalesced state
  */
 
 static void BarebotPeripheral_taskFxn(UArg a0, UArg a1)
@@ -248,6 +395,14 @@ static void BarebotPeripheral_taskFxn(UArg a0, UArg a1)
 
     uint8_t safeToDealloc = TRUE; /* whether or not to deallocate message */
 
+#if BS_TASK_STATS
+    uint32_t batch; /* app messages drained this wakeup */
+#endif
+
+    /* the task arguments are not used */
+    (void) a0;
+    (void) a1;
+
     /* initialize the task */
     BarebotPeripheral_init();
 
@@ -264,11 +419,17 @@ static void BarebotPeripheral_taskFxn(UArg a0, UArg a1)
         /* if there is an event, process it */
         if (events)
         {
+#if BS_TASK_STATS
+            taskStats.wakeups++;
+#endif
 
             /* have an event, get any available messages from the stack */
             if (ICall_fetchServiceMsg(&src, &dest,
                                       (void**) &pMsg) == ICALL_ERRNO_SUCCESS)
             {
+#if BS_TASK_STATS
+                taskStats.stackMsgs++;
+#endif
 
                 /* check if it is a BLE message for this task */
                 if ((src == ICALL_SERVICE_CLASS_BLE) && (dest == selfEntity))
@@ -289,13 +450,16 @@ static void BarebotPeripheral_taskFxn(UArg a0, UArg a1)
             /* next check if got an RTOS queue event */
             if (events & UTIL_QUEUE_EVENT_ID)
             {
+#if BS_TASK_STATS
+                batch = 0;
+#endif
 
                 /* process all RTOS queue entries until queue is empty */
                 while (!Queue_empty(appMsgQueueHandle))
                 {
 
                     /* dequeue the message */
-                    pEvtMsg = (bpEvt_t*) Util_dequeueMsg(appMsgQueueHandle);
+                    pEvtMsg = (bpEvt_t*) BS_EVT_DEQUEUE(appMsgQueueHandle);
 
                     /* check if got a message */
                     if (pEvtMsg != NULL)
@@ -304,9 +468,32 @@ static void BarebotPeripheral_taskFxn(UArg a0, UArg a1)
                         /* got a message so process the message */
                         BarebotPeripheral_processAppMsg(pEvtMsg);
                         /* now can free the memory allocated to the message */
-                        ICall_free(pEvtMsg);
+                        BS_EVT_FREE(pEvtMsg);
+#if BS_TASK_STATS
+                        batch++;
+#endif
                     }
                 }
+
+#if BS_TASK_STATS
+                /* update the app queue counts and throughput timestamps */
+                if (batch != 0)
+                {
+                    if (taskStats.appMsgs == 0)
+                        taskStats.firstTick = Clock_getTicks();
+                    taskStats.lastTick = Clock_getTicks();
+                    taskStats.appMsgs += batch;
+                    if (batch > taskStats.maxAppBatch)
+                        taskStats.maxAppBatch = batch;
+                }
+#endif
+
+                /* send all the queued speed/turn changes as one state */
+                if (pendingStateFlags != 0)
+                {
+                    BarebotProfile_NotifyState(pendingStateFlags);
+                    pendingStateFlags = 0;
+                }
             }
         }
     }
@@ -406,6 +593,7 @@ static uint8_t BarebotPeripheral_processStackMsg(ICall_Hdr *pMsg)
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   5/16/24   Adam Krivka      added button long presses
  */
 
 static void BarebotPeripheral_processAppMsg(bpEvt_t *pMsg)
@@ -421,6 +609,11 @@ static void BarebotPeripheral_processAppMsg(bpEvt_t *pMsg)
         BarebotPeripheral_handleButton(pMsg->data.byte);
         dealloc = FALSE;
         break;
+    case BS_BUTTON_HELD:
+        /* a button was held down, stop the robot */
+        BarebotPeripheral_emergencyStop();
+        dealloc = FALSE;
+        break;
     case BS_CHAR_CHANGE_EVT:
         /* a characteristic value changed, handle it */
         dealloc = BarebotPeripheral_processCharValueChangeEvt(pMsg->data);
@@ -438,8 +631,9 @@ static void BarebotPeripheral_processAppMsg(bpEvt_t *pMsg)
     }
 
     /* free message data if it exists and we are supposed to dealloc it */
+    /*    (only advertising events have data to deallocate) */
     if ((pMsg->data.pData != NULL) && (dealloc == TRUE))
-        ICall_free(pMsg->data.pData);
+        BS_ADV_FREE(pMsg->data.pData);
 
     /* done processing the message/event, return */
     return;
@@ -472,7 +666,7 @@ static void BarebotPeripheral_handleButton(uint8_t buttonId)
     uint16_t zero = 0;
 
     /* if invalid buttonID, return */
-    if (!(buttonId == 1 || buttonId == 2))
+    if (!(buttonId == BUTTON_1_ID || buttonId == BUTTON_0_ID))
     {
         return;
     }
@@ -480,17 +674,19 @@ static void BarebotPeripheral_handleButton(uint8_t buttonId)
     /* process the button press */
     switch (buttonId)
     {
-    case 1:
+    case BUTTON_1_ID:
         /* reset speed */
         BarebotProfile_SetParameter(BAREBOTPROFILE_SPEED,
         BAREBOTPROFILE_SPEED_LEN,
                                     &zero);
+        pendingStateFlags |= BP_STATE_SPEED_CHANGED | BP_STATE_RESET;
         break;
-    case 2:
+    case BUTTON_0_ID:
         /* reset turn */
         BarebotProfile_SetParameter(BAREBOTPROFILE_TURN,
         BAREBOTPROFILE_TURN_LEN,
                                     &zero);
+        pendingStateFlags |= BP_STATE_TURN_CHANGED | BP_STATE_RESET;
 
         break;
     }
@@ -498,6 +694,49 @@ static void BarebotPeripheral_handleButton(uint8_t buttonId)
     return;
 }
 
+/*
+ BarebotPeripheral_emergencyStop()
+
+ Description:      This function stops the robot when a button is held
+ down (long press).  The stop is sent to every connected
+ central with the next state notification.
+
+ Operation:        The speed and the turn are both set to zero and the
+ state notification is flagged as an emergency stop.
+
+ Arguments:        None.
+ Return Value:     None.
+ Exceptions:       None.
+
+ Inputs:           None.
+ Outputs:          None.
+
+ Error Handling:   None.
+
+ Algorithms:       None.
+ Data Structures:  None.
+
+ Revision History: 5/16/24  Adam Krivka        initial revision
+ */
+
+static void BarebotPeripheral_emergencyStop(void)
+{
+    /* variables */
+    uint16_t zero = 0;
+
+    /* stop moving and turning */
+    BarebotProfile_SetParameter(BAREBOTPROFILE_SPEED,
+    BAREBOTPROFILE_SPEED_LEN,
+                                &zero);
+    BarebotProfile_SetParameter(BAREBOTPROFILE_TURN,
+    BAREBOTPROFILE_TURN_LEN,
+                                &zero);
+    pendingStateFlags |= BP_STATE_SPEED_CHANGED | BP_STATE_TURN_CHANGED
+            | BP_STATE_RESET | BP_STATE_STOP;
+
+    return;
+}
+
 /*
  BarebotPeripheral_processGapMessage(gapEventHdr_t *)
 
@@ -534,7 +773,6 @@ static void BarebotPeripheral_processGapMessage(gapEventHdr_t *pMsg)
 {
     /* variables */
     uint8_t systemID[DEVINFO_SYSTEM_ID_LEN]; /* system ID */
-    bpEvtData_t data;
 
     /* process the message based on the opcode that generated it */
     switch (pMsg->opcode)
@@ -614,13 +852,11 @@ static void BarebotPeripheral_processGapMessage(gapEventHdr_t *pMsg)
                     conn_handles[i] =
                             ((gapEstLinkReqEvent_t*) pMsg)->connectionHandle;
 
-                    /* enable notifications for speed and turn */
-                    GATTServApp_WriteCharCfg(conn_handles[i],
-                                             BarebotProfileSpeedConfig,
-                                             GATT_CLIENT_CFG_NOTIFY);
-
+                    /* enable notifications for the robot state */
+                    /*    (speed and turn are only notified separately */
+                    /*    if the client turns them on itself) */
                     GATTServApp_WriteCharCfg(conn_handles[i],
-                                             BarebotProfileTurnConfig,
+                                             BarebotProfileStateConfig,
                                              GATT_CLIENT_CFG_NOTIFY);
 
                 }
@@ -636,7 +872,7 @@ static void BarebotPeripheral_processGapMessage(gapEventHdr_t *pMsg)
         for (int i = 0; i < BS_MAX_BLE_CONNS; i++)
         {
             if (conn_handles[i]
-                    == ((gapEstLinkReqEvent_t*) pMsg)->connectionHandle)
+                    == ((gapTerminateLinkEvent_t*) pMsg)->connectionHandle)
             {
                 /* found, make it invalid */
                 conn_handles[i] = BS_INVALID_CONN;
@@ -712,10 +948,10 @@ static void BarebotPeripheral_charValueChangeCB(uint8_t paramID)
  Operation:        The event is processed based on the passed message data.
  The byte value in the message data has the parameter ID
  of the characteristic whose value changed.  If it was the
- red LED value, the red LED is turned on or off based on
- the new value.  If it was the green LED value, the green
- LED is turned on or off based on the new value.  Any other
- parameter IDs are ignored.
+ speed or turn, a notification is sent for it (to clients
+ that turned them on) and the change is added to the
+ pending robot state notification.  Any other parameter
+ IDs are ignored.
 
  Arguments:        msg_data (bpEvtData_t) - the data for the message.
  Return Value:     (bool) - TRUE to indicated the passed message data should
@@ -733,6 +969,7 @@ static void BarebotPeripheral_charValueChangeCB(uint8_t paramID)
 
  Revision History:  03/10/22  Glen George       initial revision
                     3/15/24  Adam Krivka        added speed and turn notifications
+                    4/8/24   Adam Krivka        coalesce into the state
  */
 
 static bool BarebotPeripheral_processCharValueChangeEvt(bpEvtData_t msg_data)
@@ -747,12 +984,14 @@ static bool BarebotPeripheral_processCharValueChangeEvt(bpEvtData_t msg_data)
         // not implemented
         /* send notification */
         BarebotProfile_NotifyParameter(BAREBOTPROFILE_SPEED);
+        pendingStateFlags |= BP_STATE_SPEED_CHANGED;
         break;
     case BAREBOTPROFILE_TURN:
         /* change robot turn */
         // not implemented
         /* send notification */
         BarebotProfile_NotifyParameter(BAREBOTPROFILE_TURN);
+        pendingStateFlags |= BP_STATE_TURN_CHANGED;
         break;
     default:
         /* unknown parameter ID, shouldn't get here, do nothing */
@@ -779,6 +1018,21 @@ void ButtonPressed(uint8_t buttonId)
     BarebotPeripheral_enqueueMsg(BS_BUTTON_PRESSED, data);
 }
 
+/* ButtonHeld
+ *
+ * Description:     This function is called by the button task when a button
+ *                  is held down for a long press.  It enqueues a message to
+ *                  the barebot peripheral task to stop the robot.
+ * 
+ *  Revision History:  5/16/24  Adam Krivka        initial revision
+*/
+void ButtonHeld(uint8_t buttonId)
+{
+    bpEvtData_t data;
+    data.byte = buttonId;
+    BarebotPeripheral_enqueueMsg(BS_BUTTON_HELD, data);
+}
+
 /*
  BarebotPeripheral_advCallback(uint32_t event, void *pBuf, uintptr_t arg)
 
@@ -786,9 +1040,10 @@ void ButtonPressed(uint8_t buttonId)
  module.  It will be called when a masked advertising
  event occurs.
 
- Operation:        The function dynamically allocates memory for the passed
- message structure.  If this is successfull it copies the
- passed data to the memory and enqueues the event.
+ Operation:        The function allocates memory for the passed message
+ structure (from the advertising data pool or the heap).
+ If this is successfull it copies the passed data to the
+ memory and enqueues the event.
 
  Arguments:        event (uint32_t) - type of advertising event that occurred.
  pBuf (void *)    - pointer to the buffer containing the
@@ -802,12 +1057,15 @@ void ButtonPressed(uint8_t buttonId)
 
  Error Handling:   If memory can't be allocated the event is ignored.  If
  there is an error enqueuing the message the allocated
- memory is free and no event is enqueued.
+ memory is free and no event is enqueued.  In both cases
+ the event buffer from the stack is freed.
 
  Algorithms:       None.
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   4/4/24    Adam Krivka      allocate from the pool and free
+                                              the stack buffer on errors
  */
 
 static void BarebotPeripheral_advCallback(uint32_t event, void *pBuf,
@@ -816,8 +1074,11 @@ static void BarebotPeripheral_advCallback(uint32_t event, void *pBuf,
     /* variables */
     bpEvtData_t data; /* data to associate with the event */
 
-    /* need to dynamically allocate space for advertising event structure */
-    data.pData = ICall_malloc(sizeof(bpGapAdvEventData_t));
+    /* the callback argument is not used */
+    (void) arg;
+
+    /* need to allocate space for advertising event structure */
+    data.pData = BS_ADV_ALLOC();
 
     /* check if got the memory */
     if (data.pData != NULL)
@@ -829,10 +1090,17 @@ static void BarebotPeripheral_advCallback(uint32_t event, void *pBuf,
 
         /* enqueue the event, watching for error */
         if (BarebotPeripheral_enqueueMsg(BS_ADV_EVT, data) != SUCCESS)
+        {
             /* error enqueuing the event - deallocate memory now */
-            ICall_free(data.pData);
+            BS_ADV_FREE(data.pData);
+            data.pData = NULL;
+        }
     }
 
+    /* if the event was dropped, free the stack's buffer (if it has one) */
+    if ((data.pData == NULL) && (event != GAP_EVT_INSUFFICIENT_MEMORY))
+        ICall_free(pBuf);
+
     /* done processing the advertising even, return */
     return;
 }
@@ -888,10 +1156,10 @@ static bool BarebotPeripheral_processAdvEvent(bpEvtData_t eventData)
  Description:      This function creates a message and puts it into the
  RTOS queue.
 
- Operation:        The function dynamically allocates memory for the message
- and then copies the passed event and data into this
- message.  The message is then enqueued using the RTOS
- function that also creates an event on enqueuing.
+ Operation:        The function allocates memory for the message (from the
+ event pool or the heap) and then copies the passed event
+ and data into this message.  The message is then enqueued
+ and the queue event is posted to the task.
 
  Arguments:        event (uint8_t)    - event ID for the message to enqueue.
  data (bpEvtData_t) - data for the message to enqueue.
@@ -913,6 +1181,7 @@ static bool BarebotPeripheral_processAdvEvent(bpEvtData_t eventData)
  Data Structures:  None.
 
  Revision History: 03/10/22  Glen George      initial revision
+                   4/4/24    Adam Krivka      allocate from the event pool
  */
 
 static status_t BarebotPeripheral_enqueueMsg(uint8_t event, bpEvtData_t data)
@@ -923,7 +1192,7 @@ static status_t BarebotPeripheral_enqueueMsg(uint8_t event, bpEvtData_t data)
     status_t success; /* whether or not enqueuing was successful */
 
     /* allocate memory for the message */
-    pMsg = ICall_malloc(sizeof(bpEvt_t));
+    pMsg = BS_EVT_ALLOC();
 
     /* check if memory got allocated */
     if (pMsg != NULL)
@@ -933,6 +1202,11 @@ static status_t BarebotPeripheral_enqueueMsg(uint8_t event, bpEvtData_t data)
         pMsg->event = event;
         pMsg->data = data;
 
+#if BS_USE_MSG_POOL
+        /* pool messages carry their own queue link, so enqueuing can't fail */
+        MsgPool_enqueue(appMsgQueueHandle, syncEvent, pMsg);
+        success = SUCCESS;
+#else
         /* enqueue the message, watching for errors */
         if (Util_enqueueMsg(appMsgQueueHandle, syncEvent, (uint8_t*) pMsg))
             /* successfully enqueued the message */
@@ -941,6 +1215,7 @@ static status_t BarebotPeripheral_enqueueMsg(uint8_t event, bpEvtData_t data)
             /* there was an error enqueuing the message */
             /*    note - Util_enqueueMsg() freed the message on failure */
             success = FAILURE;
+#endif
     }
     else
     {
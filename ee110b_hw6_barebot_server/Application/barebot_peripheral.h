@@ -16,6 +16,9 @@
 
    Revision History:
       3/10/22  Glen George       initial revision
+      4/2/24   Adam Krivka       added BS_TASK_STATS switch
+      4/4/24   Adam Krivka       added message pool configuration
+      5/16/24  Adam Krivka       added the button long press event
 */
 
 
@@ -44,11 +47,26 @@
     #define  BS_TASK_STACK_SIZE    1024
 #endif
 
+/* keep task loop statistics (message counts and throughput) */
+#ifndef BS_TASK_STATS
+    #define  BS_TASK_STATS         1
+#endif
+
+/* queued messages come from fixed-size pools (1) or the ICall heap (0) */
+#ifndef BS_USE_MSG_POOL
+    #define  BS_USE_MSG_POOL       1
+#endif
+
+/* number of messages in each pool */
+#define  BS_EVT_POOL_SIZE          16       /* bpEvt_t messages */
+#define  BS_ADV_POOL_SIZE          8        /* bpGapAdvEventData_t data */
+
 
 /* application events */
 #define  BS_BUTTON_PRESSED          1
 #define  BS_CHAR_CHANGE_EVT         2
 #define  BS_ADV_EVT                 3
+#define  BS_BUTTON_HELD             4
 
 /* only system events are the ICALL message and queue events */
 #define  BS_ALL_EVENTS            ( ICALL_MSG_EVENT_ID  |  UTIL_QUEUE_EVENT_ID )
@@ -115,6 +133,7 @@ static uint8_t   BarebotPeripheral_processStackMsg(ICall_Hdr *);
 static void      BarebotPeripheral_processGapMessage(gapEventHdr_t *);
 static void      BarebotPeripheral_processAppMsg(bpEvt_t *);
 static void      BarebotPeripheral_handleButton(uint8_t buttonId);
+static void      BarebotPeripheral_emergencyStop(void);
 static bool      BarebotPeripheral_processAdvEvent(bpEvtData_t);
 static bool      BarebotPeripheral_processCharValueChangeEvt(bpEvtData_t);
 
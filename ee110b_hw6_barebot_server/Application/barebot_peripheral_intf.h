@@ -14,6 +14,8 @@
 
    Revision History:
       3/10/22  Glen George       initial revision
+      4/2/24   Adam Krivka       added task loop statistics
+      4/4/24   Adam Krivka       added message pool statistics
 */
 
 
@@ -24,10 +26,10 @@
 
 
 /* library include files */
-    /* none */
+#include  <stdint.h>
 
 /* local include files */
-    /* none */
+#include  "lib/msg_pool.h"
 
 
 
@@ -40,7 +42,16 @@
 
 
 /* structures, unions, and typedefs */
-    /* none */
+
+/* task loop statistics (only kept if BS_TASK_STATS is non-zero) */
+typedef  struct  {
+             uint32_t  wakeups;      /* times the task woke with an event */
+             uint32_t  stackMsgs;    /* BLE stack messages processed */
+             uint32_t  appMsgs;      /* application queue messages processed */
+             uint32_t  maxAppBatch;  /* most app messages drained in one wakeup */
+             uint32_t  firstTick;    /* clock tick of the first app message */
+             uint32_t  lastTick;     /* clock tick of the latest app message */
+         }  bpTaskStats_t;
 
 
 
@@ -50,4 +61,10 @@
 /* create the barebot peripheral task */
 void  BarebotPeripheral_createTask(void);
 
+/* get a copy of the task loop statistics */
+void  BarebotPeripheral_getTaskStats(bpTaskStats_t *);
+
+/* get copies of the message pool statistics (event and advertising pools) */
+void  BarebotPeripheral_getPoolStats(msgPoolStats_t *, msgPoolStats_t *);
+
 #endif
@@ -9,25 +9,38 @@
         ButtonInit_RTOS() - initialize the button using RTOS hardware and
                             software interrupts
 
+   Local functions:
+        ButtonClockCB() - debounce the buttons on every clock tick
+        ButtonEvent()   - pass debounced button events on
+
    Revision History:
        3/6/24  Adam Krivka      initial revision
        3/14/24 Adam Krivka      switched to using Clock
+       5/16/24 Adam Krivka      debounce with the shared debounce engine,
+                                added long presses
 */
 
 
 
 /* library includes */
 #include  "util.h"
+#include  <ti/sysbios/knl/Clock.h>
 
 
 /* local includes */
 #include "button_rtos_intf.h"
+#include "../lib/debounce.h"
 
 /* declarations */
 void ButtonInit();
-void ButtonDebounce();
 
-#define PERIOD_MILISECONDS 1
+/* clock period, the debounce time is DEBOUNCE_SAMPLES periods (20 ms) */
+#define PERIOD_MILISECONDS 5
+
+/* DIOs of the buttons (also in button_symbols.inc) */
+#define BUTTON_0_DIO    13
+#define BUTTON_1_DIO    14
+#define NUM_BUTTONS     2
 
 
 /* local variables */
@@ -36,9 +49,50 @@ void ButtonDebounce();
 static Clock_Struct clock;
 static Clock_Handle clockHandle;
 
+/* debounce engine input table (times are set in ButtonInit_RTOS) */
+static debounceInput_t buttonInputs[NUM_BUTTONS] = {
+    { BUTTON_0_DIO, TRUE, 0, 0, 0 },
+    { BUTTON_1_DIO, TRUE, 0, 0, 0 }
+};
+
+
+/*
+   ButtonClockCB()
+
+   Description:     This function is called by the clock every
+                    PERIOD_MILISECONDS.  It debounces the buttons.
 
-void ButtonClockCB(){
-    ButtonDebounce();
+   Revision History: 3/14/24 Adam Krivka        initial revision
+                     5/16/24 Adam Krivka        use the debounce engine
+*/
+static void ButtonClockCB(){
+    DebounceTick(Clock_getTicks());
+}
+
+/*
+   ButtonEvent(uint32_t, uint32_t)
+
+   Description:     This function is called by the debounce engine with the
+                    button events.  Presses are passed on to ButtonPressed
+                    and long presses to ButtonHeld, releases are ignored.
+
+   Revision History: 5/16/24 Adam Krivka        initial revision
+*/
+static void ButtonEvent(uint32_t evt, uint32_t ticks){
+    /* variables */
+    uint8_t buttonId;                   /* ID of the button */
+
+    /* which button it is */
+    buttonId = (DEBOUNCE_EVT_DIO(evt) == BUTTON_0_DIO) ? BUTTON_0_ID
+                                                       : BUTTON_1_ID;
+
+    /* pass the event on */
+    if (DEBOUNCE_EVT_TYPE(evt) == DEBOUNCE_EVT_PRESS)
+        ButtonPressed(buttonId);
+    else if (DEBOUNCE_EVT_TYPE(evt) == DEBOUNCE_EVT_HOLD)
+        ButtonHeld(buttonId);
+
+    return;
 }
 
 /*
@@ -49,9 +103,10 @@ void ButtonClockCB(){
                     interrupts and initializes the button hardware and software.
                     It is called once at the start of the program.
 
-   Operation:       Initializes the hardware and software interrupts, and then
-                    calls the ButtonInit function which configures the GPIOs
-                    , variables, and timer (it also starts it).
+   Operation:       Calls the ButtonInit function which configures the GPIOs,
+                    sets up the debounce engine with the buttons (active low,
+                    long press after BUTTON_HOLD_MS, no repeat), and then
+                    starts the clock that debounces them.
 
    Arguments:        None.
    Return Value:     None.
@@ -67,13 +122,20 @@ void ButtonClockCB(){
    Data Structures:  None.
 
    Revision History: 3/6/24  Adam Krivka        initial revision
+                     5/16/24 Adam Krivka        set up the debounce engine
 */
 void ButtonInit_RTOS() {
     /* variables */
+    uint8_t i;                          /* button index */
 
-    /* call assembly init function (inits GPIOs, variables) */
+    /* call assembly init function (inits GPIOs) */
     ButtonInit();
 
+    /* set up the debounce engine, long press times are in clock ticks */
+    for (i = 0; i < NUM_BUTTONS; i++)
+        buttonInputs[i].holdTicks = BUTTON_HOLD_MS * (1000 / Clock_tickPeriod);
+    DebounceInit(buttonInputs, NUM_BUTTONS, ButtonEvent);
+
     /* set up clock */
     clockHandle = Util_constructClock(&clock, ButtonClockCB, PERIOD_MILISECONDS, PERIOD_MILISECONDS, false, 0);
 
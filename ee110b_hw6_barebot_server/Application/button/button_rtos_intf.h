@@ -10,14 +10,28 @@
         ButtonInit_RTOS() - initialize the button using RTOS hardware and 
                             software interrupts
 
+   The button code calls ButtonPressed when a button is pressed and
+   ButtonHeld when it is held down for BUTTON_HOLD_MS (long press).
+
    Revision History:
        3/6/24  Adam Krivka      initial revision
+       5/16/24 Adam Krivka      added ButtonHeld and the button IDs
 */
 
 #ifndef BUTTON_RTOS_INTF_H
     #define BUTTON_RTOS_INTF_H
 
+#include  <stdint.h>
+
+/* button IDs passed to ButtonPressed and ButtonHeld */
+#define BUTTON_0_ID     2       /* button on DIO13 (BTN-1) */
+#define BUTTON_1_ID     1       /* button on DIO14 (BTN-2) */
+
+/* time a button is held down for a long press */
+#define BUTTON_HOLD_MS  1000
+
 void ButtonInit_RTOS();
 void ButtonPressed(uint8_t buttonId);
+void ButtonHeld(uint8_t buttonId);
 
 #endif
@@ -0,0 +1,98 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                debounce.h                                */
+/*                           GPIO Debounce Engine                           */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, structures, and function prototypes for
+   the GPIO debounce engine defined in debounce.s.  The engine debounces up
+   to 32 GPIO inputs from one periodic tick, with a long press and repeat
+   time for each.  The table layout and the event values must match
+   debounce_symbols.inc.
+
+
+   Revision History:
+      5/16/24  Adam Krivka       initial revision
+      5/18/24  Adam Krivka       added DebounceIsIdle
+*/
+
+
+
+#ifndef  __DEBOUNCE_H__
+    #define  __DEBOUNCE_H__
+
+
+
+/* library include files */
+#include  <stdint.h>
+
+/* local include files */
+    /* none */
+
+
+
+
+/* constants */
+
+/* most inputs that can be debounced (one per GPIO data in bit) */
+#define  DEBOUNCE_MAX_INPUTS       32
+
+/* samples an input must stay changed to be debounced */
+#define  DEBOUNCE_SAMPLES          4
+
+/* events (ORed with the DIO of the input) */
+#define  DEBOUNCE_EVT_PRESS        0x000    /* input went down */
+#define  DEBOUNCE_EVT_RELEASE      0x100    /* input went up */
+#define  DEBOUNCE_EVT_HOLD         0x200    /* held for its long press time */
+#define  DEBOUNCE_EVT_REPEAT       0x300    /* still held, repeat */
+
+
+
+
+/* macros */
+
+/* parts of an event */
+#define  DEBOUNCE_EVT_DIO(evt)     ((evt) & 0xFF)
+#define  DEBOUNCE_EVT_TYPE(evt)    ((evt) & 0x300)
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* an input in the table passed to DebounceInit */
+typedef  struct  {
+             uint8_t   dio;           /* DIO (GPIO bit) of the input */
+             uint8_t   activeLow;     /* TRUE if it reads 0 when down */
+             uint16_t  reserved;      /* (keeps the times aligned) */
+             uint32_t  holdTicks;     /* ticks to a long press, 0 for none */
+             uint32_t  repeatTicks;   /* ticks between repeats after a */
+                                      /*    long press, 0 for none */
+         }  debounceInput_t;
+
+
+/* function called with the events and the tick count */
+typedef  void  (*debounceCallback_t)(uint32_t, uint32_t);
+
+
+
+
+/* function declarations */
+
+/* set up the engine from a table of inputs */
+void   DebounceInit(const debounceInput_t *, uint32_t, debounceCallback_t);
+
+/* read the GPIOs and debounce them (called every tick) */
+void   DebounceTick(uint32_t);
+
+/* debounce an already read sample of the inputs */
+void   DebounceSample(uint32_t, uint32_t);
+
+/* check whether no input is down or being debounced */
+int    DebounceIsIdle(void);
+
+
+#endif
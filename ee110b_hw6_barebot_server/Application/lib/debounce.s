@@ -0,0 +1,554 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;                                                                            ;
+;                                 debounce.s                                 ;
+;                            GPIO Debounce Engine                            ;
+;                                                                            ;
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+; This file contains a table configured debounce engine for up to 32 GPIO
+; inputs.  The inputs are given by a table of debounceInput_t entries (see
+; debounce.h), each with its DIO, whether it is active low, and its long
+; press and repeat times.  Every input is debounced in the same pass from a
+; single read of the GPIO data in register, so a driver (or several) only
+; needs one periodic tick.  Events are reported through a callback that is
+; passed the event and the tick count.
+;
+; The functions implemented in this file are:
+;   DebounceInit - sets up the engine from an input table
+;   DebounceTick - reads the GPIOs and debounces the inputs
+;   DebounceSample - debounces an already read sample of the inputs
+;   DebounceIsIdle - checks whether no input is down or being debounced
+;
+; The callback, passed to DebounceInit, is called as
+;   callback(uint32_t event, uint32_t ticks)
+; with the event being the DIO of the input ORed with DEBOUNCE_EVT_PRESS,
+; DEBOUNCE_EVT_RELEASE, DEBOUNCE_EVT_HOLD, or DEBOUNCE_EVT_REPEAT.
+;
+; The engine is shared by the projects the way lib/ is: the server debounces
+; its buttons with DebounceTick, the client feeds it the keypad sweeps with
+; DebounceSample.
+;
+; Revision History:
+;     5/16/24  Adam Krivka      initial revision
+;     5/18/24  Adam Krivka      added DebounceIsIdle
+
+
+; local include files
+    .include "debounce_symbols.inc"
+    .include "../std.inc"
+
+; export functions defined in this file
+    .def DebounceInit
+    .def DebounceTick
+    .def DebounceSample
+    .def DebounceIsIdle
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; MEMORY
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+    .data
+    .align 8
+
+; DebounceMask - the inputs being debounced (bit DIO of each)
+DebounceMask: .word 0
+
+; DebounceInvert - the inputs that are active low (same bits)
+DebounceInvert: .word 0
+
+; DebounceState - the debounced inputs that are down (same bits)
+DebounceState: .word 0
+
+; DebounceCount0, DebounceCount1 - the low and high bits of the debounce
+;                                  counter of every input (same bits)
+DebounceCount0: .word DEBOUNCE_COUNT_RESET
+DebounceCount1: .word DEBOUNCE_COUNT_RESET
+
+; DebounceTimed - the inputs that are down with a long press or repeat
+;                 event still to come (same bits)
+DebounceTimed: .word 0
+
+; DebounceHeld - the inputs that have been reported as long presses (same
+;                bits)
+DebounceHeld: .word 0
+
+; DebounceCallback - function called with the events
+DebounceCallback: .word 0
+
+; HoldTicks - ticks each input is down before a long press (0 for none),
+;             indexed by DIO
+HoldTicks: .space DEBOUNCE_MAX_INPUTS * BYTES_PER_WORD
+
+; RepeatTicks - ticks between repeats once each input is long pressed (0
+;               for none), indexed by DIO
+RepeatTicks: .space DEBOUNCE_MAX_INPUTS * BYTES_PER_WORD
+
+; NextEvent - tick count of the next long press or repeat event of each
+;             input, indexed by DIO
+NextEvent: .space DEBOUNCE_MAX_INPUTS * BYTES_PER_WORD
+
+
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+; Code
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+    .text
+
+; DebounceInit
+;
+; Description:          Sets up the debounce engine for the inputs in the
+;                       passed table.  All the inputs start up, with their
+;                       debounce counters reset.  The GPIOs must be
+;                       configured as inputs by the caller.
+;
+; Operation:            The callback is saved and the state, counters, and
+;                       timed events are reset.  Each table entry adds the
+;                       bit of its DIO to the mask (and to the inverted
+;                       inputs if it is active low) and stores its long
+;                       press and repeat times under its DIO.
+;
+; Arguments:            R0 - address of the input table (debounceInput_t).
+;                       R1 - number of entries in the table.
+;                       R2 - address of the callback function.
+; Return Values:        None.
+;
+; Local Variables:      R4 - bit of the input.
+;                       R5 - inputs debounced.
+;                       R6 - inputs that are active low.
+; Shared Variables:     DebounceMask, DebounceInvert - written.
+;                       DebounceState, DebounceCount0, DebounceCount1,
+;                       DebounceTimed, DebounceHeld - written.
+;                       DebounceCallback - written.
+;                       HoldTicks, RepeatTicks - written.
+; Global Variables:     None.
+;
+; Inputs:               None.
+; Outputs:              None.
+;
+; Error Handling:       Entries with a DIO of DEBOUNCE_MAX_INPUTS or more are
+;                       ignored.
+;
+; Registers Changed:    flags, R0, R1, R2, R3, R12
+; Stack Depth:          4
+;
+; Revision History:
+;       5/16/24     Adam Krivka      initial revision
+
+DebounceInit:
+    PUSH    {LR, R4, R5, R6}        ; save return address and registers
+
+    ; save the callback
+    MOVA    R3, DebounceCallback
+    STR     R2, [R3]
+
+    ; all the inputs are up and nothing is being debounced or timed
+    MOV     R2, #0
+    MOVA    R3, DebounceState
+    STR     R2, [R3]
+    MOVA    R3, DebounceTimed
+    STR     R2, [R3]
+    MOVA    R3, DebounceHeld
+    STR     R2, [R3]
+    MOV32   R2, DEBOUNCE_COUNT_RESET
+    MOVA    R3, DebounceCount0
+    STR     R2, [R3]
+    MOVA    R3, DebounceCount1
+    STR     R2, [R3]
+
+    ; no inputs until the table is read
+    MOV     R5, #0
+    MOV     R6, #0
+    ;B      DebounceInitEntry
+
+
+; Add the table entry at R0 (R1 entries left)
+DebounceInitEntry:
+    CMP     R1, #0                  ; check for entries left
+    BEQ     DebounceInitEnd         ; none, done
+
+    LDRB    R3, [R0, #DEBOUNCE_ENTRY_DIO] ; get the DIO of the input
+    CMP     R3, #DEBOUNCE_MAX_INPUTS ; and make sure it is a GPIO bit
+    BHS     DebounceInitNext        ; it isn't, skip the entry
+
+    MOV     R4, #1                  ; add the input to the mask
+    LSL     R4, R3
+    ORR     R5, R4
+
+    LDRB    R12, [R0, #DEBOUNCE_ENTRY_ACTIVE_LOW] ; check whether active low
+    CMP     R12, #FALSE
+    BEQ     DebounceInitTiming      ; it isn't, just set the timing
+    ;B      DebounceInitInvert
+
+DebounceInitInvert:
+    ORR     R6, R4                  ; invert it when it is read
+    ;B      DebounceInitTiming
+
+DebounceInitTiming:
+    LDR     R12, [R0, #DEBOUNCE_ENTRY_HOLD] ; store the long press time
+    MOVA    R4, HoldTicks
+    STR     R12, [R4, R3, LSL #2]
+    LDR     R12, [R0, #DEBOUNCE_ENTRY_REPEAT] ; and the repeat time
+    MOVA    R4, RepeatTicks
+    STR     R12, [R4, R3, LSL #2]
+    ;B      DebounceInitNext
+
+DebounceInitNext:
+    ADD     R0, #DEBOUNCE_ENTRY_SIZE ; move to the next entry
+    SUB     R1, #1
+    B       DebounceInitEntry
+
+
+DebounceInitEnd:
+    ; save the inputs
+    MOVA    R3, DebounceMask
+    STR     R5, [R3]
+    MOVA    R3, DebounceInvert
+    STR     R6, [R3]
+
+    POP     {LR, R4, R5, R6}        ; restore return address and registers
+    BX      LR
+
+
+
+; DebounceTick
+;
+; Description:      Reads all the GPIO inputs at once and debounces them (see
+;                   DebounceSample).  This is meant to be called from a
+;                   periodic clock, the debounce time is DEBOUNCE_SAMPLES
+;                   clock periods.
+;
+; Operation:        The GPIO data in register is read, the active low inputs
+;                   are inverted so every input reads 1 when it is down, and
+;                   the sample is passed to DebounceSample.
+;
+; Arguments:        R0 - tick count (timestamp for the events).
+; Return Values:    None.
+;
+; Local Variables:  None.
+; Shared Variables: DebounceInvert - read.
+; Global Variables: None.
+;
+; Inputs:           GPIO inputs.
+; Outputs:          Calling the callback (through DebounceSample).
+;
+; Error Handling:   None.
+;
+; Registers Changed: flags, R0, R1, R2, R3, R12
+; Stack Depth:        8 (DebounceSample)
+;
+; Revision History:
+;     5/16/24  Adam Krivka      initial revision
+
+DebounceTick:
+    MOV     R1, R0                  ; tick count is the second argument
+
+    ; read all the inputs at once
+    MOV32   R2, GPIO_BASE_ADDR
+    LDR     R0, [R2, #GPIO_DIN_OFFSET]
+
+    ; make the active low inputs read 1 when down
+    MOVA    R2, DebounceInvert
+    LDR     R2, [R2]
+    EOR     R0, R2
+    ;B      DebounceSample          ; and debounce them
+
+
+
+; DebounceSample
+;
+; Description:      Debounces all the inputs in parallel from a sample of
+;                   them.  When an input has been down for DEBOUNCE_SAMPLES
+;                   samples the callback is called with
+;                         DIO | DEBOUNCE_EVT_PRESS
+;                   and when it has been up for DEBOUNCE_SAMPLES samples
+;                   with DIO | DEBOUNCE_EVT_RELEASE.  An input with a long
+;                   press time that stays down that long is reported with
+;                   DIO | DEBOUNCE_EVT_HOLD, and then with
+;                   DIO | DEBOUNCE_EVT_REPEAT every repeat time if it has
+;                   one.  The passed tick count is the second argument.
+;                   Every input is debounced and timed on its own, so any
+;                   number of them can be down at once.
+;
+; Operation:        The sample is masked to the inputs and debounced with a
+;                   2-bit vertical counter per input: the counter of an
+;                   input that differs from DebounceState counts, the
+;                   counter of an input that matches is reset, and the
+;                   inputs whose counter rolls over toggle in
+;                   DebounceState.  A press or release event is generated
+;                   for each toggled input.  A press of an input with a long
+;                   press time schedules its next event in NextEvent and
+;                   marks it in DebounceTimed, a release unmarks it.  Then
+;                   every timed input whose scheduled tick count has been
+;                   reached generates a hold event (the first time) or a
+;                   repeat event, and is rescheduled RepeatTicks later or
+;                   unmarked if it doesn't repeat.
+;
+; Arguments:        R0 - sample of the inputs (1 for an input that is down).
+;                   R1 - tick count (timestamp for the events).
+; Return Values:    None.
+;
+; Local Variables:
+;         R4 = DebounceState address, then DIO of the timed input
+;         R5 = DebounceCount0 address, then bit of the timed input
+;         R6 = DebounceCount1 address
+;         R7 = inputs pressed (to report), then timed inputs (to check)
+;         R8 = inputs released (to report)
+;         R9 = tick count
+;         R10 = callback
+; Shared Variables: DebounceMask - read.
+;                   DebounceState - read and written.
+;                   DebounceCount0, DebounceCount1 - read and written.
+;                   DebounceTimed, DebounceHeld - read and written.
+;                   NextEvent - read and written.
+;                   HoldTicks, RepeatTicks, DebounceCallback - read.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          Calling the callback.
+;
+; Error Handling:   None.
+;
+; Algorithms:       Vertical counters (bit i of DebounceCount0 and
+;                   DebounceCount1 is the counter of input i, so all the
+;                   inputs count at once).
+; Data Structures:  None.
+;
+; Registers Changed: flags, R0, R1, R2, R3, R12
+; Stack Depth:        8
+;
+; Revision History:
+;     5/16/24  Adam Krivka      initial revision
+
+DebounceSample:
+    PUSH    {LR, R4, R5, R6, R7, R8, R9, R10} ; save return address and registers
+    MOV     R9, R1                  ; keep the tick count for the events
+
+    ; only look at the inputs being debounced
+    MOVA    R1, DebounceMask
+    LDR     R1, [R1]
+    AND     R0, R1
+
+    ; load the debounced state and the counters
+    MOVA    R4, DebounceState
+    LDR     R2, [R4]
+    MOVA    R5, DebounceCount0
+    LDR     R3, [R5]
+    MOVA    R6, DebounceCount1
+    LDR     R1, [R6]
+
+    ; count the inputs that differ from the state, reset the others
+    EOR     R0, R2                  ; inputs that differ from the state
+    AND     R3, R0                  ; count0 = ~(count0 & differ)
+    MVN     R3, R3
+    AND     R1, R0                  ; count1 = count0 ^ (count1 & differ)
+    EOR     R1, R3
+
+    ; inputs whose counters rolled over toggle
+    AND     R0, R3                  ; differ & count0 & count1
+    AND     R0, R1
+    EOR     R2, R0                  ; toggle them in the state
+
+    ; save the state and the counters
+    STR     R2, [R4]
+    STR     R3, [R5]
+    STR     R1, [R6]
+
+    ; split the toggled inputs into presses and releases
+    AND     R7, R0, R2              ; toggled and now down
+    BIC     R8, R0, R2              ; toggled and now up
+
+    ; get the callback for the events
+    MOVA    R10, DebounceCallback
+    LDR     R10, [R10]
+    ;B      ReportPressed
+
+
+
+; Generate an event for every input in R7 that was pressed
+ReportPressed:
+    CMP     R7, #0                  ; check for inputs left
+    BEQ     ReportReleased          ; none, go report the released inputs
+
+    CLZ     R0, R7                  ; find the highest input left
+    RSB     R0, R0, #31             ; its DIO
+    MOV     R1, #1                  ; remove it from the inputs left
+    LSL     R1, R0
+    BIC     R7, R1
+
+    ; check whether it has a long press time
+    MOVA    R2, HoldTicks
+    LDR     R3, [R2, R0, LSL #2]
+    CMP     R3, #0
+    BEQ     ReportPressedEvent      ; it doesn't, just report it
+    ;B      StartHoldTimer
+
+StartHoldTimer:
+    ADD     R3, R9                  ; schedule the long press
+    MOVA    R2, NextEvent
+    STR     R3, [R2, R0, LSL #2]
+    MOVA    R2, DebounceTimed       ; and mark it as timed
+    LDR     R3, [R2]
+    ORR     R3, R1
+    STR     R3, [R2]
+    ;B      ReportPressedEvent
+
+ReportPressedEvent:
+    ORR     R0, #DEBOUNCE_EVT_PRESS ; it is a press
+    MOV     R1, R9                  ; with the tick count
+    BLX     R10                     ; report it
+    B       ReportPressed           ; check for more inputs
+
+
+; Generate an event for every input in R8 that was released
+ReportReleased:
+    CMP     R8, #0                  ; check for inputs left
+    BEQ     CheckTimed              ; none, check for timed events
+
+    CLZ     R0, R8                  ; find the highest input left
+    RSB     R0, R0, #31             ; its DIO
+    MOV     R1, #1                  ; remove it from the inputs left
+    LSL     R1, R0
+    BIC     R8, R1
+
+    ; it has no more timed events and isn't long pressed anymore
+    MOVA    R2, DebounceTimed
+    LDR     R3, [R2]
+    BIC     R3, R1
+    STR     R3, [R2]
+    MOVA    R2, DebounceHeld
+    LDR     R3, [R2]
+    BIC     R3, R1
+    STR     R3, [R2]
+
+    ORR     R0, #DEBOUNCE_EVT_RELEASE ; it is a release
+    MOV     R1, R9                  ; with the tick count
+    BLX     R10                     ; report it
+    B       ReportReleased          ; check for more inputs
+
+
+
+; Generate the long press and repeat events that are due
+CheckTimed:
+    MOVA    R2, DebounceTimed       ; get the timed inputs
+    LDR     R7, [R2]
+    ;B      CheckTimedInput
+
+CheckTimedInput:
+    CMP     R7, #0                  ; check for inputs left
+    BEQ     DebounceSampleEnd       ; none, done
+
+    CLZ     R4, R7                  ; find the highest input left
+    RSB     R4, R4, #31             ; its DIO
+    MOV     R5, #1                  ; remove it from the inputs left
+    LSL     R5, R4
+    BIC     R7, R5
+
+    MOVA    R2, NextEvent           ; check whether its event is due
+    LDR     R3, [R2, R4, LSL #2]
+    SUBS    R1, R9, R3              ; (compare as a difference so the tick
+    BMI     CheckTimedInput         ;  count can wrap), not yet, next input
+
+    MOVA    R6, DebounceHeld        ; check whether it was long pressed
+    LDR     R1, [R6]
+    TST     R1, R5
+    BNE     TimedRepeat             ; it was, this is a repeat
+    ;B      TimedHold               ; otherwise this is the long press
+
+TimedHold:
+    ORR     R1, R5                  ; it is long pressed now
+    STR     R1, [R6]
+    ORR     R0, R4, #DEBOUNCE_EVT_HOLD ; report a long press
+    B       ScheduleTimed
+
+TimedRepeat:
+    ORR     R0, R4, #DEBOUNCE_EVT_REPEAT ; report a repeat
+    ;B      ScheduleTimed
+
+ScheduleTimed:
+    MOVA    R6, RepeatTicks         ; check whether it repeats
+    LDR     R1, [R6, R4, LSL #2]
+    CMP     R1, #0
+    BEQ     StopTimed               ; it doesn't, no more timed events
+    ;B      NextTimed
+
+NextTimed:
+    ADD     R3, R1                  ; schedule the next repeat
+    STR     R3, [R2, R4, LSL #2]
+    B       ReportTimed
+
+StopTimed:
+    MOVA    R6, DebounceTimed       ; no more timed events for it
+    LDR     R1, [R6]
+    BIC     R1, R5
+    STR     R1, [R6]
+    ;B      ReportTimed
+
+ReportTimed:
+    MOV     R1, R9                  ; with the tick count
+    BLX     R10                     ; report it
+    B       CheckTimedInput         ; check for more inputs
+
+
+DebounceSampleEnd:
+    POP     {LR, R4, R5, R6, R7, R8, R9, R10} ; restore return address and registers
+    BX      LR
+
+
+
+; DebounceIsIdle
+;
+; Description:      Checks whether the inputs are idle, that is no input is
+;                   down or being debounced.
+;
+; Operation:        The inputs are idle if none of them is down in
+;                   DebounceState and every debounce counter is at
+;                   DEBOUNCE_COUNT_RESET (no input is changing).  Only the
+;                   inputs in DebounceMask are looked at.
+;
+; Arguments:        None.
+; Return Values:    R0 - TRUE if the inputs are idle, FALSE otherwise.
+;
+; Local Variables:  None.
+; Shared Variables: DebounceMask - read.
+;                   DebounceState - read.
+;                   DebounceCount0, DebounceCount1 - read.
+; Global Variables: None.
+;
+; Inputs:           None.
+; Outputs:          None.
+;
+; Error Handling:   None.
+;
+; Registers Changed: flags, R0, R1, R2
+; Stack Depth:        0
+;
+; Revision History:
+;     5/18/24  Adam Krivka      initial revision
+
+DebounceIsIdle:
+    ; get the inputs whose counters are counting
+    MOVA    R1, DebounceCount0
+    LDR     R1, [R1]
+    MOVA    R2, DebounceCount1
+    LDR     R2, [R2]
+    AND     R1, R2                  ; counters at rest are all ones
+    MVN     R0, R1
+
+    ; and the inputs that are down
+    MOVA    R1, DebounceState
+    LDR     R1, [R1]
+    ORR     R0, R1
+
+    ; of the inputs being debounced
+    MOVA    R1, DebounceMask
+    LDR     R1, [R1]
+    TST     R0, R1
+    BNE     DebounceIsIdleFalse     ; an input is down or changing
+    ;B      DebounceIsIdleTrue
+
+DebounceIsIdleTrue:
+    MOV     R0, #TRUE               ; nothing is happening
+    BX      LR
+
+DebounceIsIdleFalse:
+    MOV     R0, #FALSE              ; an input is down or changing
+    BX      LR
@@ -0,0 +1,100 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                msg_pool.h                                */
+/*                        Fixed-Size Message Block Pool                     */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, structures, and function prototypes for
+   the fixed-size message block pool defined in msg_pool.c.  The pool is
+   used in place of ICall_malloc() for the messages the BLE tasks queue to
+   themselves.
+
+
+   Revision History:
+      4/4/24   Adam Krivka       initial revision
+*/
+
+
+
+#ifndef  __MSG_POOL_H__
+    #define  __MSG_POOL_H__
+
+
+
+/* library include files */
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/knl/Event.h>
+
+/* local include files */
+    /* none */
+
+
+
+
+/* constants */
+    /* none */
+
+
+
+
+/* macros */
+
+/* size in words of a block holding a message of the passed size in bytes */
+/*    (the queue link is stored in front of the message) */
+#define  MSG_POOL_BLOCK_WORDS(size)                                         \
+             ((sizeof(Queue_Elem) + (size) + sizeof(uint32_t) - 1) /        \
+              sizeof(uint32_t))
+
+/* declare word aligned storage for a pool of num messages of the passed size */
+#define  MSG_POOL_STORAGE(name, size, num)                                  \
+             static uint32_t  name[MSG_POOL_BLOCK_WORDS(size) * (num)]
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* pool usage statistics */
+typedef  struct  {
+             uint16_t  numBlocks;   /* number of blocks in the pool */
+             uint16_t  inUse;       /* blocks currently allocated */
+             uint16_t  highWater;   /* most blocks ever allocated at once */
+             uint32_t  allocFails;  /* allocations that found the pool empty */
+         }  msgPoolStats_t;
+
+
+/* a message pool - only accessed through the MsgPool functions */
+typedef  struct  {
+             Queue_Elem     *pFree;       /* head of the free block list */
+             uint8_t        *pStart;      /* first block in the storage */
+             uint8_t        *pEnd;        /* end of the storage */
+             uint16_t        blockSize;   /* size of a block in bytes */
+             msgPoolStats_t  stats;       /* usage statistics */
+         }  MsgPool_t;
+
+
+
+
+/* function declarations */
+
+/* set up a pool in the passed storage */
+void   MsgPool_init(MsgPool_t *, uint32_t *, uint16_t, uint16_t);
+
+/* allocate and free messages */
+void  *MsgPool_alloc(MsgPool_t *);
+void   MsgPool_free(MsgPool_t *, void *);
+
+/* queue pool messages without any further allocation */
+void   MsgPool_enqueue(Queue_Handle, Event_Handle, void *);
+void  *MsgPool_dequeue(Queue_Handle);
+
+/* get the pool statistics */
+void   MsgPool_getStats(MsgPool_t *, msgPoolStats_t *);
+
+
+#endif
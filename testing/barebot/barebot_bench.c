@@ -0,0 +1,1367 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              barebot_bench.c                             */
+/*                      Host-Side Barebot Benchmark Harness                 */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a host program that runs the barebot peripheral
+   (barebot_peripheral.c and barebot_gatt_profile.c) and the barebot central
+   (barebot_central.c) as they are, on the kernel stand-ins in host_rtos.c,
+   connected by the loopback radio in ble_stack.c.  It is built and run with
+   "make" in this directory.  Functions included are:
+        main - run the benchmarks and checks and print the results
+
+   Local functions:
+        BenchAppQueue   - time button messages through the peripheral queue
+        CheckLongWrite  - check the thoughts can be written in pieces
+        BenchDispatch   - time profile reads, dispatch table against switch
+        SwitchReadAttrCB - profile read callback with the old UUID switch
+        BenchAdvTrace   - time advertising reports through the pre-filter
+        MakeAdvTrace    - make the advertising reports of the trace
+        AddAdItem       - add an AD structure to advertising data
+        StartCentral    - start the central and wait for it to be ready
+        WaitReady       - wait for the central to be ready
+        CheckAccess     - check a write and reads through the central
+        CheckRefusedWrite - check a refused write keeps the link up
+        BenchCommands   - time streamed update commands to the peripheral
+        CheckReconnect  - check the central reconnects without discovery
+
+   The first benchmark queues button presses to the peripheral from outside
+   its task, in batches, and lets the task drain each batch before the next
+   one, so it measures the messages per second through the application
+   queue (allocation, Util_enqueueMsg, the wakeup, Util_dequeueMsg and the
+   handler).  The second streams speed and turn update commands from the
+   central to the peripheral over the radio and measures commands per
+   second through both tasks.  Both check every message arrived and no
+   message or heap block was lost.  The radio isn't timed, so the rates
+   are of the code and the host, not of the air.  Two more steps run on the
+   peripheral alone: the thoughts are written in pieces as a long write
+   lands, and the profile reads are timed through the attribute dispatch
+   table against the UUID switch it replaced (kept here as
+   SwitchReadAttrCB).  Last, a trace of made-up advertising reports (the
+   server's, other devices', allow listed and malformed ones) is given to
+   the central's scanner callback and the time per report and the reports
+   forwarded by its pre-filter are measured.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <unistd.h>
+#include  <icall.h>
+#include  <icall_ble_api.h>
+#include  <ti/sysbios/knl/Event.h>
+
+/* local includes */
+#include "barebot_bench.h"
+#include "barebot_peripheral_intf.h"
+#include "barebot_gatt_profile.h"
+#include "button/button_rtos_intf.h"
+#include "barebot_central_intf.h"
+#include "barebot_ui_intf.h"
+
+/* constants */
+#define RUN_TIMEOUT_S       120     /* longest the run may take (s) */
+#define READY_TIMEOUT_MS    5000    /* longest the central may take to be */
+                                    /*    ready (ms) */
+#define READY_POLL_MS       10      /* time between checks for ready (ms) */
+
+#define QUEUE_BATCH         16      /* presses per batch (the pool size) */
+#define QUEUE_BATCHES       4000    /* batches timed */
+#define QUEUE_SINGLES       16000   /* single presses timed */
+
+#define LONG_THOUGHTS       "thinking in several pieces"
+                                    /* thoughts written with a long write */
+#define LONG_WRITE_PIECE    (ATT_MTU_SIZE - 5)  /* bytes in a Prepare Write */
+
+#define DISPATCH_ATTRS      4       /* attributes read by BenchDispatch */
+#define DISPATCH_READS      4000000 /* reads timed each way */
+#define DISPATCH_MAX_LEN    (ATT_MTU_SIZE - 1)  /* bytes in a read response */
+
+#define ADV_TRACE_KINDS     8       /* kinds of report in the trace */
+#define ADV_TRACE_LEN       64      /* reports in the trace */
+#define ADV_TRACE_REPORTS   80000   /* reports timed (the trace in turn) */
+#define ADV_TRACE_BATCH     8       /* reports between central task runs */
+#define ADV_MAX_DATA        31      /* bytes of legacy advertising data */
+#define ADV_SERVER_NAME_STR "BP"    /* name of the server (the central's */
+                                    /*    BAREBOT_SERVER_LOCAL_NAME) */
+#define ADV_OTHER_NAME_STR  "Phone" /* name of the other devices */
+#define ADV_OTHER_UUID      0x180D  /* service of the other devices */
+
+/* kinds of report in the trace (those up to ADV_ALLOWED are forwarded) */
+#define ADV_SERVER          0       /* the server name and service */
+#define ADV_NAME_ONLY       1       /* the server name, no services */
+#define ADV_ALLOWED         2       /* allow listed address, another name */
+#define ADV_OTHER_SERVICE   3       /* the server name, another service */
+#define ADV_OTHER_NAME      4       /* another name */
+#define ADV_NO_NAME         5       /* no name */
+#define ADV_TRUNCATED       6       /* the server name, cut short */
+#define ADV_BAD_LENGTH      7       /* an AD length past the data */
+
+#define NUM_COMMANDS        4000    /* update commands streamed */
+#define SPEED_WRITTEN       5       /* speed written before streaming */
+#define SPEED_REFUSED       7       /* speed write the peripheral refuses */
+#define THOUGHTS_READ_LEN   22      /* thoughts bytes in one read response */
+
+/* structures */
+
+/* advertising report of the trace */
+typedef struct {
+    uint8       kind;                   /* kind of report (ADV_...) */
+    uint8       addr[B_ADDR_LEN];       /* advertiser address */
+    uint8       data[ADV_MAX_DATA];     /* advertising data */
+    uint16      len;                    /* bytes of it */
+} advTraceRpt_t;
+
+/* shared/global variables */
+
+/* event the UI posts when it is initialized (barebot_synch.h, defined by */
+/*    barebot_central_demo.c on the board) */
+Event_Handle uiInitDoneHandle;
+static Event_Struct uiInitDone;
+
+/* speed and turn last passed to the UI by the central */
+static int16 uiSpeed = 0;
+static int16 uiTurn = 0;
+
+/* local functions */
+static int BenchAppQueue(void);
+static int CheckLongWrite(void);
+static int BenchDispatch(void);
+static bStatus_t SwitchReadAttrCB(uint16 connHandle, gattAttribute_t *pAttr,
+                                  uint8 *pValue, uint16 *pLen, uint16 offset,
+                                  uint16 maxLen, uint8 method);
+static int BenchAdvTrace(void);
+static bool MakeAdvTrace(advTraceRpt_t *trace);
+static uint16 AddAdItem(uint8 *pData, uint16 len, uint8 type,
+                        const void *pItem, uint8 itemLen);
+static int StartCentral(void);
+static int WaitReady(void);
+static int CheckAccess(void);
+static int CheckRefusedWrite(void);
+static int BenchCommands(void);
+static int CheckReconnect(void);
+
+
+
+/* functions */
+
+/*
+   main(void)
+
+   Description:      This function runs the benchmarks and checks and
+                     prints the results.
+   Operation:        The kernel and radio are started, the peripheral is
+                     started, its application queue benchmarked and its
+                     profile writes and reads checked and timed, then
+                     the central is started and the access, refused write,
+                     command and reconnect steps and the advertising trace
+                     are run.  The errors are added up.
+
+   Arguments:        None.
+   Return Value:     0 if every check passed, 1 otherwise.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   The run is stopped if it takes more than RUN_TIMEOUT_S
+                     seconds (a task stuck waiting).  The central steps are
+                     skipped if it never becomes ready.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int main(void)
+{
+    /* variables */
+    bleStackStats_t radio; /* radio counts */
+    int errors = 0; /* number of failed checks */
+
+    alarm(RUN_TIMEOUT_S);
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    HostRtos_start();
+    BleStack_start();
+
+    /* the peripheral alone first, it advertises with no one listening */
+    BarebotPeripheral_createTask();
+    BleStack_waitQuiet();
+    errors += BenchAppQueue();
+    errors += CheckLongWrite();
+    errors += BenchDispatch();
+
+    /* then the central connects to it */
+    if (StartCentral() == 0)
+    {
+        errors += CheckAccess();
+        errors += CheckRefusedWrite();
+        errors += BenchCommands();
+        errors += CheckReconnect();
+        errors += BenchAdvTrace();
+    }
+    else
+    {
+        errors++;
+    }
+
+    BleStack_getStats(&radio);
+    printf("\nradio: %lu links, %lu discoveries, %lu advertising reports,"
+           " %lu parameter updates\n", (unsigned long) radio.links,
+           (unsigned long) radio.discoveries,
+           (unsigned long) radio.advReports,
+           (unsigned long) radio.paramUpdates);
+    printf("radio: %lu connection events, %lu packets to the peripheral,"
+           " %lu to the central, %lu refused\n",
+           (unsigned long) radio.connEvents, (unsigned long) radio.toServer,
+           (unsigned long) radio.toClient, (unsigned long) radio.txFull);
+
+    printf("\n%s\n", (errors == 0) ? "all checks passed" : "CHECKS FAILED");
+    return (errors == 0) ? 0 : 1;
+}
+
+
+
+/*
+   BenchAppQueue(void)
+
+   Description:      This function measures the messages per second through
+                     the peripheral's application queue, in batches of
+                     QUEUE_BATCH messages and one message at a time.
+   Operation:        Button presses are queued as the button code does
+                     (ButtonPressed), and after each batch the peripheral
+                     task is let run until it waits again.  The presses
+                     alternate between the two buttons so each one changes
+                     the profile.  The task and pool statistics are checked
+                     against the messages sent.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The rates and statistics are printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int BenchAppQueue(void)
+{
+    /* variables */
+    bpTaskStats_t before; /* task statistics before the run */
+    bpTaskStats_t after; /* and after */
+    msgPoolStats_t evtPool; /* event pool statistics */
+    msgPoolStats_t advPool; /* advertising pool statistics */
+    uint64_t start; /* time a run started (us) */
+    double batched; /* messages per second in batches */
+    double single; /* messages per second one at a time */
+    uint32_t sent; /* messages sent */
+    int errors = 0; /* number of errors */
+    int b, m; /* batch and message indices */
+
+    BarebotPeripheral_getTaskStats(&before);
+
+    /* batches as big as the pool */
+    start = HostRtos_usec();
+    for (b = 0; b < QUEUE_BATCHES; b++)
+    {
+        for (m = 0; m < QUEUE_BATCH; m++)
+            ButtonPressed((m & 1) ? BUTTON_1_ID : BUTTON_0_ID);
+        HostRtos_waitIdle();
+    }
+    batched = (double) QUEUE_BATCHES * QUEUE_BATCH * 1e6
+            / (double) (HostRtos_usec() - start);
+
+    /* one at a time (a wakeup each) */
+    start = HostRtos_usec();
+    for (m = 0; m < QUEUE_SINGLES; m++)
+    {
+        ButtonPressed((m & 1) ? BUTTON_1_ID : BUTTON_0_ID);
+        HostRtos_waitIdle();
+    }
+    single = (double) QUEUE_SINGLES * 1e6 / (double) (HostRtos_usec() - start);
+
+    BarebotPeripheral_getTaskStats(&after);
+    BarebotPeripheral_getPoolStats(&evtPool, &advPool);
+    sent = QUEUE_BATCHES * QUEUE_BATCH + QUEUE_SINGLES;
+
+    printf("app queue: %d batches of %d: %.0f msgs/s\n", QUEUE_BATCHES,
+           QUEUE_BATCH, batched);
+    printf("app queue: %d single messages: %.0f msgs/s\n", QUEUE_SINGLES,
+           single);
+    printf("app queue: %lu messages in %lu wakeups, largest batch %lu\n",
+           (unsigned long) (after.appMsgs - before.appMsgs),
+           (unsigned long) (after.wakeups - before.wakeups),
+           (unsigned long) after.maxAppBatch);
+    printf("app queue: event pool %lu of %lu used at most, %lu in use,"
+           " %lu allocation failures\n", (unsigned long) evtPool.highWater,
+           (unsigned long) evtPool.numBlocks, (unsigned long) evtPool.inUse,
+           (unsigned long) evtPool.allocFails);
+
+    if (after.appMsgs - before.appMsgs != sent)
+    {
+        printf("  %lu messages handled, %lu sent\n",
+               (unsigned long) (after.appMsgs - before.appMsgs),
+               (unsigned long) sent);
+        errors++;
+    }
+    if (after.wakeups - before.wakeups != QUEUE_BATCHES + QUEUE_SINGLES)
+    {
+        printf("  %lu wakeups, should be one per batch (%d)\n",
+               (unsigned long) (after.wakeups - before.wakeups),
+               QUEUE_BATCHES + QUEUE_SINGLES);
+        errors++;
+    }
+    if ((evtPool.allocFails != 0) || (evtPool.inUse != 0))
+    {
+        printf("  event pool lost messages\n");
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+/*
+   CheckLongWrite(void)
+
+   Description:      This function checks the thoughts can be written in
+                     pieces, as the stack applies a long write (Prepare
+                     Write and Execute Write), and that the fixed length
+                     values can't.
+   Operation:        The thoughts are filled, then a shorter string is
+                     written to them in pieces of LONG_WRITE_PIECE bytes
+                     through the service write callback, and the profile
+                     is checked for the string with the rest cleared.
+                     Pieces that don't fit, and a speed write at an offset
+                     or of the wrong length, must be refused.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckLongWrite(void)
+{
+    /* variables */
+    static const char longThoughts[] = LONG_THOUGHTS; /* string written */
+    uint8 thoughts[BAREBOTPROFILE_THOUGHTS_LEN]; /* thoughts in the profile */
+    uint8 fill[BAREBOTPROFILE_THOUGHTS_LEN]; /* value written first */
+    uint8 value[BAREBOTPROFILE_SPEED_LEN] = { 0 }; /* a short value */
+    CONST gattServiceCBs_t *pCBs; /* the profile's callbacks */
+    gattAttribute_t *pThoughts; /* the thoughts attribute */
+    gattAttribute_t *pSpeed; /* the speed attribute */
+    uint16 len = sizeof(longThoughts) - 1; /* length of the string */
+    uint16 offset; /* offset of a piece */
+    bStatus_t status = SUCCESS; /* result of a write */
+    int errors = 0; /* number of errors */
+    int i; /* byte index */
+
+    pSpeed = BleStack_findAttr(BAREBOTPROFILE_SPEED_UUID, &pCBs);
+    pThoughts = BleStack_findAttr(BAREBOTPROFILE_THOUGHTS_UUID, &pCBs);
+    if ((pSpeed == NULL) || (pThoughts == NULL))
+    {
+        printf("  the profile attributes are not registered\n");
+        return 1;
+    }
+
+    /* fill the thoughts, then write the shorter string in pieces */
+    memset(fill, 'x', sizeof(fill));
+    status = pCBs->pfnWriteAttrCB(0, pThoughts, fill, sizeof(fill), 0,
+                                  ATT_WRITE_REQ);
+    for (offset = 0; (status == SUCCESS) && (offset < len);
+            offset += LONG_WRITE_PIECE)
+        status = pCBs->pfnWriteAttrCB(0, pThoughts,
+                                      (uint8 *) &longThoughts[offset],
+                                      MIN(LONG_WRITE_PIECE, len - offset),
+                                      offset, ATT_EXECUTE_WRITE_REQ);
+    HostRtos_waitIdle();
+    BarebotProfile_GetParameter(BAREBOTPROFILE_THOUGHTS, thoughts);
+
+    printf("\nlong write: %u bytes of thoughts in pieces of %d\n", len,
+           LONG_WRITE_PIECE);
+    if ((status != SUCCESS) || (memcmp(thoughts, longThoughts, len) != 0))
+    {
+        printf("  the pieces were not written (status 0x%02X)\n", status);
+        errors++;
+    }
+    for (i = len; i < BAREBOTPROFILE_THOUGHTS_LEN; i++)
+    {
+        if (thoughts[i] != 0)
+        {
+            printf("  the end of the old thoughts was not cleared\n");
+            errors++;
+            break;
+        }
+    }
+
+    /* pieces that don't fit and partial fixed length values are refused */
+    if (pCBs->pfnWriteAttrCB(0, pThoughts, fill, 4,
+                             BAREBOTPROFILE_THOUGHTS_LEN - 2,
+                             ATT_EXECUTE_WRITE_REQ)
+            != ATT_ERR_INVALID_VALUE_SIZE)
+    {
+        printf("  a piece past the end of the thoughts was written\n");
+        errors++;
+    }
+    if (pCBs->pfnWriteAttrCB(0, pThoughts, fill, 1,
+                             BAREBOTPROFILE_THOUGHTS_LEN + 1,
+                             ATT_EXECUTE_WRITE_REQ) != ATT_ERR_INVALID_OFFSET)
+    {
+        printf("  a piece after the end of the thoughts was written\n");
+        errors++;
+    }
+    if ((pCBs->pfnWriteAttrCB(0, pSpeed, value, 1, 1, ATT_EXECUTE_WRITE_REQ)
+            != ATT_ERR_ATTR_NOT_LONG)
+            || (pCBs->pfnWriteAttrCB(0, pSpeed, value, 1, 0, ATT_WRITE_REQ)
+                    != ATT_ERR_INVALID_VALUE_SIZE))
+    {
+        printf("  part of the speed was written\n");
+        errors++;
+    }
+    HostRtos_waitIdle();
+
+    return errors;
+}
+
+
+
+/*
+   BenchDispatch(void)
+
+   Description:      This function compares the time to read a profile
+                     value through the attribute dispatch table with the
+                     time through the UUID switch it replaced.
+   Operation:        The speed, turn, thoughts and state attributes are
+                     read in turn DISPATCH_READS times through the profile
+                     read callback and through SwitchReadAttrCB, both
+                     called through a pointer as the stack calls them.
+                     Both are first checked to read the same values.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The times per read are printed to stdout.
+
+   Error Handling:   A value read differently by the two is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int BenchDispatch(void)
+{
+    /* variables */
+    static const uint16 uuids[DISPATCH_ATTRS] = { BAREBOTPROFILE_SPEED_UUID,
+            BAREBOTPROFILE_TURN_UUID, BAREBOTPROFILE_THOUGHTS_UUID,
+            BAREBOTPROFILE_STATE_UUID }; /* attributes read */
+    gattAttribute_t *pAttrs[DISPATCH_ATTRS]; /* and their attributes */
+    CONST gattServiceCBs_t *pCBs = NULL; /* the profile's callbacks */
+    pfnGATTReadAttrCB_t volatile pfnTable; /* read through the table */
+    pfnGATTReadAttrCB_t volatile pfnSwitch; /* read through the switch */
+    uint8 value[ATT_MTU_SIZE]; /* a value read through the table */
+    uint8 switched[ATT_MTU_SIZE]; /* and through the switch */
+    uint16 len; /* length read through the table */
+    uint16 switchLen; /* and through the switch */
+    uint64_t start; /* time a run started (us) */
+    double tableNs; /* time per read through the table (ns) */
+    double switchNs; /* and through the switch (ns) */
+    int errors = 0; /* number of errors */
+    int a; /* attribute index */
+    long r; /* read index */
+
+    for (a = 0; a < DISPATCH_ATTRS; a++)
+    {
+        pAttrs[a] = BleStack_findAttr(uuids[a], &pCBs);
+        if (pAttrs[a] == NULL)
+        {
+            printf("  the profile attributes are not registered\n");
+            return 1;
+        }
+    }
+    pfnTable = pCBs->pfnReadAttrCB;
+    pfnSwitch = SwitchReadAttrCB;
+
+    /* both must read the same */
+    for (a = 0; a < DISPATCH_ATTRS; a++)
+    {
+        if ((pfnTable(0, pAttrs[a], value, &len, 0, DISPATCH_MAX_LEN,
+                      ATT_READ_REQ) != SUCCESS)
+                || (pfnSwitch(0, pAttrs[a], switched, &switchLen, 0,
+                              DISPATCH_MAX_LEN, ATT_READ_REQ) != SUCCESS)
+                || (len != switchLen) || (memcmp(value, switched, len) != 0))
+        {
+            printf("  attribute 0x%04X is read differently\n", uuids[a]);
+            errors++;
+        }
+    }
+
+    /* then time them */
+    start = HostRtos_usec();
+    for (r = 0; r < DISPATCH_READS; r++)
+        pfnTable(0, pAttrs[r % DISPATCH_ATTRS], value, &len, 0,
+                 DISPATCH_MAX_LEN, ATT_READ_REQ);
+    tableNs = (double) (HostRtos_usec() - start) * 1e3 / DISPATCH_READS;
+
+    start = HostRtos_usec();
+    for (r = 0; r < DISPATCH_READS; r++)
+        pfnSwitch(0, pAttrs[r % DISPATCH_ATTRS], switched, &switchLen, 0,
+                  DISPATCH_MAX_LEN, ATT_READ_REQ);
+    switchNs = (double) (HostRtos_usec() - start) * 1e3 / DISPATCH_READS;
+
+    printf("\ndispatch: %d reads: table %.1f ns, switch %.1f ns per read\n",
+           DISPATCH_READS, tableNs, switchNs);
+
+    return errors;
+}
+
+
+
+/*
+   SwitchReadAttrCB(uint16, gattAttribute_t *, uint8 *, uint16 *, uint16,
+                    uint16, uint8)
+
+   Description:      This function is the profile read callback as it was
+                     before the dispatch table: the value is found with a
+                     switch on the attribute's 16-bit UUID.  It is the
+                     baseline for BenchDispatch.
+   Operation:        The UUID is built from the attribute type and switched
+                     on, and the value copied.  The state (added after the
+                     table) has a case, and the value is cut to maxLen as
+                     the table's read handler does, so only the dispatch
+                     differs.
+
+   Arguments:        connHandle (uint16)       - unused.
+                     pAttr (gattAttribute_t *) - attribute to read.
+                     pValue (uint8 *)          - where to put the value.
+                     pLen (uint16 *)           - where to put its length.
+                     offset (uint16)           - offset of the read.
+                     maxLen (uint16)           - most bytes to read.
+                     method (uint8)            - unused.
+   Return Value:     (bStatus_t) - SUCCESS, ATT_ERR_ATTR_NOT_LONG for an
+                                   offset, ATT_ERR_INVALID_HANDLE for a
+                                   128-bit UUID or ATT_ERR_ATTR_NOT_FOUND.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Nothing is read on an error.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bStatus_t SwitchReadAttrCB(uint16 connHandle, gattAttribute_t *pAttr,
+                                  uint8 *pValue, uint16 *pLen, uint16 offset,
+                                  uint16 maxLen, uint8 method)
+{
+    /* variables */
+    uint16 uuid; /* UUID of attribute */
+    bStatus_t status = SUCCESS; /* return status, initially good */
+
+    (void) connHandle;
+    (void) method;
+
+    *pLen = 0;
+    if (offset != 0)
+        return ATT_ERR_ATTR_NOT_LONG;
+    if (pAttr->type.len != ATT_BT_UUID_SIZE)
+        return ATT_ERR_INVALID_HANDLE;
+
+    uuid = BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+    switch (uuid)
+    {
+    case BAREBOTPROFILE_SPEED_UUID:
+        *pLen = MIN(BAREBOTPROFILE_SPEED_LEN, maxLen);
+        memcpy(pValue, pAttr->pValue, *pLen);
+        break;
+    case BAREBOTPROFILE_TURN_UUID:
+        *pLen = MIN(BAREBOTPROFILE_TURN_LEN, maxLen);
+        memcpy(pValue, pAttr->pValue, *pLen);
+        break;
+    case BAREBOTPROFILE_THOUGHTS_UUID:
+        *pLen = MIN(BAREBOTPROFILE_THOUGHTS_LEN, maxLen);
+        memcpy(pValue, pAttr->pValue, *pLen);
+        break;
+    case BAREBOTPROFILE_STATE_UUID:
+        *pLen = MIN(BAREBOTPROFILE_STATE_LEN, maxLen);
+        memcpy(pValue, pAttr->pValue, *pLen);
+        break;
+    default:
+        status = ATT_ERR_ATTR_NOT_FOUND;
+        break;
+    }
+
+    return status;
+}
+
+
+
+/*
+   BenchAdvTrace(void)
+
+   Description:      This function measures the time per advertising report
+                     through the central's scanner callback and its
+                     pre-filter, and checks the filter forwards only the
+                     reports that may be from the server.
+   Operation:        A trace of ADV_TRACE_LEN reports is made (MakeAdvTrace)
+                     and given to the scanner callback ADV_TRACE_REPORTS
+                     times in turn, letting the central task handle what
+                     was forwarded after every ADV_TRACE_BATCH reports.
+                     The central's scan statistics are checked against the
+                     reports the trace should forward, and the central
+                     must still be ready (a forwarded server name doesn't
+                     start a connection when it isn't scanning) with no
+                     heap block lost.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The counts and the time per report are printed to
+                     stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int BenchAdvTrace(void)
+{
+    /* variables */
+    static advTraceRpt_t trace[ADV_TRACE_LEN]; /* the reports */
+    bcScanStats_t before; /* scan statistics before the run */
+    bcScanStats_t after; /* and after */
+    uint32_t heapBefore; /* heap blocks in use before the run */
+    uint32_t forward = 0; /* reports that should be forwarded */
+    uint32_t allowed = 0; /* of which from the allowed address */
+    uint64_t start; /* time the run started (us) */
+    double ns; /* time per report (ns) */
+    int errors = 0; /* number of errors */
+    long r; /* report index */
+
+    if (!MakeAdvTrace(trace))
+    {
+        printf("  no device advertises, nothing is allow listed\n");
+        return 1;
+    }
+
+    HostRtos_waitIdle();
+    heapBefore = BleStack_heapInUse();
+    BarebotCentral_getScanStats(&before);
+
+    start = HostRtos_usec();
+    for (r = 0; r < ADV_TRACE_REPORTS; r++)
+    {
+        BleStack_advReport(trace[r % ADV_TRACE_LEN].addr,
+                           trace[r % ADV_TRACE_LEN].data,
+                           trace[r % ADV_TRACE_LEN].len);
+        if ((r % ADV_TRACE_BATCH) == (ADV_TRACE_BATCH - 1))
+            HostRtos_waitIdle();
+    }
+    HostRtos_waitIdle();
+    ns = (double) (HostRtos_usec() - start) * 1e3 / ADV_TRACE_REPORTS;
+
+    BarebotCentral_getScanStats(&after);
+    for (r = 0; r < ADV_TRACE_REPORTS; r++)
+    {
+        forward += trace[r % ADV_TRACE_LEN].kind <= ADV_ALLOWED;
+        allowed += trace[r % ADV_TRACE_LEN].kind == ADV_ALLOWED;
+    }
+
+    printf("\nadvertising trace: %lu reports seen, %lu forwarded"
+           " (%lu allow listed): %.1f ns per report\n",
+           (unsigned long) (after.reportsSeen - before.reportsSeen),
+           (unsigned long) (after.reportsForwarded - before.reportsForwarded),
+           (unsigned long) (after.allowListHits - before.allowListHits), ns);
+
+    if ((after.reportsSeen - before.reportsSeen != ADV_TRACE_REPORTS)
+            || (after.reportsForwarded - before.reportsForwarded != forward)
+            || (after.allowListHits - before.allowListHits != allowed))
+    {
+        printf("  should be %d seen, %lu forwarded (%lu allow listed)\n",
+               ADV_TRACE_REPORTS, (unsigned long) forward,
+               (unsigned long) allowed);
+        errors++;
+    }
+    if (BarebotCentral_getState() != BC_STATE_READY)
+    {
+        printf("  the central went to state %u\n", BarebotCentral_getState());
+        errors++;
+    }
+    if (BleStack_heapInUse() != heapBefore)
+    {
+        printf("  %ld heap blocks lost\n",
+               (long) BleStack_heapInUse() - (long) heapBefore);
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+/*
+   MakeAdvTrace(advTraceRpt_t *)
+
+   Description:      This function makes the advertising reports of the
+                     trace for BenchAdvTrace, the ADV_TRACE_KINDS kinds in
+                     turn.
+   Operation:        Each report gets a made-up random address, except the
+                     ADV_ALLOWED ones which come from the advertising
+                     device (the server, on the central's allow list once
+                     it has connected).  The advertising data of each kind
+                     is built from AD structures (AddAdItem):
+                        ADV_SERVER        - the server name and service
+                        ADV_NAME_ONLY     - the server name, no services
+                        ADV_ALLOWED       - another name (allow listed)
+                        ADV_OTHER_SERVICE - the server name, another service
+                        ADV_OTHER_NAME    - another name
+                        ADV_NO_NAME       - no name
+                        ADV_TRUNCATED     - the server name, cut short
+                        ADV_BAD_LENGTH    - an AD length past the data
+                     The first three should be forwarded, the rest not.
+
+   Arguments:        trace (advTraceRpt_t *) - the ADV_TRACE_LEN reports.
+   Return Value:     (bool) - TRUE if the trace was made, FALSE if no device
+                              advertises.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       The random addresses are a multiplicative hash of the
+                     report index.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool MakeAdvTrace(advTraceRpt_t *trace)
+{
+    /* variables */
+    static const char serverName[] = ADV_SERVER_NAME_STR; /* names */
+    static const char otherName[] = ADV_OTHER_NAME_STR;
+    uint8 allowedAddr[B_ADDR_LEN]; /* the advertiser's address */
+    uint8 flags = GAP_ADTYPE_FLAGS_GENERAL
+            | GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED; /* flags AD data */
+    uint8 serverUUID[2] = { LO_UINT16(BAREBOTPROFILE_SERV_UUID),
+            HI_UINT16(BAREBOTPROFILE_SERV_UUID) }; /* service list */
+    uint8 otherUUID[2] = { LO_UINT16(ADV_OTHER_UUID),
+            HI_UINT16(ADV_OTHER_UUID) }; /* another service list */
+    uint8 power = 0; /* TX power AD data */
+    advTraceRpt_t *pRpt; /* report being made */
+    uint32_t hash; /* random address bits */
+    int n, i; /* report and address byte indices */
+
+    if (!BleStack_getAdvAddr(allowedAddr))
+        return false;
+
+    for (n = 0; n < ADV_TRACE_LEN; n++)
+    {
+        pRpt = &trace[n];
+        pRpt->kind = n % ADV_TRACE_KINDS;
+
+        /* a static random address (top two bits set) */
+        hash = (uint32_t) (n + 1) * 2654435761UL;
+        for (i = 0; i < B_ADDR_LEN; i++)
+            pRpt->addr[i] = (uint8) (hash >> (8 * (i % 4))) ^ (uint8) i;
+        pRpt->addr[B_ADDR_LEN - 1] |= 0xC0;
+        if (memcmp(pRpt->addr, allowedAddr, B_ADDR_LEN) == 0)
+            pRpt->addr[0] ^= 1;
+
+        pRpt->len = AddAdItem(pRpt->data, 0, GAP_ADTYPE_FLAGS, &flags, 1);
+        switch (pRpt->kind)
+        {
+        case ADV_SERVER:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_16BIT_COMPLETE, serverUUID, 2);
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, serverName,
+                                  sizeof(serverName) - 1);
+            break;
+        case ADV_NAME_ONLY:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, serverName,
+                                  sizeof(serverName) - 1);
+            break;
+        case ADV_ALLOWED:
+            memcpy(pRpt->addr, allowedAddr, B_ADDR_LEN);
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, otherName,
+                                  sizeof(otherName) - 1);
+            break;
+        case ADV_OTHER_SERVICE:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_16BIT_COMPLETE, otherUUID, 2);
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, serverName,
+                                  sizeof(serverName) - 1);
+            break;
+        case ADV_OTHER_NAME:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_SHORT, otherName,
+                                  sizeof(otherName) - 1);
+            break;
+        case ADV_NO_NAME:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_POWER_LEVEL, &power, 1);
+            break;
+        case ADV_TRUNCATED:
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, serverName,
+                                  sizeof(serverName) - 1) - 1;
+            break;
+        default:
+            /* ADV_BAD_LENGTH, a length that runs past the data */
+            pRpt->len = AddAdItem(pRpt->data, pRpt->len,
+                                  GAP_ADTYPE_LOCAL_NAME_COMPLETE, serverName,
+                                  sizeof(serverName) - 1);
+            pRpt->data[pRpt->len - sizeof(serverName)] = ADV_MAX_DATA;
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+
+/*
+   AddAdItem(uint8 *, uint16, uint8, const void *, uint8)
+
+   Description:      This function adds an AD structure to advertising data.
+   Operation:        The length (type and data), the type and the data are
+                     copied after the data already there.
+
+   Arguments:        pData (uint8 *)     - the advertising data.
+                     len (uint16)        - bytes of it already used.
+                     type (uint8)        - the AD type.
+                     pItem (const void *) - the AD data.
+                     itemLen (uint8)     - bytes of AD data.
+   Return Value:     (uint16) - bytes of advertising data used after it.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None, the caller keeps the data within ADV_MAX_DATA.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static uint16 AddAdItem(uint8 *pData, uint16 len, uint8 type,
+                        const void *pItem, uint8 itemLen)
+{
+    pData[len] = itemLen + 1;
+    pData[len + 1] = type;
+    memcpy(&pData[len + 2], pItem, itemLen);
+
+    return len + 2 + itemLen;
+}
+
+
+
+/*
+   StartCentral(void)
+
+   Description:      This function starts the central and waits for it to
+                     connect to the peripheral and find its
+                     characteristics.
+   Operation:        The UI done event is posted (there is no UI), the
+                     central task is started and WaitReady is called.
+
+   Arguments:        None.
+   Return Value:     (int) - 0 if the central is ready, 1 if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int StartCentral(void)
+{
+    uiInitDoneHandle = Event_construct(&uiInitDone, NULL);
+    Event_post(uiInitDoneHandle, Event_Id_00);
+
+    BarebotCentral_createTask();
+
+    return WaitReady();
+}
+
+
+
+/*
+   WaitReady(void)
+
+   Description:      This function waits up to READY_TIMEOUT_MS for the
+                     central to be ready, then for the radio to be quiet.
+   Operation:        The central state is checked every READY_POLL_MS.
+
+   Arguments:        None.
+   Return Value:     (int) - 0 if the central is ready, 1 if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The state is printed if it never becomes ready.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int WaitReady(void)
+{
+    /* variables */
+    uint32_t waited; /* time waited (ms) */
+
+    for (waited = 0; BarebotCentral_getState() != BC_STATE_READY;
+            waited += READY_POLL_MS)
+    {
+        if (waited >= READY_TIMEOUT_MS)
+        {
+            printf("  the central is in state %u, not ready\n",
+                   BarebotCentral_getState());
+            return 1;
+        }
+        HostRtos_sleep(READY_POLL_MS);
+    }
+    BleStack_waitQuiet();
+
+    return 0;
+}
+
+
+
+/*
+   CheckAccess(void)
+
+   Description:      This function checks a write and reads through the
+                     central: the speed is written and read back, and the
+                     thoughts are read (one response long).
+   Operation:        The write is checked in the profile, the reads against
+                     what was written and the profile.  The values read are
+                     freed and the heap checked.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckAccess(void)
+{
+    /* variables */
+    uint8 written[BAREBOTPROFILE_SPEED_LEN] = { SPEED_WRITTEN, 0 };
+    uint8 thoughts[BAREBOTPROFILE_THOUGHTS_LEN]; /* thoughts in the profile */
+    int16 speed = 0; /* speed in the profile */
+    bcReadRsp_t rsp; /* a read */
+    uint32_t heap = BleStack_heapInUse(); /* heap blocks at the start */
+    int errors = 0; /* number of errors */
+
+    printf("\ncentral: ready\n");
+
+    /* write the speed */
+    if (!BarebotCentral_write(BAREBOTPROFILE_SPEED, written))
+    {
+        printf("  speed write not sent\n");
+        errors++;
+    }
+    BleStack_waitQuiet();
+    BarebotProfile_GetParameter(BAREBOTPROFILE_SPEED, &speed);
+    printf("central: wrote speed %d, peripheral has %d\n", SPEED_WRITTEN,
+           speed);
+    if (speed != SPEED_WRITTEN)
+        errors++;
+
+    /* read it back */
+    rsp = BarebotCentral_read(BAREBOTPROFILE_SPEED);
+    if ((rsp.len != BAREBOTPROFILE_SPEED_LEN)
+            || (memcmp(rsp.pValue, written, rsp.len) != 0))
+    {
+        printf("  speed read back %u bytes, not the value written\n",
+               rsp.len);
+        errors++;
+    }
+    ICall_free(rsp.pValue);
+
+    /* the thoughts are longer than a read response */
+    BarebotProfile_GetParameter(BAREBOTPROFILE_THOUGHTS, thoughts);
+    rsp = BarebotCentral_read(BAREBOTPROFILE_THOUGHTS);
+    printf("central: read %u bytes of thoughts\n", rsp.len);
+    if ((rsp.len != THOUGHTS_READ_LEN)
+            || (memcmp(rsp.pValue, thoughts, rsp.len) != 0))
+    {
+        printf("  thoughts read are not the first %d bytes\n",
+               THOUGHTS_READ_LEN);
+        errors++;
+    }
+    ICall_free(rsp.pValue);
+
+    BleStack_waitQuiet();
+    if (BleStack_heapInUse() != heap)
+    {
+        printf("  %ld heap blocks lost\n",
+               (long) BleStack_heapInUse() - (long) heap);
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+/*
+   CheckRefusedWrite(void)
+
+   Description:      This function checks a write the server refuses only
+                     fails that write: the central counts it, drops the
+                     value from its cache and keeps the link.
+   Operation:        The speed is made read-only on the peripheral, the
+                     central writes SPEED_REFUSED, and the speed is made
+                     writable again.  The central must still be ready, the
+                     peripheral must still have SPEED_WRITTEN, and a read
+                     through the central must get it too.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckRefusedWrite(void)
+{
+    /* variables */
+    uint8 refused[BAREBOTPROFILE_SPEED_LEN] = { SPEED_REFUSED, 0 };
+    CONST gattServiceCBs_t *pCBs; /* the profile's callbacks */
+    gattAttribute_t *pSpeed; /* the speed attribute */
+    uint32_t writeErrors = BarebotCentral_getWriteErrors(); /* at start */
+    int16 speed = 0; /* speed in the profile */
+    bcReadRsp_t rsp; /* the speed read back */
+    int errors = 0; /* number of errors */
+
+    pSpeed = BleStack_findAttr(BAREBOTPROFILE_SPEED_UUID, &pCBs);
+    if (pSpeed == NULL)
+    {
+        printf("  the profile attributes are not registered\n");
+        return 1;
+    }
+
+    /* the peripheral refuses the write */
+    pSpeed->permissions &= ~GATT_PERMIT_WRITE;
+    if (!BarebotCentral_write(BAREBOTPROFILE_SPEED, refused))
+    {
+        printf("  speed write not sent\n");
+        errors++;
+    }
+    BleStack_waitQuiet();
+    pSpeed->permissions |= GATT_PERMIT_WRITE;
+
+    BarebotProfile_GetParameter(BAREBOTPROFILE_SPEED, &speed);
+    rsp = BarebotCentral_read(BAREBOTPROFILE_SPEED);
+    printf("central: speed %d refused, %lu write errors, peripheral has %d\n",
+           SPEED_REFUSED,
+           (unsigned long) (BarebotCentral_getWriteErrors() - writeErrors),
+           speed);
+
+    if (BarebotCentral_getWriteErrors() - writeErrors != 1)
+        errors++;
+    if (BarebotCentral_getState() != BC_STATE_READY)
+    {
+        printf("  the central went to state %u\n", BarebotCentral_getState());
+        errors++;
+    }
+    if ((speed != SPEED_WRITTEN) || (rsp.len != BAREBOTPROFILE_SPEED_LEN)
+            || ((int16) BUILD_UINT16(rsp.pValue[0], rsp.pValue[1])
+                    != SPEED_WRITTEN))
+    {
+        printf("  the speed read is not the one written before\n");
+        errors++;
+    }
+    ICall_free(rsp.pValue);
+    BleStack_waitQuiet();
+
+    return errors;
+}
+
+
+
+/*
+   BenchCommands(void)
+
+   Description:      This function measures the update commands per second
+                     streamed from the central to the peripheral.
+   Operation:        NUM_COMMANDS commands are sent as write commands,
+                     alternating speed +1 and turn -1, each once the link
+                     has room for it.  Then the peripheral's command counts,
+                     its speed and turn, and the speed and turn the central
+                     got in the state notifications are checked, as are the
+                     state notifications missed and the heap.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The rate and counts are printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int BenchCommands(void)
+{
+    /* variables */
+    uint32 received; /* commands the peripheral received */
+    uint32 missed; /* and missed */
+    uint32 received0; /* counts before the run */
+    uint32 missed0;
+    int16 speed = 0; /* speed and turn in the profile */
+    int16 turn = 0;
+    int16 speed0; /* and before the run */
+    int16 turn0 = 0;
+    uint32_t notSent = 0; /* commands not sent */
+    uint32_t heap; /* heap blocks at the start */
+    uint64_t start; /* time the run started (us) */
+    double rate; /* commands per second */
+    int errors = 0; /* number of errors */
+    int i; /* command index */
+
+    BarebotProfile_GetCmdStats(&received0, &missed0);
+    BarebotProfile_GetParameter(BAREBOTPROFILE_SPEED, &speed);
+    BarebotProfile_GetParameter(BAREBOTPROFILE_TURN, &turn0);
+    speed0 = speed;
+    heap = BleStack_heapInUse();
+
+    BarebotCentral_setStreaming(TRUE);
+    start = HostRtos_usec();
+    for (i = 0; i < NUM_COMMANDS; i++)
+    {
+        BleStack_waitTxFree();
+        if (!BarebotCentral_sendCommand((i & 1) ? BAREBOTPROFILE_TURNUPDATE :
+                                        BAREBOTPROFILE_SPEEDUPDATE,
+                                        (i & 1) ? -1 : 1))
+            notSent++;
+    }
+    BleStack_waitQuiet();
+    rate = (double) NUM_COMMANDS * 1e6 / (double) (HostRtos_usec() - start);
+    BarebotCentral_setStreaming(FALSE);
+
+    BarebotProfile_GetCmdStats(&received, &missed);
+    BarebotProfile_GetParameter(BAREBOTPROFILE_SPEED, &speed);
+    BarebotProfile_GetParameter(BAREBOTPROFILE_TURN, &turn);
+
+    printf("\ncommands: %d streamed: %.0f cmds/s\n", NUM_COMMANDS, rate);
+    printf("commands: %lu received, %lu missed, %lu not sent, %lu state"
+           " notifications missed\n", (unsigned long) (received - received0),
+           (unsigned long) (missed - missed0), (unsigned long) notSent,
+           (unsigned long) BarebotCentral_getMissedStates());
+    printf("commands: speed %d turn %d, the central shows %d and %d\n",
+           speed, turn, uiSpeed, uiTurn);
+
+    if ((received - received0 != NUM_COMMANDS) || (missed != missed0)
+            || (notSent != 0))
+    {
+        printf("  commands were lost\n");
+        errors++;
+    }
+    if ((speed != speed0 + NUM_COMMANDS / 2)
+            || (turn != turn0 - NUM_COMMANDS / 2))
+    {
+        printf("  speed and turn should be %d and %d\n",
+               speed0 + NUM_COMMANDS / 2, turn0 - NUM_COMMANDS / 2);
+        errors++;
+    }
+    if ((uiSpeed != speed) || (uiTurn != turn)
+            || (BarebotCentral_getMissedStates() != 0))
+    {
+        printf("  the central missed state notifications\n");
+        errors++;
+    }
+    if (BleStack_heapInUse() != heap)
+    {
+        printf("  %ld heap blocks lost\n",
+               (long) BleStack_heapInUse() - (long) heap);
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+/*
+   CheckReconnect(void)
+
+   Description:      This function checks the central reconnects after the
+                     link is lost, using the characteristic handles it
+                     saved instead of discovering them again.
+   Operation:        The link is dropped, the central is let handle it and
+                     WaitReady is called.  The discoveries are counted.
+
+   Arguments:        None.
+   Return Value:     (int) - number of failed checks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckReconnect(void)
+{
+    /* variables */
+    bleStackStats_t before; /* radio counts before */
+    bleStackStats_t after; /* and after */
+    int errors = 0; /* number of errors */
+
+    BleStack_getStats(&before);
+    if (!BleStack_dropLinks())
+    {
+        printf("  there was no link to drop\n");
+        return 1;
+    }
+    HostRtos_waitIdle();
+    if (WaitReady() != 0)
+        return 1;
+    BleStack_getStats(&after);
+
+    printf("\nreconnect: ready again, %lu links, %lu discoveries\n",
+           (unsigned long) (after.links - before.links),
+           (unsigned long) (after.discoveries - before.discoveries));
+    if ((after.links - before.links != 1)
+            || (after.discoveries != before.discoveries))
+    {
+        printf("  should reconnect once with the saved handles\n");
+        errors++;
+    }
+
+    return errors;
+}
+
+
+
+/*
+   BarebotUI_centralStateChanged(uint8)
+   BarebotUI_speedChanged(int16)
+   BarebotUI_turnChanged(int16)
+   ButtonInit_RTOS(void)
+
+   Description:      These functions stand in for the UI and the button
+                     code, which aren't part of the harness.  The speed and
+                     turn are kept for BenchCommands.
+   Operation:        The speed or turn is saved, or nothing is done.
+
+   Arguments:        newState (uint8) - unused.
+                     newSpeed (int16) - the speed.
+                     newTurn (int16)  - the turn.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void BarebotUI_centralStateChanged(uint8 newState)
+{
+    (void) newState;
+}
+
+void BarebotUI_speedChanged(int16 newSpeed)
+{
+    uiSpeed = newSpeed;
+}
+
+void BarebotUI_turnChanged(int16 newTurn)
+{
+    uiTurn = newTurn;
+}
+
+void ButtonInit_RTOS()
+{
+}
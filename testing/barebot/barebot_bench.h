@@ -0,0 +1,71 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              barebot_bench.h                             */
+/*                     Barebot Host Harness Declarations                    */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the constants and declarations shared by the parts of
+   the host-side barebot harness: the kernel stand-ins on threads
+   (host_rtos.c), the ICall and BLE stack model with its loopback radio
+   (ble_stack.c) and the benchmark (barebot_bench.c).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef BAREBOT_BENCH_H
+    #define BAREBOT_BENCH_H
+
+#include  <xdc/std.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <pthread.h>
+#include  <icall_ble_api.h>
+
+/* constants */
+
+/* most tasks and threads of the harness */
+#define HOST_MAX_TASKS          4
+
+/* structures */
+
+/* loopback radio counts */
+typedef struct {
+    uint32_t connEvents;                /* connection events with packets */
+    uint32_t toServer;                  /* packets central to peripheral */
+    uint32_t toClient;                  /* packets peripheral to central */
+    uint32_t txFull;                    /* packets refused, no TX buffer */
+    uint32_t advReports;                /* advertising reports delivered */
+    uint32_t links;                     /* links established */
+    uint32_t discoveries;               /* characteristic discoveries */
+    uint32_t paramUpdates;              /* link parameter updates */
+} bleStackStats_t;
+
+/* functions */
+
+/* host_rtos.c - kernel stand-ins, one thread runs at a time */
+void     HostRtos_start(void);
+void     HostRtos_thread(void *(*fxn)(void *));
+void     HostRtos_enter(void);
+void     HostRtos_leave(void);
+void     HostRtos_wait(pthread_cond_t *pCond);
+void     HostRtos_waitIdle(void);
+void     HostRtos_sleep(uint32_t ms);
+uint64_t HostRtos_usec(void);
+
+/* ble_stack.c - ICall and the BLE stack with a loopback radio */
+void     BleStack_start(void);
+void     BleStack_waitQuiet(void);
+void     BleStack_waitTxFree(void);
+bool     BleStack_dropLinks(void);
+uint32_t BleStack_heapInUse(void);
+void     BleStack_getStats(bleStackStats_t *pStats);
+gattAttribute_t *BleStack_findAttr(uint16 uuid,
+                                   CONST gattServiceCBs_t **ppCBs);
+bool     BleStack_advReport(const uint8 *addr, const uint8 *pData,
+                            uint16 dataLen);
+bool     BleStack_getAdvAddr(uint8 *addr);
+
+#endif
@@ -0,0 +1,60 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               ble_config.c                               */
+/*                    Host Stand-In for the SysConfig BLE Setup             */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the BLE data SysConfig generates from
+   barebot_server.syscfg (device name, random address, advertising
+   parameters and data), declared in ti_ble_config.h.  There are no
+   functions.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  "ti_ble_config.h"
+
+/* shared/global variables */
+
+/* device name and random address (aa:aa:aa:aa:aa:aa) */
+uint8_t attDeviceName[GAP_DEVICE_NAME_LEN] = "Barebot Server";
+uint8_t pRandomAddress[B_ADDR_LEN] = { 0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA };
+
+/* advertising set 1 - legacy connectable and scannable, 100 ms */
+GapAdv_params_t advParams1 = {
+    GAP_ADV_PROP_CONNECTABLE | GAP_ADV_PROP_SCANNABLE | GAP_ADV_PROP_LEGACY,
+    160, 160, INIT_PHY_1M, INIT_PHY_1M, 0
+};
+
+/* flags, short name "BP" and the barebot service UUID (more available) */
+uint8_t advData1[11] = {
+    0x02, GAP_ADTYPE_FLAGS,
+          GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED | GAP_ADTYPE_FLAGS_GENERAL,
+    0x03, GAP_ADTYPE_LOCAL_NAME_SHORT, 'B', 'P',
+    0x03, GAP_ADTYPE_16BIT_MORE, LO_UINT16(0xFFF0), HI_UINT16(0xFFF0)
+};
+
+/* complete name, connection interval range (100 to 130 ms) and TX power */
+uint8_t scanResData1[25] = {
+    0x0F, GAP_ADTYPE_LOCAL_NAME_COMPLETE,
+          'B', 'a', 'r', 'e', 'b', 'o', 't', ' ', 'S', 'e', 'r', 'v', 'e', 'r',
+    0x05, GAP_ADTYPE_PERIPHERAL_CONN_INTERVAL_RANGE,
+          LO_UINT16(80), HI_UINT16(80), LO_UINT16(104), HI_UINT16(104),
+    0x02, GAP_ADTYPE_POWER_LEVEL, 0
+};
+
+/* advertising set 2 - extended connectable on the coded PHY, 100 ms */
+GapAdv_params_t advParams2 = {
+    GAP_ADV_PROP_CONNECTABLE, 160, 160, INIT_PHY_CODED, INIT_PHY_CODED, 1
+};
+
+/* same data as set 1 */
+uint8_t advData2[11] = {
+    0x02, GAP_ADTYPE_FLAGS,
+          GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED | GAP_ADTYPE_FLAGS_GENERAL,
+    0x03, GAP_ADTYPE_LOCAL_NAME_SHORT, 'B', 'P',
+    0x03, GAP_ADTYPE_16BIT_MORE, LO_UINT16(0xFFF0), HI_UINT16(0xFFF0)
+};
@@ -0,0 +1,3582 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                ble_stack.c                               */
+/*                     ICall and BLE Stack With a Loopback Radio            */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the ICall, BLE stack, OSAL, SNV and Device Information
+   functions declared in testing/shim, for the host-side barebot harness.
+   Each task that registers with ICall is a device with its own stack
+   message queue, attribute database, advertising sets, scanner and
+   initiator.  The devices are linked by a loopback "radio" thread that
+   runs when every task is waiting: in each round it delivers advertising
+   events, advertising reports, new links and link parameter updates, then
+   moves up to RADIO_PKTS_PER_EVENT packets each way on every link (one
+   connection event).  The radio is not timed, a round is as long as the
+   tasks take to handle the last one.
+   The ATT server answers requests from the attribute tables registered
+   with GATTServApp_RegisterService, reading the declarations, user
+   descriptions, client configurations, device name and database hash
+   itself and calling the service callbacks for everything else, as the
+   stack does.  A link queues RADIO_TX_SIZE packets each way, of which the
+   application may fill RADIO_TX_APP_LIMIT (responses may use the rest).
+   Every block from ICall_malloc, ICall_allocMsg and GATT_bm_alloc is
+   counted so the harness can check none are lost.  Not modeled: timing,
+   security, indications, long writes (the harness can write the pieces
+   of one to a service callback found with BleStack_findAttr), MTU
+   exchange, scan responses and scanning or connection timeouts.  Besides
+   the reports of the devices, the harness can give the scanner made-up
+   ones (BleStack_advReport).
+   Functions included are:
+        BleStack_start                  - start the loopback radio
+        BleStack_waitQuiet              - wait until the radio has no work
+        BleStack_waitTxFree             - wait until a link can take a packet
+        BleStack_dropLinks              - drop every link (as if lost)
+        BleStack_heapInUse              - get the heap blocks allocated
+        BleStack_getStats               - get the radio counts
+        BleStack_findAttr               - find a service attribute by type
+        BleStack_advReport              - give the scanner a made-up report
+        BleStack_getAdvAddr             - get the address of the advertiser
+        ICall_registerApp               - register a task as a device
+        ICall_fetchServiceMsg           - get the next stack message
+        ICall_malloc                    - allocate a heap block
+        ICall_free                      - free a heap block
+        ICall_allocMsg                  - allocate a stack message
+        ICall_freeMsg                   - free a stack message
+        GAP_DeviceInit                  - set up a device's GAP role
+        GAP_RegisterForMsgs             - register for GAP messages
+        GAP_SetParamValue               - set a GAP parameter
+        GAP_UpdateLinkParamReq          - request new link parameters
+        GGS_SetParameter                - set the device name
+        GGS_AddService                  - add the GAP service
+        GapAdv_create                   - create an advertising set
+        GapAdv_loadByHandle             - load advertising data
+        GapAdv_setEventMask             - set the advertising events wanted
+        GapAdv_enable                   - start advertising
+        GapAdv_disable                  - stop advertising
+        GapScan_registerCb              - register the scanner callback
+        GapScan_setEventMask            - set the scanner events wanted
+        GapScan_setPhyParams            - set the scanning parameters
+        GapScan_setParam                - set a scanner parameter
+        GapScan_enable                  - start scanning
+        GapScan_disable                 - stop scanning
+        GapInit_setPhyParam             - set an initiator parameter
+        GapInit_connect                 - connect to an advertiser
+        GATT_InitClient                 - set up the GATT client
+        GATT_RegisterForInd             - register for notifications
+        GATT_RegisterForMsgs            - register for GATT messages
+        GATT_bm_alloc                   - allocate an ATT payload
+        GATT_bm_free                    - free an ATT payload
+        GATT_ReadUsingCharUUID          - read a value by its type
+        GATT_DiscAllChars               - discover characteristics
+        GATT_ReadCharValue              - read a value
+        GATT_WriteCharValue             - write a value
+        GATT_WriteNoRsp                 - write a value without a response
+        GATT_Notification               - notify a value
+        GATTServApp_AddService          - add the GATT service
+        GATTServApp_RegisterService     - register an attribute table
+        GATTServApp_InitCharCfg         - reset a client configuration table
+        GATTServApp_ReadCharCfg         - read a client configuration
+        GATTServApp_WriteCharCfg        - write a client configuration
+        GATTServApp_ProcessCharCfg      - notify a value to the clients
+        GATTServApp_ProcessCCCWriteReq  - write a client configuration
+        HCI_LE_WriteSuggestedDefaultDataLenCmd - set the data length
+        DevInfo_AddService              - add the Device Information service
+        DevInfo_SetParameter            - set a Device Information value
+        osal_memcmp                     - compare memory
+        osal_snv_read                   - read an SNV item
+        osal_snv_write                  - write an SNV item
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <pthread.h>
+#include  <icall.h>
+#include  <icall_ble_api.h>
+#include  <devinfoservice.h>
+#include  <osal.h>
+#include  <osal_snv.h>
+
+/* local includes */
+#include "barebot_bench.h"
+#include "ti_ble_config.h"
+
+/* constants */
+
+/* sizes of the model */
+#define MAX_DEVICES             2       /* tasks registered with ICall */
+#define MAX_LINKS               4       /* links at once */
+#define MAX_ADV_SETS            4       /* advertising sets per device */
+#define MAX_ATTRS               48      /* attributes per device */
+#define MAX_CCC_TABLES          8       /* client configuration tables */
+
+/* radio */
+#define RADIO_PKTS_PER_EVENT    4       /* packets each way per round */
+#define RADIO_TX_SIZE           16      /* packets queued each way */
+#define RADIO_TX_APP_LIMIT      8       /* of which the application may fill */
+
+/* ATT payloads */
+#define ATT_MAX_VALUE           (ATT_MTU_SIZE - 1)  /* read response value */
+#define ATT_MAX_NOTI_VALUE      (ATT_MTU_SIZE - 3)  /* notification value */
+#define DISC_PAIR_LEN           7       /* declaration, props, handle, UUID */
+#define DISC_MAX_PAIRS          3       /* pairs per discovery response */
+
+/* handles after the services the stack adds */
+#define GAP_SERVICE_END         0x0008
+#define GATT_SERVICE_END        0x0010
+#define DEVINFO_SERVICE_SIZE    0x0013
+
+/* GAP service UUIDs */
+#define GAP_SERVICE_UUID        0x1800
+#define GATT_SERVICE_UUID       0x1801
+#define DEVICE_NAME_UUID        0x2A00
+
+/* link timing given to new links */
+#define LINK_TIMEOUT            200     /* supervision timeout (10 ms units) */
+#define TERMINATE_REASON        0x08    /* connection timeout */
+
+/* SNV items */
+#define SNV_NUM_ITEMS           (BLE_NVID_CUST_END - BLE_NVID_CUST_START + 1)
+#define SNV_MAX_LEN             64
+
+/* data length given to the application */
+#define DATA_PKT_LEN            27
+#define NUM_DATA_PKTS           8
+
+/* structures */
+
+/* header in front of every stack message */
+typedef union bleMsgHdr {
+    union bleMsgHdr *pNext;             /* next message for the device */
+    long double align;                  /* keeps the message aligned */
+} bleMsgHdr_t;
+
+/* attribute in a device's database */
+typedef struct {
+    gattAttribute_t *pAttr;             /* the attribute */
+    CONST gattServiceCBs_t *pCBs;       /* its service's callbacks (or NULL) */
+} bleAttr_t;
+
+/* advertising set */
+typedef struct {
+    bool        used;                   /* whether it was created */
+    pfnGapCB_t  cb;                     /* callback for its events */
+    GapAdv_params_t *pParams;           /* its parameters */
+    uint8      *pData;                  /* advertising data */
+    uint16      dataLen;
+    uint32_t    mask;                   /* events wanted */
+    bool        enabled;                /* whether it is advertising */
+    uint32_t    pending;                /* events to deliver */
+    uint16      termConn;               /* link that terminated it */
+} bleAdvSet_t;
+
+/* device (a task registered with ICall) */
+typedef struct {
+    bool        used;                   /* whether it is registered */
+    pthread_t   thread;                 /* its task */
+    Event_Struct event;                 /* its sync event */
+    bleMsgHdr_t *pHead;                 /* stack messages for it */
+    bleMsgHdr_t *pTail;
+    bool        initDone;               /* whether GAP_DeviceInit was called */
+    uint8       addrType;               /* its address */
+    uint8       addr[B_ADDR_LEN];
+    uint8      *pName;                  /* its name (GAP service) */
+    bleAttr_t   attrs[MAX_ATTRS];       /* its database, by handle */
+    uint16      numAttrs;
+    uint16      nextHandle;             /* handle of the next attribute */
+    uint8       dbHash[ATT_UUID_SIZE];  /* its database hash */
+    gattAttribute_t gapAttrs[3];        /* GAP service attributes */
+    gattAttribute_t gattAttrs[3];       /* GATT service attributes */
+    bleAdvSet_t adv[MAX_ADV_SETS];      /* its advertising sets */
+    pfnGapCB_t  scanCb;                 /* scanner callback and argument */
+    uintptr_t   scanArg;
+    uint32_t    scanMask;               /* scanner events wanted */
+    bool        scanning;               /* whether it is scanning */
+    uint32_t    reported;               /* sets reported since enabled */
+    bool        connecting;             /* whether it is initiating */
+    uint8       connAddr[B_ADDR_LEN];   /* advertiser it is connecting to */
+    uint16      connInt;                /* interval for new links */
+} bleDevice_t;
+
+/* packet on a link */
+typedef struct {
+    uint8       method;                 /* ATT method (opcode) */
+    gattMsg_t   msg;                    /* the PDU */
+} blePacket_t;
+
+/* packets queued one way on a link */
+typedef struct {
+    blePacket_t pkts[RADIO_TX_SIZE];    /* circular buffer */
+    uint8       head;                   /* oldest packet */
+    uint8       count;                  /* packets queued */
+} bleRing_t;
+
+/* link */
+typedef struct {
+    bool        used;                   /* whether it is up */
+    uint16      connHandle;             /* its handle (both ends) */
+    bleDevice_t *pCentral;              /* the client */
+    bleDevice_t *pPeripheral;           /* the server */
+    bleRing_t   toServer;               /* requests and commands */
+    bleRing_t   toClient;               /* responses and notifications */
+    bool        reqOutstanding;         /* whether a request awaits a response */
+    bool        discActive;             /* whether characteristics are being */
+    uint16      discEnd;                /*    discovered, and to where */
+    bool        updatePending;          /* whether a parameter update waits */
+    gapUpdateLinkParamReq_t update;     /* the update */
+} bleLink_t;
+
+/* SNV item */
+typedef struct {
+    bool        valid;                  /* whether it was written */
+    uint8       len;                    /* its length */
+    uint8       data[SNV_MAX_LEN];      /* its value */
+} bleSnvItem_t;
+
+/* shared/global variables */
+
+/* GATT UUIDs */
+CONST uint8 primaryServiceUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_PRIM_SERVICE_UUID), HI_UINT16(GATT_PRIM_SERVICE_UUID) };
+CONST uint8 characterUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_CHARACTER_UUID), HI_UINT16(GATT_CHARACTER_UUID) };
+CONST uint8 charUserDescUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_CHAR_USER_DESC_UUID), HI_UINT16(GATT_CHAR_USER_DESC_UUID) };
+CONST uint8 clientCharCfgUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_CLIENT_CHAR_CFG_UUID), HI_UINT16(GATT_CLIENT_CHAR_CFG_UUID) };
+
+static CONST uint8 gapServiceUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GAP_SERVICE_UUID), HI_UINT16(GAP_SERVICE_UUID) };
+static CONST uint8 gattServiceUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_SERVICE_UUID), HI_UINT16(GATT_SERVICE_UUID) };
+static CONST uint8 deviceNameUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(DEVICE_NAME_UUID), HI_UINT16(DEVICE_NAME_UUID) };
+static CONST uint8 dbHashUUID[ATT_BT_UUID_SIZE] = {
+    LO_UINT16(GATT_DB_HASH_UUID), HI_UINT16(GATT_DB_HASH_UUID) };
+
+/* values of the GAP and GATT service attributes */
+static gattAttrType_t gapService = { ATT_BT_UUID_SIZE, gapServiceUUID };
+static gattAttrType_t gattService = { ATT_BT_UUID_SIZE, gattServiceUUID };
+static uint8 readProps = GATT_PROP_READ;
+
+/* devices, links and client configuration tables */
+static bleDevice_t devices[MAX_DEVICES];
+static bleLink_t links[MAX_LINKS];
+static uint16 nextConnHandle = 0;
+static gattCharCfg_t *cccTables[MAX_CCC_TABLES];
+static int numCccTables = 0;
+
+/* radio thread, and the device whose callback it is running */
+static pthread_t radioThread;
+static bool radioStarted = false;
+static bleDevice_t *pRadioDev = NULL;
+
+/* radio work (signalled when there is some), quiet (signalled when */
+/*    there is none) and transmit space (signalled after every round) */
+static pthread_cond_t workCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t quietCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t txCond = PTHREAD_COND_INITIALIZER;
+static bool stackWork = false;
+static bool quiet = false;
+
+/* counts, heap blocks in use and SNV */
+static bleStackStats_t stats;
+static uint32_t heapInUse = 0;
+static bleSnvItem_t snv[SNV_NUM_ITEMS];
+
+
+
+/* functions */
+
+/*
+   fatal(const char *)
+
+   Description:      This function reports a use of the stack the model
+                     can't handle and exits.
+   Operation:        The message is printed and the harness exits.
+
+   Arguments:        msg (const char *) - what went wrong.
+   Return Value:     None, never returns.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The message is printed to stderr.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void fatal(const char *msg)
+{
+    fprintf(stderr, "ble_stack: %s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+
+
+/*
+   needRadio(void)
+
+   Description:      This function lets the radio know it has work.
+   Operation:        The work flag is set and the radio is woken.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void needRadio(void)
+{
+    stackWork = true;
+    quiet = false;
+    pthread_cond_signal(&workCond);
+}
+
+
+
+/*
+   curDevice(void)
+
+   Description:      This function returns the device calling the stack:
+                     the device of the calling task, or the device whose
+                     callback the radio is running.
+   Operation:        The device table is searched for the calling thread.
+
+   Arguments:        None.
+   Return Value:     (bleDevice_t *) - the device.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if the caller is not a device.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bleDevice_t *curDevice(void)
+{
+    /* variables */
+    int i; /* device index */
+
+    for (i = 0; i < MAX_DEVICES; i++)
+        if (devices[i].used && pthread_equal(devices[i].thread, pthread_self()))
+            return &devices[i];
+
+    if (radioStarted && pthread_equal(radioThread, pthread_self())
+            && (pRadioDev != NULL))
+        return pRadioDev;
+
+    fatal("stack called by a thread that is not a device");
+    return NULL;
+}
+
+
+
+/*
+   findLink(uint16)
+
+   Description:      This function returns the link with a handle.
+   Operation:        The link table is searched.
+
+   Arguments:        connHandle (uint16) - the link handle.
+   Return Value:     (bleLink_t *) - the link, NULL if it isn't up.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bleLink_t *findLink(uint16 connHandle)
+{
+    /* variables */
+    int i; /* link index */
+
+    for (i = 0; i < MAX_LINKS; i++)
+        if (links[i].used && (links[i].connHandle == connHandle))
+            return &links[i];
+
+    return NULL;
+}
+
+
+
+/*
+   sendMsg(bleDevice_t *, void *)
+
+   Description:      This function sends a stack message to a device.
+   Operation:        The message is added to the device's message list and
+                     ICALL_MSG_EVENT_ID is posted to its sync event.
+
+   Arguments:        pDev (bleDevice_t *) - the device.
+                     pMsg (void *)        - the message (from ICall_allocMsg).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of messages.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void sendMsg(bleDevice_t *pDev, void *pMsg)
+{
+    /* variables */
+    bleMsgHdr_t *pHdr = (bleMsgHdr_t *) pMsg - 1; /* its header */
+
+    pHdr->pNext = NULL;
+    if (pDev->pTail == NULL)
+        pDev->pHead = pHdr;
+    else
+        pDev->pTail->pNext = pHdr;
+    pDev->pTail = pHdr;
+
+    Event_post(Event_handle(&pDev->event), ICALL_MSG_EVENT_ID);
+}
+
+
+
+/*
+   allocGapMsg(uint16, uint8)
+
+   Description:      This function allocates a GAP message.
+   Operation:        A message is allocated and cleared, and its header and
+                     opcode are filled in (status SUCCESS).
+
+   Arguments:        size (uint16)  - size of the message.
+                     opcode (uint8) - GAP event opcode.
+   Return Value:     (void *) - the message.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there is no memory.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void *allocGapMsg(uint16 size, uint8 opcode)
+{
+    /* variables */
+    gapEventHdr_t *pMsg; /* the message */
+
+    pMsg = ICall_allocMsg(size);
+    if (pMsg == NULL)
+        fatal("out of memory");
+    memset(pMsg, 0, size);
+    pMsg->hdr.event = GAP_MSG_EVENT;
+    pMsg->hdr.status = SUCCESS;
+    pMsg->opcode = opcode;
+
+    return pMsg;
+}
+
+
+
+/*
+   attrUUID(gattAttribute_t *)
+
+   Description:      This function returns the 16-bit type of an attribute.
+   Operation:        The UUID is built from its two bytes.
+
+   Arguments:        pAttr (gattAttribute_t *) - the attribute.
+   Return Value:     (uint16) - its type, 0 for a 128-bit type.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static uint16 attrUUID(gattAttribute_t *pAttr)
+{
+    if (pAttr->type.len != ATT_BT_UUID_SIZE)
+        return 0;
+
+    return BUILD_UINT16(pAttr->type.uuid[0], pAttr->type.uuid[1]);
+}
+
+
+
+/*
+   findAttr(bleDevice_t *, uint16)
+
+   Description:      This function returns the index of the attribute with
+                     a handle in a device's database.
+   Operation:        The database is searched.
+
+   Arguments:        pDev (bleDevice_t *) - the device.
+                     handle (uint16)      - the handle.
+   Return Value:     (int) - the index, -1 if there is no such attribute.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int findAttr(bleDevice_t *pDev, uint16 handle)
+{
+    /* variables */
+    int i; /* attribute index */
+
+    for (i = 0; i < pDev->numAttrs; i++)
+        if (pDev->attrs[i].pAttr->handle == handle)
+            return i;
+
+    return -1;
+}
+
+
+
+/*
+   addAttrs(bleDevice_t *, gattAttribute_t *, uint16, const
+            gattServiceCBs_t *)
+
+   Description:      This function adds attributes to a device's database.
+   Operation:        Each attribute is given the next handle and added.
+
+   Arguments:        pDev (bleDevice_t *)     - the device.
+                     pAttrs (gattAttribute_t *) - the attributes.
+                     numAttrs (uint16)        - number of attributes.
+                     pCBs (const gattServiceCBs_t *) - their callbacks (NULL
+                                                for the stack's services).
+   Return Value:     (bStatus_t) - SUCCESS, or bleNoResources if the
+                                   database is full.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Nothing is added if the database is full.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bStatus_t addAttrs(bleDevice_t *pDev, gattAttribute_t *pAttrs,
+                          uint16 numAttrs, CONST gattServiceCBs_t *pCBs)
+{
+    /* variables */
+    uint16 i; /* attribute index */
+
+    if (pDev->numAttrs + numAttrs > MAX_ATTRS)
+        return bleNoResources;
+
+    for (i = 0; i < numAttrs; i++)
+    {
+        pAttrs[i].handle = pDev->nextHandle++;
+        pDev->attrs[pDev->numAttrs].pAttr = &pAttrs[i];
+        pDev->attrs[pDev->numAttrs].pCBs = pCBs;
+        pDev->numAttrs++;
+    }
+
+    return SUCCESS;
+}
+
+
+
+/*
+   readAttr(bleDevice_t *, int, uint16, uint8 *, uint16 *, uint16, uint8)
+
+   Description:      This function reads an attribute of a device's
+                     database, as the stack does: it reads the service and
+                     characteristic declarations, user descriptions, client
+                     configurations, device name and database hash itself,
+                     and calls the service callback for other attributes.
+   Operation:        The attribute type selects how it is read.  Values are
+                     cut to the length passed.
+
+   Arguments:        pDev (bleDevice_t *) - the device.
+                     index (int)          - index of the attribute.
+                     connHandle (uint16)  - link it is read on.
+                     pValue (uint8 *)     - where to put the value.
+                     pLen (uint16 *)      - where to put its length.
+                     maxLen (uint16)      - most bytes to read.
+                     method (uint8)       - ATT method of the read.
+   Return Value:     (bStatus_t) - SUCCESS or an ATT error code.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Attributes without read permission, and service
+                     attributes without a read callback, can't be read.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bStatus_t readAttr(bleDevice_t *pDev, int index, uint16 connHandle,
+                          uint8 *pValue, uint16 *pLen, uint16 maxLen,
+                          uint8 method)
+{
+    /* variables */
+    gattAttribute_t *pAttr = pDev->attrs[index].pAttr; /* the attribute */
+    CONST gattServiceCBs_t *pCBs = pDev->attrs[index].pCBs; /* callbacks */
+    gattAttrType_t *pService; /* a service's type */
+    gattAttribute_t *pChar; /* a declaration's value attribute */
+    uint8 value[ATT_UUID_SIZE + 3]; /* value built here */
+    uint16 len; /* its length */
+    uint16 cfg; /* a client configuration */
+
+    if (!(pAttr->permissions & GATT_PERMIT_READ))
+        return ATT_ERR_READ_NOT_PERMITTED;
+
+    switch (attrUUID(pAttr))
+    {
+    case GATT_PRIM_SERVICE_UUID:
+        pService = (gattAttrType_t *) pAttr->pValue;
+        len = pService->len;
+        memcpy(value, pService->uuid, len);
+        break;
+
+    case GATT_CHARACTER_UUID:
+        /* properties, then the handle and type of the value */
+        if (index + 1 >= pDev->numAttrs)
+            return ATT_ERR_INVALID_HANDLE;
+        pChar = pDev->attrs[index + 1].pAttr;
+        value[0] = *pAttr->pValue;
+        value[1] = LO_UINT16(pChar->handle);
+        value[2] = HI_UINT16(pChar->handle);
+        memcpy(&value[3], pChar->type.uuid, pChar->type.len);
+        len = 3 + pChar->type.len;
+        break;
+
+    case GATT_CHAR_USER_DESC_UUID:
+        len = MIN(strlen((char *) pAttr->pValue), sizeof(value));
+        memcpy(value, pAttr->pValue, len);
+        break;
+
+    case GATT_CLIENT_CHAR_CFG_UUID:
+        /* the attribute value points to the configuration table */
+        cfg = GATTServApp_ReadCharCfg(connHandle,
+                                      *(gattCharCfg_t **) pAttr->pValue);
+        value[0] = LO_UINT16(cfg);
+        value[1] = HI_UINT16(cfg);
+        len = 2;
+        break;
+
+    case DEVICE_NAME_UUID:
+        len = MIN(strlen((char *) pAttr->pValue), sizeof(value));
+        memcpy(value, pAttr->pValue, len);
+        break;
+
+    case GATT_DB_HASH_UUID:
+        len = ATT_UUID_SIZE;
+        memcpy(value, pDev->dbHash, len);
+        break;
+
+    default:
+        /* the service reads everything else */
+        if ((pCBs == NULL) || (pCBs->pfnReadAttrCB == NULL))
+            return ATT_ERR_READ_NOT_PERMITTED;
+        return pCBs->pfnReadAttrCB(connHandle, pAttr, pValue, pLen, 0,
+                                   maxLen, method);
+    }
+
+    *pLen = MIN(len, maxLen);
+    memcpy(pValue, value, *pLen);
+
+    return SUCCESS;
+}
+
+
+
+/*
+   computeDbHash(bleDevice_t *)
+
+   Description:      This function computes the database hash of a device.
+                     It changes whenever an attribute is added, moved or
+                     changes type, which is all the client cares about.
+   Operation:        The handle, type and permissions of every attribute
+                     are hashed four times (with different starting values)
+                     to fill the 16 bytes.
+
+   Arguments:        pDev (bleDevice_t *) - the device.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       FNV-1a (xor in each byte, then multiply by the prime).
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void computeDbHash(bleDevice_t *pDev)
+{
+    /* variables */
+    uint32_t hash; /* one quarter of the hash */
+    gattAttribute_t *pAttr; /* attribute hashed */
+    uint8 bytes[ATT_UUID_SIZE + 3]; /* its bytes */
+    int part, i, j; /* indices */
+
+    for (part = 0; part < 4; part++)
+    {
+        hash = 2166136261u ^ (uint32_t) part;
+        for (i = 0; i < pDev->numAttrs; i++)
+        {
+            pAttr = pDev->attrs[i].pAttr;
+            bytes[0] = LO_UINT16(pAttr->handle);
+            bytes[1] = HI_UINT16(pAttr->handle);
+            bytes[2] = pAttr->permissions;
+            memcpy(&bytes[3], pAttr->type.uuid, pAttr->type.len);
+            for (j = 0; j < 3 + pAttr->type.len; j++)
+                hash = (hash ^ bytes[j]) * 16777619u;
+        }
+        memcpy(&pDev->dbHash[4 * part], &hash, sizeof(hash));
+    }
+}
+
+
+
+/*
+   ringPut(bleRing_t *, uint8, gattMsg_t *)
+   ringGet(bleRing_t *, blePacket_t *)
+
+   Description:      These functions queue a packet on a link and take the
+                     oldest one off.
+   Operation:        The circular buffer is written or read.
+
+   Arguments:        pRing (bleRing_t *)  - the packets queued one way.
+                     method (uint8)       - ATT method of the packet.
+                     pMsg (gattMsg_t *)   - its PDU.
+                     pPkt (blePacket_t *) - where to put the packet taken.
+   Return Value:     (bool) - TRUE if a packet was queued or taken, FALSE if
+                              the buffer is full or empty.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Circular buffer.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool ringPut(bleRing_t *pRing, uint8 method, gattMsg_t *pMsg)
+{
+    /* variables */
+    blePacket_t *pPkt; /* where the packet goes */
+
+    if (pRing->count == RADIO_TX_SIZE)
+        return false;
+
+    pPkt = &pRing->pkts[(pRing->head + pRing->count) % RADIO_TX_SIZE];
+    pPkt->method = method;
+    pPkt->msg = *pMsg;
+    pRing->count++;
+
+    return true;
+}
+
+static bool ringGet(bleRing_t *pRing, blePacket_t *pPkt)
+{
+    if (pRing->count == 0)
+        return false;
+
+    *pPkt = pRing->pkts[pRing->head];
+    pRing->head = (pRing->head + 1) % RADIO_TX_SIZE;
+    pRing->count--;
+
+    return true;
+}
+
+
+
+/*
+   sendRequest(uint16, uint8, gattMsg_t *)
+
+   Description:      This function queues a GATT client request (a request
+                     or a write command) to the server.  Only one request
+                     may wait for a response at a time.
+   Operation:        The link is checked for an outstanding request (not
+                     for commands) and for room, and the packet is queued.
+
+   Arguments:        connHandle (uint16) - the link.
+                     method (uint8)      - ATT method of the request.
+                     pMsg (gattMsg_t *)  - its PDU.
+   Return Value:     (bStatus_t) - SUCCESS, bleNotConnected, blePending (a
+                                   request is outstanding) or
+                                   MSG_BUFFER_NOT_AVAIL (no room).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Nothing is queued unless SUCCESS is returned.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bStatus_t sendRequest(uint16 connHandle, uint8 method, gattMsg_t *pMsg)
+{
+    /* variables */
+    bleLink_t *pLink = findLink(connHandle); /* the link */
+
+    if (pLink == NULL)
+        return bleNotConnected;
+    if ((method != ATT_WRITE_CMD) && pLink->reqOutstanding)
+        return blePending;
+    if (pLink->toServer.count >= RADIO_TX_APP_LIMIT)
+    {
+        stats.txFull++;
+        return MSG_BUFFER_NOT_AVAIL;
+    }
+
+    ringPut(&pLink->toServer, method, pMsg);
+    if (method != ATT_WRITE_CMD)
+        pLink->reqOutstanding = true;
+    needRadio();
+
+    return SUCCESS;
+}
+
+
+
+/*
+   freePacket(blePacket_t *)
+
+   Description:      This function frees the payload of a packet that is
+                     dropped.
+   Operation:        The payload is freed as for its method.
+
+   Arguments:        pPkt (blePacket_t *) - the packet.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void freePacket(blePacket_t *pPkt)
+{
+    GATT_bm_free(&pPkt->msg, pPkt->method);
+}
+
+
+
+/*
+   serveRequest(bleLink_t *, blePacket_t *)
+
+   Description:      This function is the ATT server: it handles a request
+                     or command from the client on a link and queues the
+                     response (if there is one) to the client.
+   Operation:        Writes go to the service write callback (and the
+                     written value is freed), reads are done with
+                     readAttr, and reads by type return the characteristic
+                     declarations in the range (three at a time, for the
+                     discovery) or the first attribute of another type.
+                     Failures are answered with an error response.
+
+   Arguments:        pLink (bleLink_t *)  - the link.
+                     pPkt (blePacket_t *) - the request.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Requests for attributes that don't exist are answered
+                     with ATT_ERR_INVALID_HANDLE or ATT_ERR_ATTR_NOT_FOUND.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void serveRequest(bleLink_t *pLink, blePacket_t *pPkt)
+{
+    /* variables */
+    bleDevice_t *pDev = pLink->pPeripheral; /* the server */
+    CONST gattServiceCBs_t *pCBs; /* callbacks of an attribute */
+    gattAttribute_t *pAttr; /* an attribute */
+    attReadByTypeReq_t *pReq; /* a read by type request */
+    gattMsg_t rsp; /* the response */
+    uint8 method = 0; /* its method (0 for none) */
+    uint8 *pList; /* a read by type response's pairs */
+    uint8 value[ATT_MAX_VALUE]; /* a value read */
+    uint16 len; /* its length */
+    uint16 uuid; /* type wanted */
+    bStatus_t status = SUCCESS; /* result of the request */
+    uint16 errHandle = 0; /* attribute an error is for */
+    int i; /* attribute index */
+
+    memset(&rsp, 0, sizeof(rsp));
+    pRadioDev = pDev;
+
+    switch (pPkt->method)
+    {
+    case ATT_WRITE_REQ:
+    case ATT_WRITE_CMD:
+        errHandle = pPkt->msg.writeReq.handle;
+        i = findAttr(pDev, errHandle);
+        if (i < 0)
+        {
+            status = ATT_ERR_INVALID_HANDLE;
+        }
+        else
+        {
+            pAttr = pDev->attrs[i].pAttr;
+            pCBs = pDev->attrs[i].pCBs;
+            if (!(pAttr->permissions & GATT_PERMIT_WRITE) || (pCBs == NULL)
+                    || (pCBs->pfnWriteAttrCB == NULL))
+                status = ATT_ERR_WRITE_NOT_PERMITTED;
+            else
+                status = pCBs->pfnWriteAttrCB(pLink->connHandle, pAttr,
+                                              pPkt->msg.writeReq.pValue,
+                                              pPkt->msg.writeReq.len, 0,
+                                              pPkt->method);
+        }
+        GATT_bm_free(&pPkt->msg, pPkt->method);
+
+        /* only requests are answered */
+        if (pPkt->method == ATT_WRITE_REQ)
+            method = ATT_WRITE_RSP;
+        break;
+
+    case ATT_READ_REQ:
+        errHandle = pPkt->msg.readReq.handle;
+        i = findAttr(pDev, errHandle);
+        if (i < 0)
+            status = ATT_ERR_INVALID_HANDLE;
+        else
+            status = readAttr(pDev, i, pLink->connHandle, value, &len,
+                              ATT_MAX_VALUE, ATT_READ_REQ);
+        if (status == SUCCESS)
+        {
+            rsp.readRsp.pValue = GATT_bm_alloc(pLink->connHandle,
+                                               ATT_READ_RSP, len, NULL);
+            memcpy(rsp.readRsp.pValue, value, len);
+            rsp.readRsp.len = len;
+        }
+        method = ATT_READ_RSP;
+        break;
+
+    case ATT_READ_BY_TYPE_REQ:
+        pReq = &pPkt->msg.readByTypeReq;
+        errHandle = pReq->startHandle;
+        uuid = BUILD_UINT16(pReq->type.uuid[0], pReq->type.uuid[1]);
+        pList = GATT_bm_alloc(pLink->connHandle, ATT_READ_BY_TYPE_RSP,
+                              ATT_MAX_VALUE, NULL);
+        for (i = 0; i < pDev->numAttrs; i++)
+        {
+            pAttr = pDev->attrs[i].pAttr;
+            if ((pAttr->handle < pReq->startHandle)
+                    || (pAttr->handle > pReq->endHandle)
+                    || (attrUUID(pAttr) != uuid))
+                continue;
+
+            if (uuid == GATT_CHARACTER_UUID)
+            {
+                /* declaration handle, then its value (properties, value */
+                /*    handle and 16-bit type) */
+                if ((readAttr(pDev, i, pLink->connHandle, value, &len,
+                              sizeof(value), ATT_READ_BY_TYPE_REQ) != SUCCESS)
+                        || (len != DISC_PAIR_LEN - 2))
+                    continue;
+                len = rsp.readByTypeRsp.numPairs * DISC_PAIR_LEN;
+                pList[len] = LO_UINT16(pAttr->handle);
+                pList[len + 1] = HI_UINT16(pAttr->handle);
+                memcpy(&pList[len + 2], value, DISC_PAIR_LEN - 2);
+                rsp.readByTypeRsp.len = DISC_PAIR_LEN;
+                if (++rsp.readByTypeRsp.numPairs == DISC_MAX_PAIRS)
+                    break;
+            }
+            else if (readAttr(pDev, i, pLink->connHandle, &pList[2], &len,
+                              ATT_MAX_VALUE - 2, ATT_READ_BY_TYPE_REQ)
+                    == SUCCESS)
+            {
+                /* handle and value of the first one */
+                pList[0] = LO_UINT16(pAttr->handle);
+                pList[1] = HI_UINT16(pAttr->handle);
+                rsp.readByTypeRsp.len = 2 + len;
+                rsp.readByTypeRsp.numPairs = 1;
+                break;
+            }
+        }
+        if (rsp.readByTypeRsp.numPairs == 0)
+        {
+            ICall_free(pList);
+            status = ATT_ERR_ATTR_NOT_FOUND;
+        }
+        else
+        {
+            rsp.readByTypeRsp.pDataList = pList;
+            rsp.readByTypeRsp.dataLen = rsp.readByTypeRsp.numPairs
+                    * rsp.readByTypeRsp.len;
+        }
+        method = ATT_READ_BY_TYPE_RSP;
+        break;
+
+    default:
+        fatal("unexpected request");
+    }
+    pRadioDev = NULL;
+
+    /* answer */
+    if (method == 0)
+        return;
+    if (status != SUCCESS)
+    {
+        method = ATT_ERROR_RSP;
+        memset(&rsp, 0, sizeof(rsp));
+        rsp.errorRsp.reqOpcode = pPkt->method;
+        rsp.errorRsp.handle = errHandle;
+        rsp.errorRsp.errCode = status;
+    }
+    if (!ringPut(&pLink->toClient, method, &rsp))
+        fatal("link response buffer overflow");
+}
+
+
+
+/*
+   deliverToClient(bleLink_t *, blePacket_t *)
+
+   Description:      This function delivers a response or notification to
+                     the client of a link as a GATT message.  A response
+                     lets the client send its next request, except while
+                     discovering characteristics: then the next discovery
+                     request is sent for it, and the discovery ends with a
+                     response with the status bleProcedureComplete.
+   Operation:        A GATT message is built from the packet and sent to
+                     the client.
+
+   Arguments:        pLink (bleLink_t *)  - the link.
+                     pPkt (blePacket_t *) - the response or notification.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void deliverToClient(bleLink_t *pLink, blePacket_t *pPkt)
+{
+    /* variables */
+    gattMsgEvent_t *pMsg; /* the GATT message */
+    gattMsg_t req; /* next discovery request */
+    uint8 *pLast; /* last pair of a discovery response */
+    uint16 next; /* handle the next discovery starts at */
+
+    pMsg = ICall_allocMsg(sizeof(gattMsgEvent_t));
+    if (pMsg == NULL)
+        fatal("out of memory");
+    memset(pMsg, 0, sizeof(gattMsgEvent_t));
+    pMsg->hdr.event = GATT_MSG_EVENT;
+    pMsg->hdr.status = SUCCESS;
+    pMsg->connHandle = pLink->connHandle;
+    pMsg->method = pPkt->method;
+    pMsg->msg = pPkt->msg;
+
+    if (pPkt->method != ATT_HANDLE_VALUE_NOTI)
+    {
+        pLink->reqOutstanding = false;
+        if (pLink->discActive && (pPkt->method == ATT_READ_BY_TYPE_RSP))
+        {
+            /* continue after the last declaration found */
+            pLast = &pPkt->msg.readByTypeRsp.pDataList[
+                    (pPkt->msg.readByTypeRsp.numPairs - 1) * DISC_PAIR_LEN];
+            next = BUILD_UINT16(pLast[0], pLast[1]) + 1;
+            if (next <= pLink->discEnd)
+            {
+                memset(&req, 0, sizeof(req));
+                req.readByTypeReq.startHandle = next;
+                req.readByTypeReq.endHandle = pLink->discEnd;
+                req.readByTypeReq.type.len = ATT_BT_UUID_SIZE;
+                req.readByTypeReq.type.uuid[0] = characterUUID[0];
+                req.readByTypeReq.type.uuid[1] = characterUUID[1];
+                ringPut(&pLink->toServer, ATT_READ_BY_TYPE_REQ, &req);
+                pLink->reqOutstanding = true;
+            }
+            else
+            {
+                pLink->discActive = false;
+            }
+        }
+        else if (pLink->discActive && (pPkt->method == ATT_ERROR_RSP))
+        {
+            /* nothing more to discover */
+            pLink->discActive = false;
+            pMsg->hdr.status = bleProcedureComplete;
+            pMsg->method = ATT_READ_BY_TYPE_RSP;
+            memset(&pMsg->msg, 0, sizeof(pMsg->msg));
+        }
+    }
+
+    sendMsg(pLink->pCentral, pMsg);
+}
+
+
+
+/*
+   resetCharCfgs(uint16)
+
+   Description:      This function clears the client configurations of a
+                     link that is gone.
+   Operation:        The link's entry in every table is reset.
+
+   Arguments:        connHandle (uint16) - the link.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void resetCharCfgs(uint16 connHandle)
+{
+    /* variables */
+    int i; /* table index */
+
+    for (i = 0; i < numCccTables; i++)
+        GATTServApp_InitCharCfg(connHandle, cccTables[i]);
+}
+
+
+
+/*
+   radioAdvEvents(void)
+
+   Description:      This function delivers the pending advertising events
+                     the devices asked for to their callbacks.
+   Operation:        Each pending event is delivered in a buffer from
+                     ICall_malloc: the set handle, or the termination data
+                     for GAP_EVT_ADV_SET_TERMINATED.  Events not asked for
+                     are dropped.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any event was delivered.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there is no memory.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool radioAdvEvents(void)
+{
+    /* variables */
+    bleAdvSet_t *pSet; /* a set */
+    GapAdv_setTerm_t *pTerm; /* termination data */
+    uint8 *pHandle; /* set handle */
+    uint32_t event; /* event delivered */
+    bool did = false; /* whether anything was delivered */
+    int d, s; /* device and set indices */
+
+    for (d = 0; d < MAX_DEVICES; d++)
+    {
+        for (s = 0; s < MAX_ADV_SETS; s++)
+        {
+            pSet = &devices[d].adv[s];
+            while (pSet->pending != 0)
+            {
+                event = pSet->pending & -pSet->pending;
+                pSet->pending &= ~event;
+                if (!(pSet->mask & event))
+                    continue;
+
+                pRadioDev = &devices[d];
+                if (event == GAP_EVT_ADV_SET_TERMINATED)
+                {
+                    pTerm = ICall_malloc(sizeof(GapAdv_setTerm_t));
+                    if (pTerm == NULL)
+                        fatal("out of memory");
+                    pTerm->handle = s;
+                    pTerm->status = SUCCESS;
+                    pTerm->connHandle = pSet->termConn;
+                    pTerm->numCompAdvEvts = 0;
+                    pSet->cb(event, pTerm, 0);
+                }
+                else
+                {
+                    pHandle = ICall_malloc(sizeof(uint8));
+                    if (pHandle == NULL)
+                        fatal("out of memory");
+                    *pHandle = s;
+                    pSet->cb(event, pHandle, 0);
+                }
+                pRadioDev = NULL;
+                did = true;
+            }
+        }
+    }
+
+    return did;
+}
+
+
+
+/*
+   advertising(bleDevice_t *)
+
+   Description:      This function returns the set of a device a scanner
+                     hears and can connect to: the first enabled,
+                     connectable set on the 1M PHY (the only one scanned).
+   Operation:        The sets are searched.
+
+   Arguments:        pDev (bleDevice_t *) - the device.
+   Return Value:     (int) - the set, -1 if there is none.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int advertising(bleDevice_t *pDev)
+{
+    /* variables */
+    int s; /* set index */
+
+    for (s = 0; s < MAX_ADV_SETS; s++)
+        if (pDev->adv[s].used && pDev->adv[s].enabled
+                && (pDev->adv[s].pParams->eventProps & GAP_ADV_PROP_CONNECTABLE)
+                && (pDev->adv[s].pParams->primPhy == SCAN_PRIM_PHY_1M))
+            return s;
+
+    return -1;
+}
+
+
+
+/*
+   radioScan(void)
+
+   Description:      This function delivers advertising reports to the
+                     scanning devices: one report per advertising set heard
+                     each time scanning is enabled (the duplicate filter).
+   Operation:        Every scanning device asking for reports hears the
+                     set each other device is advertising.  The report and
+                     its data are from ICall_malloc and belong to the
+                     scanner callback.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any report was delivered.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there is no memory.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool radioScan(void)
+{
+    /* variables */
+    bleDevice_t *pScanner; /* a scanning device */
+    bleDevice_t *pAdv; /* a device it may hear */
+    bleAdvSet_t *pSet; /* the set heard */
+    GapScan_Evt_AdvRpt_t *pRpt; /* the report */
+    uint32_t bit; /* bit of the set in the reported sets */
+    bool did = false; /* whether anything was delivered */
+    int d, a, s; /* device and set indices */
+
+    for (d = 0; d < MAX_DEVICES; d++)
+    {
+        pScanner = &devices[d];
+        if (!pScanner->scanning || !(pScanner->scanMask & GAP_EVT_ADV_REPORT))
+            continue;
+
+        for (a = 0; a < MAX_DEVICES; a++)
+        {
+            pAdv = &devices[a];
+            if ((a == d) || !pAdv->used || ((s = advertising(pAdv)) < 0))
+                continue;
+            bit = 1UL << (a * MAX_ADV_SETS + s);
+            if (pScanner->reported & bit)
+                continue;
+            pScanner->reported |= bit;
+
+            pSet = &pAdv->adv[s];
+            pRpt = ICall_malloc(sizeof(GapScan_Evt_AdvRpt_t));
+            if (pRpt == NULL)
+                fatal("out of memory");
+            memset(pRpt, 0, sizeof(GapScan_Evt_AdvRpt_t));
+            pRpt->evtType = pSet->pParams->eventProps;
+            pRpt->addrType = pAdv->addrType;
+            memcpy(pRpt->addr, pAdv->addr, B_ADDR_LEN);
+            pRpt->primPhy = pSet->pParams->primPhy;
+            pRpt->secPhy = pSet->pParams->secPhy;
+            pRpt->advSid = pSet->pParams->sid;
+            pRpt->rssi = -40;
+            pRpt->dataLen = pSet->dataLen;
+            pRpt->pData = ICall_malloc(pSet->dataLen);
+            if (pRpt->pData == NULL)
+                fatal("out of memory");
+            memcpy(pRpt->pData, pSet->pData, pSet->dataLen);
+
+            stats.advReports++;
+            pRadioDev = pScanner;
+            pScanner->scanCb(GAP_EVT_ADV_REPORT, pRpt, pScanner->scanArg);
+            pRadioDev = NULL;
+            did = true;
+        }
+    }
+
+    return did;
+}
+
+
+
+/*
+   radioConnect(void)
+
+   Description:      This function makes the links the initiating devices
+                     asked for, once the device they want is advertising.
+   Operation:        A link is set up, the set advertising is terminated
+                     (GAP_EVT_ADV_SET_TERMINATED is made pending) and both
+                     devices get GAP_LINK_ESTABLISHED_EVENT.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any link was made.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   An initiator waits if the table of links is full.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool radioConnect(void)
+{
+    /* variables */
+    bleDevice_t *pCentral; /* an initiating device */
+    bleDevice_t *pPeripheral; /* the device it connects to */
+    bleLink_t *pLink = NULL; /* the new link */
+    gapEstLinkReqEvent_t *pEst; /* link established messages */
+    bool did = false; /* whether any link was made */
+    int d, p, s, l; /* device, set and link indices */
+
+    for (d = 0; d < MAX_DEVICES; d++)
+    {
+        pCentral = &devices[d];
+        if (!pCentral->connecting)
+            continue;
+
+        /* find who it wants and a free link */
+        for (p = 0; p < MAX_DEVICES; p++)
+            if ((p != d) && devices[p].used
+                    && (memcmp(devices[p].addr, pCentral->connAddr, B_ADDR_LEN)
+                            == 0))
+                break;
+        if ((p == MAX_DEVICES) || ((s = advertising(&devices[p])) < 0))
+            continue;
+        for (l = 0; (l < MAX_LINKS) && links[l].used; l++)
+            ;
+        if (l == MAX_LINKS)
+            continue;
+        pPeripheral = &devices[p];
+
+        /* set up the link */
+        pLink = &links[l];
+        memset(pLink, 0, sizeof(bleLink_t));
+        pLink->used = true;
+        pLink->connHandle = nextConnHandle++;
+        pLink->pCentral = pCentral;
+        pLink->pPeripheral = pPeripheral;
+        pCentral->connecting = false;
+        stats.links++;
+
+        /* the set that was connected to stops */
+        pPeripheral->adv[s].enabled = false;
+        pPeripheral->adv[s].termConn = pLink->connHandle;
+        pPeripheral->adv[s].pending |= GAP_EVT_ADV_SET_TERMINATED;
+
+        /* tell both ends */
+        pEst = allocGapMsg(sizeof(gapEstLinkReqEvent_t),
+                           GAP_LINK_ESTABLISHED_EVENT);
+        pEst->devAddrType = pPeripheral->addrType;
+        memcpy(pEst->devAddr, pPeripheral->addr, B_ADDR_LEN);
+        pEst->connectionHandle = pLink->connHandle;
+        pEst->connRole = GAP_PROFILE_ROLE_CENTRAL;
+        pEst->connInterval = pCentral->connInt;
+        pEst->connTimeout = LINK_TIMEOUT;
+        sendMsg(pCentral, pEst);
+
+        pEst = allocGapMsg(sizeof(gapEstLinkReqEvent_t),
+                           GAP_LINK_ESTABLISHED_EVENT);
+        pEst->devAddrType = pCentral->addrType;
+        memcpy(pEst->devAddr, pCentral->addr, B_ADDR_LEN);
+        pEst->connectionHandle = pLink->connHandle;
+        pEst->connRole = GAP_PROFILE_ROLE_PERIPHERAL;
+        pEst->connInterval = pCentral->connInt;
+        pEst->connTimeout = LINK_TIMEOUT;
+        sendMsg(pPeripheral, pEst);
+
+        did = true;
+    }
+
+    return did;
+}
+
+
+
+/*
+   radioUpdates(void)
+
+   Description:      This function applies the link parameter updates that
+                     were requested.  The peer always accepts.
+   Operation:        Both ends of each link with an update pending get
+                     GAP_LINK_PARAM_UPDATE_EVENT with the new parameters.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any update was applied.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool radioUpdates(void)
+{
+    /* variables */
+    gapLinkUpdateEvent_t *pUpd; /* parameter update message */
+    bleDevice_t *pEnd; /* an end of the link */
+    bool did = false; /* whether any update was applied */
+    int l, e; /* link and end indices */
+
+    for (l = 0; l < MAX_LINKS; l++)
+    {
+        if (!links[l].used || !links[l].updatePending)
+            continue;
+        links[l].updatePending = false;
+        stats.paramUpdates++;
+
+        for (e = 0; e < 2; e++)
+        {
+            pEnd = (e == 0) ? links[l].pCentral : links[l].pPeripheral;
+            pUpd = allocGapMsg(sizeof(gapLinkUpdateEvent_t),
+                               GAP_LINK_PARAM_UPDATE_EVENT);
+            pUpd->status = SUCCESS;
+            pUpd->connectionHandle = links[l].connHandle;
+            pUpd->connInterval = links[l].update.intervalMax;
+            pUpd->connLatency = links[l].update.connLatency;
+            pUpd->connTimeout = links[l].update.connTimeout;
+            sendMsg(pEnd, pUpd);
+        }
+        did = true;
+    }
+
+    return did;
+}
+
+
+
+/*
+   radioLinks(void)
+
+   Description:      This function is a connection event on every link: it
+                     moves up to RADIO_PKTS_PER_EVENT packets from the
+                     client to the server and from the server to the
+                     client.
+   Operation:        The server handles the packets to it (queueing its
+                     responses), then the packets to the client are
+                     delivered as GATT messages.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if any packet moved.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool radioLinks(void)
+{
+    /* variables */
+    blePacket_t pkt; /* a packet */
+    bool moved; /* whether a packet moved on this link */
+    bool did = false; /* whether any packet moved */
+    int l, n; /* link and packet indices */
+
+    for (l = 0; l < MAX_LINKS; l++)
+    {
+        moved = false;
+        for (n = 0; (n < RADIO_PKTS_PER_EVENT) && links[l].used
+                && ringGet(&links[l].toServer, &pkt); n++)
+        {
+            serveRequest(&links[l], &pkt);
+            stats.toServer++;
+            moved = true;
+        }
+        for (n = 0; (n < RADIO_PKTS_PER_EVENT) && links[l].used
+                && ringGet(&links[l].toClient, &pkt); n++)
+        {
+            deliverToClient(&links[l], &pkt);
+            stats.toClient++;
+            moved = true;
+        }
+        if (moved)
+            stats.connEvents++;
+        did = did || moved;
+    }
+
+    return did;
+}
+
+
+
+/*
+   runRadio(void *)
+
+   Description:      This function is the loopback radio thread.  It runs
+                     a round whenever every task is waiting, and waits for
+                     work when a round does nothing.
+   Operation:        Each round delivers advertising events and reports,
+                     makes links, applies parameter updates and runs a
+                     connection event on each link.  When a round does
+                     nothing the radio is quiet until the stack is called.
+
+   Arguments:        arg (void *) - unused.
+   Return Value:     (void *) - never returns.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void *runRadio(void *arg)
+{
+    /* variables */
+    bool did; /* whether the round did anything */
+
+    (void) arg;
+
+    HostRtos_enter();
+    radioThread = pthread_self();
+    radioStarted = true;
+
+    for (;;)
+    {
+        /* let the tasks finish what the last round gave them */
+        HostRtos_waitIdle();
+
+        stackWork = false;
+        did = radioAdvEvents();
+        did = radioScan() || did;
+        did = radioConnect() || did;
+        did = radioUpdates() || did;
+        did = radioLinks() || did;
+        pthread_cond_broadcast(&txCond);
+
+        /* nothing to do, wait for the stack to be called */
+        if (!did && !stackWork)
+        {
+            quiet = true;
+            pthread_cond_broadcast(&quietCond);
+            while (!stackWork)
+                HostRtos_wait(&workCond);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/*
+   BleStack_start(void)
+
+   Description:      This function starts the loopback radio.  It is called
+                     with the CPU held, after HostRtos_start.
+   Operation:        The radio thread is started.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void BleStack_start(void)
+{
+    HostRtos_thread(runRadio);
+}
+
+
+
+/*
+   BleStack_waitQuiet(void)
+
+   Description:      This function waits until every task is waiting and
+                     the radio has nothing to do, so everything the caller
+                     started has been done.  Clocks may still start more.
+   Operation:        The caller waits for the tasks to be idle, then for
+                     the radio to be quiet, until both hold at once.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void BleStack_waitQuiet(void)
+{
+    do
+    {
+        HostRtos_waitIdle();
+        while (!quiet || stackWork)
+            HostRtos_wait(&quietCond);
+        HostRtos_waitIdle();
+    } while (!quiet || stackWork);
+}
+
+
+
+/*
+   BleStack_waitTxFree(void)
+
+   Description:      This function waits until every link has room for the
+                     application to queue a packet to the server.
+   Operation:        The caller waits for radio rounds until no link is
+                     full.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void BleStack_waitTxFree(void)
+{
+    /* variables */
+    bool full; /* whether a link is full */
+    int l; /* link index */
+
+    do
+    {
+        full = false;
+        for (l = 0; l < MAX_LINKS; l++)
+            if (links[l].used
+                    && (links[l].toServer.count >= RADIO_TX_APP_LIMIT))
+                full = true;
+        if (full)
+            HostRtos_wait(&txCond);
+    } while (full);
+}
+
+
+
+/*
+   BleStack_dropLinks(void)
+
+   Description:      This function drops every link, as if the devices
+                     went out of range.
+   Operation:        The packets queued on each link are freed, its client
+                     configurations are reset and both ends get
+                     GAP_LINK_TERMINATED_EVENT.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if there was a link to drop.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bool BleStack_dropLinks(void)
+{
+    /* variables */
+    gapTerminateLinkEvent_t *pTerm; /* link terminated message */
+    blePacket_t pkt; /* a packet dropped */
+    bool dropped = false; /* whether any link was dropped */
+    int l, e; /* link and end indices */
+
+    for (l = 0; l < MAX_LINKS; l++)
+    {
+        if (!links[l].used)
+            continue;
+
+        while (ringGet(&links[l].toServer, &pkt))
+            freePacket(&pkt);
+        while (ringGet(&links[l].toClient, &pkt))
+            freePacket(&pkt);
+        resetCharCfgs(links[l].connHandle);
+
+        for (e = 0; e < 2; e++)
+        {
+            pTerm = allocGapMsg(sizeof(gapTerminateLinkEvent_t),
+                                GAP_LINK_TERMINATED_EVENT);
+            pTerm->connectionHandle = links[l].connHandle;
+            pTerm->reason = TERMINATE_REASON;
+            sendMsg((e == 0) ? links[l].pCentral : links[l].pPeripheral,
+                    pTerm);
+        }
+        links[l].used = false;
+        dropped = true;
+    }
+    needRadio();
+
+    return dropped;
+}
+
+
+
+/*
+   BleStack_heapInUse(void)
+   BleStack_getStats(bleStackStats_t *)
+
+   Description:      These functions return the ICall heap blocks allocated
+                     and a copy of the radio counts.
+   Operation:        The counts are returned.
+
+   Arguments:        pStats (bleStackStats_t *) - where to put the counts.
+   Return Value:     (uint32_t) - BleStack_heapInUse returns the blocks.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint32_t BleStack_heapInUse(void)
+{
+    return heapInUse;
+}
+
+void BleStack_getStats(bleStackStats_t *pStats)
+{
+    *pStats = stats;
+}
+
+
+
+/*
+   BleStack_findAttr(uint16, const gattServiceCBs_t **)
+
+   Description:      This function finds the first attribute of a type
+                     (16-bit UUID) registered by a service, so the harness
+                     can call the service callbacks on it as the stack
+                     would.
+   Operation:        The databases of the devices are searched for an
+                     attribute of the type with service callbacks.
+
+   Arguments:        uuid (uint16)                  - type of the attribute.
+                     ppCBs (const gattServiceCBs_t **) - where to put its
+                                                       service's callbacks.
+   Return Value:     (gattAttribute_t *) - the attribute, NULL if no service
+                                           has one of the type.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+gattAttribute_t *BleStack_findAttr(uint16 uuid, CONST gattServiceCBs_t **ppCBs)
+{
+    /* variables */
+    int d, i; /* device and attribute indices */
+
+    for (d = 0; d < MAX_DEVICES; d++)
+    {
+        for (i = 0; devices[d].used && (i < devices[d].numAttrs); i++)
+        {
+            if ((devices[d].attrs[i].pCBs != NULL)
+                    && (attrUUID(devices[d].attrs[i].pAttr) == uuid))
+            {
+                *ppCBs = devices[d].attrs[i].pCBs;
+                return devices[d].attrs[i].pAttr;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/*
+   BleStack_advReport(const uint8 *, const uint8 *, uint16)
+
+   Description:      This function hands the scanner callback an advertising
+                     report made up by the harness, as if it had been heard
+                     on the air.  It is called with the CPU held.
+   Operation:        A report is allocated as radioScan does (the report
+                     and its data are ICall heap blocks the callback frees)
+                     and given to the first device with a scanner callback,
+                     whether it is scanning or not.  The report isn't
+                     counted in the radio counts.
+
+   Arguments:        addr (const uint8 *)  - address of the advertiser.
+                     pData (const uint8 *) - advertising data.
+                     dataLen (uint16)      - bytes of advertising data.
+   Return Value:     (bool) - TRUE if a scanner callback was called, FALSE
+                              if no device has one.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there is no memory.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bool BleStack_advReport(const uint8 *addr, const uint8 *pData, uint16 dataLen)
+{
+    /* variables */
+    GapScan_Evt_AdvRpt_t *pRpt; /* the report */
+    bleDevice_t *pScanner = NULL; /* the device given the report */
+    int d; /* device index */
+
+    for (d = 0; (d < MAX_DEVICES) && (pScanner == NULL); d++)
+        if (devices[d].used && (devices[d].scanCb != NULL))
+            pScanner = &devices[d];
+    if (pScanner == NULL)
+        return false;
+
+    pRpt = ICall_malloc(sizeof(GapScan_Evt_AdvRpt_t));
+    if (pRpt == NULL)
+        fatal("out of memory");
+    memset(pRpt, 0, sizeof(GapScan_Evt_AdvRpt_t));
+    pRpt->evtType = GAP_ADV_PROP_CONNECTABLE | GAP_ADV_PROP_LEGACY;
+    pRpt->addrType = ADDRTYPE_RANDOM;
+    memcpy(pRpt->addr, addr, B_ADDR_LEN);
+    pRpt->primPhy = SCAN_PRIM_PHY_1M;
+    pRpt->rssi = -60;
+    pRpt->dataLen = dataLen;
+    pRpt->pData = ICall_malloc(dataLen);
+    if (pRpt->pData == NULL)
+        fatal("out of memory");
+    memcpy(pRpt->pData, pData, dataLen);
+
+    pScanner->scanCb(GAP_EVT_ADV_REPORT, pRpt, pScanner->scanArg);
+
+    return true;
+}
+
+
+
+/*
+   BleStack_getAdvAddr(uint8 *)
+
+   Description:      This function gets the address of the first device
+                     that created an advertising set.
+   Operation:        The devices are searched for an advertising set.
+
+   Arguments:        addr (uint8 *) - where to put the address.
+   Return Value:     (bool) - TRUE if a device advertises, FALSE if none.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bool BleStack_getAdvAddr(uint8 *addr)
+{
+    /* variables */
+    int d, s; /* device and set indices */
+
+    for (d = 0; d < MAX_DEVICES; d++)
+    {
+        for (s = 0; devices[d].used && (s < MAX_ADV_SETS); s++)
+        {
+            if (devices[d].adv[s].used)
+            {
+                memcpy(addr, devices[d].addr, B_ADDR_LEN);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+
+/*
+   ICall_registerApp(ICall_EntityID *, ICall_SyncHandle *)
+
+   Description:      This function registers the calling task with ICall,
+                     making it a device.
+   Operation:        A free device is taken for the task and its sync event
+                     is constructed.  The entity ID is the device index.
+
+   Arguments:        pEntity (ICall_EntityID *)     - where to put the ID.
+                     pSyncHandle (ICall_SyncHandle *) - where to put the
+                                                      sync event.
+   Return Value:     (ICall_Errno) - ICALL_ERRNO_SUCCESS, or
+                                     ICALL_ERRNO_NO_RESOURCE if there are
+                                     too many devices.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+ICall_Errno ICall_registerApp(ICall_EntityID *pEntity,
+                              ICall_SyncHandle *pSyncHandle)
+{
+    /* variables */
+    bleDevice_t *pDev; /* the new device */
+    int d; /* device index */
+
+    for (d = 0; (d < MAX_DEVICES) && devices[d].used; d++)
+        ;
+    if (d == MAX_DEVICES)
+        return ICALL_ERRNO_NO_RESOURCE;
+
+    pDev = &devices[d];
+    memset(pDev, 0, sizeof(bleDevice_t));
+    pDev->used = true;
+    pDev->thread = pthread_self();
+    pDev->nextHandle = 1;
+    pDev->connInt = INIT_PHYPARAM_MAX_CONN_INT;
+    Event_construct(&pDev->event, NULL);
+
+    *pEntity = d;
+    *pSyncHandle = Event_handle(&pDev->event);
+
+    return ICALL_ERRNO_SUCCESS;
+}
+
+
+
+/*
+   ICall_fetchServiceMsg(ICall_ServiceEnum *, ICall_EntityID *, void **)
+
+   Description:      This function gets the next stack message for the
+                     calling task.  If more are waiting ICALL_MSG_EVENT_ID
+                     is posted again so the task comes back for them.
+   Operation:        The first message is taken off the device's list.
+
+   Arguments:        pSrc (ICall_ServiceEnum *) - where to put the source.
+                     pDest (ICall_EntityID *)   - where to put the entity.
+                     pMsg (void **)             - where to put the message.
+   Return Value:     (ICall_Errno) - ICALL_ERRNO_SUCCESS, or
+                                     ICALL_ERRNO_NOMSG if there is none.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of messages.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+ICall_Errno ICall_fetchServiceMsg(ICall_ServiceEnum *pSrc,
+                                  ICall_EntityID *pDest, void **pMsg)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+    bleMsgHdr_t *pHdr = pDev->pHead; /* its first message */
+
+    if (pHdr == NULL)
+        return ICALL_ERRNO_NOMSG;
+
+    pDev->pHead = pHdr->pNext;
+    if (pDev->pHead == NULL)
+        pDev->pTail = NULL;
+    else
+        Event_post(Event_handle(&pDev->event), ICALL_MSG_EVENT_ID);
+
+    *pSrc = ICALL_SERVICE_CLASS_BLE;
+    *pDest = pDev - devices;
+    *pMsg = pHdr + 1;
+
+    return ICALL_ERRNO_SUCCESS;
+}
+
+
+
+/*
+   ICall_malloc(uint_least16_t)
+   ICall_free(void *)
+   ICall_allocMsg(size_t)
+   ICall_freeMsg(void *)
+
+   Description:      These functions allocate and free ICall heap blocks
+                     and stack messages (a block with a message header in
+                     front).  The blocks allocated are counted.
+   Operation:        The C heap is used.  Freeing NULL does nothing.
+
+   Arguments:        size (uint_least16_t/size_t) - bytes to allocate.
+                     pMsg (void *)                - block to free.
+   Return Value:     (void *) - the block or message, NULL if there is no
+                                memory.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void *ICall_malloc(uint_least16_t size)
+{
+    /* variables */
+    void *p = malloc(size); /* the block */
+
+    if (p != NULL)
+        heapInUse++;
+
+    return p;
+}
+
+void ICall_free(void *pMsg)
+{
+    if (pMsg == NULL)
+        return;
+
+    heapInUse--;
+    free(pMsg);
+}
+
+void *ICall_allocMsg(size_t size)
+{
+    /* variables */
+    bleMsgHdr_t *pHdr; /* the message's header */
+
+    pHdr = ICall_malloc(sizeof(bleMsgHdr_t) + size);
+    if (pHdr == NULL)
+        return NULL;
+
+    return pHdr + 1;
+}
+
+void ICall_freeMsg(void *pMsg)
+{
+    if (pMsg != NULL)
+        ICall_free((bleMsgHdr_t *) pMsg - 1);
+}
+
+
+
+/*
+   GAP_DeviceInit(uint8, uint8, GAP_Addr_Modes_t, void *)
+
+   Description:      This function finishes setting up a device: it gets
+                     its address and database hash, and is sent
+                     GAP_DEVICE_INIT_DONE_EVENT.
+   Operation:        The random address is used unless another device has
+                     it, then a public address is made up.  The hash is
+                     computed over the services added so far.
+
+   Arguments:        profileRole (uint8)        - GAP role (unused).
+                     taskID (uint8)             - entity of the device.
+                     addrMode (GAP_Addr_Modes_t) - address mode.
+                     pRandomAddr (void *)       - the random address.
+   Return Value:     (bStatus_t) - SUCCESS, or INVALID_TASK if the entity
+                                   isn't a device.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GAP_DeviceInit(uint8 profileRole, uint8 taskID,
+                         GAP_Addr_Modes_t addrMode, void *pRandomAddr)
+{
+    /* variables */
+    bleDevice_t *pDev; /* the device */
+    gapDeviceInitDoneEvent_t *pDone; /* init done message */
+    int d; /* device index */
+
+    (void) profileRole;
+
+    if ((taskID >= MAX_DEVICES) || !devices[taskID].used)
+        return INVALID_TASK;
+    pDev = &devices[taskID];
+
+    /* the random address, unless another device has it */
+    pDev->addrType = ADDRTYPE_PUBLIC;
+    if ((addrMode == ADDRMODE_RANDOM) && (pRandomAddr != NULL))
+    {
+        pDev->addrType = ADDRTYPE_RANDOM;
+        memcpy(pDev->addr, pRandomAddr, B_ADDR_LEN);
+        for (d = 0; d < MAX_DEVICES; d++)
+            if ((d != taskID) && devices[d].initDone
+                    && (memcmp(devices[d].addr, pDev->addr, B_ADDR_LEN) == 0))
+                pDev->addrType = ADDRTYPE_PUBLIC;
+    }
+    if (pDev->addrType == ADDRTYPE_PUBLIC)
+    {
+        memset(pDev->addr, 0x11, B_ADDR_LEN);
+        pDev->addr[0] = taskID;
+    }
+
+    computeDbHash(pDev);
+    pDev->initDone = true;
+
+    pDone = allocGapMsg(sizeof(gapDeviceInitDoneEvent_t),
+                        GAP_DEVICE_INIT_DONE_EVENT);
+    memcpy(pDone->devAddr, pDev->addr, B_ADDR_LEN);
+    pDone->dataPktLen = DATA_PKT_LEN;
+    pDone->numDataPkts = NUM_DATA_PKTS;
+    sendMsg(pDev, pDone);
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GAP_RegisterForMsgs(uint8)
+   GAP_SetParamValue(uint16, uint16)
+   GATT_InitClient(void)
+   GATT_RegisterForInd(uint8)
+   GATT_RegisterForMsgs(uint8)
+   HCI_LE_WriteSuggestedDefaultDataLenCmd(uint16, uint16)
+   DevInfo_SetParameter(uint8, uint8, void *)
+
+   Description:      These functions set up parts of the stack that aren't
+                     modeled: every device gets all its messages, accepts
+                     every parameter update and is a GATT client.
+   Operation:        Nothing is done.
+
+   Arguments:        Unused.
+   Return Value:     (bStatus_t) - SUCCESS.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void GAP_RegisterForMsgs(uint8 taskID)
+{
+    (void) taskID;
+}
+
+bStatus_t GAP_SetParamValue(uint16 paramID, uint16 paramValue)
+{
+    (void) paramID;
+    (void) paramValue;
+
+    return SUCCESS;
+}
+
+void GATT_InitClient(void)
+{
+}
+
+void GATT_RegisterForInd(uint8 taskId)
+{
+    (void) taskId;
+}
+
+void GATT_RegisterForMsgs(uint8 taskID)
+{
+    (void) taskID;
+}
+
+bStatus_t HCI_LE_WriteSuggestedDefaultDataLenCmd(uint16 suggestedPktLen,
+                                                 uint16 suggestedTxTime)
+{
+    (void) suggestedPktLen;
+    (void) suggestedTxTime;
+
+    return SUCCESS;
+}
+
+bStatus_t DevInfo_SetParameter(uint8 param, uint8 len, void *value)
+{
+    (void) param;
+    (void) len;
+    (void) value;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GAP_UpdateLinkParamReq(gapUpdateLinkParamReq_t *)
+
+   Description:      This function requests new parameters for a link.
+                     The radio applies them in its next round.
+   Operation:        The request is saved on the link.
+
+   Arguments:        pParams (gapUpdateLinkParamReq_t *) - the request.
+   Return Value:     (bStatus_t) - SUCCESS, bleNotConnected, or
+                                   bleAlreadyInRequestedMode if an update is
+                                   already pending.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GAP_UpdateLinkParamReq(gapUpdateLinkParamReq_t *pParams)
+{
+    /* variables */
+    bleLink_t *pLink = findLink(pParams->connectionHandle); /* the link */
+
+    if (pLink == NULL)
+        return bleNotConnected;
+    if (pLink->updatePending)
+        return bleAlreadyInRequestedMode;
+
+    pLink->update = *pParams;
+    pLink->updatePending = true;
+    needRadio();
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GGS_SetParameter(uint8, uint8, void *)
+   GGS_AddService(uint32)
+
+   Description:      These functions set the device name and add the GAP
+                     service (its declaration and the device name) to the
+                     calling device's database, at handle 1.
+   Operation:        The name is kept, and the service attributes are
+                     added.  The handles up to GAP_SERVICE_END are taken.
+
+   Arguments:        param (uint8)    - parameter (only the name is kept).
+                     len (uint8)      - length of the value (unused).
+                     value (void *)   - the value (the name must stay).
+                     services (uint32) - services to add (unused).
+   Return Value:     (bStatus_t) - SUCCESS, or bleNoResources if the
+                                   database is full.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GGS_SetParameter(uint8 param, uint8 len, void *value)
+{
+    (void) len;
+
+    if (param == GGS_DEVICE_NAME_ATT)
+        curDevice()->pName = value;
+
+    return SUCCESS;
+}
+
+bStatus_t GGS_AddService(uint32 services)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+    gattAttribute_t *pAttrs = pDev->gapAttrs; /* the service */
+    bStatus_t status; /* result of adding it */
+
+    (void) services;
+
+    pAttrs[0] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, primaryServiceUUID },
+                                    GATT_PERMIT_READ, 0,
+                                    (uint8 *) &gapService };
+    pAttrs[1] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, characterUUID },
+                                    GATT_PERMIT_READ, 0, &readProps };
+    pAttrs[2] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, deviceNameUUID },
+                                    GATT_PERMIT_READ, 0,
+                                    (pDev->pName != NULL) ? pDev->pName :
+                                            (uint8 *) "" };
+    status = addAttrs(pDev, pAttrs, 3, NULL);
+    pDev->nextHandle = MAX(pDev->nextHandle, GAP_SERVICE_END);
+
+    return status;
+}
+
+
+
+/*
+   GATTServApp_AddService(uint32)
+   DevInfo_AddService(void)
+
+   Description:      These functions add the GATT service (its declaration
+                     and the database hash) and the Device Information
+                     service to the calling device.  The Device Information
+                     attributes aren't modeled, only their handles are
+                     taken.
+   Operation:        The GATT service attributes are added and the handles
+                     up to GATT_SERVICE_END are taken, or the handles of
+                     the Device Information service are skipped.
+
+   Arguments:        services (uint32) - services to add (unused).
+   Return Value:     (bStatus_t) - SUCCESS, or bleNoResources if the
+                                   database is full.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATTServApp_AddService(uint32 services)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+    gattAttribute_t *pAttrs = pDev->gattAttrs; /* the service */
+    bStatus_t status; /* result of adding it */
+
+    (void) services;
+
+    pAttrs[0] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, primaryServiceUUID },
+                                    GATT_PERMIT_READ, 0,
+                                    (uint8 *) &gattService };
+    pAttrs[1] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, characterUUID },
+                                    GATT_PERMIT_READ, 0, &readProps };
+    pAttrs[2] = (gattAttribute_t) { { ATT_BT_UUID_SIZE, dbHashUUID },
+                                    GATT_PERMIT_READ, 0, NULL };
+    pDev->nextHandle = MAX(pDev->nextHandle, GAP_SERVICE_END);
+    status = addAttrs(pDev, pAttrs, 3, NULL);
+    pDev->nextHandle = MAX(pDev->nextHandle, GATT_SERVICE_END);
+
+    return status;
+}
+
+bStatus_t DevInfo_AddService(void)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    pDev->nextHandle = MAX(pDev->nextHandle, GATT_SERVICE_END)
+            + DEVINFO_SERVICE_SIZE;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GATTServApp_RegisterService(gattAttribute_t *, uint16, uint8,
+                               const gattServiceCBs_t *)
+
+   Description:      This function adds a service's attribute table to the
+                     calling device's database.  The table and callbacks
+                     must stay.
+   Operation:        The attributes are given the next handles.
+
+   Arguments:        pAttrs (gattAttribute_t *) - the attribute table.
+                     numAttrs (uint16)        - number of attributes.
+                     encKeySize (uint8)       - key size (unused).
+                     pServiceCBs (const gattServiceCBs_t *) - callbacks.
+   Return Value:     (bStatus_t) - SUCCESS, or bleNoResources if the
+                                   database is full.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                      uint16 numAttrs, uint8 encKeySize,
+                                      CONST gattServiceCBs_t *pServiceCBs)
+{
+    (void) encKeySize;
+
+    return addAttrs(curDevice(), pAttrs, numAttrs, pServiceCBs);
+}
+
+
+
+/*
+   GATTServApp_InitCharCfg(uint16, gattCharCfg_t *)
+
+   Description:      This function resets the entry of a link in a client
+                     configuration table, or every entry for
+                     LINKDB_CONNHANDLE_INVALID (which also registers the
+                     table to be reset when links go away).
+   Operation:        The entries are given no link and no configuration.
+
+   Arguments:        connHandle (uint16)        - the link.
+                     charCfgTbl (gattCharCfg_t *) - the table
+                                                (MAX_NUM_BLE_CONNS entries).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there are too many tables.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void GATTServApp_InitCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl)
+{
+    /* variables */
+    int i; /* entry or table index */
+
+    if (charCfgTbl == NULL)
+        return;
+
+    if (connHandle == LINKDB_CONNHANDLE_INVALID)
+    {
+        for (i = 0; (i < numCccTables) && (cccTables[i] != charCfgTbl); i++)
+            ;
+        if (i == numCccTables)
+        {
+            if (numCccTables == MAX_CCC_TABLES)
+                fatal("too many client configuration tables");
+            cccTables[numCccTables++] = charCfgTbl;
+        }
+    }
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if ((connHandle == LINKDB_CONNHANDLE_INVALID)
+                || (charCfgTbl[i].connHandle == connHandle))
+        {
+            charCfgTbl[i].connHandle = LINKDB_CONNHANDLE_INVALID;
+            charCfgTbl[i].value = GATT_CFG_NO_OPERATION;
+        }
+    }
+}
+
+
+
+/*
+   GATTServApp_ReadCharCfg(uint16, gattCharCfg_t *)
+   GATTServApp_WriteCharCfg(uint16, gattCharCfg_t *, uint16)
+
+   Description:      These functions read and write the client
+                     configuration of a link.
+   Operation:        The link's entry is looked up (a free one is taken to
+                     write a link that has none).
+
+   Arguments:        connHandle (uint16)        - the link.
+                     charCfgTbl (gattCharCfg_t *) - the table.
+                     value (uint16)             - the configuration.
+   Return Value:     (uint16) - GATTServApp_ReadCharCfg returns the
+                                configuration (none if the link has no
+                                entry).
+                     (uint8) - GATTServApp_WriteCharCfg returns SUCCESS, or
+                               FAILURE if the table is full.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint16 GATTServApp_ReadCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl)
+{
+    /* variables */
+    int i; /* entry index */
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+        if (charCfgTbl[i].connHandle == connHandle)
+            return charCfgTbl[i].value;
+
+    return GATT_CFG_NO_OPERATION;
+}
+
+uint8 GATTServApp_WriteCharCfg(uint16 connHandle, gattCharCfg_t *charCfgTbl,
+                               uint16 value)
+{
+    /* variables */
+    int i; /* entry index */
+    int slot = -1; /* entry written */
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if (charCfgTbl[i].connHandle == connHandle)
+        {
+            slot = i;
+            break;
+        }
+        if ((slot < 0)
+                && (charCfgTbl[i].connHandle == LINKDB_CONNHANDLE_INVALID))
+            slot = i;
+    }
+    if (slot < 0)
+        return FAILURE;
+
+    charCfgTbl[slot].connHandle = connHandle;
+    charCfgTbl[slot].value = value;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GATTServApp_ProcessCCCWriteReq(uint16, gattAttribute_t *, uint8 *, uint16,
+                                  uint16, uint16)
+
+   Description:      This function handles a write of a client
+                     configuration attribute.
+   Operation:        The value is checked and written to the table the
+                     attribute points to.
+
+   Arguments:        connHandle (uint16)       - the link.
+                     pAttr (gattAttribute_t *) - the attribute.
+                     pValue (uint8 *)          - the value.
+                     len (uint16)              - its length.
+                     offset (uint16)           - its offset.
+                     validCfg (uint16)         - configurations allowed.
+   Return Value:     (bStatus_t) - SUCCESS or an ATT error code.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Values that aren't two bytes at offset 0, or that
+                     aren't allowed, are not written.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATTServApp_ProcessCCCWriteReq(uint16 connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8 *pValue, uint16 len,
+                                         uint16 offset, uint16 validCfg)
+{
+    /* variables */
+    uint16 value; /* the configuration */
+
+    if (offset != 0)
+        return ATT_ERR_ATTR_NOT_LONG;
+    if (len != 2)
+        return ATT_ERR_INVALID_VALUE_SIZE;
+
+    value = BUILD_UINT16(pValue[0], pValue[1]);
+    if (value & ~validCfg)
+        return ATT_ERR_INVALID_VALUE;
+
+    if (GATTServApp_WriteCharCfg(connHandle, *(gattCharCfg_t **) pAttr->pValue,
+                                 value) != SUCCESS)
+        return ATT_ERR_INVALID_VALUE;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GATTServApp_ProcessCharCfg(gattCharCfg_t *, uint8 *, uint8,
+                              gattAttribute_t *, uint16, uint8,
+                              pfnGATTReadAttrCB_t)
+
+   Description:      This function notifies a characteristic value to every
+                     link whose client configuration has notifications on.
+   Operation:        The attribute holding the value is found in the table,
+                     then for each link the value is read with the service
+                     read callback (GATT_LOCAL_READ) into an ATT payload and
+                     notified.
+
+   Arguments:        charCfgTbl (gattCharCfg_t *) - the configurations.
+                     pValue (uint8 *)           - the value's storage.
+                     authenticated (uint8)      - unused.
+                     attrTbl (gattAttribute_t *) - the service's table.
+                     numAttrs (uint16)          - its attributes.
+                     taskId (uint8)             - unused.
+                     pfnReadAttrCB (pfnGATTReadAttrCB_t) - read callback.
+   Return Value:     (bStatus_t) - SUCCESS, INVALIDPARAMETER if the value
+                                   isn't in the table, or the error of the
+                                   last notification that failed.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The payload of a notification that isn't sent is
+                     freed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATTServApp_ProcessCharCfg(gattCharCfg_t *charCfgTbl, uint8 *pValue,
+                                     uint8 authenticated,
+                                     gattAttribute_t *attrTbl,
+                                     uint16 numAttrs, uint8 taskId,
+                                     pfnGATTReadAttrCB_t pfnReadAttrCB)
+{
+    /* variables */
+    gattAttribute_t *pAttr = NULL; /* attribute of the value */
+    attHandleValueNoti_t noti; /* a notification */
+    bStatus_t status = SUCCESS; /* result */
+    bStatus_t sent; /* result of a notification */
+    uint16 i; /* attribute or entry index */
+
+    (void) taskId;
+
+    for (i = 0; (i < numAttrs) && (pAttr == NULL); i++)
+        if (attrTbl[i].pValue == pValue)
+            pAttr = &attrTbl[i];
+    if (pAttr == NULL)
+        return INVALIDPARAMETER;
+
+    for (i = 0; i < MAX_NUM_BLE_CONNS; i++)
+    {
+        if ((charCfgTbl[i].connHandle == LINKDB_CONNHANDLE_INVALID)
+                || !(charCfgTbl[i].value & GATT_CLIENT_CFG_NOTIFY))
+            continue;
+
+        noti.pValue = GATT_bm_alloc(charCfgTbl[i].connHandle,
+                                    ATT_HANDLE_VALUE_NOTI, ATT_MAX_NOTI_VALUE,
+                                    NULL);
+        if (noti.pValue == NULL)
+        {
+            status = bleNoResources;
+            continue;
+        }
+        noti.handle = pAttr->handle;
+        sent = pfnReadAttrCB(charCfgTbl[i].connHandle, pAttr, noti.pValue,
+                             &noti.len, 0, ATT_MAX_NOTI_VALUE,
+                             GATT_LOCAL_READ);
+        if (sent == SUCCESS)
+            sent = GATT_Notification(charCfgTbl[i].connHandle, &noti,
+                                     authenticated);
+        if (sent != SUCCESS)
+        {
+            GATT_bm_free((gattMsg_t *) &noti, ATT_HANDLE_VALUE_NOTI);
+            status = sent;
+        }
+    }
+
+    return status;
+}
+
+
+
+/*
+   GapAdv_create(pfnGapCB_t, GapAdv_params_t *, uint8 *)
+   GapAdv_loadByHandle(uint8, GapAdv_dataTypes_t, uint16, uint8 *)
+   GapAdv_setEventMask(uint8, GapAdv_eventMaskFlags_t)
+
+   Description:      These functions create an advertising set of the
+                     calling device, load its data (scan response data is
+                     not used) and set the events it wants.  The
+                     parameters and data must stay.
+   Operation:        A free set is taken, or the set is filled in.
+
+   Arguments:        cb (pfnGapCB_t)               - callback for its events.
+                     advParam (GapAdv_params_t *)  - its parameters.
+                     advHandle (uint8 *)           - where to put its handle.
+                     handle (uint8)                - the set.
+                     dataType (GapAdv_dataTypes_t) - data loaded.
+                     len (uint16)                  - length of the data.
+                     pBuf (uint8 *)                - the data.
+                     mask (GapAdv_eventMaskFlags_t) - events wanted.
+   Return Value:     (bStatus_t) - SUCCESS, bleNoResources if there is no
+                                   free set, or bleInvalidRange for a bad
+                                   handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GapAdv_create(pfnGapCB_t cb, GapAdv_params_t *advParam,
+                        uint8 *advHandle)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+    int s; /* set index */
+
+    for (s = 0; (s < MAX_ADV_SETS) && pDev->adv[s].used; s++)
+        ;
+    if (s == MAX_ADV_SETS)
+        return bleNoResources;
+
+    memset(&pDev->adv[s], 0, sizeof(bleAdvSet_t));
+    pDev->adv[s].used = true;
+    pDev->adv[s].cb = cb;
+    pDev->adv[s].pParams = advParam;
+    *advHandle = s;
+
+    return SUCCESS;
+}
+
+bStatus_t GapAdv_loadByHandle(uint8 handle, GapAdv_dataTypes_t dataType,
+                              uint16 len, uint8 *pBuf)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    if ((handle >= MAX_ADV_SETS) || !pDev->adv[handle].used)
+        return bleInvalidRange;
+
+    if (dataType == GAP_ADV_DATA_TYPE_ADV)
+    {
+        pDev->adv[handle].pData = pBuf;
+        pDev->adv[handle].dataLen = len;
+    }
+
+    return SUCCESS;
+}
+
+bStatus_t GapAdv_setEventMask(uint8 handle, GapAdv_eventMaskFlags_t mask)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    if ((handle >= MAX_ADV_SETS) || !pDev->adv[handle].used)
+        return bleInvalidRange;
+
+    pDev->adv[handle].mask = mask;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GapAdv_enable(uint8, GapAdv_enableOptions_t, uint16)
+   GapAdv_disable(uint8)
+
+   Description:      These functions start and stop an advertising set of
+                     the calling device.  Advertising goes on until it is
+                     disabled or a link is made with the set.
+   Operation:        The set is enabled or disabled and its
+                     GAP_EVT_ADV_START_AFTER_ENABLE or
+                     GAP_EVT_ADV_END_AFTER_DISABLE event is made pending.
+
+   Arguments:        handle (uint8)                        - the set.
+                     enableOptions (GapAdv_enableOptions_t) - unused.
+                     durationOrMaxEvents (uint16)          - unused.
+   Return Value:     (bStatus_t) - SUCCESS, bleInvalidRange for a bad
+                                   handle, or bleAlreadyInRequestedMode.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GapAdv_enable(uint8 handle, GapAdv_enableOptions_t enableOptions,
+                        uint16 durationOrMaxEvents)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    (void) enableOptions;
+    (void) durationOrMaxEvents;
+
+    if ((handle >= MAX_ADV_SETS) || !pDev->adv[handle].used)
+        return bleInvalidRange;
+    if (pDev->adv[handle].enabled)
+        return bleAlreadyInRequestedMode;
+
+    pDev->adv[handle].enabled = true;
+    pDev->adv[handle].pending |= GAP_EVT_ADV_START_AFTER_ENABLE;
+    needRadio();
+
+    return SUCCESS;
+}
+
+bStatus_t GapAdv_disable(uint8 handle)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    if ((handle >= MAX_ADV_SETS) || !pDev->adv[handle].used)
+        return bleInvalidRange;
+    if (!pDev->adv[handle].enabled)
+        return bleAlreadyInRequestedMode;
+
+    pDev->adv[handle].enabled = false;
+    pDev->adv[handle].pending |= GAP_EVT_ADV_END_AFTER_DISABLE;
+    needRadio();
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GapScan_registerCb(pfnGapCB_t, uintptr_t)
+   GapScan_setEventMask(uint32_t)
+   GapScan_setPhyParams(uint8, uint8, uint16, uint16)
+   GapScan_setParam(GapScan_ParamId_t, void *)
+
+   Description:      These functions set up the scanner of the calling
+                     device: its callback and the events it wants.  The
+                     scanning parameters and filters are not modeled (the
+                     1M PHY is scanned and duplicates are filtered).
+   Operation:        The callback and event mask are kept.
+
+   Arguments:        cb (pfnGapCB_t)      - callback for the events.
+                     arg (uintptr_t)      - argument passed to it.
+                     eventMask (uint32_t) - events wanted.
+                     Other arguments unused.
+   Return Value:     (bStatus_t) - SUCCESS.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GapScan_registerCb(pfnGapCB_t cb, uintptr_t arg)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    pDev->scanCb = cb;
+    pDev->scanArg = arg;
+
+    return SUCCESS;
+}
+
+bStatus_t GapScan_setEventMask(uint32_t eventMask)
+{
+    curDevice()->scanMask = eventMask;
+
+    return SUCCESS;
+}
+
+bStatus_t GapScan_setPhyParams(uint8 primPhys, uint8 type, uint16 interval,
+                               uint16 window)
+{
+    (void) primPhys;
+    (void) type;
+    (void) interval;
+    (void) window;
+
+    return SUCCESS;
+}
+
+bStatus_t GapScan_setParam(GapScan_ParamId_t paramId, void *pValue)
+{
+    (void) paramId;
+    (void) pValue;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GapScan_enable(uint16, uint16, uint8)
+   GapScan_disable(void)
+
+   Description:      These functions start and stop the scanner of the
+                     calling device.  Scanning goes on until it is
+                     disabled (the period and duration are not modeled).
+   Operation:        The scanner is enabled, forgetting the sets reported
+                     (the duplicate filter), or disabled.
+
+   Arguments:        Unused.
+   Return Value:     (bStatus_t) - SUCCESS, or bleIncorrectMode if there is
+                                   no callback or the scanner is already in
+                                   that state.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GapScan_enable(uint16 period, uint16 duration, uint8 maxNumReport)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    (void) period;
+    (void) duration;
+    (void) maxNumReport;
+
+    if ((pDev->scanCb == NULL) || pDev->scanning)
+        return bleIncorrectMode;
+
+    pDev->scanning = true;
+    pDev->reported = 0;
+    needRadio();
+
+    return SUCCESS;
+}
+
+bStatus_t GapScan_disable(void)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    if (!pDev->scanning)
+        return bleIncorrectMode;
+
+    pDev->scanning = false;
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GapInit_setPhyParam(uint8, GapInit_PhyParamId_t, uint16)
+   GapInit_connect(uint8, uint8 *, uint8, uint16)
+
+   Description:      These functions set the interval of the links the
+                     calling device makes and start a connection to an
+                     advertiser.  The link is made when the advertiser is
+                     heard (there is no timeout).
+   Operation:        The largest interval is kept, and the address to
+                     connect to is saved.
+
+   Arguments:        phys (uint8)                    - unused.
+                     paramId (GapInit_PhyParamId_t)  - parameter to set.
+                     value (uint16)                  - its value.
+                     peerAddrType (uint8)            - unused.
+                     pPeerAddress (uint8 *)          - advertiser address.
+                     timeout (uint16)                - unused.
+   Return Value:     (bStatus_t) - SUCCESS, or bleIncorrectMode if it is
+                                   already connecting.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GapInit_setPhyParam(uint8 phys, GapInit_PhyParamId_t paramId,
+                              uint16 value)
+{
+    (void) phys;
+
+    if (paramId == INIT_PHYPARAM_CONN_INT_MAX)
+        curDevice()->connInt = value;
+
+    return SUCCESS;
+}
+
+bStatus_t GapInit_connect(uint8 peerAddrType, uint8 *pPeerAddress,
+                          uint8 phys, uint16 timeout)
+{
+    /* variables */
+    bleDevice_t *pDev = curDevice(); /* the caller */
+
+    (void) peerAddrType;
+    (void) phys;
+    (void) timeout;
+
+    if (pDev->connecting)
+        return bleIncorrectMode;
+
+    pDev->connecting = true;
+    memcpy(pDev->connAddr, pPeerAddress, B_ADDR_LEN);
+    needRadio();
+
+    return SUCCESS;
+}
+
+
+
+/*
+   GATT_bm_alloc(uint16, uint8, uint16, uint16 *)
+   GATT_bm_free(gattMsg_t *, uint8)
+
+   Description:      These functions allocate an ATT payload and free the
+                     payload of a GATT message.  A payload given to a
+                     successful GATT call belongs to the stack.
+   Operation:        Payloads are ICall heap blocks.  The payload freed is
+                     the one the method of the message has (if any), and
+                     its pointer is cleared.
+
+   Arguments:        connHandle (uint16) - unused.
+                     opcode (uint8)      - method of the message.
+                     size (uint16)       - bytes to allocate.
+                     pSizeAlloc (uint16 *) - where to put the size (may be
+                                           NULL).
+                     pMsg (gattMsg_t *)  - the message.
+   Return Value:     (void *) - GATT_bm_alloc returns the payload, NULL if
+                                there is no memory.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                    uint16 *pSizeAlloc)
+{
+    /* variables */
+    void *p; /* the payload */
+
+    (void) connHandle;
+    (void) opcode;
+
+    p = ICall_malloc(size);
+    if (pSizeAlloc != NULL)
+        *pSizeAlloc = (p != NULL) ? size : 0;
+
+    return p;
+}
+
+void GATT_bm_free(gattMsg_t *pMsg, uint8 opcode)
+{
+    switch (opcode)
+    {
+    case ATT_READ_RSP:
+        ICall_free(pMsg->readRsp.pValue);
+        pMsg->readRsp.pValue = NULL;
+        break;
+
+    case ATT_READ_BY_TYPE_RSP:
+        ICall_free(pMsg->readByTypeRsp.pDataList);
+        pMsg->readByTypeRsp.pDataList = NULL;
+        break;
+
+    case ATT_WRITE_REQ:
+    case ATT_WRITE_CMD:
+        ICall_free(pMsg->writeReq.pValue);
+        pMsg->writeReq.pValue = NULL;
+        break;
+
+    case ATT_HANDLE_VALUE_NOTI:
+        ICall_free(pMsg->handleValueNoti.pValue);
+        pMsg->handleValueNoti.pValue = NULL;
+        break;
+
+    default:
+        /* no payload */
+        break;
+    }
+}
+
+
+
+/*
+   GATT_ReadUsingCharUUID(uint16, attReadByTypeReq_t *, uint8)
+   GATT_DiscAllChars(uint16, uint16, uint16, uint8)
+   GATT_ReadCharValue(uint16, attReadReq_t *, uint8)
+   GATT_WriteCharValue(uint16, attWriteReq_t *, uint8)
+   GATT_WriteNoRsp(uint16, attWriteReq_t *)
+
+   Description:      These functions send GATT client requests and write
+                     commands to the server of a link.  The responses come
+                     back to the client as GATT messages.  Discovering the
+                     characteristics takes as many requests as needed and
+                     ends with a response with the status
+                     bleProcedureComplete.
+   Operation:        The request is queued with sendRequest.
+
+   Arguments:        connHandle (uint16)         - the link.
+                     pReq                        - the request.
+                     startHandle, endHandle (uint16) - range discovered.
+                     taskId (uint8)              - unused.
+   Return Value:     (bStatus_t) - SUCCESS, bleNotConnected, blePending (a
+                                   request is outstanding) or
+                                   MSG_BUFFER_NOT_AVAIL (no room).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The payload of a write that isn't sent still belongs
+                     to the caller.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATT_ReadUsingCharUUID(uint16 connHandle, attReadByTypeReq_t *pReq,
+                                 uint8 taskId)
+{
+    /* variables */
+    gattMsg_t msg; /* the request */
+
+    (void) taskId;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.readByTypeReq = *pReq;
+
+    return sendRequest(connHandle, ATT_READ_BY_TYPE_REQ, &msg);
+}
+
+bStatus_t GATT_DiscAllChars(uint16 connHandle, uint16 startHandle,
+                            uint16 endHandle, uint8 taskId)
+{
+    /* variables */
+    gattMsg_t msg; /* the request */
+    bStatus_t status; /* result of sending it */
+
+    (void) taskId;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.readByTypeReq.startHandle = startHandle;
+    msg.readByTypeReq.endHandle = endHandle;
+    msg.readByTypeReq.type.len = ATT_BT_UUID_SIZE;
+    msg.readByTypeReq.type.uuid[0] = characterUUID[0];
+    msg.readByTypeReq.type.uuid[1] = characterUUID[1];
+
+    status = sendRequest(connHandle, ATT_READ_BY_TYPE_REQ, &msg);
+    if (status == SUCCESS)
+    {
+        findLink(connHandle)->discActive = true;
+        findLink(connHandle)->discEnd = endHandle;
+        stats.discoveries++;
+    }
+
+    return status;
+}
+
+bStatus_t GATT_ReadCharValue(uint16 connHandle, attReadReq_t *pReq,
+                             uint8 taskId)
+{
+    /* variables */
+    gattMsg_t msg; /* the request */
+
+    (void) taskId;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.readReq = *pReq;
+
+    return sendRequest(connHandle, ATT_READ_REQ, &msg);
+}
+
+bStatus_t GATT_WriteCharValue(uint16 connHandle, attWriteReq_t *pReq,
+                              uint8 taskId)
+{
+    /* variables */
+    gattMsg_t msg; /* the request */
+
+    (void) taskId;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.writeReq = *pReq;
+
+    return sendRequest(connHandle, ATT_WRITE_REQ, &msg);
+}
+
+bStatus_t GATT_WriteNoRsp(uint16 connHandle, attWriteReq_t *pReq)
+{
+    /* variables */
+    gattMsg_t msg; /* the command */
+
+    memset(&msg, 0, sizeof(msg));
+    msg.writeReq = *pReq;
+
+    return sendRequest(connHandle, ATT_WRITE_CMD, &msg);
+}
+
+
+
+/*
+   GATT_Notification(uint16, attHandleValueNoti_t *, uint8)
+
+   Description:      This function sends a notification to the client of a
+                     link.
+   Operation:        The notification is queued to the client if the
+                     application hasn't filled its share of the buffer.
+
+   Arguments:        connHandle (uint16)            - the link.
+                     pNoti (attHandleValueNoti_t *) - the notification.
+                     authenticated (uint8)          - unused.
+   Return Value:     (bStatus_t) - SUCCESS, bleNotConnected or
+                                   MSG_BUFFER_NOT_AVAIL (no room).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The payload of a notification that isn't sent still
+                     belongs to the caller.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated)
+{
+    /* variables */
+    bleLink_t *pLink = findLink(connHandle); /* the link */
+    gattMsg_t msg; /* the notification */
+
+    (void) authenticated;
+
+    if (pLink == NULL)
+        return bleNotConnected;
+    if (pLink->toClient.count >= RADIO_TX_APP_LIMIT)
+    {
+        stats.txFull++;
+        return MSG_BUFFER_NOT_AVAIL;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.handleValueNoti = *pNoti;
+    ringPut(&pLink->toClient, ATT_HANDLE_VALUE_NOTI, &msg);
+    needRadio();
+
+    return SUCCESS;
+}
+
+
+
+/*
+   osal_memcmp(const void *, const void *, unsigned int)
+
+   Description:      This function compares two blocks of memory.
+   Operation:        memcmp is used.
+
+   Arguments:        src1, src2 (const void *) - the blocks.
+                     len (unsigned int)        - bytes to compare.
+   Return Value:     (uint8) - TRUE if they are the same, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8 osal_memcmp(const void *src1, const void *src2, unsigned int len)
+{
+    return memcmp(src1, src2, len) == 0;
+}
+
+
+
+/*
+   osal_snv_read(osalSnvId_t, osalSnvLen_t, void *)
+   osal_snv_write(osalSnvId_t, osalSnvLen_t, void *)
+
+   Description:      These functions read and write the application's SNV
+                     items (kept in memory for the run).
+   Operation:        The item is copied out of or into the SNV table.
+
+   Arguments:        id (osalSnvId_t)   - the item (BLE_NVID_CUST_START to
+                                          BLE_NVID_CUST_END).
+                     len (osalSnvLen_t) - its length.
+                     pBuf (void *)      - the value.
+   Return Value:     (uint8) - SUCCESS, or NV_OPER_FAILED for a bad item or
+                               length, or an item never written.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8 osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+    /* variables */
+    bleSnvItem_t *pItem; /* the item */
+
+    if ((id < BLE_NVID_CUST_START) || (id > BLE_NVID_CUST_END))
+        return NV_OPER_FAILED;
+    pItem = &snv[id - BLE_NVID_CUST_START];
+    if (!pItem->valid || (len > pItem->len))
+        return NV_OPER_FAILED;
+
+    memcpy(pBuf, pItem->data, len);
+
+    return SUCCESS;
+}
+
+uint8 osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf)
+{
+    /* variables */
+    bleSnvItem_t *pItem; /* the item */
+
+    if ((id < BLE_NVID_CUST_START) || (id > BLE_NVID_CUST_END)
+            || (len > SNV_MAX_LEN))
+        return NV_OPER_FAILED;
+    pItem = &snv[id - BLE_NVID_CUST_START];
+
+    memcpy(pItem->data, pBuf, len);
+    pItem->len = len;
+    pItem->valid = true;
+
+    return SUCCESS;
+}
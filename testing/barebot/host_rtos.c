@@ -0,0 +1,1487 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                host_rtos.c                               */
+/*                       Kernel Stand-Ins on Host Threads                   */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Task, Event, Queue, Clock and Hwi functions
+   declared in testing/shim/ti/sysbios and the Util functions declared in
+   testing/shim/util.h, for the host-side barebot harness.  Every task is a
+   thread, and so are the clock Swi, the loopback radio and the benchmark.
+   Only one of them runs at a time: a thread runs while it holds the "CPU"
+   (a mutex) and gives it up when it waits, so the application code sees
+   the same atomicity it has on the single CPU of the target.  The tasks
+   that are not waiting are counted so the radio and the benchmark can
+   wait for all of them to be idle.  Priorities are not modeled.
+   Functions included are:
+        HostRtos_start        - start the kernel, the caller has the CPU
+        HostRtos_thread       - start a thread that is not a task
+        HostRtos_enter        - take the CPU
+        HostRtos_leave        - give up the CPU
+        HostRtos_wait         - wait on a condition, without the CPU
+        HostRtos_waitIdle     - wait until every task is waiting
+        HostRtos_sleep        - let real time pass, without the CPU
+        HostRtos_usec         - get the time in us
+        Task_Params_init      - set the default task parameters
+        Task_construct        - start a task on a thread of its own
+        Event_Params_init     - set the default event parameters
+        Event_construct       - set up an event
+        Event_handle          - get the handle of an event
+        Event_pend            - wait for events
+        Event_post            - post events
+        Queue_construct       - set up a queue
+        Queue_handle          - get the handle of a queue
+        Queue_empty           - whether a queue is empty
+        Queue_get             - remove the first element of a queue
+        Queue_put             - add an element to the end of a queue
+        Clock_Params_init     - set the default clock parameters
+        Clock_construct       - set up a clock
+        Clock_handle          - get the handle of a clock
+        Clock_start           - start a clock
+        Clock_stop            - stop a clock
+        Clock_isActive        - whether a clock is running
+        Clock_setTimeout      - set the ticks to the first call
+        Clock_setPeriod       - set the ticks between calls
+        Clock_getTicks        - get the tick count
+        Hwi_disable           - disable interrupts (nothing to do here)
+        Hwi_restore           - restore interrupts (nothing to do here)
+        Util_constructClock   - set up a clock with times in ms
+        Util_startClock       - start a clock
+        Util_restartClock     - start a clock with a new timeout in ms
+        Util_isActive         - whether a clock is running
+        Util_stopClock        - stop a clock
+        Util_constructQueue   - set up a queue
+        Util_enqueueMsg       - queue a message and post the queue event
+        Util_dequeueMsg       - remove a message from a queue
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <time.h>
+#include  <errno.h>
+#include  <pthread.h>
+#include  <ti/sysbios/BIOS.h>
+#include  <ti/sysbios/knl/Task.h>
+#include  <ti/sysbios/knl/Event.h>
+#include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/knl/Clock.h>
+#include  <ti/sysbios/hal/Hwi.h>
+#include  <icall.h>
+#include  <util.h>
+
+/* local includes */
+#include "barebot_bench.h"
+
+/* constants */
+#define CLOCK_SLEEP_US  1000            /* time between clock Swi runs */
+
+/* structures */
+
+/* thread waiting on an event (only one task may pend on an event) */
+typedef struct {
+    pthread_cond_t cond;                /* signalled when it may go on */
+    bool        waiting;                /* whether a thread is waiting */
+    bool        isTask;                 /* whether that thread is a task */
+    bool        readied;                /* whether a post satisfied it */
+    UInt32      andMask;                /* events it is waiting for */
+    UInt32      orMask;
+} hostEvent_t;
+
+/* record Util_enqueueMsg puts on a queue for a message */
+typedef struct {
+    Queue_Elem  elem;                   /* queue link (must be first) */
+    uint8_t    *pData;                  /* the message */
+} queueRec_t;
+
+/* shared/global variables */
+
+/* the CPU, and the tasks that are not waiting (signalled when it is 0) */
+static pthread_mutex_t cpu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idleCond = PTHREAD_COND_INITIALIZER;
+static int runnable = 0;
+
+/* threads of the tasks */
+static pthread_t tasks[HOST_MAX_TASKS];
+static int numTasks = 0;
+
+/* clocks constructed, and the time the kernel started */
+static Clock_Struct *clocks = NULL;
+static uint64_t startUsec = 0;
+
+
+
+/* functions */
+
+/*
+   isTask(void)
+
+   Description:      This function returns whether the calling thread is a
+                     task.
+   Operation:        The thread is looked for in the task table.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if the caller is a task, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool isTask(void)
+{
+    /* variables */
+    int i; /* task index */
+
+    for (i = 0; i < numTasks; i++)
+        if (pthread_equal(tasks[i], pthread_self()))
+            return true;
+
+    return false;
+}
+
+
+
+/*
+   runClocks(void *)
+
+   Description:      This function is the clock Swi thread.  It runs the
+                     clock functions that are due, about once a ms.
+   Operation:        The thread sleeps without the CPU, then takes it and
+                     calls every running clock whose next call is at or
+                     before the current tick, setting its next call one
+                     period later.  A clock without a period is stopped.
+
+   Arguments:        arg (void *) - unused.
+   Return Value:     (void *) - never returns.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of clocks.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void *runClocks(void *arg)
+{
+    /* variables */
+    Clock_Struct *pClock; /* clock being checked */
+    uint64_t tick; /* the current tick */
+
+    (void) arg;
+
+    HostRtos_enter();
+    for (;;)
+    {
+        HostRtos_sleep(CLOCK_SLEEP_US / 1000);
+
+        tick = Clock_getTicks();
+        for (pClock = clocks; pClock != NULL; pClock = pClock->next)
+        {
+            if (!pClock->active || (pClock->due > tick))
+                continue;
+
+            if (pClock->period == 0)
+                pClock->active = FALSE;
+            else
+                pClock->due = tick + pClock->period;
+            pClock->fxn(pClock->arg);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/*
+   HostRtos_start(void)
+
+   Description:      This function starts the kernel.  The caller has the
+                     CPU when it returns.
+   Operation:        The start time is recorded, the CPU is taken and the
+                     clock Swi thread is started.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if the thread can't be started.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_start(void)
+{
+    startUsec = HostRtos_usec();
+    HostRtos_enter();
+    HostRtos_thread(runClocks);
+}
+
+
+
+/*
+   HostRtos_thread(void *(*)(void *))
+
+   Description:      This function starts a thread that is not a task (the
+                     radio, the clock Swi).  The thread must take the CPU
+                     with HostRtos_enter before using anything here.
+   Operation:        The thread is created and detached.
+
+   Arguments:        fxn (void *(*)(void *)) - function the thread runs,
+                                               passed NULL.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if the thread can't be started.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_thread(void *(*fxn)(void *))
+{
+    /* variables */
+    pthread_t thread; /* the new thread */
+
+    if (pthread_create(&thread, NULL, fxn, NULL) != 0)
+    {
+        fprintf(stderr, "host_rtos: can't start a thread\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(thread);
+}
+
+
+
+/*
+   HostRtos_enter(void)
+   HostRtos_leave(void)
+
+   Description:      These functions take and give up the CPU.
+   Operation:        The CPU mutex is locked or unlocked.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_enter(void)
+{
+    pthread_mutex_lock(&cpu);
+}
+
+void HostRtos_leave(void)
+{
+    pthread_mutex_unlock(&cpu);
+}
+
+
+
+/*
+   HostRtos_wait(pthread_cond_t *)
+
+   Description:      This function waits on a condition the caller shares
+                     with other threads, giving up the CPU while it waits.
+                     The condition is signalled with the CPU held.
+   Operation:        The condition is waited on with the CPU mutex.
+
+   Arguments:        pCond (pthread_cond_t *) - condition to wait on.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_wait(pthread_cond_t *pCond)
+{
+    pthread_cond_wait(pCond, &cpu);
+}
+
+
+
+/*
+   HostRtos_waitIdle(void)
+
+   Description:      This function waits until every task is waiting (on
+                     an event), so all the work that was posted to them is
+                     done.  It is only called by threads that are not tasks.
+   Operation:        The idle condition is waited on until no task is
+                     runnable.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_waitIdle(void)
+{
+    while (runnable != 0)
+        pthread_cond_wait(&idleCond, &cpu);
+}
+
+
+
+/*
+   HostRtos_sleep(uint32_t)
+
+   Description:      This function lets real time pass, giving up the CPU
+                     meanwhile.
+   Operation:        The CPU is given up, the thread sleeps, and the CPU is
+                     taken again.
+
+   Arguments:        ms (uint32_t) - time to sleep in ms.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HostRtos_sleep(uint32_t ms)
+{
+    /* variables */
+    struct timespec ts; /* time to sleep */
+
+    ts.tv_sec = ms / 1000;
+    ts.tv_nsec = (long) (ms % 1000) * 1000000L;
+
+    HostRtos_leave();
+    while (nanosleep(&ts, &ts) != 0)
+        ;
+    HostRtos_enter();
+}
+
+
+
+/*
+   HostRtos_usec(void)
+
+   Description:      This function returns the time in us.
+   Operation:        The monotonic clock is read.
+
+   Arguments:        None.
+   Return Value:     (uint64_t) - the time in us.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint64_t HostRtos_usec(void)
+{
+    /* variables */
+    struct timespec ts; /* the time */
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+
+
+/*
+   Task_Params_init(Task_Params *)
+
+   Description:      This function sets the default task parameters.
+   Operation:        The arguments are 0, the priority 1, and there is no
+                     stack.
+
+   Arguments:        params (Task_Params *) - parameters to set.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Task_Params_init(Task_Params *params)
+{
+    params->arg0 = 0;
+    params->arg1 = 0;
+    params->priority = 1;
+    params->stack = NULL;
+    params->stackSize = 0;
+}
+
+
+
+/*
+   runTask(void *)
+
+   Description:      This function is the thread of a task.  It takes the
+                     CPU and runs the task function.
+   Operation:        The task function is called with the CPU held.
+
+   Arguments:        arg (void *) - the task (Task_Struct *).
+   Return Value:     (void *) - NULL if the task function returns.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void *runTask(void *arg)
+{
+    /* variables */
+    Task_Struct *obj = arg; /* the task */
+
+    HostRtos_enter();
+    obj->fxn(obj->arg0, obj->arg1);
+
+    /* a task that returns is never runnable again */
+    if (--runnable == 0)
+        pthread_cond_broadcast(&idleCond);
+    HostRtos_leave();
+
+    return NULL;
+}
+
+
+
+/*
+   Task_construct(Task_Struct *, Task_FuncPtr, const Task_Params *,
+                  Error_Block *)
+
+   Description:      This function starts a task.  It is called with the
+                     CPU held, so the task runs once the caller gives the
+                     CPU up.
+   Operation:        The task is filled in, counted as runnable, and its
+                     thread is started and put in the task table.  The
+                     stack in the parameters is not used.
+
+   Arguments:        obj (Task_Struct *)          - the task.
+                     fxn (Task_FuncPtr)           - function the task runs.
+                     params (const Task_Params *) - arguments and priority
+                                                    (NULL for the default).
+                     eb (Error_Block *)           - unused.
+   Return Value:     (Task_Handle) - the task.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there are too many tasks or the
+                     thread can't be started.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Task_Handle Task_construct(Task_Struct *obj, Task_FuncPtr fxn,
+                           const Task_Params *params, Error_Block *eb)
+{
+    /* variables */
+    Task_Params defaults; /* parameters used when none are passed */
+
+    (void) eb;
+
+    if (params == NULL)
+    {
+        Task_Params_init(&defaults);
+        params = &defaults;
+    }
+    obj->fxn = fxn;
+    obj->arg0 = params->arg0;
+    obj->arg1 = params->arg1;
+    obj->priority = params->priority;
+    obj->host = NULL;
+
+    if ((numTasks == HOST_MAX_TASKS)
+            || (pthread_create(&tasks[numTasks], NULL, runTask, obj) != 0))
+    {
+        fprintf(stderr, "host_rtos: can't start a task\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(tasks[numTasks++]);
+    runnable++;
+
+    return obj;
+}
+
+
+
+/*
+   Event_Params_init(Event_Params *)
+
+   Description:      This function sets the default event parameters.
+   Operation:        There are none to set.
+
+   Arguments:        params (Event_Params *) - parameters to set.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Event_Params_init(Event_Params *params)
+{
+    params->unused = 0;
+}
+
+
+
+/*
+   Event_construct(Event_Struct *, const Event_Params *)
+
+   Description:      This function sets up an event with nothing posted.
+   Operation:        The waiter record of the event is allocated and its
+                     condition is set up on the monotonic clock (for the
+                     pend timeouts).
+
+   Arguments:        obj (Event_Struct *)          - the event.
+                     params (const Event_Params *) - unused.
+   Return Value:     (Event_Handle) - the event.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   The harness exits if there is no memory.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Event_Handle Event_construct(Event_Struct *obj, const Event_Params *params)
+{
+    /* variables */
+    hostEvent_t *pWait; /* waiter record */
+    pthread_condattr_t attr; /* condition attributes */
+
+    (void) params;
+
+    pWait = calloc(1, sizeof(hostEvent_t));
+    if (pWait == NULL)
+    {
+        fprintf(stderr, "host_rtos: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pWait->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    obj->posted = 0;
+    obj->host = pWait;
+
+    return obj;
+}
+
+
+
+/*
+   Event_handle(Event_Struct *)
+
+   Description:      This function returns the handle of an event.
+   Operation:        The handle is the event itself.
+
+   Arguments:        obj (Event_Struct *) - the event.
+   Return Value:     (Event_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Event_Handle Event_handle(Event_Struct *obj)
+{
+    return obj;
+}
+
+
+
+/*
+   eventsReady(UInt32, UInt32, UInt32)
+
+   Description:      This function returns the posted events that satisfy
+                     a pend.
+   Operation:        A pend is satisfied when all the events of the and
+                     mask are posted (if there are any), or any event of
+                     the or mask is.
+
+   Arguments:        posted (UInt32)  - events posted.
+                     andMask (UInt32) - events that are all needed.
+                     orMask (UInt32)  - events any of which is enough.
+   Return Value:     (UInt32) - the events that satisfy it, 0 if it isn't.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static UInt32 eventsReady(UInt32 posted, UInt32 andMask, UInt32 orMask)
+{
+    if ((andMask != 0) && ((posted & andMask) == andMask))
+        return posted & (andMask | orMask);
+
+    return posted & orMask;
+}
+
+
+
+/*
+   Event_pend(Event_Handle, UInt32, UInt32, UInt32)
+
+   Description:      This function waits for events to be posted.  The
+                     events that satisfied the pend are consumed and
+                     returned.
+   Operation:        If the pend is not satisfied the caller waits on the
+                     condition of the event, without the CPU and (if it is
+                     a task) no longer runnable, until a post satisfies it
+                     or the timeout passes.  A post that satisfies it makes
+                     the task runnable again, so no one sees every task
+                     idle while it still has work.
+
+   Arguments:        handle (Event_Handle) - the event.
+                     andMask (UInt32)      - events that are all needed.
+                     orMask (UInt32)       - events any of which is enough.
+                     timeout (UInt32)      - ticks to wait, BIOS_NO_WAIT or
+                                             BIOS_WAIT_FOREVER.
+   Return Value:     (UInt32) - the events consumed, 0 on a timeout.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt32 Event_pend(Event_Handle handle, UInt32 andMask, UInt32 orMask,
+                  UInt32 timeout)
+{
+    /* variables */
+    hostEvent_t *pWait = handle->host; /* waiter record */
+    UInt32 events; /* events that satisfied the pend */
+    struct timespec deadline; /* when the pend times out */
+    uint64_t ns; /* deadline in ns */
+    int rc = 0; /* result of the wait */
+
+    if (timeout != BIOS_WAIT_FOREVER)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        ns = (uint64_t) deadline.tv_nsec
+                + (uint64_t) timeout * Clock_tickPeriod * 1000;
+        deadline.tv_sec += ns / 1000000000;
+        deadline.tv_nsec = ns % 1000000000;
+    }
+
+    while ((events = eventsReady(handle->posted, andMask, orMask)) == 0)
+    {
+        if ((timeout == BIOS_NO_WAIT) || (rc == ETIMEDOUT))
+            return 0;
+
+        /* wait for a post, not runnable meanwhile */
+        pWait->waiting = true;
+        pWait->isTask = isTask();
+        pWait->readied = false;
+        pWait->andMask = andMask;
+        pWait->orMask = orMask;
+        if (pWait->isTask && (--runnable == 0))
+            pthread_cond_broadcast(&idleCond);
+
+        if (timeout == BIOS_WAIT_FOREVER)
+            pthread_cond_wait(&pWait->cond, &cpu);
+        else
+            rc = pthread_cond_timedwait(&pWait->cond, &cpu, &deadline);
+
+        /* the post made it runnable, otherwise it makes itself runnable */
+        if (pWait->isTask && !pWait->readied)
+            runnable++;
+        pWait->waiting = false;
+    }
+
+    handle->posted &= ~events;
+
+    return events;
+}
+
+
+
+/*
+   Event_post(Event_Handle, UInt32)
+
+   Description:      This function posts events.
+   Operation:        The events are added to the posted ones.  If that
+                     satisfies the thread waiting on the event it is made
+                     runnable and woken.
+
+   Arguments:        handle (Event_Handle) - the event.
+                     eventMask (UInt32)    - events to post.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Event_post(Event_Handle handle, UInt32 eventMask)
+{
+    /* variables */
+    hostEvent_t *pWait = handle->host; /* waiter record */
+
+    handle->posted |= eventMask;
+
+    if (pWait->waiting && !pWait->readied
+            && (eventsReady(handle->posted, pWait->andMask, pWait->orMask)
+                    != 0))
+    {
+        pWait->readied = true;
+        if (pWait->isTask)
+            runnable++;
+        pthread_cond_signal(&pWait->cond);
+    }
+}
+
+
+
+/*
+   Queue_construct(Queue_Struct *, const Queue_Params *)
+
+   Description:      This function sets up an empty queue.
+   Operation:        The head links to itself.
+
+   Arguments:        obj (Queue_Struct *)          - the queue.
+                     params (const Queue_Params *) - unused.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Doubly linked circular list.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Queue_construct(Queue_Struct *obj, const Queue_Params *params)
+{
+    (void) params;
+
+    obj->elem.next = &obj->elem;
+    obj->elem.prev = &obj->elem;
+}
+
+
+
+/*
+   Queue_handle(Queue_Struct *)
+
+   Description:      This function returns the handle of a queue.
+   Operation:        The handle is the queue itself.
+
+   Arguments:        obj (Queue_Struct *) - the queue.
+   Return Value:     (Queue_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Queue_Handle Queue_handle(Queue_Struct *obj)
+{
+    return obj;
+}
+
+
+
+/*
+   Queue_empty(Queue_Handle)
+
+   Description:      This function returns whether a queue is empty.
+   Operation:        The queue is empty when the head links to itself.
+
+   Arguments:        handle (Queue_Handle) - the queue.
+   Return Value:     (Bool) - TRUE if it is empty, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Doubly linked circular list.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Bool Queue_empty(Queue_Handle handle)
+{
+    return handle->elem.next == &handle->elem;
+}
+
+
+
+/*
+   Queue_get(Queue_Handle)
+
+   Description:      This function removes the first element of a queue.
+   Operation:        The element after the head is unlinked.  On an empty
+                     queue that is the head, which is returned without
+                     changing anything.
+
+   Arguments:        handle (Queue_Handle) - the queue.
+   Return Value:     (Ptr) - the element, the queue if it is empty.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Doubly linked circular list.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Ptr Queue_get(Queue_Handle handle)
+{
+    /* variables */
+    Queue_Elem *pElem = handle->elem.next; /* element removed */
+
+    handle->elem.next = pElem->next;
+    pElem->next->prev = &handle->elem;
+
+    return pElem;
+}
+
+
+
+/*
+   Queue_put(Queue_Handle, Queue_Elem *)
+
+   Description:      This function adds an element to the end of a queue.
+   Operation:        The element is linked in before the head.
+
+   Arguments:        handle (Queue_Handle) - the queue.
+                     elem (Queue_Elem *)   - the element.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Doubly linked circular list.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Queue_put(Queue_Handle handle, Queue_Elem *elem)
+{
+    elem->next = &handle->elem;
+    elem->prev = handle->elem.prev;
+    handle->elem.prev->next = elem;
+    handle->elem.prev = elem;
+}
+
+
+
+/*
+   Clock_Params_init(Clock_Params *)
+
+   Description:      This function sets the default clock parameters.
+   Operation:        The clock is one-shot, not started, with argument 0.
+
+   Arguments:        params (Clock_Params *) - parameters to set.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_Params_init(Clock_Params *params)
+{
+    params->period = 0;
+    params->startFlag = FALSE;
+    params->arg = 0;
+}
+
+
+
+/*
+   Clock_construct(Clock_Struct *, Clock_FuncPtr, UInt32,
+                   const Clock_Params *)
+
+   Description:      This function sets up a clock and starts it if the
+                     parameters say to.
+   Operation:        The clock is filled in and added to the clock list.
+
+   Arguments:        obj (Clock_Struct *)          - the clock.
+                     fxn (Clock_FuncPtr)           - function to call.
+                     timeout (UInt32)              - ticks to the first call.
+                     params (const Clock_Params *) - period, start flag and
+                                                     argument (NULL for the
+                                                     default).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of clocks.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn, UInt32 timeout,
+                     const Clock_Params *params)
+{
+    /* variables */
+    Clock_Params defaults; /* parameters used when none are passed */
+
+    if (params == NULL)
+    {
+        Clock_Params_init(&defaults);
+        params = &defaults;
+    }
+    obj->fxn = fxn;
+    obj->arg = params->arg;
+    obj->timeout = timeout;
+    obj->period = params->period;
+    obj->active = FALSE;
+    obj->next = clocks;
+    clocks = obj;
+
+    if (params->startFlag)
+        Clock_start(obj);
+}
+
+
+
+/*
+   Clock_handle(Clock_Struct *)
+
+   Description:      This function returns the handle of a clock.
+   Operation:        The handle is the clock itself.
+
+   Arguments:        obj (Clock_Struct *) - the clock.
+   Return Value:     (Clock_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Clock_Handle Clock_handle(Clock_Struct *obj)
+{
+    return obj;
+}
+
+
+
+/*
+   Clock_start(Clock_Handle)
+   Clock_stop(Clock_Handle)
+   Clock_isActive(Clock_Handle)
+
+   Description:      These functions start a clock (its first call is the
+                     timeout from now), stop it, and return whether it is
+                     running.
+   Operation:        The active flag and next call of the clock are set or
+                     returned.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+   Return Value:     (Bool) - Clock_isActive returns TRUE if the clock is
+                              running, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_start(Clock_Handle handle)
+{
+    handle->due = (uint64_t) Clock_getTicks() + handle->timeout;
+    handle->active = TRUE;
+}
+
+void Clock_stop(Clock_Handle handle)
+{
+    handle->active = FALSE;
+}
+
+Bool Clock_isActive(Clock_Handle handle)
+{
+    return handle->active;
+}
+
+
+
+/*
+   Clock_setTimeout(Clock_Handle, UInt32)
+   Clock_setPeriod(Clock_Handle, UInt32)
+
+   Description:      These functions set the ticks to the first call and
+                     between calls of a clock, for the next time it is
+                     started.
+   Operation:        The field of the clock is set.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+                     timeout/period (UInt32) - the ticks.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+    handle->timeout = timeout;
+}
+
+void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+    handle->period = period;
+}
+
+
+
+/*
+   Clock_getTicks(void)
+
+   Description:      This function returns the ticks since the kernel
+                     started.
+   Operation:        The real time since the start is divided by the tick
+                     period.
+
+   Arguments:        None.
+   Return Value:     (UInt32) - the tick count.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt32 Clock_getTicks(void)
+{
+    return (UInt32) ((HostRtos_usec() - startUsec) / Clock_tickPeriod);
+}
+
+
+
+/*
+   Hwi_disable(void)
+   Hwi_restore(UInt)
+
+   Description:      These functions disable and restore interrupts.
+   Operation:        Nothing to do, only the thread with the CPU runs.
+
+   Arguments:        key (UInt) - unused.
+   Return Value:     (UInt) - Hwi_disable returns 0.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt Hwi_disable(void)
+{
+    return 0;
+}
+
+void Hwi_restore(UInt key)
+{
+    (void) key;
+}
+
+
+
+/*
+   Util_constructClock(Clock_Struct *, Clock_FuncPtr, uint32_t, uint32_t,
+                       uint8_t, UArg)
+
+   Description:      This function sets up a clock with its times in ms.
+   Operation:        The times are converted to ticks and the clock is
+                     constructed.
+
+   Arguments:        pClock (Clock_Struct *)  - the clock.
+                     clockCB (Clock_FuncPtr)  - function to call.
+                     clockDuration (uint32_t) - ms to the first call.
+                     clockPeriod (uint32_t)   - ms between calls (0 for one).
+                     startFlag (uint8_t)      - whether to start it now.
+                     arg (UArg)               - argument for the function.
+   Return Value:     (Clock_Handle) - the clock.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Clock_Handle Util_constructClock(Clock_Struct *pClock, Clock_FuncPtr clockCB,
+                                 uint32_t clockDuration, uint32_t clockPeriod,
+                                 uint8_t startFlag, UArg arg)
+{
+    /* variables */
+    Clock_Params params; /* clock parameters */
+
+    Clock_Params_init(&params);
+    params.period = clockPeriod * 1000 / Clock_tickPeriod;
+    params.startFlag = startFlag;
+    params.arg = arg;
+    Clock_construct(pClock, clockCB, clockDuration * 1000 / Clock_tickPeriod,
+                    &params);
+
+    return pClock;
+}
+
+
+
+/*
+   Util_startClock(Clock_Struct *)
+   Util_restartClock(Clock_Struct *, uint32_t)
+   Util_isActive(Clock_Struct *)
+   Util_stopClock(Clock_Struct *)
+
+   Description:      These functions start a clock, start it with a new
+                     timeout, return whether it is running, and stop it.
+   Operation:        The Clock functions are called, converting the timeout
+                     from ms to ticks.
+
+   Arguments:        pClock (Clock_Struct *) - the clock.
+                     clockTimeout (uint32_t) - ms to the first call.
+   Return Value:     (bool) - Util_isActive returns TRUE if the clock is
+                              running, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Util_startClock(Clock_Struct *pClock)
+{
+    Clock_start(pClock);
+}
+
+void Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout)
+{
+    Clock_stop(pClock);
+    Clock_setTimeout(pClock, clockTimeout * 1000 / Clock_tickPeriod);
+    Clock_start(pClock);
+}
+
+bool Util_isActive(Clock_Struct *pClock)
+{
+    return Clock_isActive(pClock);
+}
+
+void Util_stopClock(Clock_Struct *pClock)
+{
+    Clock_stop(pClock);
+}
+
+
+
+/*
+   Util_constructQueue(Queue_Struct *)
+
+   Description:      This function sets up an empty queue.
+   Operation:        The queue is constructed.
+
+   Arguments:        pQueue (Queue_Struct *) - the queue.
+   Return Value:     (Queue_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Queue_Handle Util_constructQueue(Queue_Struct *pQueue)
+{
+    Queue_construct(pQueue, NULL);
+
+    return Queue_handle(pQueue);
+}
+
+
+
+/*
+   Util_enqueueMsg(Queue_Handle, Event_Handle, uint8_t *)
+
+   Description:      This function queues a message and posts the queue
+                     event, as in the SDK: the message is put on the queue
+                     in a record allocated from the ICall heap.
+   Operation:        A record is allocated and holds the message, it is
+                     put on the queue and UTIL_QUEUE_EVENT_ID is posted.
+
+   Arguments:        msgQueue (Queue_Handle) - queue to put it on.
+                     event (Event_Handle)    - event to post (may be NULL).
+                     pMsg (uint8_t *)        - the message.
+   Return Value:     (uint8_t) - TRUE if it was queued, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   If there is no memory for the record the message is
+                     freed and FALSE is returned.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8_t Util_enqueueMsg(Queue_Handle msgQueue, Event_Handle event,
+                        uint8_t *pMsg)
+{
+    /* variables */
+    queueRec_t *pRec; /* record for the message */
+
+    pRec = ICall_malloc(sizeof(queueRec_t));
+    if (pRec == NULL)
+    {
+        ICall_free(pMsg);
+        return FALSE;
+    }
+
+    pRec->pData = pMsg;
+    Queue_put(msgQueue, &pRec->elem);
+    if (event != NULL)
+        Event_post(event, UTIL_QUEUE_EVENT_ID);
+
+    return TRUE;
+}
+
+
+
+/*
+   Util_dequeueMsg(Queue_Handle)
+
+   Description:      This function removes a message from a queue.
+   Operation:        The first record is removed, and the message taken
+                     from it before it is freed.
+
+   Arguments:        msgQueue (Queue_Handle) - the queue.
+   Return Value:     (uint8_t *) - the message, NULL if it is empty.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8_t *Util_dequeueMsg(Queue_Handle msgQueue)
+{
+    /* variables */
+    queueRec_t *pRec; /* record removed */
+    uint8_t *pData; /* its message */
+
+    pRec = Queue_get(msgQueue);
+    if ((Queue_Handle) pRec == msgQueue)
+        return NULL;
+
+    pData = pRec->pData;
+    ICall_free(pRec);
+
+    return pData;
+}
@@ -0,0 +1,64 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              ti_ble_config.h                             */
+/*                    Host Stand-In for the SysConfig BLE Setup             */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the BLE settings SysConfig generates for the barebot
+   server and client (barebot_server.syscfg and barebot_client.syscfg), so
+   both can be compiled into the host-side barebot harness.  There is one
+   copy of the settings for both: the advertising sets and addresses are
+   the server's, the scanner and initiator settings are the client's
+   defaults.  The data is defined in ble_config.c.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_BLE_CONFIG_H
+    #define TI_BLE_CONFIG_H
+
+#include  <bcomdef.h>
+#include  <icall_ble_api.h>
+
+/* constants */
+
+/* device */
+#define MAX_NUM_BLE_CONNS                   8
+#define GAP_DEVICE_NAME_LEN                 (20 + 1)
+#define DEFAULT_ADDRESS_MODE                ADDRMODE_RANDOM
+
+/* link parameter update requests from the peer are accepted */
+#define DEFAULT_PARAM_UPDATE_REQ_DECISION   GAP_UPDATE_REQ_ACCEPT_ALL
+
+/* scanner (interval and window in 0.625 ms, duration in 10 ms) */
+#define DEFAULT_SCAN_PHY                    SCAN_PRIM_PHY_1M
+#define DEFAULT_SCAN_TYPE                   SCAN_TYPE_ACTIVE
+#define DEFAULT_SCAN_INTERVAL               800
+#define DEFAULT_SCAN_WINDOW                 800
+#define DEFAULT_SCAN_DURATION               1000
+#define ADV_RPT_FIELDS                      (SCAN_ADVRPT_FLD_ADDRESS | \
+                                             SCAN_ADVRPT_FLD_ADDRTYPE)
+#define SCANNER_DUPLICATE_FILTER            SCAN_FLT_DUP_ENABLE
+
+/* initiator (connection interval in 1.25 ms) */
+#define DEFAULT_INIT_PHY                    INIT_PHY_1M
+#define INIT_PHYPARAM_MIN_CONN_INT          80
+#define INIT_PHYPARAM_MAX_CONN_INT          80
+
+/* shared/global variables (ble_config.c) */
+
+/* device name and random address */
+extern uint8_t attDeviceName[GAP_DEVICE_NAME_LEN];
+extern uint8_t pRandomAddress[B_ADDR_LEN];
+
+/* advertising set 1 (legacy) and 2 (long range) */
+extern GapAdv_params_t advParams1;
+extern uint8_t advData1[11];
+extern uint8_t scanResData1[25];
+extern GapAdv_params_t advParams2;
+extern uint8_t advData2[11];
+
+#endif
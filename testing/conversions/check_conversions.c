@@ -0,0 +1,381 @@
+/****************************************************************************/
+/*                                                                          */
+/*                           check_conversions.c                            */
+/*                      IntToString Host-Side Checker                       */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a host program that checks a model of IntToString
+   (lib/conversions.s) against the strings it replaced and against the C
+   library.  It is built and run with "make" in this directory.  Functions
+   included are:
+        main - run all the checks
+
+   Local functions:
+        IntToString     - model of IntToString in lib/conversions.s
+        CheckReciprocal - check the divide by 10 for every 32-bit value
+        CheckAngleTable - check the old AngleToAscii strings
+        CheckPrintf     - check against snprintf
+
+   The model does what the assembly does step by step (UMULL by the
+   reciprocal, MLS for the remainder, the digits stored backwards, then
+   copied out with the sign and the padding), so a change to the assembly
+   has to be made here too.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+/* constants, the same as in lib/conversions.s */
+#define  RECIP_10           0xCCCCCCCDu /* round_up(2^35 / 10) */
+#define  RECIP_10_SHIFT     3           /* 35 - 32 */
+#define  BASE               10
+#define  DIGIT_BUFFER_SIZE  12          /* 10 digits and a sign, aligned */
+
+/* constants of the old AngleToAscii table */
+#define  MIN_ANGLE          -359        /* first string in the table */
+#define  MAX_ANGLE          359         /* last string in the table */
+#define  ANGLE_WIDTH        4           /* width AngleToAscii passes */
+
+#define  STRING_SIZE        32          /* room for any string checked */
+#define  LINE_SIZE          128         /* longest line read from the table */
+
+/* local functions */
+static void IntToString(int32_t value, char *str, int32_t width);
+static int CheckReciprocal(void);
+static int CheckAngleTable(const char *fileName);
+static int CheckPrintf(void);
+
+
+
+/* functions */
+
+/*
+   main(int, char *[])
+
+   Description:      This function runs all the checks and prints how they
+                     went.
+   Operation:        Each check is run and the number of errors is added up.
+
+   Arguments:        argc (int) - number of arguments.
+                     argv (char *[]) - arguments, argv[1] is the file with
+                        the old AngleToAscii strings (angle_table.inc).
+   Return Value:     0 if every check passed, 1 otherwise.
+   Exceptions:       None.
+
+   Inputs:           The old AngleToAscii strings.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int main(int argc, char *argv[])
+{
+    /* variables */
+    int errors = 0; /* number of failed checks */
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s angle_table.inc\n", argv[0]);
+        return 1;
+    }
+
+    errors += CheckReciprocal();
+    errors += CheckAngleTable(argv[1]);
+    errors += CheckPrintf();
+
+    printf("%s\n", (errors == 0) ? "all checks passed" : "CHECKS FAILED");
+    return (errors == 0) ? 0 : 1;
+}
+
+
+
+/*
+   IntToString(int32_t, char *, int32_t)
+
+   Description:      This function converts a signed 32-bit integer to a NUL
+                     terminated decimal string, left justified and padded
+                     with spaces to the passed width, the same way as
+                     IntToString in lib/conversions.s.
+   Operation:        The absolute value is divided by 10 repeatedly with a
+                     multiply by the reciprocal, the remainders are stored
+                     backwards in a buffer, then the sign is added and the
+                     buffer is copied out backwards, followed by the padding
+                     and the NUL.
+
+   Arguments:        value (int32_t) - integer to convert.
+                     str (char *) - buffer for the string.
+                     width (int32_t) - width to pad to (0 for no padding).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       Division by 10 with the reciprocal (UMULL and LSR).
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void IntToString(int32_t value, char *str, int32_t width)
+{
+    /* variables */
+    char digits[DIGIT_BUFFER_SIZE]; /* digits from the least significant */
+    char *pDigit = digits; /* next free byte in digits */
+    uint32_t sign; /* all ones if negative, otherwise 0 */
+    uint32_t absValue; /* |value| (unsigned, so INT32_MIN works) */
+    uint32_t quotient; /* absValue / 10 */
+
+    /* ASR, EOR and SUB */
+    sign = (uint32_t) (value >> 31);
+    absValue = ((uint32_t) value ^ sign) - sign;
+
+    /* UMULL, LSR and MLS for each digit */
+    do
+    {
+        quotient = (uint32_t) (((uint64_t) absValue * RECIP_10) >> 32)
+                >> RECIP_10_SHIFT;
+        *pDigit++ = (char) ('0' + (absValue - quotient * BASE));
+        absValue = quotient;
+    }
+    while (absValue != 0);
+
+    if (sign != 0)
+        *pDigit++ = '-';
+
+    /* padding needed, then copy the digits out backwards and pad */
+    width -= (int32_t) (pDigit - digits);
+    while (pDigit != digits)
+        *str++ = *--pDigit;
+    for (; width > 0; width--)
+        *str++ = ' ';
+    *str = '\0';
+}
+
+
+
+/*
+   CheckReciprocal(void)
+
+   Description:      This function checks that the divide by 10 with
+                     RECIP_10 gives the same result as a real divide for
+                     every 32-bit unsigned value.
+   Operation:        Every value is divided both ways and compared.
+
+   Arguments:        None.
+   Return Value:     1 if any value is wrong, 0 otherwise.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   The first wrong value is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckReciprocal(void)
+{
+    /* variables */
+    uint32_t x = 0; /* value being divided */
+    uint32_t quotient; /* x / 10 with the reciprocal */
+
+    do
+    {
+        quotient = (uint32_t) (((uint64_t) x * RECIP_10) >> 32)
+                >> RECIP_10_SHIFT;
+        if (quotient != x / BASE)
+        {
+            printf("reciprocal: %lu / 10 gave %lu\n", (unsigned long) x,
+                   (unsigned long) quotient);
+            return 1;
+        }
+    }
+    while (++x != 0);
+
+    printf("reciprocal: all 2^32 values divide exactly\n");
+    return 0;
+}
+
+
+
+/*
+   CheckAngleTable(const char *)
+
+   Description:      This function checks that IntToString with the width
+                     AngleToAscii passes gives exactly the strings of the
+                     old AngleToAscii table.
+   Operation:        Every .cstring line of the file is read, its angle is
+                     taken from the label (smN is -N, ssN is N) and the
+                     string is compared with IntToString of the angle.  Then
+                     every angle in [MIN_ANGLE, MAX_ANGLE] is checked to have
+                     had exactly one string.
+
+   Arguments:        fileName (const char *) - file with the old strings.
+   Return Value:     Number of errors.
+   Exceptions:       None.
+
+   Inputs:           The old AngleToAscii strings.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   Every mismatch is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckAngleTable(const char *fileName)
+{
+    /* variables */
+    FILE *pFile; /* file with the old strings */
+    char line[LINE_SIZE]; /* line read from the file */
+    char label[LINE_SIZE]; /* label of the string */
+    char old[LINE_SIZE]; /* old string */
+    char new[STRING_SIZE]; /* string from IntToString */
+    int seen[MAX_ANGLE - MIN_ANGLE + 1] = { 0 }; /* strings for each angle */
+    int32_t angle; /* angle of the string */
+    int count = 0; /* number of strings read */
+    int errors = 0; /* number of errors */
+
+    pFile = fopen(fileName, "r");
+    if (pFile == NULL)
+    {
+        perror(fileName);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), pFile) != NULL)
+    {
+        /* only the string lines, "smN: .cstring "..."" */
+        if (sscanf(line, "%[a-z0-9]: .cstring \"%[^\"]\"", label, old) != 2)
+            continue;
+
+        angle = (int32_t) strtol(label + 2, NULL, 10);
+        if (strncmp(label, "sm", 2) == 0)
+            angle = -angle;
+        if ((angle < MIN_ANGLE) || (angle > MAX_ANGLE))
+        {
+            printf("angle table: %s is out of range\n", label);
+            errors++;
+            continue;
+        }
+        seen[angle - MIN_ANGLE]++;
+        count++;
+
+        IntToString(angle, new, ANGLE_WIDTH);
+        if (strcmp(old, new) != 0)
+        {
+            printf("angle table: %ld was \"%s\", now \"%s\"\n", (long) angle,
+                   old, new);
+            errors++;
+        }
+    }
+    fclose(pFile);
+
+    for (angle = MIN_ANGLE; angle <= MAX_ANGLE; angle++)
+    {
+        if (seen[angle - MIN_ANGLE] != 1)
+        {
+            printf("angle table: %ld has %d strings\n", (long) angle,
+                   seen[angle - MIN_ANGLE]);
+            errors++;
+        }
+    }
+
+    printf("angle table: %d strings compared, %d errors\n", count, errors);
+    return errors;
+}
+
+
+
+/*
+   CheckPrintf(void)
+
+   Description:      This function checks IntToString against snprintf
+                     with "%-*ld" for the values and widths most likely to
+                     go wrong.
+   Operation:        Every value in [-100000, 100000], the values next to
+                     each power of 10 and the extreme values are converted
+                     with widths 0 to 12 and compared.
+
+   Arguments:        None.
+   Return Value:     Number of errors.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   The first mismatches are printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckPrintf(void)
+{
+    /* variables */
+    static const int32_t extremes[] = { INT32_MIN, INT32_MIN + 1,
+                                        INT32_MAX - 1, INT32_MAX, -1, 0, 1 };
+    int64_t values[256]; /* values around the powers of 10 and extremes */
+    int nValues = 0; /* number of values in values */
+    int64_t power; /* power of 10 */
+    int64_t value; /* value to convert */
+    char expected[STRING_SIZE]; /* string from snprintf */
+    char got[STRING_SIZE]; /* string from IntToString */
+    int32_t width; /* width to pad to */
+    int compared = 0; /* number of strings compared */
+    int errors = 0; /* number of errors */
+    int i; /* index into values */
+
+    for (power = 1; power <= INT32_MAX; power *= BASE)
+    {
+        values[nValues++] = power - 1;
+        values[nValues++] = power;
+        values[nValues++] = -power;
+        values[nValues++] = -(power - 1);
+    }
+    for (i = 0; i < (int) (sizeof(extremes) / sizeof(extremes[0])); i++)
+        values[nValues++] = extremes[i];
+
+    for (value = -100000; value <= 100000 + nValues; value++)
+    {
+        /* the range first, then the special values */
+        int32_t v = (int32_t) ((value <= 100000) ?
+                value : values[value - 100001]);
+
+        for (width = 0; width <= DIGIT_BUFFER_SIZE; width++)
+        {
+            snprintf(expected, sizeof(expected), "%-*ld", (int) width,
+                     (long) v);
+            IntToString(v, got, width);
+            compared++;
+            if ((strcmp(expected, got) != 0) && (errors++ < 10))
+                printf("printf: %ld width %ld gave \"%s\", not \"%s\"\n",
+                       (long) v, (long) width, got, expected);
+        }
+    }
+
+    printf("printf: %d strings compared, %d errors\n", compared, errors);
+    return errors;
+}
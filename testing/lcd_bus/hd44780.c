@@ -0,0 +1,1054 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                hd44780.c                                 */
+/*                         HD44780 Controller Model                         */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a model of the HD44780 LCD controller on an 8-bit bus,
+   for the host-side LCD bus harness.  It watches the pins on every write
+   to DOUT or DOE, checks the bus timing on every edge, runs the
+   instructions, and drives the data pins on reads.  Functions included
+   are:
+        HD44780Pins       - the MCU changed the pins
+        HD44780Din        - the data pins the LCD drives
+        HD44780GetStats   - get the bus counts and shortest times
+        HD44780Cell       - get the character at a display position
+        HD44780Cgram      - get a byte of the CGRAM
+        HD44780Row        - render a row of the display
+        HD44780DisplayOn  - whether the display is turned on
+        HD44780LogClear   - start a new log of E pulses
+        HD44780LogPrint   - print the log of E pulses
+
+   Local functions:
+        ERise      - E went high
+        EFall      - E went low
+        Execute    - run a written instruction or data write
+        MoveAc     - move the address counter after a data access
+        Busy       - whether an instruction is still running
+        Shorter    - whether cycles are shorter than a time in ns
+        Ns         - convert cycles to ns
+        Violation  - report a timing or protocol violation
+        Describe   - describe a bus operation
+
+   The timing limits are from the HD44780U data sheet for VCC = 2.7 to
+   4.5 V, the same ones the LCD code was written for (450 ns E pulses).
+   The display is 4 rows of 16 characters in 2-line mode, rows 2 and 3
+   being the second half of lines 1 and 2.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdarg.h>
+#include  <stdio.h>
+#include  <string.h>
+
+/* local includes */
+#include "lcd_bus.h"
+
+/* bus timing limits in ns */
+#define T_CYCE              1000        /* E cycle time */
+#define T_PWEH              450         /* E high */
+#define T_AS                60          /* RS, R/W setup to E rise */
+#define T_AH                20          /* RS, R/W hold after E fall */
+#define T_DSW               195         /* data setup to E fall */
+#define T_H                 10          /* data hold after E fall */
+#define T_DDR               360         /* E rise to read data valid */
+#define T_DHR               5           /* read data held after E fall */
+
+/* execution times in ns (fcp = 270 kHz) */
+#define T_EXEC              37000       /* most instructions and data */
+#define T_EXEC_SLOW         1520000     /* clear display and return home */
+#define T_POWER_ON          15000000    /* power on to the first instruction */
+#define T_INIT_1            4100000     /* after the first function set */
+#define T_INIT_2            100000      /* after the second function set */
+
+/* instructions (the highest bit set selects the instruction) */
+#define INS_CLEAR           0x01
+#define INS_HOME            0x02
+#define INS_ENTRY_MODE      0x04
+#define INS_ENTRY_INC       0x02        /*    increment the address */
+#define INS_ENTRY_SHIFT     0x01        /*    shift the display on writes */
+#define INS_DISPLAY         0x08
+#define INS_DISPLAY_ON      0x04        /*    display on */
+#define INS_SHIFT           0x10
+#define INS_SHIFT_DISPLAY   0x08        /*    shift the display, not cursor */
+#define INS_SHIFT_RIGHT     0x04        /*    shift right */
+#define INS_FUNCTION        0x20
+#define INS_FUNCTION_8BIT   0x10        /*    8-bit interface */
+#define INS_FUNCTION_2LINE  0x08        /*    2-line display */
+#define INS_SET_CGRAM       0x40
+#define INS_SET_DDRAM       0x80
+
+/* memories */
+#define DDRAM_SIZE          0x80        /* addresses of the DDRAM */
+#define DDRAM_LINE_LEN      0x28        /* characters in a line */
+#define DDRAM_LINE_2        0x40        /* address of the second line */
+#define CGRAM_SIZE          0x40        /* addresses of the CGRAM */
+#define CGRAM_CHARS         0x10        /* character codes from the CGRAM */
+#define CGRAM_SLOTS         8           /* characters in the CGRAM */
+
+#define DATA_PINS           (DATA_MASK << DATA_0_PIN)
+
+/* reporting */
+#define LOG_SIZE            512         /* E pulses kept in the log */
+#define MAX_REPORTED        20          /* violations printed */
+#define DESCRIPTION_SIZE    40          /* longest description of an op */
+
+/* structures */
+
+/* a logged E pulse */
+typedef struct {
+    uint64_t rise;                      /* cycle E went high */
+    uint64_t fall;                      /* cycle E went low */
+    bool     rs;                        /* register select */
+    bool     rw;                        /* read (TRUE) or write */
+    uint8_t  data;                      /* byte written or read */
+    bool     busy;                      /* written while busy */
+} pulse_t;
+
+/* shared/global variables */
+
+/* controller state: memories, address counter (and whether it points to */
+/*    CGRAM), entry mode, display state, function sets seen, and the cycle */
+/*    the running instruction ends */
+static uint8_t ddram[DDRAM_SIZE];
+static uint8_t cgram[CGRAM_SIZE];
+static uint8_t ac = 0;
+static bool acCgram = false;
+static bool increment = true;
+static bool shiftOnWrite = false;
+static uint8_t displayShift = 0;
+static bool displayOn = false;
+static uint32_t functionSets = 0;
+static uint64_t busyUntil = (uint64_t) T_POWER_ON * SIM_CPU_MHZ / 1000;
+
+/* pins: E, RS and R/W, data pins driven by the MCU and their enables */
+static bool pinE = false;
+static bool pinRs = false;
+static bool pinRw = false;
+static uint32_t busData = 0;
+static uint32_t busDoe = 0;
+
+/* bus timing: when the edges and changes were, whether the hold times */
+/*    still have to be checked, and the pulse on the bus */
+static uint64_t tRise = 0;
+static uint64_t tFall = 0;
+static uint64_t tControl = 0;
+static uint64_t tData = 0;
+static bool risen = false;
+static bool controlHold = false;
+static bool dataHold = false;
+static pulse_t pulse;
+
+/* counts, shortest times, and the log */
+static hd44780Stats_t stats = { 0, 0, 0, UINT32_MAX, UINT32_MAX,
+        UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, 0, 0 };
+static pulse_t pulseLog[LOG_SIZE];
+static uint32_t logCount = 0;
+
+/* local functions */
+static void ERise(uint64_t now);
+static void EFall(uint64_t now);
+static void Execute(bool rs, uint8_t data, uint64_t now);
+static void MoveAc(void);
+static bool Busy(uint64_t now);
+static bool Shorter(uint64_t cycles, uint32_t ns, uint32_t *pMin);
+static uint32_t Ns(uint64_t cycles);
+static void Violation(uint64_t now, const char *fmt, ...);
+static void Describe(const pulse_t *pPulse, char *buf);
+
+
+
+/* functions */
+
+/*
+   HD44780Pins(uint32_t, uint32_t)
+
+   Description:      This function is called whenever the MCU changes the
+                     pins (DOUT or DOE written).
+   Operation:        A change of RS or R/W is checked against the hold time
+                     after the last E fall (and not allowed while E is
+                     high).  A change of the data pins driven by the MCU is
+                     checked against the data hold time after the last E
+                     fall.  Driving the data pins while the LCD drives them
+                     is bus contention.  Then an E edge is handled.
+
+   Arguments:        dout (uint32_t) - GPIO DOUT.
+                     doe (uint32_t) - GPIO DOE.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Violations are reported.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HD44780Pins(uint32_t dout, uint32_t doe)
+{
+    /* variables */
+    uint64_t now = simCycles; /* time of the change */
+    bool e = ((dout >> E_PIN) & 1) != 0; /* new pin values */
+    bool rs = ((dout >> RS_PIN) & 1) != 0;
+    bool rw = ((dout >> RW_PIN) & 1) != 0;
+    uint32_t data = dout & doe & DATA_PINS;
+    uint32_t dataDoe = doe & DATA_PINS;
+
+    /* RS and R/W */
+    if ((rs != pinRs) || (rw != pinRw))
+    {
+        if (pinE)
+            Violation(now, "RS or R/W changed while E is high");
+        else if (controlHold && Shorter(now - tFall, T_AH, &stats.minAH))
+            Violation(now, "tAH %lu ns < %d ns", (unsigned long) Ns(now - tFall),
+                      T_AH);
+        controlHold = false;
+        pinRs = rs;
+        pinRw = rw;
+        tControl = now;
+    }
+
+    /* data driven by the MCU */
+    if ((data != busData) || (dataDoe != busDoe))
+    {
+        if (dataHold && Shorter(now - tFall, T_H, &stats.minH))
+            Violation(now, "tH %lu ns < %d ns", (unsigned long) Ns(now - tFall),
+                      T_H);
+        dataHold = false;
+        busData = data;
+        busDoe = dataDoe;
+        tData = now;
+    }
+
+    /* both driving the data pins */
+    if ((dataDoe != 0) && pulse.rw
+            && (pinE || Shorter(now - tFall, T_DHR + 1, NULL)))
+        Violation(now, "bus contention, the MCU drives the data pins while"
+                  " the LCD does");
+
+    /* the E edges */
+    if (e && !pinE)
+    {
+        pinE = true;
+        ERise(now);
+    }
+    else if (!e && pinE)
+    {
+        pinE = false;
+        EFall(now);
+    }
+}
+
+
+
+/*
+   HD44780Din(void)
+
+   Description:      This function returns the data pins the LCD drives,
+                     when the MCU reads DIN.
+   Operation:        The LCD drives the data of a read from tDDR after E
+                     rises until tDHR after E falls.  A read outside of that
+                     is a violation (the value is still returned, it is
+                     often still on the pins).
+
+   Arguments:        None.
+   Return Value:     (uint32_t) - data pins driven by the LCD.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Violations are reported.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint32_t HD44780Din(void)
+{
+    /* variables */
+    uint64_t now = simCycles; /* time of the read */
+
+    /* not a read at all */
+    if (!risen || !pulse.rw)
+    {
+        Violation(now, "DIN read without a read on the bus");
+        return 0;
+    }
+
+    /* too early */
+    if (Shorter(now - pulse.rise, T_DDR, &stats.minDDR))
+        Violation(now, "read %lu ns after E rose, tDDR is %d ns",
+                  (unsigned long) Ns(now - pulse.rise), T_DDR);
+
+    /* or too late */
+    if (!pinE)
+    {
+        if (Ns(now - tFall) > stats.maxDHR)
+            stats.maxDHR = Ns(now - tFall);
+        if (!Shorter(now - tFall, T_DHR + 1, NULL))
+            Violation(now, "read %lu ns after E fell, tDHR is %d ns",
+                      (unsigned long) Ns(now - tFall), T_DHR);
+    }
+
+    return (uint32_t) pulse.data << DATA_0_PIN;
+}
+
+
+
+/*
+   HD44780GetStats(hd44780Stats_t *)
+
+   Description:      This function gets the bus counts and shortest times.
+   Operation:        The statistics are copied.
+
+   Arguments:        pStats (hd44780Stats_t *) - where to copy them.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HD44780GetStats(hd44780Stats_t *pStats)
+{
+    *pStats = stats;
+}
+
+
+
+/*
+   HD44780Cell(int, int)
+
+   Description:      This function gets the character shown at a position
+                     of the display.
+   Operation:        Rows 0 and 2 are line 1 and rows 1 and 3 line 2, rows
+                     2 and 3 starting after the 16 characters of rows 0 and
+                     1.  The display shift moves the window along the line.
+
+   Arguments:        r (int) - row.
+                     c (int) - column.
+   Return Value:     (uint8_t) - the character code.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8_t HD44780Cell(int r, int c)
+{
+    /* variables */
+    int offset = (r / 2) * NUM_COLS + c; /* position in the line */
+
+    offset = (offset + displayShift) % DDRAM_LINE_LEN;
+    return ddram[(r % 2) * DDRAM_LINE_2 + offset];
+}
+
+
+
+/*
+   HD44780Cgram(uint8_t)
+
+   Description:      This function gets a byte of the CGRAM.
+   Operation:        The byte is returned.
+
+   Arguments:        addr (uint8_t) - CGRAM address.
+   Return Value:     (uint8_t) - the byte.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8_t HD44780Cgram(uint8_t addr)
+{
+    return cgram[addr % CGRAM_SIZE];
+}
+
+
+
+/*
+   HD44780Row(int, char *)
+
+   Description:      This function renders a row of the display as text.
+   Operation:        Each character is shown as itself if it is printable
+                     ASCII, the full block as '#', a CGRAM character as the
+                     digit of its slot and anything else as '?'.
+
+   Arguments:        r (int) - row.
+                     buf (char *) - buffer for NUM_COLS characters and the
+                        NUL.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HD44780Row(int r, char *buf)
+{
+    /* variables */
+    uint8_t ch; /* character code */
+    int c; /* column */
+
+    for (c = 0; c < NUM_COLS; c++)
+    {
+        ch = HD44780Cell(r, c);
+        if ((ch >= ' ') && (ch <= '~'))
+            buf[c] = (char) ch;
+        else if (ch == 0xFF)
+            buf[c] = '#';
+        else if (ch < CGRAM_CHARS)
+            buf[c] = (char) ('0' + ch % CGRAM_SLOTS);
+        else
+            buf[c] = '?';
+    }
+    buf[c] = '\0';
+}
+
+
+
+/*
+   HD44780DisplayOn(void)
+
+   Description:      This function returns whether the display is on.
+   Operation:        The display control state is returned.
+
+   Arguments:        None.
+   Return Value:     (bool) - TRUE if the display is on.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+bool HD44780DisplayOn(void)
+{
+    return displayOn;
+}
+
+
+
+/*
+   HD44780LogClear(void)
+
+   Description:      This function starts a new log of E pulses.
+   Operation:        The log is emptied.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HD44780LogClear(void)
+{
+    logCount = 0;
+}
+
+
+
+/*
+   HD44780LogPrint(void)
+
+   Description:      This function prints the E pulses logged since the log
+                     was cleared.
+   Operation:        Each pulse is printed with the time E rose, how long it
+                     was high, the gap since the previous pulse, RS, R/W and
+                     what it did.  If the log filled up only the first
+                     LOG_SIZE pulses are printed.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The log is printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void HD44780LogPrint(void)
+{
+    /* variables */
+    char description[DESCRIPTION_SIZE]; /* what a pulse did */
+    uint32_t i; /* index into the log */
+
+    printf("    %12s %8s %10s  RS RW  operation\n", "E rise (us)",
+           "E high", "gap (ns)");
+    for (i = 0; (i < logCount) && (i < LOG_SIZE); i++)
+    {
+        Describe(&pulseLog[i], description);
+        printf("    %12.3f %5lu ns %10lu  %2d %2d  %s\n",
+               (double) pulseLog[i].rise / SIM_CPU_MHZ,
+               (unsigned long) Ns(pulseLog[i].fall - pulseLog[i].rise),
+               (unsigned long) ((i == 0) ? 0 :
+                       Ns(pulseLog[i].rise - pulseLog[i - 1].fall)),
+               pulseLog[i].rs, pulseLog[i].rw, description);
+    }
+    if (logCount > LOG_SIZE)
+        printf("    (%lu more)\n", (unsigned long) (logCount - LOG_SIZE));
+}
+
+
+
+/* local functions */
+
+/*
+   ERise(uint64_t)
+
+   Description:      This function handles E going high.
+   Operation:        The E cycle time since the last rise and the RS and
+                     R/W setup time are checked.  RS and R/W are latched.
+                     On a read the LCD puts the busy flag and address
+                     counter (RS = 0) or the data at the address counter
+                     (RS = 1) on the bus.
+
+   Arguments:        now (uint64_t) - cycle of the edge.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Violations are reported.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void ERise(uint64_t now)
+{
+    if (risen && Shorter(now - tRise, T_CYCE, &stats.minCycE))
+        Violation(now, "tcycE %lu ns < %d ns",
+                  (unsigned long) Ns(now - tRise), T_CYCE);
+    if (Shorter(now - tControl, T_AS, &stats.minAS))
+        Violation(now, "tAS %lu ns < %d ns",
+                  (unsigned long) Ns(now - tControl), T_AS);
+
+    tRise = now;
+    risen = true;
+    memset(&pulse, 0, sizeof(pulse));
+    pulse.rise = now;
+    pulse.rs = pinRs;
+    pulse.rw = pinRw;
+
+    if (pulse.rw)
+    {
+        stats.reads++;
+        if (busDoe != 0)
+            Violation(now, "bus contention, the MCU drives the data pins on"
+                      " a read");
+
+        if (!pulse.rs)
+        {
+            /* busy flag and address counter */
+            pulse.data = ac & ~BUSY_FLAG_MASK;
+            if (Busy(now))
+                pulse.data |= BUSY_FLAG_MASK;
+        }
+        else
+        {
+            /* data */
+            pulse.data = acCgram ? cgram[ac % CGRAM_SIZE] : ddram[ac];
+            MoveAc();
+        }
+    }
+}
+
+
+
+/*
+   EFall(uint64_t)
+
+   Description:      This function handles E going low.
+   Operation:        The E pulse width is checked.  On a write the data
+                     pins must all be driven and the data setup time is
+                     checked, then the byte is latched and run (a write
+                     while the LCD is busy is a violation).  The pulse is
+                     added to the log and the hold times are to be checked
+                     on the next change.
+
+   Arguments:        now (uint64_t) - cycle of the edge.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Violations are reported.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void EFall(uint64_t now)
+{
+    if (Shorter(now - tRise, T_PWEH, &stats.minPWEH))
+        Violation(now, "PWEH %lu ns < %d ns",
+                  (unsigned long) Ns(now - tRise), T_PWEH);
+
+    tFall = now;
+    controlHold = true;
+    dataHold = true;
+    pulse.fall = now;
+
+    if (!pulse.rw)
+    {
+        if (busDoe != DATA_PINS)
+            Violation(now, "write with the data pins not driven");
+        if (Shorter(now - tData, T_DSW, &stats.minDSW))
+            Violation(now, "tDSW %lu ns < %d ns",
+                      (unsigned long) Ns(now - tData), T_DSW);
+
+        pulse.data = (uint8_t) (busData >> DATA_0_PIN);
+        if (Busy(now))
+        {
+            pulse.busy = true;
+            Violation(now, "written %lu ns before the LCD is ready",
+                      (unsigned long) Ns(busyUntil - now));
+        }
+
+        if (stats.writes++ == 0)
+            stats.firstWriteUs = (uint32_t) (now / SIM_CPU_MHZ);
+        Execute(pulse.rs, pulse.data, now);
+    }
+
+    if (logCount++ < LOG_SIZE)
+        pulseLog[logCount - 1] = pulse;
+}
+
+
+
+/*
+   Execute(bool, uint8_t, uint64_t)
+
+   Description:      This function runs a written instruction or data
+                     write.
+   Operation:        Data is written to DDRAM or CGRAM at the address
+                     counter, which then moves (shifting the display if
+                     that is set).  An instruction is decoded by its highest
+                     set bit.  The LCD is busy for the execution time of the
+                     instruction, and for the first two function sets of the
+                     initialization, for the waits the initialization needs
+                     after them.
+
+   Arguments:        rs (bool) - register select (TRUE for data).
+                     data (uint8_t) - byte written.
+                     now (uint64_t) - cycle of the write.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Addresses that don't exist in 2-line mode and the
+                     modes the model doesn't handle are violations.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void Execute(bool rs, uint8_t data, uint64_t now)
+{
+    /* variables */
+    uint32_t execNs = T_EXEC; /* execution time */
+
+    if (rs)
+    {
+        /* data write */
+        if (acCgram)
+            cgram[ac % CGRAM_SIZE] = data;
+        else
+            ddram[ac] = data;
+        MoveAc();
+        if (shiftOnWrite && !acCgram)
+            displayShift = (uint8_t) ((displayShift + (increment ? 1 :
+                    DDRAM_LINE_LEN - 1)) % DDRAM_LINE_LEN);
+    }
+    else if ((data & INS_SET_DDRAM) != 0)
+    {
+        ac = data & ~INS_SET_DDRAM;
+        acCgram = false;
+        if ((ac >= DDRAM_LINE_LEN)
+                && ((ac < DDRAM_LINE_2) || (ac >= DDRAM_LINE_2 + DDRAM_LINE_LEN)))
+            Violation(now, "DDRAM address 0x%02x doesn't exist", ac);
+    }
+    else if ((data & INS_SET_CGRAM) != 0)
+    {
+        ac = data & ~INS_SET_CGRAM;
+        acCgram = true;
+    }
+    else if ((data & INS_FUNCTION) != 0)
+    {
+        if ((data & INS_FUNCTION_8BIT) == 0)
+            Violation(now, "4-bit interface isn't modeled");
+        if ((data & INS_FUNCTION_2LINE) == 0)
+            Violation(now, "1-line mode doesn't show rows 1 and 3");
+        functionSets++;
+        if (functionSets == 1)
+            execNs = T_INIT_1;
+        else if (functionSets == 2)
+            execNs = T_INIT_2;
+    }
+    else if ((data & INS_SHIFT) != 0)
+    {
+        if ((data & INS_SHIFT_DISPLAY) != 0)
+            displayShift = (uint8_t) ((displayShift
+                    + (((data & INS_SHIFT_RIGHT) != 0) ? DDRAM_LINE_LEN - 1 : 1))
+                    % DDRAM_LINE_LEN);
+        else
+        {
+            /* move the cursor the way a write in that direction would */
+            bool saveIncrement = increment;
+            increment = ((data & INS_SHIFT_RIGHT) != 0);
+            MoveAc();
+            increment = saveIncrement;
+        }
+    }
+    else if ((data & INS_DISPLAY) != 0)
+    {
+        displayOn = ((data & INS_DISPLAY_ON) != 0);
+    }
+    else if ((data & INS_ENTRY_MODE) != 0)
+    {
+        increment = ((data & INS_ENTRY_INC) != 0);
+        shiftOnWrite = ((data & INS_ENTRY_SHIFT) != 0);
+    }
+    else if ((data & INS_HOME) != 0)
+    {
+        ac = 0;
+        acCgram = false;
+        displayShift = 0;
+        execNs = T_EXEC_SLOW;
+    }
+    else if ((data & INS_CLEAR) != 0)
+    {
+        memset(ddram, ' ', sizeof(ddram));
+        ac = 0;
+        acCgram = false;
+        increment = true;
+        displayShift = 0;
+        execNs = T_EXEC_SLOW;
+    }
+
+    busyUntil = now + ((uint64_t) execNs * SIM_CPU_MHZ + 999) / 1000;
+}
+
+
+
+/*
+   MoveAc(void)
+
+   Description:      This function moves the address counter after a data
+                     access.
+   Operation:        The counter is incremented or decremented.  In CGRAM
+                     it wraps around the 64 bytes, in DDRAM the end of line
+                     1 goes to the start of line 2 and the other way round.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void MoveAc(void)
+{
+    if (acCgram)
+        ac = (uint8_t) ((ac + (increment ? 1 : CGRAM_SIZE - 1)) % CGRAM_SIZE);
+    else if (increment)
+    {
+        ac++;
+        if (ac == DDRAM_LINE_LEN)
+            ac = DDRAM_LINE_2;
+        else if (ac == DDRAM_LINE_2 + DDRAM_LINE_LEN)
+            ac = 0;
+    }
+    else
+    {
+        if (ac == 0)
+            ac = DDRAM_LINE_2 + DDRAM_LINE_LEN - 1;
+        else if (ac == DDRAM_LINE_2)
+            ac = DDRAM_LINE_LEN - 1;
+        else
+            ac--;
+    }
+}
+
+
+
+/*
+   Busy(uint64_t)
+
+   Description:      This function returns whether an instruction is still
+                     running.
+   Operation:        The time is compared with the end of the instruction.
+
+   Arguments:        now (uint64_t) - current cycle.
+   Return Value:     (bool) - TRUE if the LCD is busy.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool Busy(uint64_t now)
+{
+    return (now < busyUntil);
+}
+
+
+
+/*
+   Shorter(uint64_t, uint32_t, uint32_t *)
+
+   Description:      This function returns whether a number of cycles is
+                     shorter than a time in ns, and keeps the shortest time
+                     seen.
+   Operation:        The cycles are compared in ns * SIM_CPU_MHZ so there
+                     is no rounding.  The time is saved if it is shorter
+                     than the one at pMin.
+
+   Arguments:        cycles (uint64_t) - the time in cycles.
+                     ns (uint32_t) - the limit in ns.
+                     pMin (uint32_t *) - shortest time seen in ns (NULL if
+                        not kept).
+   Return Value:     (bool) - TRUE if the time is shorter than the limit.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static bool Shorter(uint64_t cycles, uint32_t ns, uint32_t *pMin)
+{
+    if ((pMin != NULL) && (Ns(cycles) < *pMin))
+        *pMin = Ns(cycles);
+    return (cycles * 1000 < (uint64_t) ns * SIM_CPU_MHZ);
+}
+
+
+
+/*
+   Ns(uint64_t)
+
+   Description:      This function converts cycles to ns.
+   Operation:        The cycles are scaled by the CPU clock (rounding
+                     down), limited to UINT32_MAX - 1.
+
+   Arguments:        cycles (uint64_t) - the time in cycles.
+   Return Value:     (uint32_t) - the time in ns.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static uint32_t Ns(uint64_t cycles)
+{
+    /* variables */
+    uint64_t ns = cycles * 1000 / SIM_CPU_MHZ; /* the time in ns */
+
+    return (ns >= UINT32_MAX) ? UINT32_MAX - 1 : (uint32_t) ns;
+}
+
+
+
+/*
+   Violation(uint64_t, const char *, ...)
+
+   Description:      This function reports a timing or protocol violation.
+   Operation:        The violation is counted and the first MAX_REPORTED
+                     are printed with the time.
+
+   Arguments:        now (uint64_t) - cycle of the violation.
+                     fmt (const char *) - printf format of the message.
+                     ... - arguments of the format.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The violation is printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void Violation(uint64_t now, const char *fmt, ...)
+{
+    /* variables */
+    va_list args; /* arguments of the format */
+
+    if (stats.violations++ >= MAX_REPORTED)
+        return;
+
+    printf("HD44780 at %.3f us: ", (double) now / SIM_CPU_MHZ);
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+    printf("\n");
+}
+
+
+
+/*
+   Describe(const pulse_t *, char *)
+
+   Description:      This function describes what a bus operation did.
+   Operation:        Reads are the busy flag and address counter or data,
+                     data writes show the character, and instructions are
+                     decoded by their highest set bit.
+
+   Arguments:        pPulse (const pulse_t *) - the pulse.
+                     buf (char *) - buffer for DESCRIPTION_SIZE characters.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void Describe(const pulse_t *pPulse, char *buf)
+{
+    /* variables */
+    uint8_t d = pPulse->data; /* the byte */
+    int n; /* length of the description */
+
+    if (pPulse->rw && !pPulse->rs)
+        n = snprintf(buf, DESCRIPTION_SIZE, "read busy flag %d, AC 0x%02x",
+                     (d & BUSY_FLAG_MASK) != 0, d & ~BUSY_FLAG_MASK);
+    else if (pPulse->rw)
+        n = snprintf(buf, DESCRIPTION_SIZE, "read data 0x%02x", d);
+    else if (pPulse->rs)
+        n = snprintf(buf, DESCRIPTION_SIZE, ((d >= ' ') && (d <= '~')) ?
+                     "write '%c'" : "write 0x%02x", d);
+    else if ((d & INS_SET_DDRAM) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "set DDRAM address 0x%02x",
+                     d & ~INS_SET_DDRAM);
+    else if ((d & INS_SET_CGRAM) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "set CGRAM address 0x%02x",
+                     d & ~INS_SET_CGRAM);
+    else if ((d & INS_FUNCTION) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "function set 0x%02x", d);
+    else if ((d & INS_SHIFT) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "shift 0x%02x", d);
+    else if ((d & INS_DISPLAY) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "display control 0x%02x", d);
+    else if ((d & INS_ENTRY_MODE) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "entry mode 0x%02x", d);
+    else if ((d & INS_HOME) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "return home");
+    else if ((d & INS_CLEAR) != 0)
+        n = snprintf(buf, DESCRIPTION_SIZE, "clear display");
+    else
+        n = snprintf(buf, DESCRIPTION_SIZE, "no instruction");
+
+    if (pPulse->busy && (n < DESCRIPTION_SIZE))
+        snprintf(buf + n, DESCRIPTION_SIZE - n, " (while busy)");
+}
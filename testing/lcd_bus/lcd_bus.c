@@ -0,0 +1,530 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 lcd_bus.c                                */
+/*                       Host-Side LCD Bus Harness                          */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a host program that runs the LCD driver against a
+   model of the GPIO and timer registers and of the HD44780 controller.  The
+   C code of the driver (lcd_rtos.c, lcd_util.c, lcd_glyph.c and
+   lcd_marquee.c) is compiled as it is, and the assembly is transcribed
+   instruction by instruction with its timing (lcd_io_model.c and
+   lcd_display_model.c).  It is built and run with "make" in this
+   directory.  Functions included are:
+        main - run the steps and print the results
+
+   Local functions:
+        RunStep    - run one step and check it
+        CheckRows  - check the display against the expected rows
+        ShowTiming - print the shortest bus times against the limits
+        ShowScreen - print the display and the CGRAM characters used
+        Step...    - the steps (what the application displays)
+
+   Every step is something the application displays, followed by LCDFlush,
+   which runs the queue clock on simulated time until the queue is empty.
+   For each step the bytes written to the LCD are counted and checked
+   against the most the step should take, so a change that makes a redraw
+   cost more bus traffic fails.  After every step the display must match
+   the shadow in lcd_display.s, and for some steps the expected rows.  The
+   HD44780 model checks the timing of every E pulse and the busy flag
+   against the data sheet, and any violation fails the run.
+
+   The assembly itself is not run, only its transcription, so the results
+   hold for the assembly only as long as the two match.  The Makefile
+   checks the assembly against the hashes in asm.sum before every run (see
+   there), so it can't change without the models being looked at.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+       5/18/24 Adam Krivka      noted the limit of the transcription
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <string.h>
+
+/* local includes */
+#include "lcd_bus.h"
+#include "lcd_rtos_intf.h"
+#include "lcd_util.h"
+#include "lcd_glyph.h"
+#include "lcd_marquee.h"
+
+/* constants */
+#define ROW_SIZE        (NUM_COLS + 1)  /* a row of text and the NUL */
+#define GLYPH_SLOT_0    8               /* character of CGRAM slot 0 */
+
+/* structures */
+
+/* a step of the run */
+typedef struct {
+    const char *name;                   /* what the step does */
+    void      (*draw)(void);            /* function doing it */
+    uint32_t    maxWrites;              /* bytes it may write to the LCD */
+    const char *rows[NUM_ROWS];         /* expected rows (NULL for none) */
+    bool        log;                    /* whether to print its E pulses */
+} step_t;
+
+/* local functions */
+static int RunStep(const step_t *pStep);
+static int CheckRows(const step_t *pStep);
+static int ShowTiming(void);
+static void ShowScreen(void);
+
+static void StepInit(void);
+static void StepClear(void);
+static void StepIdle(void);
+static void StepReady(void);
+static void StepControl(void);
+static void StepSpeed(void);
+static void StepSpeedDigit(void);
+static void StepSpeedInt(void);
+static void StepTurn(void);
+static void StepBar(void);
+static void StepBarGrow(void);
+static void StepBarFull(void);
+static void StepThoughts(void);
+static void StepMarqueeHold(void);
+static void StepMarqueeScroll(void);
+
+/* the steps, in order */
+static const step_t steps[] = {
+    { "LCDInit_RTOS", StepInit, 12,
+      { "                ", "                ",
+        "                ", "                " }, false },
+    { "ClearDisplay", StepClear, 1, { NULL }, false },
+    { "status \"Idle\"", StepIdle, 4,
+      { "Idle            ", NULL, NULL, NULL }, false },
+    { "status \"Idle\" again", StepIdle, 0, { NULL }, false },
+    { "status \"Ready\"", StepReady, 6,
+      { "Ready           ", NULL, NULL, NULL }, false },
+    { "control screen", StepControl, 8,
+      { "CONTROL         ", "                ",
+        "                ", "                " }, false },
+    { "speed 42", StepSpeed, 10,
+      { NULL, "Speed:  42      ", NULL, NULL }, false },
+    { "speed 42 again", StepSpeed, 0, { NULL }, false },
+    { "speed 43", StepSpeedDigit, 2,
+      { NULL, "Speed:  43      ", NULL, NULL }, true },
+    { "speed 100 (Display_int)", StepSpeedInt, 4,
+      { NULL, "Speed:  100     ", NULL, NULL }, false },
+    { "turn -15", StepTurn, 10,
+      { NULL, NULL, "Turn:   -15     ", NULL }, false },
+    { "bar 37%", StepBar, 16,
+      { NULL, NULL, NULL, "\xFF\xFF\xFF\xFF\xFF\x08          " }, false },
+    { "bar 37% again", StepBar, 0, { NULL }, false },
+    { "bar 40% (new glyph)", StepBarGrow, 12,
+      { NULL, NULL, NULL, "\xFF\xFF\xFF\xFF\xFF\xFF\x09         " }, false },
+    { "bar 44%", StepBarFull, 2,
+      { NULL, NULL, NULL, "\xFF\xFF\xFF\xFF\xFF\xFF\xFF         " }, false },
+    { "thoughts screen", StepThoughts, 26,
+      { "THOUGHTS        ", "the path ahead l",
+        "                ", "                " }, false },
+    { "marquee hold", StepMarqueeHold, 0, { NULL }, false },
+    { "marquee scroll", StepMarqueeScroll, 17,
+      { NULL, "he path ahead lo", NULL, NULL }, false },
+};
+
+/* bar graph glyph of 4 lit columns (as in lcd_glyph.c) */
+static const uint8_t barGlyph4[GLYPH_ROWS] = {
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E
+};
+
+
+
+/* functions */
+
+/*
+   main(void)
+
+   Description:      This function runs every step and prints the results.
+   Operation:        The steps are run in order, then the bus timing, the
+                     queue statistics and the display are printed and the
+                     errors added up.
+
+   Arguments:        None.
+   Return Value:     0 if every check passed, 1 otherwise.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int main(void)
+{
+    /* variables */
+    lcdStats_t queue; /* queue timing statistics */
+    int errors = 0; /* number of failed checks */
+    size_t i; /* step index */
+    int row; /* glyph row */
+
+    printf("%-26s %6s %6s %5s %10s\n", "step", "writes", "budget", "reads",
+           "time (us)");
+    for (i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+        errors += RunStep(&steps[i]);
+
+    /* the bar graph glyph must have been sent */
+    for (row = 0; row < GLYPH_ROWS; row++)
+    {
+        if (HD44780Cgram((uint8_t) row) != barGlyph4[row])
+        {
+            printf("CGRAM slot 0 row %d is 0x%02x, not 0x%02x\n", row,
+                   HD44780Cgram((uint8_t) row), barGlyph4[row]);
+            errors++;
+        }
+    }
+    if (!HD44780DisplayOn())
+    {
+        printf("the display is off\n");
+        errors++;
+    }
+
+    errors += ShowTiming();
+
+    LCDGetStats(&queue);
+    printf("\nqueue: write takes %lu us, steps every %lu us (%lu ticks),"
+           " %lu busy steps\n", (unsigned long) queue.busyUs,
+           (unsigned long) queue.stepUs, (unsigned long) queue.stepTicks,
+           (unsigned long) queue.busySteps);
+    if (queue.pacedBytes != 0)
+        printf("queue: %lu bytes back to back, %.1f us per byte\n",
+               (unsigned long) queue.pacedBytes, (double) queue.pacedCycles
+               / queue.pacedBytes / SIM_CPU_MHZ);
+
+    ShowScreen();
+
+    errors += (int) RegErrors();
+    printf("\n%s\n", (errors == 0) ? "all checks passed" : "CHECKS FAILED");
+    return (errors == 0) ? 0 : 1;
+}
+
+
+
+/* local functions */
+
+/*
+   RunStep(const step_t *)
+
+   Description:      This function runs one step and checks it.
+   Operation:        The step is drawn and the queue flushed, and the bytes
+                     written and read, the simulated time and the
+                     violations during the step are found.  The writes are
+                     checked against the budget of the step and the
+                     display against the shadow and the expected rows.
+                     The E pulses are printed if the step asks for it.
+
+   Arguments:        pStep (const step_t *) - the step.
+   Return Value:     Number of errors.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   Every failed check is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int RunStep(const step_t *pStep)
+{
+    /* variables */
+    hd44780Stats_t before; /* bus statistics before the step */
+    hd44780Stats_t after; /* and after */
+    uint64_t start = simCycles; /* time the step started */
+    uint32_t writes; /* bytes written in the step */
+    int errors = 0; /* number of errors */
+    int r, c; /* display position */
+
+    HD44780GetStats(&before);
+    HD44780LogClear();
+
+    pStep->draw();
+    LCDFlush();
+
+    HD44780GetStats(&after);
+    writes = after.writes - before.writes;
+    printf("%-26s %6lu %6lu %5lu %10.1f\n", pStep->name,
+           (unsigned long) writes, (unsigned long) pStep->maxWrites,
+           (unsigned long) (after.reads - before.reads),
+           (double) (simCycles - start) / SIM_CPU_MHZ);
+
+    if (writes > pStep->maxWrites)
+    {
+        printf("  writes %lu bytes, more than the %lu it should\n",
+               (unsigned long) writes, (unsigned long) pStep->maxWrites);
+        errors++;
+    }
+    if (after.violations != before.violations)
+    {
+        printf("  %lu bus violations\n",
+               (unsigned long) (after.violations - before.violations));
+        errors++;
+    }
+
+    /* the LCD must show what the shadow says it does */
+    for (r = 0; r < NUM_ROWS; r++)
+    {
+        for (c = 0; c < NUM_COLS; c++)
+        {
+            if (HD44780Cell(r, c) != ShadowCell(r, c))
+            {
+                printf("  (%d, %d) is 0x%02x on the LCD, 0x%02x in the"
+                       " shadow\n", r, c, HD44780Cell(r, c),
+                       ShadowCell(r, c));
+                errors++;
+            }
+        }
+    }
+    errors += CheckRows(pStep);
+
+    if (pStep->log)
+        HD44780LogPrint();
+
+    return errors;
+}
+
+
+
+/*
+   CheckRows(const step_t *)
+
+   Description:      This function checks the display against the rows the
+                     step expects.
+   Operation:        Every row given is compared character by character.
+
+   Arguments:        pStep (const step_t *) - the step.
+   Return Value:     Number of rows that are wrong.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          Wrong rows are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckRows(const step_t *pStep)
+{
+    /* variables */
+    char shown[ROW_SIZE]; /* row as the LCD shows it */
+    int errors = 0; /* number of wrong rows */
+    int r, c; /* display position */
+
+    for (r = 0; r < NUM_ROWS; r++)
+    {
+        if (pStep->rows[r] == NULL)
+            continue;
+        for (c = 0; c < NUM_COLS; c++)
+            if (HD44780Cell(r, c) != (uint8_t) pStep->rows[r][c])
+                break;
+        if (c < NUM_COLS)
+        {
+            HD44780Row(r, shown);
+            printf("  row %d is \"%s\", column %d should be 0x%02x\n", r,
+                   shown, c, (uint8_t) pStep->rows[r][c]);
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+
+/*
+   ShowTiming(void)
+
+   Description:      This function prints the shortest bus times seen
+                     against the data sheet limits and the total violations.
+   Operation:        Each time is printed with its limit.
+
+   Arguments:        None.
+   Return Value:     Number of violations.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The times are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int ShowTiming(void)
+{
+    /* variables */
+    hd44780Stats_t stats; /* bus statistics */
+
+    HD44780GetStats(&stats);
+
+    printf("\nbus: %lu bytes written, %lu read, %lu violations\n",
+           (unsigned long) stats.writes, (unsigned long) stats.reads,
+           (unsigned long) stats.violations);
+    printf("bus: shortest tcycE %lu ns (>= 1000), PWEH %lu ns (>= 450),"
+           " tAS %lu ns (>= 60)\n", (unsigned long) stats.minCycE,
+           (unsigned long) stats.minPWEH, (unsigned long) stats.minAS);
+    printf("bus: shortest tAH %lu ns (>= 20), tDSW %lu ns (>= 195),"
+           " tH %lu ns (>= 10)\n", (unsigned long) stats.minAH,
+           (unsigned long) stats.minDSW, (unsigned long) stats.minH);
+    printf("bus: reads sampled >= %lu ns after E rose (>= 360), <= %lu ns"
+           " after E fell (<= 5)\n", (unsigned long) stats.minDDR,
+           (unsigned long) stats.maxDHR);
+    printf("bus: first write %lu us after power on (>= 15000, plus the"
+           " boot time on the board)\n", (unsigned long) stats.firstWriteUs);
+
+    return (int) stats.violations;
+}
+
+
+
+/*
+   ShowScreen(void)
+
+   Description:      This function prints the display and the CGRAM
+                     characters.
+   Operation:        Each row is rendered between bars, then the pattern of
+                     each CGRAM slot is printed.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The display is printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void ShowScreen(void)
+{
+    /* variables */
+    char shown[ROW_SIZE]; /* row as the LCD shows it */
+    int r; /* row */
+    int slot; /* CGRAM slot */
+
+    printf("\ndisplay (# full block, digits CGRAM slots):\n");
+    for (r = 0; r < NUM_ROWS; r++)
+    {
+        HD44780Row(r, shown);
+        printf("    |%s|\n", shown);
+    }
+
+    printf("CGRAM:");
+    for (slot = 0; slot < GLYPH_NUM_SLOTS; slot++)
+    {
+        printf(" %d:", slot);
+        for (r = 0; r < GLYPH_ROWS; r++)
+            printf("%02x", HD44780Cgram((uint8_t) (slot * GLYPH_ROWS + r)));
+    }
+    printf("\n");
+}
+
+
+
+/* the steps */
+
+static void StepInit(void)
+{
+    LCDInit_RTOS();
+}
+
+static void StepClear(void)
+{
+    ClearDisplay();
+}
+
+static void StepIdle(void)
+{
+    Display(0, 0, "Idle", 16);
+}
+
+static void StepReady(void)
+{
+    Display(0, 0, "Ready", 16);
+}
+
+static void StepControl(void)
+{
+    ClearDisplay();
+    Display(0, 0, "CONTROL", 16);
+}
+
+static void StepSpeed(void)
+{
+    Display_labelInt(1, 0, 12, "Speed:  ", 42);
+}
+
+static void StepSpeedDigit(void)
+{
+    Display_labelInt(1, 0, 12, "Speed:  ", 43);
+}
+
+static void StepSpeedInt(void)
+{
+    Display_int(1, 8, 4, 100);
+}
+
+static void StepTurn(void)
+{
+    Display_labelInt(2, 0, 12, "Turn:   ", -15);
+}
+
+static void StepBar(void)
+{
+    Display_bar(3, 0, 16, 37, 100);
+}
+
+static void StepBarGrow(void)
+{
+    Display_bar(3, 0, 16, 40, 100);
+}
+
+static void StepBarFull(void)
+{
+    Display_bar(3, 0, 16, 44, 100);
+}
+
+static void StepThoughts(void)
+{
+    MarqueeStopAll();
+    ClearDisplay();
+    Display(0, 0, "THOUGHTS", 16);
+    MarqueeStart(0, 1, 0, 16, "the path ahead looks clear");
+}
+
+static void StepMarqueeHold(void)
+{
+    MarqueeStep();
+}
+
+static void StepMarqueeScroll(void)
+{
+    /* the rest of the hold at the start, then the first move */
+    int i; /* step index */
+
+    for (i = 1; i <= MARQUEE_PAUSE_STEPS; i++)
+        MarqueeStep();
+}
@@ -0,0 +1,97 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 lcd_bus.h                                */
+/*                      LCD Bus Harness Declarations                        */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the constants and declarations shared by the parts of
+   the host-side LCD bus harness: the simulated CPU time and registers
+   (lcd_regs.c), the kernel stand-ins (sim_rtos.c), the HD44780 model
+   (hd44780.c) and the transcriptions of the LCD assembly
+   (lcd_io_model.c and lcd_display_model.c).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef LCD_BUS_H
+    #define LCD_BUS_H
+
+#include  <xdc/std.h>
+#include  <stdint.h>
+#include  <stdbool.h>
+
+/* constants generated from the assembly include files */
+#include "lcd_symbols.h"
+
+/* simulated CPU clock */
+#define SIM_CPU_MHZ     48              /* CPU clock in MHz (as on the board) */
+
+/* Cortex-M4 instruction times in cycles with no flash wait states, used by */
+/*    the transcriptions of the assembly */
+#define CYC_OP          1               /* data processing, CPSID/CPSIE */
+#define CYC_MOV32       2               /* MOV32 and MOVA (MOVW and MOVT) */
+#define CYC_LDR         2               /* load (counted by RegRead) */
+#define CYC_STR         1               /* store (counted by RegWrite) */
+#define CYC_TAKEN       2               /* taken branch, BL and BX */
+#define CYC_NOT_TAKEN   1               /* branch not taken */
+#define CYC_STACK(n)    (1 + (n))       /* PUSH or POP of n registers */
+
+/* time taken by instructions of the assembly */
+#define CPU(n)          SimCycles(n)
+#define BRANCH(taken)   SimCycles((taken) ? CYC_TAKEN : CYC_NOT_TAKEN)
+
+/* structures */
+
+/* bus counts and the shortest times seen by the HD44780 model (in ns, */
+/*    UINT32_MAX if not seen yet) */
+typedef struct {
+    uint32_t writes;                    /* bytes written to the LCD */
+    uint32_t reads;                     /* bytes read from the LCD */
+    uint32_t violations;                /* timing and protocol violations */
+    uint32_t minCycE;                   /* E rise to E rise */
+    uint32_t minPWEH;                   /* E high */
+    uint32_t minAS;                     /* RS, R/W to E rise */
+    uint32_t minAH;                     /* E fall to RS, R/W change */
+    uint32_t minDSW;                    /* data to E fall on a write */
+    uint32_t minH;                      /* E fall to data change */
+    uint32_t minDDR;                    /* E rise to the data read */
+    uint32_t maxDHR;                    /* E fall to the data read (0 if it */
+                                        /*    was read while E was high) */
+    uint32_t firstWriteUs;              /* power on to the first write */
+} hd44780Stats_t;
+
+/* lcd_regs.c - simulated time and registers */
+extern uint64_t simCycles;
+void     SimCycles(uint32_t n);
+uint32_t RegRead(uint32_t addr);
+void     RegWrite(uint32_t addr, uint32_t value);
+uint32_t RegErrors(void);
+
+/* sim_rtos.c - kernel stand-ins */
+void     SimTick(void);
+
+/* hd44780.c - the LCD controller */
+void     HD44780Pins(uint32_t dout, uint32_t doe);
+uint32_t HD44780Din(void);
+void     HD44780GetStats(hd44780Stats_t *pStats);
+uint8_t  HD44780Cell(int r, int c);
+uint8_t  HD44780Cgram(uint8_t addr);
+void     HD44780Row(int r, char *buf);
+bool     HD44780DisplayOn(void);
+void     HD44780LogClear(void);
+void     HD44780LogPrint(void);
+
+/* lcd_io_model.c - lcd_io.s and lcd_init.s */
+void     LCDInit();
+void     LCDWrite(UArg rs, UArg data);
+UArg     LCDRead(UArg rs);
+void     LCDWaitForNotBusy();
+int      LCDIsBusy();
+
+/* lcd_display_model.c - lcd_display.s */
+uint8_t  ShadowCell(int r, int c);
+
+#endif
@@ -0,0 +1,383 @@
+/****************************************************************************/
+/*                                                                          */
+/*                           lcd_display_model.c                            */
+/*                        lcd_display.s for the Host                        */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the display functions of lcd/lcd_display.s, written
+   in C step by step for the host-side LCD bus harness.  They only queue
+   writes with LCDEnqueue, so no time is counted here.  Functions included
+   are:
+        Display             - display a string
+        DisplayChar         - display a single character
+        ClearDisplay        - clear the display
+        ResetShadow         - mark the whole display blank in the shadow
+        LCDInvalidateCursor - forget where the LCD cursor is
+        ShadowCell          - get a cell of the shadow (for the harness)
+
+   Local functions:
+        CheckCursorPos - check that a position is on the display
+        WriteCell      - write a character to a cell if it changed
+
+   The registers of the assembly are 32 bits, so the arguments are
+   compared as int32_t the way the assembly compares them.  The steps are
+   copied, so a change to lcd_display.s has to be made here too (the
+   harness won't run until it is and the new assembly is pinned with "make
+   pin").
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+       5/18/24 Adam Krivka      assembly pinned in asm.sum
+*/
+
+/* local includes */
+#include "lcd_bus.h"
+
+/* from lcd_rtos.c */
+void LCDEnqueue(UArg rs, UArg data);
+
+/* shared/global variables */
+
+/* characters on the display, row by row, and the DDRAM address the LCD */
+/*    cursor is at (CURSOR_ADDR_UNKNOWN if it isn't known) */
+static uint8_t shadow[NUM_ROWS * NUM_COLS];
+static uint8_t cursorAddr = CURSOR_ADDR_UNKNOWN;
+
+/* addresses of the first character of each row */
+static const uint8_t cursorBaseAddr[NUM_ROWS] = {
+    ROW_0_START, ROW_1_START, ROW_2_START, ROW_3_START
+};
+
+/* local functions */
+static int32_t CheckCursorPos(int32_t r, int32_t c);
+static void WriteCell(int32_t r, int32_t c, uint8_t ch);
+
+/* other functions of the file */
+void ResetShadow();
+
+
+
+/* functions */
+
+/*
+   Display(UArg, UArg, char *, UArg)
+
+   Description:      This function displays a string starting at the given
+                     row and column, as in lcd_display.s.  The string is
+                     padded with spaces up to the target length (not past
+                     the end of the row), or not at all for -1.
+   Operation:        Each character is written with WriteCell until the NUL
+                     or the target length, failing if it would go off the
+                     row, then the rest of the target length is padded.
+
+   Arguments:        r (UArg) - row.
+                     c (UArg) - column.
+                     str (char *) - string to display.
+                     len (UArg) - target length (-1 for none).
+   Return Value:     (int) - FUNCTION_SUCCESS or FUNCTION_FAIL.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The changed cells are queued for the LCD.
+
+   Error Handling:   A bad position or a string going off the row fails.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int Display(UArg r, UArg c, char *str, UArg len)
+{
+    /* variables */
+    int32_t row = (int32_t) r; /* R8 */
+    int32_t col = (int32_t) c; /* R4 */
+    int32_t target = (int32_t) len; /* R7 */
+    const uint8_t *pStr = (const uint8_t *) str; /* R5 */
+    uint8_t ch; /* R6 */
+
+    if (CheckCursorPos(row, col) == FUNCTION_FAIL)
+        return FUNCTION_FAIL;
+
+    /* DisplayLoop */
+    col--;
+    for (;;)
+    {
+        ch = *pStr++;
+        col++;
+        if (ch == 0)
+            break;
+        if (col >= NUM_COLS)
+            return FUNCTION_FAIL;
+
+        WriteCell(row, col, ch);
+
+        if (target == -1)
+            continue;
+        target--;
+        if (target == 0)
+            return FUNCTION_SUCCESS;
+    }
+
+    /* DisplayPadRest */
+    for (;;)
+    {
+        if (target == -1)
+            return FUNCTION_SUCCESS;
+        if (col >= NUM_COLS)
+            return FUNCTION_SUCCESS;
+
+        WriteCell(row, col, ASCII_SPACE);
+
+        col++;
+        target--;
+        if (target == 0)
+            return FUNCTION_SUCCESS;
+    }
+}
+
+
+
+/*
+   DisplayChar(UArg, UArg, UArg)
+
+   Description:      This function displays a single character, as in
+                     lcd_display.s.
+   Operation:        The position is checked and the character is written
+                     with WriteCell.
+
+   Arguments:        r (UArg) - row.
+                     c (UArg) - column.
+                     ch (UArg) - character.
+   Return Value:     (int) - FUNCTION_SUCCESS or FUNCTION_FAIL.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The cell is queued for the LCD if it changed.
+
+   Error Handling:   A bad position fails.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int DisplayChar(UArg r, UArg c, UArg ch)
+{
+    if (CheckCursorPos((int32_t) r, (int32_t) c) == FUNCTION_FAIL)
+        return FUNCTION_FAIL;
+
+    WriteCell((int32_t) r, (int32_t) c, (uint8_t) ch);
+    return FUNCTION_SUCCESS;
+}
+
+
+
+/*
+   ClearDisplay()
+
+   Description:      This function clears the display, as in lcd_display.s.
+   Operation:        The clear command is queued, the shadow is reset, and
+                     the cursor is at the top left.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The clear command is queued for the LCD.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void ClearDisplay()
+{
+    LCDEnqueue(0, CLEAR_DISPLAY);
+    ResetShadow();
+    cursorAddr = ROW_0_START;
+}
+
+
+
+/*
+   ResetShadow()
+
+   Description:      This function marks the display blank in the shadow,
+                     as in lcd_display.s.
+   Operation:        The shadow is filled with spaces and the cursor
+                     address is unknown.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void ResetShadow()
+{
+    /* variables */
+    int i; /* index into the shadow */
+
+    for (i = 0; i < NUM_ROWS * NUM_COLS; i++)
+        shadow[i] = ASCII_SPACE;
+    cursorAddr = CURSOR_ADDR_UNKNOWN;
+}
+
+
+
+/*
+   LCDInvalidateCursor()
+
+   Description:      This function forgets where the LCD cursor is, as in
+                     lcd_display.s.
+   Operation:        The cursor address is unknown.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDInvalidateCursor()
+{
+    cursorAddr = CURSOR_ADDR_UNKNOWN;
+}
+
+
+
+/*
+   ShadowCell(int, int)
+
+   Description:      This function gets a cell of the shadow, so the
+                     harness can check it against the LCD.  It isn't in
+                     lcd_display.s.
+   Operation:        The cell is returned.
+
+   Arguments:        r (int) - row.
+                     c (int) - column.
+   Return Value:     (uint8_t) - the character in the shadow.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint8_t ShadowCell(int r, int c)
+{
+    return shadow[r * NUM_COLS + c];
+}
+
+
+
+/* local functions */
+
+/*
+   CheckCursorPos(int32_t, int32_t)
+
+   Description:      This function checks that a position is on the
+                     display, as in lcd_display.s.
+   Operation:        The row and column are compared with the size of the
+                     display.
+
+   Arguments:        r (int32_t) - row.
+                     c (int32_t) - column.
+   Return Value:     (int32_t) - FUNCTION_SUCCESS or FUNCTION_FAIL.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int32_t CheckCursorPos(int32_t r, int32_t c)
+{
+    if ((r < 0) || (r >= NUM_ROWS) || (c < 0) || (c >= NUM_COLS))
+        return FUNCTION_FAIL;
+    return FUNCTION_SUCCESS;
+}
+
+
+
+/*
+   WriteCell(int32_t, int32_t, uint8_t)
+
+   Description:      This function writes a character to a cell if it isn't
+                     already showing it, as in lcd_display.s.
+   Operation:        Nothing is done if the shadow already has the
+                     character.  Otherwise the shadow is updated, the DDRAM
+                     address is queued if the cursor isn't at the cell, the
+                     character is queued, and the cursor is one cell on.
+
+   Arguments:        r (int32_t) - row (must be valid).
+                     c (int32_t) - column (must be valid).
+                     ch (uint8_t) - character.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The cell is queued for the LCD if it changed.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void WriteCell(int32_t r, int32_t c, uint8_t ch)
+{
+    /* variables */
+    int32_t index = r * NUM_COLS + c; /* R4 */
+    uint8_t addr; /* R5 */
+
+    if (shadow[index] == ch)
+        return;
+    shadow[index] = ch;
+
+    addr = (uint8_t) (cursorBaseAddr[r] + c);
+    if (cursorAddr != addr)
+        LCDEnqueue(0, addr | SET_DDRAM_ADDR);
+
+    LCDEnqueue(1, ch);
+    cursorAddr = (uint8_t) (addr + 1);
+}
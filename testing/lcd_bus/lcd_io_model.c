@@ -0,0 +1,553 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              lcd_io_model.c                              */
+/*                    lcd_io.s and lcd_init.s for the Host                  */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the LCD I/O and initialization functions of
+   lcd/lcd_io.s and lcd/lcd_init.s, written in C instruction by instruction
+   for the host-side LCD bus harness.  Every load and store of a register
+   goes through RegRead and RegWrite, and the time of every other
+   instruction is counted with CPU and BRANCH, so the pins change at the
+   times they would on the board.  Functions included are:
+        LCDConfigureForRead  - configure the data pins as inputs
+        LCDConfigureForWrite - configure the data pins as outputs
+        LCDWrite             - write a byte to the LCD
+        LCDRead              - read a byte from the LCD
+        LCDWaitForNotBusy    - wait for the busy flag to clear
+        LCDIsBusy            - read the busy flag once
+        LCDInit              - initialize the LCD
+
+   The constants come from the assembly include files (lcd_symbols.h is
+   generated from them), but the instructions are copied, so a change to
+   lcd_io.s or lcd_init.s has to be made here too (the harness won't run
+   until it is and the new assembly is pinned with "make pin").  The
+   comments give the instructions each line stands for.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+       5/18/24 Adam Krivka      assembly pinned in asm.sum
+*/
+
+/* local includes */
+#include "lcd_bus.h"
+
+/* constants */
+#define DATA_PINS       (DATA_MASK << DATA_0_PIN)
+#define INIT_WAIT_BUSY  0xFFFFFFFF      /* table delay to read the busy flag */
+
+/* the initialization table of lcd_init.s, command and delay loops before */
+/*    it (INIT_WAIT_BUSY to wait for the busy flag) */
+static const uint32_t lcdInitTab[][2] = {
+    { 0x38, 15000 * LOOPS_PER_US },
+    { 0x38, 4100 * LOOPS_PER_US },
+    { 0x38, 100 * LOOPS_PER_US },
+    { 0x38, INIT_WAIT_BUSY },
+    { 0x08, INIT_WAIT_BUSY },
+    { 0x01, INIT_WAIT_BUSY },
+    { 0x06, INIT_WAIT_BUSY },
+    { 0x0C, INIT_WAIT_BUSY }
+};
+
+/* from lcd_display.s */
+void ResetShadow();
+
+
+
+/* functions */
+
+/*
+   LCDConfigureForRead()
+
+   Description:      This function configures the LCD data pins as inputs,
+                     as in lcd_io.s.
+   Operation:        Each data pin gets the generic input configuration and
+                     its output enable is cleared.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The data pins are released.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDConfigureForRead()
+{
+    /* variables */
+    uint32_t r0; /* R0 */
+    int pin; /* data pin being configured */
+
+    CPU(CYC_TAKEN + CYC_STACK(1));                      /* BL, PUSH {LR} */
+    CPU(CYC_MOV32);                                     /* MOV32 R1, IOC */
+    for (pin = DATA_0_PIN; pin <= DATA_7_PIN; pin++)
+    {
+        CPU(CYC_MOV32);                                 /* STREG */
+        RegWrite(IOC_BASE_ADDR + IOCFG_REG_SIZE * pin, IOCFG_GENERIC_INPUT);
+    }
+
+    CPU(CYC_MOV32 + CYC_OP);                            /* MOV32 R1, CPSID */
+    r0 = RegRead(GPIO_BASE_ADDR + GPIO_DOE_OFFSET);     /* LDR */
+    CPU(CYC_OP);                                        /* BIC */
+    r0 &= ~DATA_PINS;
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOE_OFFSET, r0);     /* STR */
+    CPU(CYC_OP + CYC_STACK(1) + CYC_TAKEN);             /* CPSIE, POP, BX */
+}
+
+
+
+/*
+   LCDConfigureForWrite()
+
+   Description:      This function configures the LCD data pins as outputs,
+                     as in lcd_io.s.
+   Operation:        Each data pin gets the generic output configuration
+                     and its output enable is set.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The data pins are driven.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDConfigureForWrite()
+{
+    /* variables */
+    uint32_t r0; /* R0 */
+    int pin; /* data pin being configured */
+
+    CPU(CYC_TAKEN + CYC_STACK(1));                      /* BL, PUSH {LR} */
+    CPU(CYC_MOV32);                                     /* MOV32 R1, IOC */
+    for (pin = DATA_0_PIN; pin <= DATA_7_PIN; pin++)
+    {
+        CPU(CYC_MOV32);                                 /* STREG */
+        RegWrite(IOC_BASE_ADDR + IOCFG_REG_SIZE * pin, IOCFG_GENERIC_OUTPUT);
+    }
+
+    CPU(CYC_MOV32 + CYC_OP);                            /* MOV32 R1, CPSID */
+    r0 = RegRead(GPIO_BASE_ADDR + GPIO_DOE_OFFSET);     /* LDR */
+    CPU(CYC_OP);                                        /* ORR */
+    r0 |= DATA_PINS;
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOE_OFFSET, r0);     /* STR */
+    CPU(CYC_OP + CYC_STACK(1) + CYC_TAKEN);             /* CPSIE, POP, BX */
+}
+
+
+
+/*
+   LCDWrite(UArg, UArg)
+
+   Description:      This function writes a byte to the LCD, as in lcd_io.s.
+   Operation:        The function waits for the command timer to time out,
+                     sets RS and R/W = 0, waits the setup loop, raises E
+                     with the data, starts the timer, waits for its match
+                     and lowers E.
+
+   Arguments:        rs (UArg) - register select (0 or 1).
+                     data (UArg) - byte to write.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The byte is written to the LCD.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDWrite(UArg rs, UArg data)
+{
+    /* variables */
+    uint32_t r2; /* R2 */
+
+    CPU(CYC_TAKEN + CYC_STACK(3) + 2 * CYC_MOV32);      /* BL, PUSH, MOV32 x2 */
+
+    /* LCDWriteWaitTimeOut */
+    do
+    {
+        r2 = RegRead(TIMER_BASE_ADDR + GPT_RIS_OFFSET); /* LDR */
+        CPU(CYC_OP);                                    /* TST */
+        BRANCH((r2 & GPT_RIS_TATORIS) == 0);            /* BEQ */
+    }
+    while ((r2 & GPT_RIS_TATORIS) == 0);
+
+    CPU(CYC_OP);                                        /* MOVW */
+    RegWrite(TIMER_BASE_ADDR + GPT_ICLR_OFFSET,
+             GPT_ICLR_TATOCINT_CLEAR | GPT_ICLR_TAMCINT_CLEAR);
+
+    /* RS and R/W low */
+    CPU(CYC_OP);                                        /* CPSID */
+    r2 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(3 * CYC_OP);                                    /* BIC, ORR, BIC */
+    r2 &= ~(1u << RS_PIN);
+    r2 |= (uint32_t) rs << RS_PIN;
+    r2 &= ~(1u << RW_PIN);
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r2);    /* STR */
+    CPU(CYC_OP);                                        /* CPSIE */
+
+    /* LCDWriteWaitSetup */
+    CPU(CYC_OP);                                        /* MOV */
+    for (r2 = LOOPS_IN_SETUP; r2 != 0; )
+    {
+        r2--;
+        CPU(CYC_OP);                                    /* SUBS */
+        BRANCH(r2 != 0);                                /* BNE */
+    }
+
+    /* E high and the data */
+    CPU(CYC_OP);                                        /* CPSID */
+    r2 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(3 * CYC_OP);                                    /* ORR, BIC, ORR */
+    r2 |= (1u << E_PIN);
+    r2 &= ~DATA_PINS;
+    r2 |= (uint32_t) data << DATA_0_PIN;
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r2);    /* STR */
+    CPU(CYC_OP);                                        /* CPSIE */
+
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_CTL_OFFSET, TIMER_ENABLE);
+
+    /* LCDWriteWaitPulse */
+    do
+    {
+        r2 = RegRead(TIMER_BASE_ADDR + GPT_RIS_OFFSET); /* LDR */
+        CPU(CYC_OP);                                    /* TST */
+        BRANCH((r2 & GPT_RIS_TAMRIS) == 0);             /* BEQ */
+    }
+    while ((r2 & GPT_RIS_TAMRIS) == 0);
+
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_ICLR_OFFSET, GPT_ICLR_TAMCINT_CLEAR);
+
+    /* E low */
+    CPU(CYC_OP);                                        /* CPSID */
+    r2 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(CYC_OP);                                        /* BIC */
+    r2 &= ~(1u << E_PIN);
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r2);    /* STR */
+    CPU(CYC_OP + CYC_STACK(3) + CYC_TAKEN);             /* CPSIE, POP, BX */
+}
+
+
+
+/*
+   LCDRead(UArg)
+
+   Description:      This function reads a byte from the LCD, as in
+                     lcd_io.s.  The data pins must be configured as inputs.
+   Operation:        The function waits for the command timer to time out,
+                     sets RS and R/W = 1, waits the setup loop, raises E,
+                     starts the timer, waits for its match, reads DIN and
+                     lowers E.
+
+   Arguments:        rs (UArg) - register select (0 or 1).
+   Return Value:     (UArg) - the byte read.
+   Exceptions:       None.
+
+   Inputs:           The byte is read from the LCD.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UArg LCDRead(UArg rs)
+{
+    /* variables */
+    uint32_t r0; /* R0 */
+    uint32_t r2; /* R2 */
+    uint32_t r3; /* R3 */
+
+    CPU(CYC_TAKEN + CYC_STACK(3) + 2 * CYC_MOV32);      /* BL, PUSH, MOV32 x2 */
+
+    /* LCDReadWaitTimeOut */
+    do
+    {
+        r2 = RegRead(TIMER_BASE_ADDR + GPT_RIS_OFFSET); /* LDR */
+        CPU(CYC_OP);                                    /* TST */
+        BRANCH((r2 & GPT_RIS_TATORIS) == 0);            /* BEQ */
+    }
+    while ((r2 & GPT_RIS_TATORIS) == 0);
+
+    CPU(CYC_OP);                                        /* MOVW */
+    RegWrite(TIMER_BASE_ADDR + GPT_ICLR_OFFSET,
+             GPT_ICLR_TATOCINT_CLEAR | GPT_ICLR_TAMCINT_CLEAR);
+
+    /* RS and R/W high */
+    CPU(CYC_OP);                                        /* CPSID */
+    r2 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(3 * CYC_OP);                                    /* BIC, ORR, ORR */
+    r2 &= ~(1u << RS_PIN);
+    r2 |= (uint32_t) rs << RS_PIN;
+    r2 |= (1u << RW_PIN);
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r2);    /* STR */
+    CPU(CYC_OP);                                        /* CPSIE */
+
+    /* LCDReadWaitSetup */
+    CPU(CYC_OP);                                        /* MOV */
+    for (r2 = LOOPS_IN_SETUP; r2 != 0; )
+    {
+        r2--;
+        CPU(CYC_OP);                                    /* SUBS */
+        BRANCH(r2 != 0);                                /* BNE */
+    }
+
+    /* E high */
+    CPU(CYC_OP);                                        /* CPSID */
+    r2 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(CYC_OP);                                        /* ORR */
+    r2 |= (1u << E_PIN);
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r2);    /* STR */
+    CPU(CYC_OP);                                        /* CPSIE */
+
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_CTL_OFFSET, TIMER_ENABLE);
+
+    /* LCDReadWaitPulse */
+    do
+    {
+        r2 = RegRead(TIMER_BASE_ADDR + GPT_RIS_OFFSET); /* LDR */
+        CPU(CYC_OP);                                    /* TST */
+        BRANCH((r2 & GPT_RIS_TAMRIS) == 0);             /* BEQ */
+    }
+    while ((r2 & GPT_RIS_TAMRIS) == 0);
+
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_ICLR_OFFSET, GPT_ICLR_TAMCINT_CLEAR);
+
+    /* the data, while E is still high */
+    r3 = RegRead(GPIO_BASE_ADDR + GPIO_DIN_OFFSET);     /* LDR */
+
+    /* E low */
+    CPU(CYC_OP);                                        /* CPSID */
+    r0 = RegRead(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET);    /* LDR */
+    CPU(CYC_OP);                                        /* BIC */
+    r0 &= ~(1u << E_PIN);
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOUT_OFFSET, r0);    /* STR */
+    CPU(CYC_OP);                                        /* CPSIE */
+
+    CPU(2 * CYC_OP);                                    /* LSR, AND */
+    r0 = (r3 >> DATA_0_PIN) & DATA_MASK;
+
+    CPU(CYC_STACK(3) + CYC_TAKEN);                      /* POP, BX */
+    return r0;
+}
+
+
+
+/*
+   LCDWaitForNotBusy()
+
+   Description:      This function waits for the LCD busy flag to clear, as
+                     in lcd_io.s.
+   Operation:        The data pins are configured as inputs, the busy flag
+                     is read until it is clear, and the pins are configured
+                     as outputs again.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           The busy flag is read.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDWaitForNotBusy()
+{
+    /* variables */
+    uint32_t r0; /* R0 */
+
+    CPU(CYC_TAKEN + CYC_STACK(1));                      /* BL, PUSH {LR} */
+    LCDConfigureForRead();
+
+    /* LCDWaitForNotBusyLoop */
+    do
+    {
+        CPU(CYC_OP);                                    /* MOV R0, #0 */
+        r0 = LCDRead(0);
+        CPU(CYC_OP);                                    /* TST */
+        BRANCH((r0 & BUSY_FLAG_MASK) != 0);             /* BNE */
+    }
+    while ((r0 & BUSY_FLAG_MASK) != 0);
+
+    LCDConfigureForWrite();
+    CPU(CYC_STACK(1) + CYC_TAKEN);                      /* POP, BX */
+}
+
+
+
+/*
+   LCDIsBusy()
+
+   Description:      This function reads the LCD busy flag once, as in
+                     lcd_io.s.
+   Operation:        The data pins are configured as inputs, the busy flag
+                     is read, and the pins are configured as outputs again.
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if the LCD is busy, FALSE if not.
+   Exceptions:       None.
+
+   Inputs:           The busy flag is read.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int LCDIsBusy()
+{
+    /* variables */
+    uint32_t r4; /* R4 */
+
+    CPU(CYC_TAKEN + CYC_STACK(2));                      /* BL, PUSH */
+    LCDConfigureForRead();
+    CPU(CYC_OP);                                        /* MOV R0, #0 */
+    r4 = LCDRead(0);
+    CPU(CYC_OP);                                        /* MOV R4, R0 */
+    LCDConfigureForWrite();
+
+    CPU(CYC_OP);                                        /* TST */
+    BRANCH((r4 & BUSY_FLAG_MASK) != 0);                 /* BNE */
+    CPU(CYC_MOV32 + CYC_TAKEN);                         /* MOV32, B */
+    CPU(CYC_STACK(2) + CYC_TAKEN);                      /* POP, BX */
+    return ((r4 & BUSY_FLAG_MASK) != 0) ? TRUE : FALSE;
+}
+
+
+
+/*
+   LCDInit()
+
+   Description:      This function initializes the LCD, as in lcd_init.s.
+   Operation:        The control pins are configured as outputs, the data
+                     pins for writing, and the LCD timer is set up and
+                     started (so it has timed out for the first write).
+                     Then each command of the initialization table is
+                     written after its delay loop or after waiting for the
+                     busy flag, and the display shadow is reset.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           The busy flag is read.
+   Outputs:          The LCD is initialized.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Initialization table.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void LCDInit()
+{
+    /* variables */
+    uint32_t r7; /* R7 */
+    size_t i; /* index into the table (R4) */
+
+    CPU(CYC_TAKEN + CYC_STACK(5));                      /* BL, PUSH */
+
+    /* control pins */
+    CPU(CYC_MOV32);                                     /* MOV32 R1, IOC */
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(IOC_BASE_ADDR + IOCFG_REG_SIZE * RS_PIN, IOCFG_GENERIC_OUTPUT);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(IOC_BASE_ADDR + IOCFG_REG_SIZE * RW_PIN, IOCFG_GENERIC_OUTPUT);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(IOC_BASE_ADDR + IOCFG_REG_SIZE * E_PIN, IOCFG_GENERIC_OUTPUT);
+
+    CPU(2 * CYC_MOV32);                                 /* MOV32, STREG */
+    RegWrite(GPIO_BASE_ADDR + GPIO_DOE_OFFSET,
+             (1u << RW_PIN) | (1u << RS_PIN) | (1u << E_PIN));
+
+    LCDConfigureForWrite();
+
+    /* timer */
+    CPU(CYC_MOV32);                                     /* MOV32 R1, timer */
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_CFG_OFFSET, TIMER_CFG);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_TAMR_OFFSET, TIMER_TAMR);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_TAILR_OFFSET, TIMER_TAILR);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_TAMATCHR_OFFSET, TIMER_TAMATCHR);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_TAPR_OFFSET, TIMER_TAPR);
+    CPU(CYC_MOV32);                                     /* STREG */
+    RegWrite(TIMER_BASE_ADDR + GPT_CTL_OFFSET, TIMER_ENABLE);
+
+    /* LCDInitLoop */
+    CPU(2 * CYC_OP);                                    /* ADR x2 */
+    for (i = 0; i < sizeof(lcdInitTab) / sizeof(lcdInitTab[0]); i++)
+    {
+        CPU(2 * CYC_LDR + CYC_OP);                      /* LDR x2, CMP */
+        r7 = lcdInitTab[i][1];
+        BRANCH(r7 != INIT_WAIT_BUSY);                   /* BNE */
+        if (r7 == INIT_WAIT_BUSY)
+        {
+            /* LCDInitLoopWaitBusy */
+            LCDWaitForNotBusy();
+            CPU(CYC_TAKEN);                             /* B */
+        }
+        else
+        {
+            /* LCDInitLoopWaitLoop */
+            do
+            {
+                r7--;
+                CPU(CYC_OP);                            /* SUBS */
+                BRANCH(r7 != 0);                        /* BNE */
+            }
+            while (r7 != 0);
+        }
+
+        /* LCDInitLoopWrite */
+        CPU(CYC_MOV32 + CYC_OP);                        /* MOV32, MOV */
+        LCDWrite(0, lcdInitTab[i][0]);
+        CPU(CYC_OP);                                    /* CMP */
+        BRANCH(i + 1 < sizeof(lcdInitTab) / sizeof(lcdInitTab[0])); /* BNE */
+    }
+
+    ResetShadow();
+    CPU(CYC_STACK(5) + CYC_TAKEN);                      /* POP, BX */
+}
@@ -0,0 +1,428 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                lcd_regs.c                                */
+/*                    Simulated CPU Time and LCD Registers                  */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the simulated CPU time and the registers the LCD code
+   uses, for the host-side LCD bus harness.  Functions included are:
+        SimCycles - let CPU cycles pass
+        RegRead   - read a peripheral register (an LDR in the assembly)
+        RegWrite  - write a peripheral register (an STR in the assembly)
+        RegErrors - number of accesses to registers that aren't modeled
+        HostReg   - stand-in for the registers C reads with HWREG
+
+   Local functions:
+        GptUpdate - bring the LCD timer up to the current time
+        RegError  - report an access to a register that isn't modeled
+
+   The registers modeled are GPIO DOUT, DIN and DOE, the IOC configuration
+   of each pin, timer A of the LCD timer (one-shot, counting up, with the
+   match and time-out raw interrupts), and the DWT cycle counter.  Every
+   write to DOUT or DOE is passed to the HD44780 model, and DIN returns the
+   pins the LCD drives (only for pins configured as inputs).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <inc/hw_types.h>
+#include  <inc/hw_memmap.h>
+#include  <inc/hw_cpu_dwt.h>
+#include  <inc/hw_cpu_scs.h>
+
+/* local includes */
+#include "lcd_bus.h"
+
+/* constants */
+#define NUM_PINS            32          /* pins with an IOC register */
+#define MAX_REPORTED        10          /* bad accesses printed */
+
+/* shared/global variables */
+
+/* CPU cycles since power on */
+uint64_t simCycles = 0;
+
+/* GPIO and IOC registers */
+static uint32_t gpioDout = 0;
+static uint32_t gpioDoe = 0;
+static uint32_t iocCfg[NUM_PINS];
+
+/* timer A of the LCD timer, the cycle it was started at and whether it */
+/*    is counting */
+static uint32_t gptCfg = 0;
+static uint32_t gptTamr = 0;
+static uint32_t gptCtl = 0;
+static uint32_t gptRis = 0;
+static uint32_t gptTailr = 0;
+static uint32_t gptTamatchr = 0;
+static uint32_t gptTapr = 0;
+static uint64_t gptStart = 0;
+static uint64_t gptCount = 0;          /* count at the last update */
+
+/* DWT and SCS registers read with HWREG */
+static uint32_t dwtCtrl = 0;
+static uint32_t dwtCyccnt = 0;
+static uint32_t scsDemcr = 0;
+
+/* accesses to registers that aren't modeled */
+static uint32_t regErrors = 0;
+
+/* local functions */
+static void GptUpdate(void);
+static void RegError(const char *access, uint32_t addr);
+
+
+
+/* functions */
+
+/*
+   SimCycles(uint32_t)
+
+   Description:      This function lets CPU cycles pass.
+   Operation:        The cycle count is increased.
+
+   Arguments:        n (uint32_t) - number of cycles.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void SimCycles(uint32_t n)
+{
+    simCycles += n;
+}
+
+
+
+/*
+   RegRead(uint32_t)
+
+   Description:      This function reads a peripheral register, the way an
+                     LDR in the assembly does.
+   Operation:        The time of the load passes first, so the register is
+                     read at the end of the instruction.  The timer is
+                     brought up to date before its interrupt status is read,
+                     and DIN is the output of the pins driven by the MCU and
+                     the LCD data pins driven by the LCD, for the pins with
+                     their input enabled.
+
+   Arguments:        addr (uint32_t) - register address.
+   Return Value:     (uint32_t) - the register value.
+   Exceptions:       None.
+
+   Inputs:           The pins the HD44780 model drives.
+   Outputs:          None.
+
+   Error Handling:   A register that isn't modeled is reported and reads 0.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint32_t RegRead(uint32_t addr)
+{
+    /* variables */
+    uint32_t inputs = 0; /* pins with the input enabled */
+    uint32_t pin; /* pin number */
+
+    CPU(CYC_LDR);
+
+    switch (addr)
+    {
+    case GPIO_BASE_ADDR + GPIO_DOUT_OFFSET:
+        return gpioDout;
+    case GPIO_BASE_ADDR + GPIO_DOE_OFFSET:
+        return gpioDoe;
+    case GPIO_BASE_ADDR + GPIO_DIN_OFFSET:
+        for (pin = 0; pin < NUM_PINS; pin++)
+            if ((iocCfg[pin] & IO_INPUT) != 0)
+                inputs |= (1u << pin);
+        return ((gpioDout & gpioDoe) | (HD44780Din() & ~gpioDoe)) & inputs;
+    case TIMER_BASE_ADDR + GPT_RIS_OFFSET:
+        GptUpdate();
+        return gptRis;
+    case TIMER_BASE_ADDR + GPT_CTL_OFFSET:
+        GptUpdate();
+        return gptCtl;
+    default:
+        RegError("read", addr);
+        return 0;
+    }
+}
+
+
+
+/*
+   RegWrite(uint32_t, uint32_t)
+
+   Description:      This function writes a peripheral register, the way an
+                     STR in the assembly does.
+   Operation:        The time of the store passes first, so the register
+                     changes at the end of the instruction.  DOUT and DOE
+                     are passed on to the HD44780 model.  Enabling the timer
+                     starts it from 0 if it isn't already counting, and
+                     writing ICLR clears the raw interrupts.
+
+   Arguments:        addr (uint32_t) - register address.
+                     value (uint32_t) - value to write.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The pins seen by the HD44780 model.
+
+   Error Handling:   A register that isn't modeled is reported and ignored.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void RegWrite(uint32_t addr, uint32_t value)
+{
+    CPU(CYC_STR);
+
+    /* the IOC configuration registers, one per pin */
+    if ((addr >= IOC_BASE_ADDR)
+            && (addr < IOC_BASE_ADDR + NUM_PINS * IOCFG_REG_SIZE)
+            && (((addr - IOC_BASE_ADDR) % IOCFG_REG_SIZE) == 0))
+    {
+        iocCfg[(addr - IOC_BASE_ADDR) / IOCFG_REG_SIZE] = value;
+        return;
+    }
+
+    switch (addr)
+    {
+    case GPIO_BASE_ADDR + GPIO_DOUT_OFFSET:
+        gpioDout = value;
+        HD44780Pins(gpioDout, gpioDoe);
+        break;
+    case GPIO_BASE_ADDR + GPIO_DOE_OFFSET:
+        gpioDoe = value;
+        HD44780Pins(gpioDout, gpioDoe);
+        break;
+    case TIMER_BASE_ADDR + GPT_CFG_OFFSET:
+        gptCfg = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_TAMR_OFFSET:
+        gptTamr = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_TAILR_OFFSET:
+        gptTailr = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_TAMATCHR_OFFSET:
+        gptTamatchr = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_TAPR_OFFSET:
+        gptTapr = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_CTL_OFFSET:
+        GptUpdate();
+        if (((value & GPT_CTL_TAEN_ENABLED) != 0)
+                && ((gptCtl & GPT_CTL_TAEN_ENABLED) == 0))
+        {
+            gptStart = simCycles;
+            gptCount = 0;
+        }
+        gptCtl = value;
+        break;
+    case TIMER_BASE_ADDR + GPT_ICLR_OFFSET:
+        GptUpdate();
+        gptRis &= ~value;
+        break;
+    default:
+        RegError("write", addr);
+        break;
+    }
+}
+
+
+
+/*
+   RegErrors(void)
+
+   Description:      This function returns the number of accesses to
+                     registers that aren't modeled.
+   Operation:        The count is returned.
+
+   Arguments:        None.
+   Return Value:     (uint32_t) - number of bad accesses.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+uint32_t RegErrors(void)
+{
+    return regErrors;
+}
+
+
+
+/*
+   HostReg(uint32_t)
+
+   Description:      This function stands in for the registers read and
+                     written with HWREG.  The LCD C code only uses the DWT
+                     cycle counter and the trace enable bit.
+   Operation:        The cycle counter is set from the simulated time (if
+                     it is enabled) and the modeled register is returned.
+
+   Arguments:        addr (uint32_t) - register address.
+   Return Value:     (volatile uint32_t *) - the modeled register.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Other registers are reported (and the cycle counter is
+                     returned for them).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+volatile uint32_t *HostReg(uint32_t addr)
+{
+    switch (addr)
+    {
+    case CPU_DWT_BASE + CPU_DWT_O_CTRL:
+        return &dwtCtrl;
+    case CPU_SCS_BASE + CPU_SCS_O_DEMCR:
+        return &scsDemcr;
+    case CPU_DWT_BASE + CPU_DWT_O_CYCCNT:
+        break;
+    default:
+        RegError("HWREG", addr);
+        break;
+    }
+
+    /* the counter only runs once it is enabled */
+    if (((dwtCtrl & CPU_DWT_CTRL_CYCCNTENA) != 0)
+            && ((scsDemcr & CPU_SCS_DEMCR_TRCENA) != 0))
+        dwtCyccnt = (uint32_t) simCycles;
+    return &dwtCyccnt;
+}
+
+
+
+/* local functions */
+
+/*
+   GptUpdate(void)
+
+   Description:      This function brings timer A of the LCD timer up to the
+                     current time.
+   Operation:        If the timer is counting, the count is the cycles since
+                     it was started divided by the prescale.  Reaching the
+                     match value sets the match raw interrupt (only with the
+                     match interrupt enabled in TAMR, and only once per run) and reaching the
+                     interval load value sets the time-out raw interrupt
+                     and, in one-shot mode, stops the timer.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   Only the configuration the LCD uses is modeled, any
+                     other is reported once.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void GptUpdate(void)
+{
+    /* variables */
+    static bool reported = false; /* whether a bad mode was reported */
+    uint64_t count; /* timer count */
+
+    if ((gptCtl & GPT_CTL_TAEN_ENABLED) == 0)
+        return;
+
+    if (((gptCfg != GPT_CFG_2_16BIT)
+            || ((gptTamr & 0x3) != GPT_TXMR_ONESHOT)
+            || ((gptTamr & GPT_TXMR_TXCDIR_UP) == 0)) && !reported)
+    {
+        printf("GPT: only one-shot count up is modeled (CFG 0x%lx, TAMR"
+               " 0x%lx)\n", (unsigned long) gptCfg, (unsigned long) gptTamr);
+        regErrors++;
+        reported = true;
+    }
+
+    /* the match only sets the interrupt when the count passes it */
+    count = (simCycles - gptStart) / (gptTapr + 1);
+    if (((gptTamr & GPT_TXMR_TXMIE_ENABLED) != 0) && (gptCount < gptTamatchr)
+            && (count >= gptTamatchr))
+        gptRis |= GPT_RIS_TAMRIS;
+    gptCount = count;
+    if (count >= gptTailr)
+    {
+        gptRis |= GPT_RIS_TATORIS;
+        gptCtl &= ~GPT_CTL_TAEN_ENABLED;
+    }
+}
+
+
+
+/*
+   RegError(const char *, uint32_t)
+
+   Description:      This function reports an access to a register that
+                     isn't modeled.
+   Operation:        The access is counted and the first MAX_REPORTED are
+                     printed.
+
+   Arguments:        access (const char *) - kind of access.
+                     addr (uint32_t) - register address.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The access is printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void RegError(const char *access, uint32_t addr)
+{
+    if (regErrors++ < MAX_REPORTED)
+        printf("registers: %s of 0x%08lx isn't modeled\n", access,
+               (unsigned long) addr);
+}
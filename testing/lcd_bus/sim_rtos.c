@@ -0,0 +1,694 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                sim_rtos.c                                */
+/*                     Kernel Stand-Ins on Simulated Time                   */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Clock, Semaphore, Swi and Hwi functions declared
+   in testing/shim/ti/sysbios, for the host-side LCD bus harness.  There is
+   only one thread: the clock functions run (like the clock Swi) when the
+   task waits on a semaphore, one tick at a time of simulated time.
+   Functions included are:
+        SimTick               - let time pass to the next tick
+        Clock_Params_init     - set the default clock parameters
+        Clock_construct       - set up a clock
+        Clock_handle          - get the handle of a clock
+        Clock_start           - start a clock
+        Clock_stop            - stop a clock
+        Clock_isActive        - whether a clock is running
+        Clock_setTimeout      - set the ticks to the first call
+        Clock_setPeriod       - set the ticks between calls
+        Clock_getTicks        - get the tick count
+        Semaphore_Params_init - set the default semaphore parameters
+        Semaphore_construct   - set up a semaphore
+        Semaphore_handle      - get the handle of a semaphore
+        Semaphore_pend        - wait for a semaphore, running the clocks
+        Semaphore_post        - post a semaphore
+        Swi_disable           - keep the clock functions from running
+        Swi_restore           - let them run again
+        Hwi_disable           - disable interrupts (nothing to do here)
+        Hwi_restore           - restore interrupts (nothing to do here)
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <ti/sysbios/BIOS.h>
+#include  <ti/sysbios/knl/Clock.h>
+#include  <ti/sysbios/knl/Semaphore.h>
+#include  <ti/sysbios/knl/Swi.h>
+#include  <ti/sysbios/hal/Hwi.h>
+
+/* local includes */
+#include "lcd_bus.h"
+
+/* constants */
+#define TICK_CYCLES     (Clock_tickPeriod * SIM_CPU_MHZ) /* cycles per tick */
+#define PEND_LIMIT_US   10000000        /* longest a pend forever may take */
+
+/* shared/global variables */
+
+/* clocks constructed, and whether the clock functions may run */
+static Clock_Struct *clocks = NULL;
+static bool swiEnabled = true;
+
+
+
+/* functions */
+
+/*
+   SimTick(void)
+
+   Description:      This function lets time pass to the next clock tick and
+                     runs the clock functions that are due.
+   Operation:        The time is moved to the start of the next tick.  If
+                     the Swis are enabled, every running clock whose next
+                     call is at or before this tick is called and its next
+                     call is set one period later (so a clock that fell
+                     behind catches up on the following ticks).  A clock
+                     without a period is stopped.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of clocks.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void SimTick(void)
+{
+    /* variables */
+    Clock_Struct *pClock; /* clock being checked */
+    uint64_t tick; /* the new tick */
+
+    tick = simCycles / TICK_CYCLES + 1;
+    simCycles = tick * TICK_CYCLES;
+
+    if (!swiEnabled)
+        return;
+
+    for (pClock = clocks; pClock != NULL; pClock = pClock->next)
+    {
+        if (!pClock->active || (pClock->due > tick))
+            continue;
+
+        if (pClock->period == 0)
+            pClock->active = FALSE;
+        else
+            pClock->due += pClock->period;
+        pClock->fxn(pClock->arg);
+    }
+}
+
+
+
+/*
+   Clock_Params_init(Clock_Params *)
+
+   Description:      This function sets the default clock parameters.
+   Operation:        The clock is one-shot, not started, with argument 0.
+
+   Arguments:        params (Clock_Params *) - parameters to set.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_Params_init(Clock_Params *params)
+{
+    params->period = 0;
+    params->startFlag = FALSE;
+    params->arg = 0;
+}
+
+
+
+/*
+   Clock_construct(Clock_Struct *, Clock_FuncPtr, UInt32, const Clock_Params *)
+
+   Description:      This function sets up a clock.
+   Operation:        The clock is filled in from the arguments, added to
+                     the list of clocks and started if startFlag is set.
+
+   Arguments:        obj (Clock_Struct *) - the clock.
+                     fxn (Clock_FuncPtr) - function to call.
+                     timeout (UInt32) - ticks to the first call.
+                     params (const Clock_Params *) - parameters (NULL for
+                        the defaults).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Linked list of clocks.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn, UInt32 timeout,
+                     const Clock_Params *params)
+{
+    /* variables */
+    Clock_Params defaults; /* parameters used without any */
+
+    if (params == NULL)
+    {
+        Clock_Params_init(&defaults);
+        params = &defaults;
+    }
+
+    obj->fxn = fxn;
+    obj->arg = params->arg;
+    obj->timeout = timeout;
+    obj->period = params->period;
+    obj->active = FALSE;
+    obj->next = clocks;
+    clocks = obj;
+
+    if (params->startFlag)
+        Clock_start(obj);
+}
+
+
+
+/*
+   Clock_handle(Clock_Struct *)
+
+   Description:      This function gets the handle of a clock.
+   Operation:        The handle is the clock itself.
+
+   Arguments:        obj (Clock_Struct *) - the clock.
+   Return Value:     (Clock_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Clock_Handle Clock_handle(Clock_Struct *obj)
+{
+    return obj;
+}
+
+
+
+/*
+   Clock_start(Clock_Handle)
+
+   Description:      This function starts a clock.
+   Operation:        The first call is set timeout ticks from now.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_start(Clock_Handle handle)
+{
+    handle->due = simCycles / TICK_CYCLES + handle->timeout;
+    handle->active = TRUE;
+}
+
+
+
+/*
+   Clock_stop(Clock_Handle)
+
+   Description:      This function stops a clock.
+   Operation:        The clock is marked not running.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_stop(Clock_Handle handle)
+{
+    handle->active = FALSE;
+}
+
+
+
+/*
+   Clock_isActive(Clock_Handle)
+
+   Description:      This function returns whether a clock is running.
+   Operation:        The running flag is returned.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+   Return Value:     (Bool) - TRUE if it is running.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Bool Clock_isActive(Clock_Handle handle)
+{
+    return handle->active;
+}
+
+
+
+/*
+   Clock_setTimeout(Clock_Handle, UInt32)
+
+   Description:      This function sets the ticks from a start of the clock
+                     to its first call.
+   Operation:        The timeout is saved for the next start.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+                     timeout (UInt32) - ticks to the first call.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_setTimeout(Clock_Handle handle, UInt32 timeout)
+{
+    handle->timeout = timeout;
+}
+
+
+
+/*
+   Clock_setPeriod(Clock_Handle, UInt32)
+
+   Description:      This function sets the ticks between calls of a clock.
+   Operation:        The period is saved.
+
+   Arguments:        handle (Clock_Handle) - the clock.
+                     period (UInt32) - ticks between calls (0 for one).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Clock_setPeriod(Clock_Handle handle, UInt32 period)
+{
+    handle->period = period;
+}
+
+
+
+/*
+   Clock_getTicks(void)
+
+   Description:      This function gets the number of ticks since power on.
+   Operation:        The simulated time is divided by the tick length.
+
+   Arguments:        None.
+   Return Value:     (UInt32) - the tick count.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt32 Clock_getTicks(void)
+{
+    return (UInt32) (simCycles / TICK_CYCLES);
+}
+
+
+
+/*
+   Semaphore_Params_init(Semaphore_Params *)
+
+   Description:      This function sets the default semaphore parameters.
+   Operation:        The semaphore is counting.
+
+   Arguments:        params (Semaphore_Params *) - parameters to set.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Semaphore_Params_init(Semaphore_Params *params)
+{
+    params->mode = Semaphore_Mode_COUNTING;
+}
+
+
+
+/*
+   Semaphore_construct(Semaphore_Struct *, Int, const Semaphore_Params *)
+
+   Description:      This function sets up a semaphore.
+   Operation:        The mode and count are set.
+
+   Arguments:        obj (Semaphore_Struct *) - the semaphore.
+                     count (Int) - initial count.
+                     params (const Semaphore_Params *) - parameters (NULL
+                        for the defaults).
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Semaphore_construct(Semaphore_Struct *obj, Int count,
+                         const Semaphore_Params *params)
+{
+    obj->mode = (params == NULL) ? Semaphore_Mode_COUNTING : params->mode;
+    obj->count = (UInt) count;
+    obj->host = NULL;
+}
+
+
+
+/*
+   Semaphore_handle(Semaphore_Struct *)
+
+   Description:      This function gets the handle of a semaphore.
+   Operation:        The handle is the semaphore itself.
+
+   Arguments:        obj (Semaphore_Struct *) - the semaphore.
+   Return Value:     (Semaphore_Handle) - its handle.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Semaphore_Handle Semaphore_handle(Semaphore_Struct *obj)
+{
+    return obj;
+}
+
+
+
+/*
+   Semaphore_pend(Semaphore_Handle, UInt32)
+
+   Description:      This function waits for a semaphore.  While the task
+                     waits, time passes and the clock functions run.
+   Operation:        Ticks are run until the semaphore is posted or the
+                     timeout passes, then the count is taken.
+
+   Arguments:        handle (Semaphore_Handle) - the semaphore.
+                     timeout (UInt32) - ticks to wait at most
+                        (BIOS_WAIT_FOREVER for no limit).
+   Return Value:     (Bool) - TRUE if the semaphore was taken, FALSE on a
+                     timeout.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   A pend forever that isn't posted within PEND_LIMIT_US
+                     of simulated time can never return, so the harness
+                     stops.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+Bool Semaphore_pend(Semaphore_Handle handle, UInt32 timeout)
+{
+    /* variables */
+    uint64_t start = simCycles / TICK_CYCLES; /* tick the wait started */
+    uint64_t limit; /* ticks to wait at most */
+
+    limit = (timeout == BIOS_WAIT_FOREVER) ?
+            (PEND_LIMIT_US / Clock_tickPeriod) : timeout;
+
+    while (handle->count == 0)
+    {
+        if (simCycles / TICK_CYCLES - start >= limit)
+        {
+            if (timeout != BIOS_WAIT_FOREVER)
+                return FALSE;
+            printf("Semaphore_pend: not posted in %d s, the task is stuck\n",
+                   PEND_LIMIT_US / 1000000);
+            exit(EXIT_FAILURE);
+        }
+        SimTick();
+    }
+
+    handle->count--;
+    return TRUE;
+}
+
+
+
+/*
+   Semaphore_post(Semaphore_Handle)
+
+   Description:      This function posts a semaphore.
+   Operation:        The count is incremented (set to 1 for a binary
+                     semaphore).
+
+   Arguments:        handle (Semaphore_Handle) - the semaphore.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Semaphore_post(Semaphore_Handle handle)
+{
+    if (handle->mode == Semaphore_Mode_BINARY)
+        handle->count = 1;
+    else
+        handle->count++;
+}
+
+
+
+/*
+   Swi_disable(void)
+
+   Description:      This function keeps the clock functions from running.
+   Operation:        The Swis are disabled and whether they were enabled is
+                     returned.
+
+   Arguments:        None.
+   Return Value:     (UInt) - key for Swi_restore.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt Swi_disable(void)
+{
+    /* variables */
+    UInt key = swiEnabled; /* whether they were enabled */
+
+    swiEnabled = false;
+    return key;
+}
+
+
+
+/*
+   Swi_restore(UInt)
+
+   Description:      This function lets the clock functions run again if
+                     they could before Swi_disable.
+   Operation:        The enable is restored from the key.
+
+   Arguments:        key (UInt) - key from Swi_disable.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Swi_restore(UInt key)
+{
+    swiEnabled = (key != 0);
+}
+
+
+
+/*
+   Hwi_disable(void)
+
+   Description:      This function disables interrupts.  Nothing interrupts
+                     the single thread of the harness, so there is nothing
+                     to do.
+   Operation:        None.
+
+   Arguments:        None.
+   Return Value:     (UInt) - key for Hwi_restore (0).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+UInt Hwi_disable(void)
+{
+    return 0;
+}
+
+
+
+/*
+   Hwi_restore(UInt)
+
+   Description:      This function restores interrupts.  There is nothing
+                     to do (see Hwi_disable).
+   Operation:        None.
+
+   Arguments:        key (UInt) - key from Hwi_disable.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+void Hwi_restore(UInt key)
+{
+    (void) key;
+}
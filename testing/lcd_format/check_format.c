@@ -0,0 +1,445 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              check_format.c                              */
+/*                     Display_printf Host-Side Checker                     */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains a host program that checks the formatting of the LCD
+   utility functions (ee110b_hw6_barebot_client/Application/lcd/lcd_util.c,
+   compiled as it is with the stand-ins in testing/shim).  It is built and
+   run with "make" in this directory.  Functions included are:
+        main    - run all the checks
+        Display - stand-in for the LCD, keeps the string
+        HostReg - stand-in for the registers (the cycle counter)
+
+   Local functions:
+        CheckString   - compare the last displayed string
+        CheckCases    - check the formats against expected strings
+        CheckSnprintf - check the formats against snprintf
+        ShowTiming    - time the formatters on the host
+
+   The expected strings cover what snprintf can't check: the fixed-point
+   precision on %d, and the truncation at the end of the row.  The formats
+   with the same meaning as in C are also checked against snprintf, which
+   truncates at the same place when given TEXT_BUF_SIZE.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+/* includes */
+#include  <xdc/std.h>
+#include  <stdint.h>
+#include  <stdio.h>
+#include  <string.h>
+#include  <time.h>
+#include  <inc/hw_memmap.h>
+#include  <inc/hw_cpu_dwt.h>
+
+/* local includes */
+#include "lcd_util.h"
+#include "lcd_rtos_intf.h"
+
+/* constants */
+#define  NUM_COLS       16              /* columns on the display */
+#define  MAX_ERRORS     10              /* mismatches printed per check */
+
+/* check that a Display_printf call shows the expected string */
+#define  CHECK_PRINTF(expected, ...)                                    \
+    (Display_printf(0, 0, NUM_COLS, __VA_ARGS__),                       \
+     CheckString((expected), #__VA_ARGS__))
+
+/* check that a typed helper call shows the expected string */
+#define  CHECK_CALL(expected, call)                                     \
+    ((call), CheckString((expected), #call))
+
+/* shared/global variables */
+
+/* last string displayed and the number of mismatches */
+static char displayed[TEXT_BUF_SIZE * 2];
+static int errors = 0;
+
+/* the modeled cycle counter */
+static volatile uint32_t cycleCount;
+
+/* local functions */
+static int CheckString(const char *expected, const char *call);
+static void CheckCases(void);
+static void CheckSnprintf(void);
+static void ShowTiming(void);
+
+
+
+/* functions */
+
+/*
+   main(void)
+
+   Description:      This function runs all the checks and prints how they
+                     went.
+   Operation:        Each check is run, counting the mismatches.
+
+   Arguments:        None.
+   Return Value:     0 if every check passed, 1 otherwise.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The results are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int main(void)
+{
+    CheckCases();
+    CheckSnprintf();
+    ShowTiming();
+
+    printf("%s\n", (errors == 0) ? "all checks passed" : "CHECKS FAILED");
+    return (errors == 0) ? 0 : 1;
+}
+
+
+
+/*
+   Display(UArg, UArg, char *, UArg)
+
+   Description:      This function stands in for the LCD Display function.
+                     It keeps the string to be checked.
+   Operation:        The string is copied, a string that is too long for
+                     a row is an error.
+
+   Arguments:        r (UArg) - row (not used).
+                     c (UArg) - column (not used).
+                     str (char *) - string to display.
+                     len (UArg) - target length (not used).
+   Return Value:     (int) - 0 (FUNCTION_SUCCESS).
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          None.
+
+   Error Handling:   A string longer than a row is counted as an error.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+int Display(UArg r, UArg c, char *str, UArg len)
+{
+    (void) r;
+    (void) c;
+    (void) len;
+
+    if (strlen(str) > NUM_COLS)
+    {
+        printf("Display: \"%s\" is longer than a row\n", str);
+        errors++;
+    }
+    snprintf(displayed, sizeof(displayed), "%s", str);
+    return 0;
+}
+
+
+
+/*
+   HostReg(uint32_t)
+
+   Description:      This function stands in for the registers read with
+                     HWREG.  Only the cycle counter is used by lcd_util.c.
+   Operation:        The cycle counter is set from the host clock (in ns)
+                     and returned, any other address is an error.
+
+   Arguments:        addr (uint32_t) - register address.
+   Return Value:     (volatile uint32_t *) - the modeled register.
+   Exceptions:       None.
+
+   Inputs:           The host clock.
+   Outputs:          None.
+
+   Error Handling:   Other registers are counted as an error (and the cycle
+                     counter is returned for them).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+volatile uint32_t *HostReg(uint32_t addr)
+{
+    /* variables */
+    struct timespec now; /* host clock */
+
+    if (addr != (CPU_DWT_BASE + CPU_DWT_O_CYCCNT))
+    {
+        printf("HostReg: unexpected register 0x%08lx\n", (unsigned long) addr);
+        errors++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    cycleCount = (uint32_t) ((uint64_t) now.tv_sec * 1000000000u
+            + (uint64_t) now.tv_nsec);
+    return &cycleCount;
+}
+
+
+
+/*
+   CheckString(const char *, const char *)
+
+   Description:      This function compares the last displayed string with
+                     the expected one.
+   Operation:        The strings are compared, a mismatch is printed with
+                     the call that made it and counted.
+
+   Arguments:        expected (const char *) - string that should be shown.
+                     call (const char *) - the call, for the message.
+   Return Value:     (int) - 1 for a mismatch, 0 otherwise.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          Mismatches are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static int CheckString(const char *expected, const char *call)
+{
+    if (strcmp(expected, displayed) == 0)
+        return 0;
+
+    printf("%s: \"%s\", expected \"%s\"\n", call, displayed, expected);
+    errors++;
+    return 1;
+}
+
+
+
+/*
+   CheckCases(void)
+
+   Description:      This function checks the formats against expected
+                     strings, mainly those snprintf can't check.
+   Operation:        Each case is displayed and compared.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   Every mismatch is printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void CheckCases(void)
+{
+    /* variables */
+    int start = errors; /* errors before the cases */
+    int cases = 0; /* number of cases */
+
+    /* the extremes of %d, %u and %x */
+    cases++; CHECK_PRINTF("-2147483648", "%d", INT32_MIN);
+    cases++; CHECK_PRINTF("2147483647", "%d", INT32_MAX);
+    cases++; CHECK_PRINTF("4294967295", "%u", UINT32_MAX);
+    cases++; CHECK_PRINTF("0", "%d", 0);
+    cases++; CHECK_PRINTF("deadbeef", "%x", 0xDEADBEEFu);
+    cases++; CHECK_PRINTF("0", "%x", 0);
+    cases++; CHECK_PRINTF("000a", "%04x", 0xA);
+    cases++; CHECK_PRINTF("ffffffff", "%x", -1);
+
+    /* fixed point, negative and below 1 */
+    cases++; CHECK_PRINTF("12.34", "%.2d", 1234);
+    cases++; CHECK_PRINTF("-12.34", "%.2d", -1234);
+    cases++; CHECK_PRINTF("0.05", "%.2d", 5);
+    cases++; CHECK_PRINTF("-0.05", "%.2d", -5);
+    cases++; CHECK_PRINTF("0.00", "%.2d", 0);
+    cases++; CHECK_PRINTF("0.99", "%.2d", 99);
+    cases++; CHECK_PRINTF("-1.00", "%.2d", -100);
+    cases++; CHECK_PRINTF("-0.5", "%.1d", -5);
+    cases++; CHECK_PRINTF("0.001", "%.3u", 1);
+    cases++; CHECK_PRINTF("-21474836.48", "%.2d", INT32_MIN);
+    cases++; CHECK_PRINTF("   -0.05", "%8.2d", -5);
+    cases++; CHECK_PRINTF("-0.05   |", "%-8.2d|", -5);
+    cases++; CHECK_PRINTF("-0000.05", "%08.2d", -5);
+    cases++; CHECK_PRINTF("7", "%.0d", 7);
+
+    /* justification and zero padding */
+    cases++; CHECK_PRINTF("42   |", "%-5d|", 42);
+    cases++; CHECK_PRINTF("-42  |", "%-5d|", -42);
+    cases++; CHECK_PRINTF("00042", "%05d", 42);
+    cases++; CHECK_PRINTF("-0042", "%05d", -42);
+    cases++; CHECK_PRINTF("  -42", "%5d", -42);
+    cases++; CHECK_PRINTF("42   |", "%-05d|", 42);
+    cases++; CHECK_PRINTF("123456", "%3d", 123456);
+
+    /* strings, characters and % */
+    cases++; CHECK_PRINTF("a|  b|c  ", "%c|%3c|%-3c", 'a', 'b', 'c');
+    cases++; CHECK_PRINTF("  hi|hi  |bot", "%4s|%-4s|%.3s", "hi", "hi",
+                          "bot thoughts");
+    cases++; CHECK_PRINTF("100%", "%d%%", 100);
+    cases++; CHECK_PRINTF("%q", "%q");
+
+    /* truncation at the end of the row (TEXT_BUF_SIZE) */
+    cases++; CHECK_PRINTF("abcdefghijklmnop", "abcdefghijklmnopqrstuvwxyz");
+    cases++; CHECK_PRINTF("abcdefghijklmno1", "abcdefghijklmno%d", 123);
+    cases++; CHECK_PRINTF("Speed: -21474836", "Speed: %d", INT32_MIN);
+    cases++; CHECK_PRINTF("Turn:   -2147483", "Turn:   %.3d", INT32_MIN);
+    cases++; CHECK_PRINTF("           -2147", "%16d%d", -2147, 1);
+    cases++; CHECK_PRINTF("0123456789abcdef", "%s%s", "0123456789",
+                          "abcdefghijk");
+    cases++; CHECK_PRINTF("x               ", "%-20s", "x");
+    cases++; CHECK_PRINTF("-000000000000000", "%020d", -5);
+
+    /* the typed helpers */
+    cases++; CHECK_CALL("-2147483648", Display_int(0, 0, 4, INT32_MIN));
+    cases++; CHECK_CALL("-1234", Display_int(0, 0, 4, -1234));
+    cases++; CHECK_CALL("-0.05", Display_fixed(0, 0, 4, -5, 2));
+    cases++; CHECK_CALL("12.34", Display_fixed(0, 0, 4, 1234, 2));
+    cases++; CHECK_CALL("Speed:  -32768",
+                        Display_labelInt(0, 0, 12, "Speed:  ", -32768));
+    cases++; CHECK_CALL("Speed:  -2147483",
+                        Display_labelInt(0, 0, 12, "Speed:  ", INT32_MIN));
+    cases++; CHECK_CALL("A very long labe",
+                        Display_labelInt(0, 0, 12, "A very long label", 1));
+
+    printf("cases: %d compared, %d errors\n", cases, errors - start);
+}
+
+
+
+/*
+   CheckSnprintf(void)
+
+   Description:      This function checks the formats that mean the same
+                     as in C against snprintf with a row-sized buffer.
+   Operation:        Every format is displayed for values around every
+                     power of 10 and 16, and the extreme values, and
+                     compared with snprintf.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The result is printed to stdout.
+
+   Error Handling:   The first mismatches are printed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void CheckSnprintf(void)
+{
+    /* variables */
+    static const char *const formats[] = {
+        "%d", "%i", "%u", "%x", "%1d", "%5d", "%-5d|", "%05d", "%12d",
+        "%-12d|", "%012d", "%8x", "%-8x|", "%08x", "%5u", "%05u",
+        "Speed:  %d", "Turn: %6d|", "%d,%d", "%-6d%6d" };
+    int64_t values[512]; /* values checked */
+    int nValues = 0; /* number of values */
+    int64_t power; /* power of the base */
+    char expected[TEXT_BUF_SIZE]; /* string from snprintf */
+    int start = errors; /* errors before the check */
+    int compared = 0; /* number of strings compared */
+    int32_t value; /* value being checked */
+    unsigned f; /* format index */
+    int i; /* value index */
+    int d; /* offset from the power */
+
+    /* values around the powers of 10 and 16 */
+    for (power = 1; power <= INT32_MAX; power *= 10)
+        for (d = -1; d <= 1; d++)
+        {
+            values[nValues++] = power + d;
+            values[nValues++] = -(power + d);
+        }
+    for (power = 16; power <= UINT32_MAX; power *= 16)
+        for (d = -1; d <= 1; d++)
+            values[nValues++] = (uint32_t) (power + d);
+    values[nValues++] = INT32_MIN;
+    values[nValues++] = INT32_MAX;
+    values[nValues++] = UINT32_MAX;
+
+    for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++)
+    {
+        for (i = 0; i < nValues; i++)
+        {
+            value = (int32_t) (uint32_t) values[i];
+            snprintf(expected, sizeof(expected), formats[f], value, value);
+            Display_printf(0, 0, NUM_COLS, (char*) formats[f], value, value);
+            compared++;
+            if ((strcmp(expected, displayed) != 0)
+                    && (errors++ - start < MAX_ERRORS))
+                printf("snprintf: \"%s\" of %ld gave \"%s\", not \"%s\"\n",
+                       formats[f], (long) value, displayed, expected);
+        }
+    }
+
+    printf("snprintf: %d strings compared, %d errors\n", compared,
+           errors - start);
+}
+
+
+
+/*
+   ShowTiming(void)
+
+   Description:      This function times the formatters with the modeled
+                     cycle counter, which counts host ns.  The times are
+                     only a rough guide, the cycles on the board come from
+                     Display_measureFormat there.
+   Operation:        Display_measureFormat is called and the times printed.
+
+   Arguments:        None.
+   Return Value:     None.
+   Exceptions:       None.
+
+   Inputs:           None.
+   Outputs:          The times are printed to stdout.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+static void ShowTiming(void)
+{
+    /* variables */
+    lcdFormatStats_t stats; /* time per call */
+
+    Display_measureFormat(&stats);
+    printf("host ns per call: \"%%d\" vsprintf %lu, FormatVa %lu, "
+           "Display_int %lu\n", (unsigned long) stats.sprintfCycles,
+           (unsigned long) stats.printfCycles,
+           (unsigned long) stats.intCycles);
+    printf("host ns per call: \"Speed:  %%d\" vsprintf %lu, FormatVa %lu, "
+           "Display_labelInt %lu\n", (unsigned long) stats.labelSprintfCycles,
+           (unsigned long) stats.labelPrintfCycles,
+           (unsigned long) stats.labelIntCycles);
+}
@@ -0,0 +1,86 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                bcomdef.h                                 */
+/*                        Host Stand-In for <bcomdef.h>                     */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the BLE stack types, status codes and macros the
+   application code uses (from bcomdef.h and the comdef.h it includes), so
+   it can be compiled on a host by the checkers in testing/.  The values are
+   the ones the stack uses.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef BCOMDEF_H
+    #define BCOMDEF_H
+
+#include  <xdc/std.h>
+
+/* types */
+typedef uint8_t         uint8;
+typedef uint16_t        uint16;
+typedef uint32_t        uint32;
+typedef int8_t          int8;
+typedef int16_t         int16;
+typedef int32_t         int32;
+typedef uint8_t         halDataAlign_t;
+
+typedef uint8_t         status_t;       /* general status */
+typedef uint8_t         bStatus_t;      /* BLE stack status */
+
+/* constants */
+#ifndef CONST
+#define CONST           const
+#endif
+
+/* general status codes */
+#define SUCCESS                 0x00
+#define FAILURE                 0x01
+#define INVALIDPARAMETER        0x02
+#define INVALID_TASK            0x03
+#define MSG_BUFFER_NOT_AVAIL    0x04
+#define INVALID_MSG_POINTER     0x05
+#define NV_ITEM_UNINIT          0x09
+#define NV_OPER_FAILED          0x0A
+#define INVALID_MEM_SIZE        0x0B
+
+/* BLE stack status codes */
+#define bleNotReady                 0x10
+#define bleAlreadyInRequestedMode   0x11
+#define bleIncorrectMode            0x12
+#define bleMemAllocError            0x13
+#define bleNotConnected             0x14
+#define bleNoResources              0x15
+#define blePending                  0x16
+#define bleTimeout                  0x17
+#define bleInvalidRange             0x18
+#define bleProcedureComplete        0x1A
+
+/* task ID meaning no task */
+#define INVALID_TASK_ID         0xFF
+
+/* length of a Bluetooth device address */
+#define B_ADDR_LEN              6
+
+/* first SNV item ID the application may use */
+#define BLE_NVID_CUST_START     0x80
+#define BLE_NVID_CUST_END       0x8F
+
+/* macros */
+#define BUILD_UINT16(loByte, hiByte) \
+            ((uint16) (((loByte) & 0x00FF) + (((hiByte) & 0x00FF) << 8)))
+#define LO_UINT16(a)            ((uint8) ((a) & 0xFF))
+#define HI_UINT16(a)            ((uint8) (((a) >> 8) & 0xFF))
+
+#ifndef MIN
+#define MIN(n, m)               (((n) < (m)) ? (n) : (m))
+#endif
+#ifndef MAX
+#define MAX(n, m)               (((n) < (m)) ? (m) : (n))
+#endif
+
+#endif
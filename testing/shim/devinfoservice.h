@@ -0,0 +1,30 @@
+/****************************************************************************/
+/*                                                                          */
+/*                             devinfoservice.h                             */
+/*                     Host Stand-In for <devinfoservice.h>                 */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Device Information Service functions the
+   application code uses, so it can be compiled on a host by the checkers in
+   testing/.  The functions are defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef DEVINFOSERVICE_H
+    #define DEVINFOSERVICE_H
+
+#include  <bcomdef.h>
+
+/* parameters */
+#define DEVINFO_SYSTEM_ID       0
+#define DEVINFO_SYSTEM_ID_LEN   8
+
+/* functions (defined by the checker) */
+bStatus_t DevInfo_AddService(void);
+bStatus_t DevInfo_SetParameter(uint8 param, uint8 len, void *value);
+
+#endif
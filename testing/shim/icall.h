@@ -0,0 +1,63 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  icall.h                                 */
+/*                         Host Stand-In for <icall.h>                      */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the ICall interface between the application tasks and
+   the BLE stack that the application code uses, so it can be compiled on a
+   host by the checkers in testing/.  The sync handle of a task is its RTOS
+   event, as with TI-RTOS.  The functions are defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef ICALL_H
+    #define ICALL_H
+
+#include  <xdc/std.h>
+#include  <ti/sysbios/BIOS.h>
+#include  <ti/sysbios/knl/Event.h>
+
+/* constants */
+
+/* event posted when a stack message is queued to a task */
+#define ICALL_MSG_EVENT_ID          Event_Id_31
+
+/* wait forever */
+#define ICALL_TIMEOUT_FOREVER       BIOS_WAIT_FOREVER
+
+/* error numbers */
+#define ICALL_ERRNO_SUCCESS         0
+#define ICALL_ERRNO_NOMSG           (-5)
+#define ICALL_ERRNO_NO_RESOURCE     (-6)
+
+/* service classes */
+#define ICALL_SERVICE_CLASS_BLE     0x0010
+
+/* types */
+typedef uint8_t         ICall_EntityID;
+typedef uint16_t        ICall_ServiceEnum;
+typedef int_fast16_t    ICall_Errno;
+typedef Event_Handle    ICall_SyncHandle;
+
+/* header of every stack message */
+typedef struct {
+    uint8_t     event;                  /* message type */
+    uint8_t     status;                 /* status (or event code) */
+} ICall_Hdr;
+
+/* functions (defined by the checker) */
+ICall_Errno ICall_registerApp(ICall_EntityID *pEntity,
+                              ICall_SyncHandle *pSyncHandle);
+ICall_Errno ICall_fetchServiceMsg(ICall_ServiceEnum *pSrc,
+                                  ICall_EntityID *pDest, void **pMsg);
+void       *ICall_malloc(uint_least16_t size);
+void        ICall_free(void *pMsg);
+void       *ICall_allocMsg(size_t size);
+void        ICall_freeMsg(void *pMsg);
+
+#endif
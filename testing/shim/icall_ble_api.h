@@ -0,0 +1,547 @@
+/****************************************************************************/
+/*                                                                          */
+/*                              icall_ble_api.h                             */
+/*                     Host Stand-In for <icall_ble_api.h>                  */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the parts of the BLE stack API (GAP, the advertiser,
+   scanner and initiator, GATT, ATT, the GATT server application and HCI)
+   the application code uses, so it can be compiled on a host by the
+   checkers in testing/.  The constants are the ones the stack uses and the
+   structures have the fields the stack's do (only the fields the code
+   uses, and in their order).  The functions are defined by each checker.
+   <string.h> is included as the stack headers include it (the application
+   code uses memcpy without including it).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef ICALL_BLE_API_H
+    #define ICALL_BLE_API_H
+
+#include  <string.h>
+#include  <icall.h>
+#include  <bcomdef.h>
+
+
+
+/* stack message types (ICall_Hdr event) */
+#define HCI_GAP_EVENT_EVENT                 0x91
+#define GATT_MSG_EVENT                      0xB0
+#define GAP_MSG_EVENT                       0xD0
+
+/* HCI event codes */
+#define HCI_BLE_HARDWARE_ERROR_EVENT_CODE   0x10
+
+/* header of a stack message (osal_event_hdr_t in the stack) */
+typedef ICall_Hdr osal_event_hdr_t;
+
+/* stack event (a signature of 0xffff is a command status, not a message) */
+typedef struct {
+    ICall_Hdr   hdr;                    /* message header */
+    uint16_t    signature;              /* 0xffff for stack events */
+} ICall_Stack_Event;
+
+/* HCI extended event */
+typedef struct {
+    ICall_Hdr   hdr;                    /* message header */
+    uint8_t    *pData;                  /* event data */
+} ICall_HciExtEvt;
+
+
+
+/* GAP */
+
+/* GAP event opcodes */
+#define GAP_DEVICE_INIT_DONE_EVENT          0x00
+#define GAP_LINK_ESTABLISHED_EVENT          0x05
+#define GAP_LINK_TERMINATED_EVENT           0x06
+#define GAP_LINK_PARAM_UPDATE_EVENT         0x07
+
+/* device roles */
+#define GAP_PROFILE_BROADCASTER             0x01
+#define GAP_PROFILE_OBSERVER                0x02
+#define GAP_PROFILE_PERIPHERAL              0x04
+#define GAP_PROFILE_CENTRAL                 0x08
+
+/* GAP parameters and the link update decisions */
+#define GAP_PARAM_LINK_UPDATE_DECISION      0x0E
+#define GAP_UPDATE_REQ_PASS_TO_APP          0x00
+#define GAP_UPDATE_REQ_ACCEPT_ALL           0x01
+#define GAP_UPDATE_REQ_DENY_ALL             0x02
+
+/* GAP GATT server parameters and services */
+#define GGS_DEVICE_NAME_ATT                 0
+#define GAP_SERVICE                         0x00000001
+
+/* advertising data types */
+#define GAP_ADTYPE_FLAGS                    0x01
+#define GAP_ADTYPE_16BIT_MORE               0x02
+#define GAP_ADTYPE_16BIT_COMPLETE           0x03
+#define GAP_ADTYPE_LOCAL_NAME_SHORT         0x08
+#define GAP_ADTYPE_LOCAL_NAME_COMPLETE      0x09
+#define GAP_ADTYPE_POWER_LEVEL              0x0A
+#define GAP_ADTYPE_PERIPHERAL_CONN_INTERVAL_RANGE   0x12
+#define GAP_ADTYPE_FLAGS_GENERAL            0x02
+#define GAP_ADTYPE_FLAGS_BREDR_NOT_SUPPORTED    0x04
+
+/* address modes and types */
+typedef enum {
+    ADDRMODE_PUBLIC = 0x00,
+    ADDRMODE_RANDOM = 0x01,
+    ADDRMODE_RP_WITH_PUBLIC_ID = 0x02,
+    ADDRMODE_RP_WITH_RANDOM_ID = 0x03
+} GAP_Addr_Modes_t;
+
+#define ADDRTYPE_PUBLIC                     0x00
+#define ADDRTYPE_RANDOM                     0x01
+
+/* link roles */
+#define GAP_PROFILE_ROLE_CENTRAL            GAP_PROFILE_CENTRAL
+#define GAP_PROFILE_ROLE_PERIPHERAL         GAP_PROFILE_PERIPHERAL
+
+/* header of a GAP message */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GAP_MSG_EVENT and status */
+    uint8       opcode;                 /* GAP event opcode */
+} gapEventHdr_t;
+
+/* GAP_DEVICE_INIT_DONE_EVENT */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GAP_MSG_EVENT and status */
+    uint8       opcode;                 /* GAP_DEVICE_INIT_DONE_EVENT */
+    uint8       devAddr[B_ADDR_LEN];    /* device address */
+    uint16      dataPktLen;             /* HC_LE_Data_Packet_Length */
+    uint8       numDataPkts;            /* HC_Total_Num_LE_Data_Packets */
+} gapDeviceInitDoneEvent_t;
+
+/* GAP_LINK_ESTABLISHED_EVENT */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GAP_MSG_EVENT and status */
+    uint8       opcode;                 /* GAP_LINK_ESTABLISHED_EVENT */
+    uint8       devAddrType;            /* peer address type */
+    uint8       devAddr[B_ADDR_LEN];    /* peer address */
+    uint16      connectionHandle;       /* connection handle */
+    uint8       connRole;               /* role of this device on the link */
+    uint16      connInterval;           /* interval (1.25 ms units) */
+    uint16      connLatency;            /* peripheral latency */
+    uint16      connTimeout;            /* supervision timeout (10 ms units) */
+    uint8       clockAccuracy;          /* peer clock accuracy */
+} gapEstLinkReqEvent_t;
+
+/* GAP_LINK_TERMINATED_EVENT */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GAP_MSG_EVENT and status */
+    uint8       opcode;                 /* GAP_LINK_TERMINATED_EVENT */
+    uint16      connectionHandle;       /* connection handle */
+    uint8       reason;                 /* termination reason */
+} gapTerminateLinkEvent_t;
+
+/* GAP_LINK_PARAM_UPDATE_EVENT */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GAP_MSG_EVENT and status */
+    uint8       opcode;                 /* GAP_LINK_PARAM_UPDATE_EVENT */
+    uint8       status;                 /* status of the update */
+    uint16      connectionHandle;       /* connection handle */
+    uint16      connInterval;           /* new interval (1.25 ms units) */
+    uint16      connLatency;            /* new peripheral latency */
+    uint16      connTimeout;            /* new supervision timeout */
+} gapLinkUpdateEvent_t;
+
+/* link parameter update request */
+typedef struct {
+    uint16      connectionHandle;       /* connection handle */
+    uint16      intervalMin;            /* interval range (1.25 ms units) */
+    uint16      intervalMax;
+    uint16      connLatency;            /* peripheral latency */
+    uint16      connTimeout;            /* supervision timeout (10 ms units) */
+} gapUpdateLinkParamReq_t;
+
+/* callback for advertiser and scanner events */
+typedef void (*pfnGapCB_t)(uint32_t event, void *pBuf, uintptr_t arg);
+
+/* advertiser and scanner events (also the event mask bits) */
+#define GAP_EVT_ADV_START_AFTER_ENABLE      (1UL << 0)
+#define GAP_EVT_ADV_END_AFTER_DISABLE       (1UL << 1)
+#define GAP_EVT_ADV_START                   (1UL << 2)
+#define GAP_EVT_ADV_END                     (1UL << 3)
+#define GAP_EVT_ADV_SET_TERMINATED          (1UL << 5)
+#define GAP_EVT_SCAN_ENABLED                (1UL << 16)
+#define GAP_EVT_SCAN_DISABLED               (1UL << 17)
+#define GAP_EVT_SCAN_PRD_ENDED              (1UL << 18)
+#define GAP_EVT_SCAN_DUR_ENDED              (1UL << 19)
+#define GAP_EVT_ADV_REPORT                  (1UL << 22)
+#define GAP_EVT_INSUFFICIENT_MEMORY         (1UL << 31)
+
+/* advertiser */
+#define GAP_ADV_EVT_MASK_START_AFTER_ENABLE GAP_EVT_ADV_START_AFTER_ENABLE
+#define GAP_ADV_EVT_MASK_END_AFTER_DISABLE  GAP_EVT_ADV_END_AFTER_DISABLE
+#define GAP_ADV_EVT_MASK_START              GAP_EVT_ADV_START
+#define GAP_ADV_EVT_MASK_END                GAP_EVT_ADV_END
+#define GAP_ADV_EVT_MASK_SET_TERMINATED     GAP_EVT_ADV_SET_TERMINATED
+
+typedef enum {
+    GAP_ADV_DATA_TYPE_ADV,              /* advertising data */
+    GAP_ADV_DATA_TYPE_SCAN_RSP          /* scan response data */
+} GapAdv_dataTypes_t;
+
+typedef enum {
+    GAP_ADV_ENABLE_OPTIONS_USE_MAX,     /* advertise until disabled */
+    GAP_ADV_ENABLE_OPTIONS_USE_DURATION,
+    GAP_ADV_ENABLE_OPTIONS_USE_MAX_EVENTS
+} GapAdv_enableOptions_t;
+
+typedef uint32_t GapAdv_eventMaskFlags_t;
+
+/* advertising parameters (only the event properties are used) */
+#define GAP_ADV_PROP_CONNECTABLE            (1U << 0)
+#define GAP_ADV_PROP_SCANNABLE              (1U << 1)
+#define GAP_ADV_PROP_LEGACY                 (1U << 4)
+
+typedef struct {
+    uint16_t    eventProps;             /* GAP_ADV_PROP_ flags */
+    uint32_t    primIntMin;             /* interval range (0.625 ms units) */
+    uint32_t    primIntMax;
+    uint8_t     primPhy;                /* primary PHY */
+    uint8_t     secPhy;                 /* secondary PHY */
+    uint8_t     sid;                    /* advertising set ID */
+} GapAdv_params_t;
+
+/* data of GAP_EVT_ADV_SET_TERMINATED */
+typedef struct {
+    uint8_t     handle;                 /* advertising set */
+    uint8_t     status;                 /* SUCCESS when a link formed */
+    uint16_t    connHandle;             /* the new link */
+    uint8_t     numCompAdvEvts;         /* advertising events completed */
+} GapAdv_setTerm_t;
+
+/* scanner */
+typedef enum {
+    SCAN_PARAM_RPT_FIELDS,              /* advertising report fields kept */
+    SCAN_PARAM_PRIM_PHYS,               /* primary PHYs scanned */
+    SCAN_PARAM_FLT_POLICY,              /* filter policy */
+    SCAN_PARAM_FLT_PDU_TYPE,            /* PDU types reported */
+    SCAN_PARAM_FLT_MIN_RSSI,            /* weakest signal reported */
+    SCAN_PARAM_FLT_DISC_MODE,           /* discoverable modes reported */
+    SCAN_PARAM_FLT_DUP                  /* duplicate filtering */
+} GapScan_ParamId_t;
+
+#define SCAN_FLT_PDU_CONNECTABLE_ONLY       0x0001
+#define SCAN_FLT_PDU_COMPLETE_ONLY          0x0100
+#define SCAN_FLT_DUP_DISABLE                0x00
+#define SCAN_FLT_DUP_ENABLE                 0x01
+#define SCAN_FLT_DUP_RESET                  0x02
+
+#define SCAN_ADVRPT_FLD_ADDRTYPE            0x0001
+#define SCAN_ADVRPT_FLD_ADDRESS             0x0002
+
+#define SCAN_PRIM_PHY_1M                    0x01
+#define SCAN_PRIM_PHY_CODED                 0x04
+#define SCAN_TYPE_PASSIVE                   0x00
+#define SCAN_TYPE_ACTIVE                    0x01
+
+/* advertising report (GAP_EVT_ADV_REPORT) */
+typedef struct {
+    uint8_t     evtType;                /* advertising event type */
+    uint8_t     addrType;               /* advertiser address type */
+    uint8_t     addr[B_ADDR_LEN];       /* advertiser address */
+    uint8_t     primPhy;                /* primary PHY */
+    uint8_t     secPhy;                 /* secondary PHY */
+    uint8_t     advSid;                 /* advertising set ID */
+    int8_t      txPower;                /* transmit power */
+    int8_t      rssi;                   /* received signal strength */
+    uint16_t    dataLen;                /* length of the data */
+    uint8_t    *pData;                  /* advertising data */
+} GapScan_Evt_AdvRpt_t;
+
+/* initiator */
+#define INIT_PHY_1M                         0x01
+#define INIT_PHY_CODED                      0x04
+
+typedef enum {
+    INIT_PHYPARAM_SCAN_INTERVAL,        /* scan interval while initiating */
+    INIT_PHYPARAM_SCAN_WINDOW,          /* scan window while initiating */
+    INIT_PHYPARAM_CONN_INT_MIN,         /* connection interval range */
+    INIT_PHYPARAM_CONN_INT_MAX,
+    INIT_PHYPARAM_CONN_LATENCY,         /* peripheral latency */
+    INIT_PHYPARAM_SUP_TIMEOUT           /* supervision timeout */
+} GapInit_PhyParamId_t;
+
+
+
+/* ATT */
+
+/* UUID sizes */
+#define ATT_BT_UUID_SIZE                    2
+#define ATT_UUID_SIZE                       16
+
+/* default MTU */
+#define ATT_MTU_SIZE                        23
+
+/* methods (PDU opcodes) */
+#define ATT_ERROR_RSP                       0x01
+#define ATT_READ_BY_TYPE_REQ                0x08
+#define ATT_READ_BY_TYPE_RSP                0x09
+#define ATT_READ_REQ                        0x0A
+#define ATT_READ_RSP                        0x0B
+#define ATT_WRITE_REQ                       0x12
+#define ATT_WRITE_RSP                       0x13
+#define ATT_EXECUTE_WRITE_REQ               0x18
+#define ATT_HANDLE_VALUE_NOTI               0x1B
+#define ATT_WRITE_CMD                       0x52
+
+/* error codes */
+#define ATT_ERR_INVALID_HANDLE              0x01
+#define ATT_ERR_READ_NOT_PERMITTED          0x02
+#define ATT_ERR_WRITE_NOT_PERMITTED         0x03
+#define ATT_ERR_INVALID_PDU                 0x04
+#define ATT_ERR_INVALID_OFFSET              0x07
+#define ATT_ERR_ATTR_NOT_FOUND              0x0A
+#define ATT_ERR_ATTR_NOT_LONG               0x0B
+#define ATT_ERR_INVALID_VALUE_SIZE          0x0D
+#define ATT_ERR_INVALID_VALUE               0x80
+
+/* attribute type (UUID) in a request */
+typedef struct {
+    uint8       len;                    /* 2 or 16 */
+    uint8       uuid[ATT_UUID_SIZE];    /* the UUID (little endian) */
+} attAttrType_t;
+
+typedef struct {
+    uint8       reqOpcode;              /* request that failed */
+    uint16      handle;                 /* attribute it failed on */
+    uint8       errCode;                /* ATT_ERR_ code */
+} attErrorRsp_t;
+
+typedef struct {
+    uint16      startHandle;            /* handle range searched */
+    uint16      endHandle;
+    attAttrType_t type;                 /* attribute type wanted */
+} attReadByTypeReq_t;
+
+typedef struct {
+    uint16      numPairs;               /* handle-value pairs in the list */
+    uint16      len;                    /* size of each pair */
+    uint8      *pDataList;              /* the pairs */
+    uint16      dataLen;                /* size of the list */
+} attReadByTypeRsp_t;
+
+typedef struct {
+    uint16      handle;                 /* attribute to read */
+} attReadReq_t;
+
+typedef struct {
+    uint16      len;                    /* length of the value */
+    uint8      *pValue;                 /* the value */
+} attReadRsp_t;
+
+typedef struct {
+    uint16      handle;                 /* attribute to write */
+    uint16      len;                    /* length of the value */
+    uint8      *pValue;                 /* the value (from GATT_bm_alloc) */
+    uint8       sig;                    /* whether it is signed */
+    uint8       cmd;                    /* whether it is a write command */
+} attWriteReq_t;
+
+typedef struct {
+    uint16      handle;                 /* attribute notified */
+    uint16      len;                    /* length of the value */
+    uint8      *pValue;                 /* the value (from GATT_bm_alloc) */
+} attHandleValueNoti_t;
+
+
+
+/* GATT */
+
+/* services */
+#define GATT_ALL_SERVICES                   0xFFFFFFFF
+
+/* attribute permissions */
+#define GATT_PERMIT_READ                    0x01
+#define GATT_PERMIT_WRITE                   0x02
+
+/* characteristic properties */
+#define GATT_PROP_BCAST                     0x01
+#define GATT_PROP_READ                      0x02
+#define GATT_PROP_WRITE_NO_RSP              0x04
+#define GATT_PROP_WRITE                     0x08
+#define GATT_PROP_NOTIFY                    0x10
+#define GATT_PROP_INDICATE                  0x20
+
+/* client characteristic configuration values */
+#define GATT_CFG_NO_OPERATION               0x0000
+#define GATT_CLIENT_CFG_NOTIFY              0x0001
+#define GATT_CLIENT_CFG_INDICATE            0x0002
+
+/* largest encryption key */
+#define GATT_MAX_ENCRYPT_KEY_SIZE           16
+
+/* method passed to the read callback for reads by the server itself */
+#define GATT_LOCAL_READ                     0xFF
+
+/* number of attributes in an attribute table */
+#define GATT_NUM_ATTRS(attrs)   (sizeof(attrs) / sizeof(gattAttribute_t))
+
+/* GATT UUIDs (defined with the stack) */
+#define GATT_PRIM_SERVICE_UUID              0x2800
+#define GATT_CHARACTER_UUID                 0x2803
+#define GATT_CHAR_USER_DESC_UUID            0x2901
+#define GATT_CLIENT_CHAR_CFG_UUID           0x2902
+#define GATT_DB_HASH_UUID                   0x2B2A
+
+extern CONST uint8 primaryServiceUUID[];
+extern CONST uint8 characterUUID[];
+extern CONST uint8 charUserDescUUID[];
+extern CONST uint8 clientCharCfgUUID[];
+
+/* attribute type */
+typedef struct {
+    uint8       len;                    /* 2 or 16 */
+    const uint8 *uuid;                  /* the UUID (little endian) */
+} gattAttrType_t;
+
+/* attribute in a service's attribute table */
+typedef struct {
+    gattAttrType_t type;                /* attribute type */
+    uint8       permissions;            /* GATT_PERMIT_ flags */
+    uint16      handle;                 /* set when the service registers */
+    uint8      *pValue;                 /* the value */
+} gattAttribute_t;
+
+/* client characteristic configuration of one connection */
+typedef struct {
+    uint16      connHandle;             /* the connection */
+    uint8       value;                  /* GATT_CLIENT_CFG_ flags */
+} gattCharCfg_t;
+
+/* service callbacks */
+typedef bStatus_t (*pfnGATTReadAttrCB_t)(uint16 connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8 *pValue, uint16 *pLen,
+                                         uint16 offset, uint16 maxLen,
+                                         uint8 method);
+typedef bStatus_t (*pfnGATTWriteAttrCB_t)(uint16 connHandle,
+                                          gattAttribute_t *pAttr,
+                                          uint8 *pValue, uint16 len,
+                                          uint16 offset, uint8 method);
+typedef bStatus_t (*pfnGATTAuthorizeAttrCB_t)(uint16 connHandle,
+                                              gattAttribute_t *pAttr,
+                                              uint8 opcode);
+
+typedef struct {
+    pfnGATTReadAttrCB_t      pfnReadAttrCB;      /* read callback */
+    pfnGATTWriteAttrCB_t     pfnWriteAttrCB;     /* write callback */
+    pfnGATTAuthorizeAttrCB_t pfnAuthorizeAttrCB; /* authorization callback */
+} gattServiceCBs_t;
+
+/* GATT message contents */
+typedef union {
+    attErrorRsp_t        errorRsp;      /* ATT_ERROR_RSP */
+    attReadByTypeReq_t   readByTypeReq; /* ATT_READ_BY_TYPE_REQ */
+    attReadByTypeRsp_t   readByTypeRsp; /* ATT_READ_BY_TYPE_RSP */
+    attReadReq_t         readReq;       /* ATT_READ_REQ */
+    attReadRsp_t         readRsp;       /* ATT_READ_RSP */
+    attWriteReq_t        writeReq;      /* ATT_WRITE_REQ and ATT_WRITE_CMD */
+    attHandleValueNoti_t handleValueNoti; /* ATT_HANDLE_VALUE_NOTI */
+} gattMsg_t;
+
+/* GATT_MSG_EVENT */
+typedef struct {
+    osal_event_hdr_t hdr;               /* GATT_MSG_EVENT and status */
+    uint16      connHandle;             /* connection the message is for */
+    uint8       method;                 /* ATT method (opcode) */
+    gattMsg_t   msg;                    /* the message */
+} gattMsgEvent_t;
+
+
+
+/* link database */
+#define LINKDB_CONNHANDLE_INVALID           0xFFFE
+#define LINKDB_CONNHANDLE_ALL               0xFFFF
+
+
+
+/* functions (defined by the checker) */
+
+/* GAP */
+bStatus_t GAP_DeviceInit(uint8 profileRole, uint8 taskID,
+                         GAP_Addr_Modes_t addrMode, void *pRandomAddr);
+void      GAP_RegisterForMsgs(uint8 taskID);
+bStatus_t GAP_SetParamValue(uint16 paramID, uint16 paramValue);
+bStatus_t GAP_UpdateLinkParamReq(gapUpdateLinkParamReq_t *pParams);
+bStatus_t GGS_SetParameter(uint8 param, uint8 len, void *value);
+bStatus_t GGS_AddService(uint32 services);
+
+/* advertiser */
+bStatus_t GapAdv_create(pfnGapCB_t cb, GapAdv_params_t *advParam,
+                        uint8 *advHandle);
+bStatus_t GapAdv_loadByHandle(uint8 handle, GapAdv_dataTypes_t dataType,
+                              uint16 len, uint8 *pBuf);
+bStatus_t GapAdv_setEventMask(uint8 handle, GapAdv_eventMaskFlags_t mask);
+bStatus_t GapAdv_enable(uint8 handle, GapAdv_enableOptions_t enableOptions,
+                        uint16 durationOrMaxEvents);
+bStatus_t GapAdv_disable(uint8 handle);
+
+/* scanner */
+bStatus_t GapScan_registerCb(pfnGapCB_t cb, uintptr_t arg);
+bStatus_t GapScan_setEventMask(uint32_t eventMask);
+bStatus_t GapScan_setPhyParams(uint8 primPhys, uint8 type, uint16 interval,
+                               uint16 window);
+bStatus_t GapScan_setParam(GapScan_ParamId_t paramId, void *pValue);
+bStatus_t GapScan_enable(uint16 period, uint16 duration, uint8 maxNumReport);
+bStatus_t GapScan_disable(void);
+
+/* initiator */
+bStatus_t GapInit_setPhyParam(uint8 phys, GapInit_PhyParamId_t paramId,
+                              uint16 value);
+bStatus_t GapInit_connect(uint8 peerAddrType, uint8 *pPeerAddress,
+                          uint8 phys, uint16 timeout);
+
+/* GATT client */
+void      GATT_InitClient(void);
+void      GATT_RegisterForInd(uint8 taskId);
+void      GATT_RegisterForMsgs(uint8 taskID);
+void     *GATT_bm_alloc(uint16 connHandle, uint8 opcode, uint16 size,
+                        uint16 *pSizeAlloc);
+void      GATT_bm_free(gattMsg_t *pMsg, uint8 opcode);
+bStatus_t GATT_ReadUsingCharUUID(uint16 connHandle, attReadByTypeReq_t *pReq,
+                                 uint8 taskId);
+bStatus_t GATT_DiscAllChars(uint16 connHandle, uint16 startHandle,
+                            uint16 endHandle, uint8 taskId);
+bStatus_t GATT_ReadCharValue(uint16 connHandle, attReadReq_t *pReq,
+                             uint8 taskId);
+bStatus_t GATT_WriteCharValue(uint16 connHandle, attWriteReq_t *pReq,
+                              uint8 taskId);
+bStatus_t GATT_WriteNoRsp(uint16 connHandle, attWriteReq_t *pReq);
+bStatus_t GATT_Notification(uint16 connHandle, attHandleValueNoti_t *pNoti,
+                            uint8 authenticated);
+
+/* GATT server application */
+bStatus_t GATTServApp_AddService(uint32 services);
+bStatus_t GATTServApp_RegisterService(gattAttribute_t *pAttrs,
+                                      uint16 numAttrs, uint8 encKeySize,
+                                      CONST gattServiceCBs_t *pServiceCBs);
+void      GATTServApp_InitCharCfg(uint16 connHandle,
+                                  gattCharCfg_t *charCfgTbl);
+uint16    GATTServApp_ReadCharCfg(uint16 connHandle,
+                                  gattCharCfg_t *charCfgTbl);
+uint8     GATTServApp_WriteCharCfg(uint16 connHandle,
+                                   gattCharCfg_t *charCfgTbl, uint16 value);
+bStatus_t GATTServApp_ProcessCharCfg(gattCharCfg_t *charCfgTbl, uint8 *pValue,
+                                     uint8 authenticated,
+                                     gattAttribute_t *attrTbl,
+                                     uint16 numAttrs, uint8 taskId,
+                                     pfnGATTReadAttrCB_t pfnReadAttrCB);
+bStatus_t GATTServApp_ProcessCCCWriteReq(uint16 connHandle,
+                                         gattAttribute_t *pAttr,
+                                         uint8 *pValue, uint16 len,
+                                         uint16 offset, uint16 validCfg);
+
+/* HCI */
+bStatus_t HCI_LE_WriteSuggestedDefaultDataLenCmd(uint16 suggestedPktLen,
+                                                 uint16 suggestedTxTime);
+
+#endif
@@ -0,0 +1,23 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               hw_cpu_dwt.h                               */
+/*                   Host Stand-In for <inc/hw_cpu_dwt.h>                   */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the DWT registers the application code uses, for the
+   checkers in testing/.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef INC_HW_CPU_DWT_H
+    #define INC_HW_CPU_DWT_H
+
+#define CPU_DWT_O_CTRL              0x00000000
+#define CPU_DWT_O_CYCCNT            0x00000004
+#define CPU_DWT_CTRL_CYCCNTENA      0x00000001
+
+#endif
@@ -0,0 +1,22 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               hw_cpu_scs.h                               */
+/*                   Host Stand-In for <inc/hw_cpu_scs.h>                   */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the SCS registers the application code uses, for the
+   checkers in testing/.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef INC_HW_CPU_SCS_H
+    #define INC_HW_CPU_SCS_H
+
+#define CPU_SCS_O_DEMCR             0x00000DFC
+#define CPU_SCS_DEMCR_TRCENA        0x01000000
+
+#endif
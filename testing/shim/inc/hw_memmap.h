@@ -0,0 +1,25 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               hw_memmap.h                                */
+/*                   Host Stand-In for <inc/hw_memmap.h>                    */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the CC26x2 base addresses the application code uses,
+   for the checkers in testing/.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef INC_HW_MEMMAP_H
+    #define INC_HW_MEMMAP_H
+
+#define GPIO_BASE       0x40022000
+#define GPT0_BASE       0x40010000
+#define GPT1_BASE       0x40011000
+#define CPU_DWT_BASE    0xE0001000
+#define CPU_SCS_BASE    0xE000E000
+
+#endif
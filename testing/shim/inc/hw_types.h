@@ -0,0 +1,27 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                hw_types.h                                */
+/*                    Host Stand-In for <inc/hw_types.h>                    */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains HWREG for the checkers in testing/.  A register access
+   goes through HostReg, which each checker defines with the registers it
+   models (an access to any other register is an error there).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef INC_HW_TYPES_H
+    #define INC_HW_TYPES_H
+
+#include  <stdint.h>
+
+/* the modeled register at an address (defined by the checker) */
+volatile uint32_t *HostReg(uint32_t addr);
+
+#define HWREG(x)        (*HostReg((uint32_t)(x)))
+
+#endif
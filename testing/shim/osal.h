@@ -0,0 +1,27 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  osal.h                                  */
+/*                          Host Stand-In for "osal.h"                      */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the OSAL functions the application code uses, so it
+   can be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef OSAL_H
+    #define OSAL_H
+
+#include  <bcomdef.h>
+
+/* functions (defined by the checker) */
+
+/* compare two blocks of memory, TRUE if they are the same */
+uint8 osal_memcmp(const void *src1, const void *src2, unsigned int len);
+
+#endif
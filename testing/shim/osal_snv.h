@@ -0,0 +1,33 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                osal_snv.h                                */
+/*                        Host Stand-In for "osal_snv.h"                    */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the simple non-volatile (SNV) storage functions the
+   application code uses, so it can be compiled on a host by the checkers in
+   testing/.  The functions are defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef OSAL_SNV_H
+    #define OSAL_SNV_H
+
+#include  <bcomdef.h>
+
+/* types */
+typedef uint8   osalSnvId_t;
+typedef uint8   osalSnvLen_t;
+
+/* functions (defined by the checker) */
+
+/* read and write an item, SUCCESS or NV_OPER_FAILED (an item never */
+/*    written can't be read) */
+uint8 osal_snv_read(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+uint8 osal_snv_write(osalSnvId_t id, osalSnvLen_t len, void *pBuf);
+
+#endif
@@ -0,0 +1,25 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  BIOS.h                                  */
+/*                   Host Stand-In for <ti/sysbios/BIOS.h>                  */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the BIOS constants the application code uses, so it
+   can be compiled on a host by the checkers in testing/.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_BIOS_H
+    #define TI_SYSBIOS_BIOS_H
+
+#include  <xdc/std.h>
+
+/* timeouts */
+#define BIOS_NO_WAIT            0
+#define BIOS_WAIT_FOREVER       (~(UInt32) 0)
+
+#endif
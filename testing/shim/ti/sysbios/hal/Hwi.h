@@ -0,0 +1,26 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  Hwi.h                                   */
+/*                  Host Stand-In for <ti/sysbios/hal/Hwi.h>                */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Hwi functions the application code uses, so it
+   can be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_HAL_HWI_H
+    #define TI_SYSBIOS_HAL_HWI_H
+
+#include  <xdc/std.h>
+
+/* functions (defined by the checker) */
+UInt Hwi_disable(void);
+void Hwi_restore(UInt key);
+
+#endif
@@ -0,0 +1,61 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 Clock.h                                  */
+/*                 Host Stand-In for <ti/sysbios/knl/Clock.h>               */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Clock module the application code uses, so it can
+   be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker, since only it knows how time passes there (the
+   fields of Clock_Struct are for the checker to use).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_CLOCK_H
+    #define TI_SYSBIOS_KNL_CLOCK_H
+
+#include  <xdc/std.h>
+
+/* tick period in us (Clock.tickPeriod in the .syscfg files) */
+#ifndef Clock_tickPeriod
+#define Clock_tickPeriod        10
+#endif
+
+/* types */
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+typedef struct {
+    UInt32      period;                 /* ticks between calls (0 for one) */
+    Bool        startFlag;              /* whether to start when constructed */
+    UArg        arg;                    /* argument passed to the function */
+} Clock_Params;
+
+typedef struct Clock_Struct {
+    Clock_FuncPtr fxn;                  /* function to call */
+    UArg        arg;                    /* argument passed to the function */
+    UInt32      timeout;                /* ticks to the first call */
+    UInt32      period;                 /* ticks between calls (0 for one) */
+    Bool        active;                 /* whether the clock is running */
+    uint64_t    due;                    /* tick of the next call */
+    struct Clock_Struct *next;          /* next clock the checker knows of */
+} Clock_Struct;
+
+typedef Clock_Struct *Clock_Handle;
+
+/* functions (defined by the checker) */
+void         Clock_Params_init(Clock_Params *params);
+void         Clock_construct(Clock_Struct *obj, Clock_FuncPtr fxn,
+                             UInt32 timeout, const Clock_Params *params);
+Clock_Handle Clock_handle(Clock_Struct *obj);
+void         Clock_start(Clock_Handle handle);
+void         Clock_stop(Clock_Handle handle);
+Bool         Clock_isActive(Clock_Handle handle);
+void         Clock_setTimeout(Clock_Handle handle, UInt32 timeout);
+void         Clock_setPeriod(Clock_Handle handle, UInt32 period);
+UInt32       Clock_getTicks(void);
+
+#endif
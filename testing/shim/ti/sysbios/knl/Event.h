@@ -0,0 +1,54 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 Event.h                                  */
+/*                 Host Stand-In for <ti/sysbios/knl/Event.h>               */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Event module the application code uses, so it can
+   be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_EVENT_H
+    #define TI_SYSBIOS_KNL_EVENT_H
+
+#include  <xdc/std.h>
+
+/* event IDs */
+#define Event_Id_NONE           0
+#define Event_Id_00             (1UL << 0)
+#define Event_Id_01             (1UL << 1)
+#define Event_Id_02             (1UL << 2)
+#define Event_Id_03             (1UL << 3)
+#define Event_Id_04             (1UL << 4)
+#define Event_Id_05             (1UL << 5)
+#define Event_Id_30             (1UL << 30)
+#define Event_Id_31             (1UL << 31)
+
+/* types */
+typedef struct {
+    Int         unused;                 /* no parameters are used */
+} Event_Params;
+
+typedef struct {
+    volatile UInt32 posted;             /* events posted, not pended on yet */
+    void       *host;                   /* anything else the checker needs */
+} Event_Struct;
+
+typedef Event_Struct Event_Object;
+typedef Event_Struct *Event_Handle;
+
+/* functions (defined by the checker) */
+void         Event_Params_init(Event_Params *params);
+Event_Handle Event_construct(Event_Struct *obj, const Event_Params *params);
+Event_Handle Event_handle(Event_Struct *obj);
+UInt32       Event_pend(Event_Handle handle, UInt32 andMask, UInt32 orMask,
+                        UInt32 timeout);
+void         Event_post(Event_Handle handle, UInt32 eventMask);
+
+#endif
@@ -0,0 +1,47 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 Queue.h                                  */
+/*                 Host Stand-In for <ti/sysbios/knl/Queue.h>               */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Queue module the application code uses, so it can
+   be compiled on a host by the checkers in testing/.  As in SYS/BIOS the
+   queue is a doubly linked list whose head is an element of the queue
+   itself, so Queue_get on an empty queue returns the queue.  The functions
+   are defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_QUEUE_H
+    #define TI_SYSBIOS_KNL_QUEUE_H
+
+#include  <xdc/std.h>
+
+/* types */
+typedef struct Queue_Elem {
+    struct Queue_Elem *volatile next;   /* next element (the head at the end) */
+    struct Queue_Elem *volatile prev;   /* previous element */
+} Queue_Elem;
+
+typedef struct {
+    Int         unused;                 /* no parameters are used */
+} Queue_Params;
+
+typedef struct {
+    Queue_Elem  elem;                   /* head of the list (must be first) */
+} Queue_Struct;
+
+typedef Queue_Struct *Queue_Handle;
+
+/* functions (defined by the checker) */
+void         Queue_construct(Queue_Struct *obj, const Queue_Params *params);
+Queue_Handle Queue_handle(Queue_Struct *obj);
+Bool         Queue_empty(Queue_Handle handle);
+Ptr          Queue_get(Queue_Handle handle);
+void         Queue_put(Queue_Handle handle, Queue_Elem *elem);
+
+#endif
@@ -0,0 +1,49 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               Semaphore.h                                */
+/*               Host Stand-In for <ti/sysbios/knl/Semaphore.h>             */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Semaphore module the application code uses, so it
+   can be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker (the fields of Semaphore_Struct are for the
+   checker to use).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_SEMAPHORE_H
+    #define TI_SYSBIOS_KNL_SEMAPHORE_H
+
+#include  <xdc/std.h>
+
+/* types */
+typedef enum {
+    Semaphore_Mode_COUNTING,            /* count every post */
+    Semaphore_Mode_BINARY               /* count is 0 or 1 */
+} Semaphore_Mode;
+
+typedef struct {
+    Semaphore_Mode mode;                /* counting or binary */
+} Semaphore_Params;
+
+typedef struct {
+    Semaphore_Mode mode;                /* counting or binary */
+    volatile UInt  count;               /* posts not pended on yet */
+    void          *host;                /* anything else the checker needs */
+} Semaphore_Struct;
+
+typedef Semaphore_Struct *Semaphore_Handle;
+
+/* functions (defined by the checker) */
+void             Semaphore_Params_init(Semaphore_Params *params);
+void             Semaphore_construct(Semaphore_Struct *obj, Int count,
+                                     const Semaphore_Params *params);
+Semaphore_Handle Semaphore_handle(Semaphore_Struct *obj);
+Bool             Semaphore_pend(Semaphore_Handle handle, UInt32 timeout);
+void             Semaphore_post(Semaphore_Handle handle);
+
+#endif
@@ -0,0 +1,26 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  Swi.h                                   */
+/*                  Host Stand-In for <ti/sysbios/knl/Swi.h>                */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Swi functions the application code uses, so it
+   can be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_SWI_H
+    #define TI_SYSBIOS_KNL_SWI_H
+
+#include  <xdc/std.h>
+
+/* functions (defined by the checker) */
+UInt Swi_disable(void);
+void Swi_restore(UInt key);
+
+#endif
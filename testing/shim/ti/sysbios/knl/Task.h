@@ -0,0 +1,52 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  Task.h                                  */
+/*                  Host Stand-In for <ti/sysbios/knl/Task.h>               */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the Task module the application code uses, so it can
+   be compiled on a host by the checkers in testing/.  The functions are
+   defined by each checker (the stack is not used, a checker runs a task
+   however it likes).
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef TI_SYSBIOS_KNL_TASK_H
+    #define TI_SYSBIOS_KNL_TASK_H
+
+#include  <xdc/std.h>
+
+/* types */
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+/* error block (from <xdc/runtime/Error.h>, only ever passed as NULL) */
+typedef struct Error_Block Error_Block;
+
+typedef struct {
+    UArg        arg0;                   /* first argument of the function */
+    UArg        arg1;                   /* second argument of the function */
+    Int         priority;               /* task priority */
+    Ptr         stack;                  /* task stack */
+    size_t      stackSize;              /* size of the stack in bytes */
+} Task_Params;
+
+typedef struct {
+    Task_FuncPtr fxn;                   /* task function */
+    UArg        arg0;                   /* its arguments */
+    UArg        arg1;
+    Int         priority;               /* task priority */
+    void       *host;                   /* anything else the checker needs */
+} Task_Struct;
+
+typedef Task_Struct *Task_Handle;
+
+/* functions (defined by the checker) */
+void        Task_Params_init(Task_Params *params);
+Task_Handle Task_construct(Task_Struct *obj, Task_FuncPtr fxn,
+                           const Task_Params *params, Error_Block *eb);
+
+#endif
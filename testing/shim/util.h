@@ -0,0 +1,41 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  util.h                                  */
+/*                          Host Stand-In for "util.h"                      */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the BLE application utility functions (common/util.c
+   in the SDK) the application code uses, so it can be compiled on a host
+   by the checkers in testing/.  The functions are defined by each checker.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef UTIL_H
+    #define UTIL_H
+
+#include  <xdc/std.h>
+#include  <ti/sysbios/knl/Clock.h>
+#include  <ti/sysbios/knl/Queue.h>
+#include  <ti/sysbios/knl/Event.h>
+
+/* event posted when a message is queued with Util_enqueueMsg */
+#define UTIL_QUEUE_EVENT_ID     Event_Id_30
+
+/* functions (defined by the checker) */
+Clock_Handle Util_constructClock(Clock_Struct *pClock, Clock_FuncPtr clockCB,
+                                 uint32_t clockDuration, uint32_t clockPeriod,
+                                 uint8_t startFlag, UArg arg);
+void         Util_startClock(Clock_Struct *pClock);
+void         Util_restartClock(Clock_Struct *pClock, uint32_t clockTimeout);
+bool         Util_isActive(Clock_Struct *pClock);
+void         Util_stopClock(Clock_Struct *pClock);
+Queue_Handle Util_constructQueue(Queue_Struct *pQueue);
+uint8_t      Util_enqueueMsg(Queue_Handle msgQueue, Event_Handle event,
+                             uint8_t *pMsg);
+uint8_t     *Util_dequeueMsg(Queue_Handle msgQueue);
+
+#endif
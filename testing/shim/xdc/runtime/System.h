@@ -0,0 +1,27 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 System.h                                 */
+/*                  Host Stand-In for <xdc/runtime/System.h>                */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file maps the XDC System formatting functions the application code
+   uses onto the C library, so it can be compiled on a host by the checkers
+   in testing/.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef XDC_RUNTIME_SYSTEM_H
+    #define XDC_RUNTIME_SYSTEM_H
+
+#include  <stdio.h>
+#include  <xdc/std.h>
+
+#define System_sprintf_va(buf, fmt, va)     vsprintf((buf), (fmt), (va))
+#define System_sprintf                      sprintf
+#define System_printf                       printf
+
+#endif
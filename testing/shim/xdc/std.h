@@ -0,0 +1,47 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  std.h                                   */
+/*                      Host Stand-In for <xdc/std.h>                       */
+/*                                Include File                              */
+/*                                                                          */
+/****************************************************************************/
+
+/* This file contains the XDC types the application code uses, so it can be
+   compiled on a host by the checkers in testing/.  Only what the code uses
+   is here.
+
+   Revision History:
+       5/18/24 Adam Krivka      initial revision
+*/
+
+#ifndef XDC_STD_H
+    #define XDC_STD_H
+
+#include  <stdint.h>
+#include  <stdbool.h>
+#include  <stdarg.h>
+#include  <stddef.h>
+
+/* types */
+typedef uintptr_t       UArg;
+typedef int             Int;
+typedef unsigned int    UInt;
+typedef uint8_t         UInt8;
+typedef uint16_t        UInt16;
+typedef uint32_t        UInt32;
+typedef int32_t         Int32;
+typedef char            Char;
+typedef const char      *CString;
+typedef bool            Bool;
+typedef void            *Ptr;
+typedef va_list         VaList;
+
+/* constants */
+#ifndef TRUE
+#define TRUE            1
+#endif
+#ifndef FALSE
+#define FALSE           0
+#endif
+
+#endif